@@ -0,0 +1,232 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "AIMatch.h"
+#include "RttrConfig.h"
+#include "helpers/ThreadPool.h"
+#include "libutil/Socket.h"
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/nowide/args.hpp>
+#include <boost/nowide/fstream.hpp>
+#include <boost/nowide/iostream.hpp>
+#include <boost/program_options.hpp>
+#include <exception>
+#include <iomanip>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace bfs = boost::filesystem;
+namespace po = boost::program_options;
+
+namespace {
+/// Result of one match or the error that stopped it
+struct MatchOutcome
+{
+    AIMatchResult result;
+    std::string error;
+};
+
+double toMilliseconds(Clock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+bool parseAI(std::string name, AI::Info& ai)
+{
+    static const std::map<std::string, AI::Info> ais = {{"dummy", AI::Info(AI::DUMMY)},
+                                                       {"easy", AI::Info(AI::DEFAULT, AI::EASY)},
+                                                       {"medium", AI::Info(AI::DEFAULT, AI::MEDIUM)},
+                                                       {"hard", AI::Info(AI::DEFAULT, AI::HARD)}};
+    boost::algorithm::to_lower(name);
+    const auto it = ais.find(name);
+    if(it == ais.end())
+        return false;
+    ai = it->second;
+    return true;
+}
+
+bool parseObjective(std::string name, GameObjective& objective)
+{
+    static const std::map<std::string, GameObjective> objectives = {
+      {"none", GO_NONE}, {"conquer", GO_CONQUER3_4}, {"domination", GO_TOTALDOMINATION}};
+    boost::algorithm::to_lower(name);
+    const auto it = objectives.find(name);
+    if(it == objectives.end())
+        return false;
+    objective = it->second;
+    return true;
+}
+
+void writeCSVHeader(std::ostream& os, unsigned numPlayers)
+{
+    os << "seed,gfs,finished,checksum";
+    for(unsigned i = 0; i < numPlayers; i++)
+        os << ",defeated" << i << ",country" << i << ",buildings" << i << ",military" << i << ",gold" << i;
+    os << ",duration[ms],error\n";
+}
+
+void writeCSVLine(std::ostream& os, const MatchOutcome& outcome)
+{
+    const AIMatchResult& result = outcome.result;
+    os << result.seed << "," << result.numGFs << "," << result.isFinished << "," << result.checksum;
+    for(const AIMatchResult::Player& player : result.players)
+        os << "," << player.isDefeated << "," << player.country << "," << player.buildings << "," << player.military << "," << player.gold;
+    os << "," << toMilliseconds(result.duration) << "," << outcome.error << "\n";
+}
+
+int runMatches(const po::variables_map& options)
+{
+    if(!RTTRCONFIG.Init())
+    {
+        bnw::cerr << "Failed to initialize the paths" << std::endl;
+        return 1;
+    }
+    const std::string mapPath = options["map"].as<std::string>();
+    if(!bfs::exists(mapPath))
+    {
+        bnw::cerr << "Map not found: " << mapPath << std::endl;
+        return 1;
+    }
+    std::vector<AI::Info> players;
+    for(const std::string& name : options["ai"].as<std::vector<std::string>>())
+    {
+        AI::Info ai;
+        if(!parseAI(name, ai))
+        {
+            bnw::cerr << "Invalid AI: " << name << std::endl;
+            return 1;
+        }
+        players.push_back(ai);
+    }
+    GlobalGameSettings ggs;
+    if(!parseObjective(options["objective"].as<std::string>(), ggs.objective))
+    {
+        bnw::cerr << "Invalid objective: " << options["objective"].as<std::string>() << std::endl;
+        return 1;
+    }
+
+    const unsigned numMatches = options["count"].as<unsigned>();
+    const uint64_t firstSeed = options["seed"].as<uint64_t>();
+    const unsigned maxGF = options["gfs"].as<unsigned>();
+
+    const bool useSpectatorFeed = options.count("spectator-port") > 0;
+    const unsigned spectatorPort = useSpectatorFeed ? options["spectator-port"].as<uint16_t>() : 0;
+    if(useSpectatorFeed && !Socket::Initialize())
+    {
+        bnw::cerr << "Could not initialize the sockets" << std::endl;
+        return 1;
+    }
+
+    AIMatch::InitProcess();
+    helpers::ThreadPool threadPool(options["threads"].as<unsigned>());
+    std::vector<MatchOutcome> outcomes(numMatches);
+    const Clock::time_point startTime = Clock::now();
+    // Each match is completely run by a single thread
+    threadPool.parallelFor(numMatches, [&](size_t i) {
+        MatchOutcome& outcome = outcomes[i];
+        outcome.result.seed = firstSeed + i;
+        try
+        {
+            AIMatch match(players, ggs, outcome.result.seed);
+            if(!match.LoadMap(mapPath))
+                outcome.error = "Could not load the map";
+            else if(useSpectatorFeed && !match.StartSpectatorFeed(static_cast<uint16_t>(spectatorPort + i)))
+                outcome.error = "Could not start the spectator feed";
+            else
+                outcome.result = match.Run(maxGF);
+        } catch(const std::exception& e)
+        {
+            outcome.error = e.what();
+        }
+    });
+    const Clock::duration totalDuration = Clock::now() - startTime;
+
+    bnw::ofstream resultFile;
+    if(options.count("results"))
+    {
+        resultFile.open(options["results"].as<std::string>());
+        if(!resultFile)
+        {
+            bnw::cerr << "Could not open " << options["results"].as<std::string>() << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& resultOut = resultFile.is_open() ? static_cast<std::ostream&>(resultFile) : bnw::cout;
+    writeCSVHeader(resultOut, players.size());
+    for(const MatchOutcome& outcome : outcomes)
+        writeCSVLine(resultOut, outcome);
+
+    // Throughput summary
+    uint64_t numGFs = 0;
+    unsigned numFailed = 0;
+    for(const MatchOutcome& outcome : outcomes)
+    {
+        numGFs += outcome.result.numGFs;
+        if(!outcome.error.empty())
+            numFailed++;
+    }
+    const double wallSeconds = std::chrono::duration<double>(totalDuration).count();
+    bnw::cerr << "Ran " << numMatches << " matches (" << numFailed << " failed) with " << numGFs << " GFs on " << threadPool.getNumThreads()
+              << " threads in " << std::fixed << std::setprecision(3) << wallSeconds << "s ("
+              << (wallSeconds > 0 ? numGFs / wallSeconds : 0.) << " GF/s)" << std::endl;
+    return numFailed ? 1 : 0;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    bnw::args _(argc, argv);
+
+    po::options_description desc("Runs matches between AI players without UI and writes their results as CSV");
+    desc.add_options()("help,h", "Show help")("map", po::value<std::string>()->required(), "Map file to play on")(
+      "ai", po::value<std::vector<std::string>>()->multitoken()->default_value({"hard", "hard"}, "hard hard"),
+      "AI of each player: dummy, easy, medium or hard")("count,n", po::value<unsigned>()->default_value(1), "Number of matches to run")(
+      "seed,s", po::value<uint64_t>()->default_value(0), "Seed of the first match. The following matches use the next seeds")(
+      "gfs,g", po::value<unsigned>()->default_value(50000), "Maximum number of GFs per match")(
+      "objective", po::value<std::string>()->default_value("domination"), "Objective ending a match: none, conquer or domination")(
+      "results,r", po::value<std::string>(), "CSV file for the results. Default: stdout")(
+      "threads,t", po::value<unsigned>()->default_value(0), "Number of threads. 0 uses all cores")(
+      "spectator-port", po::value<uint16_t>(), "Stream the matches to spectators. Match i uses this port + i");
+
+    po::variables_map options;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), options);
+        if(options.count("help"))
+        {
+            bnw::cout << desc << std::endl;
+            return 0;
+        }
+        po::notify(options);
+    } catch(const std::exception& e)
+    {
+        bnw::cerr << "Error: " << e.what() << "\n\n" << desc << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        return runMatches(options);
+    } catch(const std::exception& e)
+    {
+        bnw::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
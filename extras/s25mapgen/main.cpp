@@ -0,0 +1,254 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "Clock.h"
+#include "RttrConfig.h"
+#include "helpers/ThreadPool.h"
+#include "lua/GameDataLoader.h"
+#include "mapGenerator/Map.h"
+#include "mapGenerator/MapMetrics.h"
+#include "mapGenerator/MapSettings.h"
+#include "mapGenerator/RandomConfig.h"
+#include "mapGenerator/RandomMapGenerator.h"
+#include "gameData/LandscapeDesc.h"
+#include "gameData/WorldDescription.h"
+#include "libsiedler2/Archiv.h"
+#include "libsiedler2/libsiedler2.h"
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/nowide/args.hpp>
+#include <boost/nowide/fstream.hpp>
+#include <boost/nowide/iostream.hpp>
+#include <boost/program_options.hpp>
+#include <array>
+#include <exception>
+#include <iomanip>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bfs = boost::filesystem;
+namespace po = boost::program_options;
+
+namespace {
+/// Result of the generation of one map
+struct MapResult
+{
+    uint64_t seed;
+    MapMetrics metrics;
+    std::vector<RandomMapGenerator::StepTiming> stepTimings;
+    Clock::duration totalDuration;
+};
+
+double toMilliseconds(Clock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+bool parseMapStyle(std::string name, MapStyle& style)
+{
+    static const std::map<std::string, MapStyle> styles = {
+      {"greenland", MapStyle::Greenland}, {"riverland", MapStyle::Riverland}, {"ringland", MapStyle::Ringland},
+      {"migration", MapStyle::Migration}, {"islands", MapStyle::Islands},     {"continent", MapStyle::Continent},
+      {"random", MapStyle::Random}};
+    boost::algorithm::to_lower(name);
+    const auto it = styles.find(name);
+    if(it == styles.end())
+        return false;
+    style = it->second;
+    return true;
+}
+
+void writeCSVHeader(std::ostream& os, const MapSettings& settings, const std::vector<RandomMapGenerator::StepTiming>& stepTimings)
+{
+    os << "seed";
+    for(unsigned i = 0; i < settings.numPlayers; i++)
+        os << ",buildable" << i;
+    os << ",hqFairness,waterShare,gold,iron,coal,granite,water,fish,trees,stones";
+    for(const RandomMapGenerator::StepTiming& step : stepTimings)
+        os << "," << step.name << "[ms]";
+    os << ",total[ms]\n";
+}
+
+void writeCSVLine(std::ostream& os, const MapResult& result)
+{
+    const MapMetrics& metrics = result.metrics;
+    os << result.seed;
+    for(unsigned area : metrics.buildableArea)
+        os << "," << area;
+    os << "," << metrics.hqFairness << "," << metrics.waterShare << "," << metrics.gold << "," << metrics.iron << "," << metrics.coal
+       << "," << metrics.granite << "," << metrics.water << "," << metrics.fish << "," << metrics.trees << "," << metrics.stones;
+    for(const RandomMapGenerator::StepTiming& step : result.stepTimings)
+        os << "," << toMilliseconds(step.duration);
+    os << "," << toMilliseconds(result.totalDuration) << "\n";
+}
+
+int generateMaps(const po::variables_map& options)
+{
+    if(!RTTRCONFIG.Init())
+    {
+        bnw::cerr << "Failed to initialize the paths" << std::endl;
+        return 1;
+    }
+    WorldDescription worldDesc;
+    GameDataLoader gdLoader(worldDesc);
+    if(!gdLoader.Load())
+    {
+        bnw::cerr << "Failed to load the game data" << std::endl;
+        return 1;
+    }
+
+    MapSettings settings;
+    settings.numPlayers = options["players"].as<unsigned>();
+    settings.size = MapExtent(options["width"].as<unsigned short>(), options["height"].as<unsigned short>());
+    settings.minPlayerRadius = options["min-radius"].as<double>();
+    settings.maxPlayerRadius = options["max-radius"].as<double>();
+    if(!parseMapStyle(options["style"].as<std::string>(), settings.style))
+    {
+        bnw::cerr << "Invalid map style: " << options["style"].as<std::string>() << std::endl;
+        return 1;
+    }
+    settings.type = worldDesc.landscapes.getIndex(options["landscape"].as<std::string>());
+    if(!settings.type)
+    {
+        bnw::cerr << "Invalid landscape: " << options["landscape"].as<std::string>() << std::endl;
+        return 1;
+    }
+    settings.Validate();
+
+    const unsigned numMaps = options["count"].as<unsigned>();
+    const uint64_t firstSeed = options["seed"].as<uint64_t>();
+    bfs::path outputDir;
+    if(options.count("output"))
+    {
+        outputDir = options["output"].as<std::string>();
+        bfs::create_directories(outputDir);
+    }
+
+    helpers::ThreadPool threadPool(options["threads"].as<unsigned>());
+    std::vector<MapResult> results(numMaps);
+    const Clock::time_point startTime = Clock::now();
+    threadPool.parallelFor(numMaps, [&](size_t i) {
+        MapResult& result = results[i];
+        result.seed = firstSeed + i;
+        const Clock::time_point mapStartTime = Clock::now();
+        RandomConfig config;
+        config.Init(settings.style, settings.type, result.seed, worldDesc);
+        // Maps are generated in parallel. Only a single map can use the pool itself (runs on the calling thread)
+        RandomMapGenerator generator(config, numMaps == 1u ? &threadPool : nullptr);
+        MapSettings mapSettings = settings;
+        mapSettings.name = "Random " + std::to_string(result.seed);
+        Map map = generator.Create(mapSettings);
+        result.totalDuration = Clock::now() - mapStartTime;
+        result.stepTimings = generator.GetStepTimings();
+        result.metrics = MapMetrics::Compute(map, config);
+        if(!outputDir.empty())
+        {
+            const bfs::path filePath = outputDir / ("random_" + std::to_string(result.seed) + ".swd");
+            if(int ec = libsiedler2::Write(filePath.string(), map.CreateArchiv()))
+                throw std::runtime_error("Could not write " + filePath.string() + ": " + libsiedler2::getErrorString(ec));
+        }
+    });
+    const Clock::duration totalDuration = Clock::now() - startTime;
+
+    bnw::ofstream metricsFile;
+    if(options.count("metrics"))
+    {
+        metricsFile.open(options["metrics"].as<std::string>());
+        if(!metricsFile)
+        {
+            bnw::cerr << "Could not open " << options["metrics"].as<std::string>() << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& metricsOut = metricsFile.is_open() ? static_cast<std::ostream&>(metricsFile) : bnw::cout;
+    if(!results.empty())
+        writeCSVHeader(metricsOut, settings, results.front().stepTimings);
+    for(const MapResult& result : results)
+        writeCSVLine(metricsOut, result);
+
+    // Throughput summary
+    Clock::duration cpuDuration = Clock::duration::zero();
+    for(const MapResult& result : results)
+        cpuDuration += result.totalDuration;
+    const double wallSeconds = std::chrono::duration<double>(totalDuration).count();
+    bnw::cerr << "Generated " << numMaps << " maps of " << settings.size.x << "x" << settings.size.y << " on "
+              << threadPool.getNumThreads() << " threads in " << std::fixed << std::setprecision(3) << wallSeconds << "s ("
+              << (wallSeconds > 0 ? numMaps / wallSeconds : 0.) << " maps/s, " << (numMaps ? toMilliseconds(cpuDuration) / numMaps : 0.)
+              << "ms per map)" << std::endl;
+    if(!results.empty())
+    {
+        for(unsigned step = 0; step < results.front().stepTimings.size(); step++)
+        {
+            Clock::duration stepDuration = Clock::duration::zero();
+            for(const MapResult& result : results)
+                stepDuration += result.stepTimings[step].duration;
+            bnw::cerr << "  " << std::setw(12) << std::left << results.front().stepTimings[step].name << std::right << std::setw(10)
+                      << toMilliseconds(stepDuration) / numMaps << "ms" << std::endl;
+        }
+    }
+    return 0;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    bnw::args _(argc, argv);
+
+    po::options_description desc("Generates random maps and writes their quality metrics as CSV");
+    desc.add_options()("help,h", "Show help")("count,n", po::value<unsigned>()->default_value(1), "Number of maps to generate")(
+      "seed,s", po::value<uint64_t>()->default_value(0), "Seed of the first map. The following maps use the next seeds")(
+      "players,p", po::value<unsigned>()->default_value(2), "Number of players")(
+      "width", po::value<unsigned short>()->default_value(256), "Width of the maps")(
+      "height", po::value<unsigned short>()->default_value(256), "Height of the maps")(
+      "style", po::value<std::string>()->default_value("random"),
+      "Map style: greenland, riverland, ringland, migration, islands, continent or random")(
+      "landscape", po::value<std::string>()->default_value("greenland"), "Landscape: greenland, wasteland or winterworld")(
+      "min-radius", po::value<double>()->default_value(MapSettings().minPlayerRadius), "Minimum player distance to the center")(
+      "max-radius", po::value<double>()->default_value(MapSettings().maxPlayerRadius), "Maximum player distance to the center")(
+      "output,o", po::value<std::string>(), "Folder to write the maps to. Maps are not written if not given")(
+      "metrics,m", po::value<std::string>(), "CSV file for the metrics. Default: stdout")(
+      "threads,t", po::value<unsigned>()->default_value(0), "Number of threads. 0 uses all cores");
+
+    po::variables_map options;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), options);
+        po::notify(options);
+    } catch(const std::exception& e)
+    {
+        bnw::cerr << "Error: " << e.what() << "\n\n" << desc << std::endl;
+        return 1;
+    }
+
+    if(options.count("help"))
+    {
+        bnw::cout << desc << std::endl;
+        return 0;
+    }
+
+    try
+    {
+        return generateMaps(options);
+    } catch(const std::exception& e)
+    {
+        bnw::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,63 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef Fnv1aHash_h__
+#define Fnv1aHash_h__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace helpers {
+
+/// Simple and fast 64 bit hash (FNV-1a). Not suitable for cryptographic purposes
+/// but stable across runs and platforms (for the same byte input) so it can be used for cache keys
+class Fnv1aHash
+{
+    uint64_t value_;
+
+public:
+    Fnv1aHash() : value_(14695981039346656037ull) {}
+
+    void add(const void* data, size_t size)
+    {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        for(size_t i = 0; i < size; i++)
+        {
+            value_ ^= bytes[i];
+            value_ *= 1099511628211ull;
+        }
+    }
+    template<typename T>
+    std::enable_if_t<std::is_arithmetic<T>::value> add(T value)
+    {
+        add(&value, sizeof(value));
+    }
+    void add(const std::string& value)
+    {
+        // Include the size so ("ab", "c") differs from ("a", "bc")
+        add(static_cast<uint64_t>(value.size()));
+        add(value.data(), value.size());
+    }
+
+    uint64_t get() const { return value_; }
+};
+
+} // namespace helpers
+
+#endif // Fnv1aHash_h__
@@ -0,0 +1,89 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef LRUCache_h__
+#define LRUCache_h__
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <map>
+#include <utility>
+
+namespace helpers {
+/// Map holding at most maxSize entries. When full the least recently used entry is removed.
+/// Lookup accepts any type comparable to T_Key (e.g. a tuple of references for a tuple key) to avoid creating keys on each lookup
+template<typename T_Key, typename T_Value>
+class LRUCache
+{
+    using Entry = std::pair<T_Key, T_Value>;
+    /// Most recently used entry first
+    std::list<Entry> entries_;
+    std::map<T_Key, typename std::list<Entry>::iterator, std::less<>> index_;
+    size_t maxSize_;
+
+public:
+    explicit LRUCache(size_t maxSize) : maxSize_(maxSize) {}
+    /// Copies start empty as the index refers to the entries of the source
+    LRUCache(const LRUCache& other) : maxSize_(other.maxSize_) {}
+    LRUCache& operator=(const LRUCache& other)
+    {
+        clear();
+        maxSize_ = other.maxSize_;
+        return *this;
+    }
+
+    /// Return the value for the key and mark it as most recently used or nullptr if it is not cached
+    template<typename T_LookupKey>
+    T_Value* find(const T_LookupKey& key)
+    {
+        auto it = index_.find(key);
+        if(it == index_.end())
+            return nullptr;
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return &it->second->second;
+    }
+    /// Add or replace the value for the key and return a reference to the stored value
+    T_Value& insert(const T_Key& key, T_Value value)
+    {
+        auto it = index_.find(key);
+        if(it != index_.end())
+        {
+            entries_.splice(entries_.begin(), entries_, it->second);
+            it->second->second = std::move(value);
+            return it->second->second;
+        }
+        if(maxSize_ > 0 && entries_.size() >= maxSize_)
+        {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+        entries_.emplace_front(key, std::move(value));
+        index_.emplace(key, entries_.begin());
+        return entries_.front().second;
+    }
+    void clear()
+    {
+        index_.clear();
+        entries_.clear();
+    }
+    size_t size() const { return entries_.size(); }
+    size_t maxSize() const { return maxSize_; }
+};
+} // namespace helpers
+
+#endif // LRUCache_h__
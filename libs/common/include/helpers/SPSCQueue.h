@@ -0,0 +1,77 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SPSCQueue_h__
+#define SPSCQueue_h__
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace helpers {
+
+/// Bounded lock-free queue for exactly one producer and one consumer thread.
+/// Pushing and popping never block or allocate, so it can be used on the game thread without adding jitter
+template<typename T>
+class SPSCQueue
+{
+public:
+    explicit SPSCQueue(size_t capacity) : buffer_(capacity + 1u), readIdx_(0), writeIdx_(0) {}
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    size_t capacity() const { return buffer_.size() - 1u; }
+
+    /// Add an element (producer only). Returns false if the queue is full in which case value is unchanged
+    bool tryPush(T&& value)
+    {
+        const size_t writeIdx = writeIdx_.load(std::memory_order_relaxed);
+        const size_t nextIdx = next(writeIdx);
+        if(nextIdx == readIdx_.load(std::memory_order_acquire))
+            return false;
+        buffer_[writeIdx] = std::move(value);
+        writeIdx_.store(nextIdx, std::memory_order_release);
+        return true;
+    }
+    /// Remove the oldest element (consumer only). Returns false if the queue is empty
+    bool tryPop(T& value)
+    {
+        const size_t readIdx = readIdx_.load(std::memory_order_relaxed);
+        if(readIdx == writeIdx_.load(std::memory_order_acquire))
+            return false;
+        value = std::move(buffer_[readIdx]);
+        readIdx_.store(next(readIdx), std::memory_order_release);
+        return true;
+    }
+    /// Only exact if neither thread modifies the queue concurrently
+    bool empty() const { return readIdx_.load(std::memory_order_acquire) == writeIdx_.load(std::memory_order_acquire); }
+
+private:
+    size_t next(size_t idx) const { return (idx + 1u == buffer_.size()) ? 0u : idx + 1u; }
+
+    /// One unused slot to distinguish full from empty
+    std::vector<T> buffer_;
+    /// Next element to read, written by the consumer only
+    std::atomic<size_t> readIdx_;
+    /// Next slot to write, written by the producer only
+    std::atomic<size_t> writeIdx_;
+};
+
+} // namespace helpers
+
+#endif // SPSCQueue_h__
@@ -0,0 +1,132 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ThreadPool_h__
+#define ThreadPool_h__
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace helpers {
+
+/// Fixed number of worker threads executing submitted tasks in FIFO order.
+/// Tasks must not wait for other tasks of the same pool (e.g. by calling parallelFor) as that can deadlock
+class ThreadPool
+{
+public:
+    /// Create the given number of threads. 0 uses the number of hardware threads
+    explicit ThreadPool(unsigned numThreads = 0);
+    /// Finishes all pending tasks and joins the threads
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned getNumThreads() const { return static_cast<unsigned>(threads_.size()); }
+
+    /// Run the function on a worker thread. Exceptions are passed to the returned future
+    template<typename F>
+    std::future<std::result_of_t<F()>> submit(F&& func);
+
+    /// Call func(i) for all i in [0, count) and wait till all are done. The calling thread works on the items too.
+    /// The first exception thrown by func is rethrown after all started calls are finished
+    template<typename F>
+    void parallelFor(size_t count, F&& func);
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> threads_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_;
+};
+
+template<typename F>
+std::future<std::result_of_t<F()>> ThreadPool::submit(F&& func)
+{
+    using Result = std::result_of_t<F()>;
+    // std::function requires copyable functors
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(func));
+    std::future<Result> result = task->get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.emplace([task]() { (*task)(); });
+    }
+    cv_.notify_one();
+    return result;
+}
+
+template<typename F>
+void ThreadPool::parallelFor(size_t count, F&& func)
+{
+    if(count <= 1u || threads_.empty())
+    {
+        for(size_t i = 0; i < count; i++)
+            func(i);
+        return;
+    }
+    std::atomic<size_t> nextIdx(0);
+    const auto worker = [&nextIdx, count, &func]() {
+        for(size_t i = nextIdx++; i < count; i = nextIdx++)
+            func(i);
+    };
+    const size_t numHelpers = std::min<size_t>(threads_.size(), count - 1u);
+    std::vector<std::future<void>> helperTasks;
+    helperTasks.reserve(numHelpers);
+    for(size_t i = 0; i < numHelpers; i++)
+        helperTasks.push_back(submit(worker));
+    std::exception_ptr error;
+    try
+    {
+        worker();
+    } catch(...)
+    {
+        error = std::current_exception();
+        // Let the helpers stop early
+        nextIdx = count;
+    }
+    // Always wait for all helpers as they reference local variables
+    for(std::future<void>& helper : helperTasks)
+    {
+        try
+        {
+            helper.get();
+        } catch(...)
+        {
+            if(!error)
+                error = std::current_exception();
+        }
+    }
+    if(error)
+        std::rethrow_exception(error);
+}
+
+} // namespace helpers
+
+#endif // ThreadPool_h__
@@ -128,7 +128,7 @@ const std::array<const char*, 104> SUPPRESS_UNUSED FILE_PATHS = {{
   /* 98 */ "<RTTR_USERDATA>/LSTS",              // persönliche lstfiles (immer bei start geladen)
   /* 99 */ "<RTTR_USERDATA>/LSTS/GAME",         // persönliche lstfiles (immer bei spielstart geladen)
   /*100 */ "<RTTR_USERDATA>/screenshots",       // Screenshots
-  /*101 */ "",                                  // unused
+  /*101 */ "<RTTR_USERDATA>/cache",             // Cache for generated data (e.g. packed textures)
   /*102 */ "<RTTR_GAME>/GFX/PICS/SETUP013.LBM", // Optionen
   /*103 */ "<RTTR_GAME>/GFX/PICS/SETUP015.LBM"  // Freies Spiel
 }};
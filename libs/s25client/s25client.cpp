@@ -23,9 +23,11 @@
 #include "RTTR_Version.h"
 #include "RttrConfig.h"
 #include "Settings.h"
+#include "SimProfiler.h"
 #include "SignalHandler.h"
 #include "files.h"
 #include "mygettext/mygettext.h"
+#include "network/GameClient.h"
 #include "ogl/glAllocator.h"
 #include "libsiedler2/libsiedler2.h"
 #include "libutil/LocaleHelper.h"
@@ -267,7 +269,7 @@ bool InitDirectories()
     LOG.write("Starting in %s\n", LogTarget::Stdout) % curPath;
 
     // diverse dirs anlegen
-    std::array<unsigned, 9> dirs = {{94, 41, 47, 48, 51, 85, 98, 99, 100}}; // settingsdir muss zuerst angelegt werden (94)
+    std::array<unsigned, 10> dirs = {{94, 41, 47, 48, 51, 85, 98, 99, 100, 101}}; // settingsdir muss zuerst angelegt werden (94)
 
     std::string oldSettingsDir;
 
@@ -375,6 +377,16 @@ int RunProgram(po::variables_map& options)
         if(!InitGame())
             return 2;
 
+#if RTTR_ENABLE_PROFILER
+        if(options.count("profile") || options.count("profile-trace"))
+        {
+            SIMPROFILER.setEnabled(true);
+            SIMPROFILER.setTraceEnabled(options.count("profile-trace") > 0);
+        }
+#endif
+
+        if(options.count("spectator-port"))
+            GAMECLIENT.SetSpectatorPort(options["spectator-port"].as<uint16_t>());
         if(options.count("map"))
             QuickStartGame(options["map"].as<std::string>());
 
@@ -420,7 +432,12 @@ int main(int argc, char** argv)
 
     po::options_description desc("Allowed options");
     desc.add_options()("help,h", "Show help")("map,m", po::value<std::string>(),
-                                              "Map to load")("test", "Run in test mode (shows errors during run)");
+                                              "Map to load")("test", "Run in test mode (shows errors during run)")(
+      "spectator-port", po::value<uint16_t>(), "Stream the games to spectators connecting to this port (only what you see in own games)");
+#if RTTR_ENABLE_PROFILER
+    desc.add_options()("profile", "Record timings of the simulation and write a report to the log folder when the game ends")(
+      "profile-trace", "Same as profile but also write a timeline in the Chrome trace format");
+#endif
     po::positional_options_description positionalOptions;
     positionalOptions.add("map", 1);
 
@@ -0,0 +1,159 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "AIMatch.h"
+#include "AsyncChecksum.h"
+#include "EventManager.h"
+#include "Game.h"
+#include "GamePlayer.h"
+#include "PlayerInfo.h"
+#include "Settings.h"
+#include "SoundManager.h"
+#include "ai/AIPlayer.h"
+#include "factories/AIFactory.h"
+#include "network/GameClient.h"
+#include "network/SpectatorFeed.h"
+#include "ogl/glAllocator.h"
+#include "random/Random.h"
+#include "world/GameWorld.h"
+#include "gameData/MaxPlayers.h"
+#include "libsiedler2/libsiedler2.h"
+#include "libutil/colors.h"
+#include <algorithm>
+
+namespace {
+/// Interval in GFs at which the AIs get to issue commands (like the network frames of a real game)
+const unsigned NWF_LENGTH = 5;
+} // namespace
+
+AIMatch::AIMatch(const std::vector<AI::Info>& players, const GlobalGameSettings& ggs, uint64_t seed) : seed_(seed), aiInfos_(players)
+{
+    RANDOM.Init(seed);
+    std::vector<PlayerInfo> playerInfos;
+    for(unsigned i = 0; i < aiInfos_.size(); i++)
+    {
+        PlayerInfo player;
+        player.ps = PS_AI;
+        player.aiInfo = aiInfos_[i];
+        player.name = "AI " + std::to_string(i);
+        player.color = PLAYER_COLORS[i % PLAYER_COLORS.size()];
+        playerInfos.push_back(player);
+    }
+    game_ = std::make_shared<Game>(ggs, 0u, playerInfos);
+    GameWorld& world = game_->world_;
+    for(unsigned i = 0; i < world.GetNumPlayers(); ++i)
+        world.GetPlayer(i).MakeStartPacts();
+}
+
+AIMatch::~AIMatch() = default;
+
+void AIMatch::InitProcess()
+{
+    // Maps are loaded as GL items
+    libsiedler2::setAllocator(new GlAllocator);
+    // The simulation only reads from those but they must be created and set up before running the matches
+    SETTINGS.sound.effekte = false;
+    SOUNDMANAGER.WorkingFinished(nullptr);
+    // Make sure no match player is the local player of the client so nothing is sent to it
+    GAMECLIENT.SetTestPlayerId(MAX_PLAYERS);
+}
+
+bool AIMatch::LoadMap(const std::string& mapFilePath)
+{
+    GameWorld& world = game_->world_;
+    if(!world.LoadMap(game_, mapFilePath, ""))
+        return false;
+    world.PlaceAndFixWater();
+    world.InitAfterLoad();
+    return true;
+}
+
+bool AIMatch::StartSpectatorFeed(uint16_t port)
+{
+    spectatorFeed_ = std::make_unique<SpectatorFeed>(game_->world_);
+    if(spectatorFeed_->Listen(port))
+        return true;
+    spectatorFeed_.reset();
+    return false;
+}
+
+AIMatchResult AIMatch::Run(unsigned maxGF)
+{
+    GameWorld& world = game_->world_;
+    for(unsigned i = 0; i < aiInfos_.size(); i++)
+        game_->AddAIPlayer(AIFactory::Create(aiInfos_[i], i, world));
+    game_->Start(false);
+
+    // Commands are executed at the NWF after they were issued as in a network game
+    std::vector<std::vector<gc::GameCommandPtr>> pendingGCs(game_->aiPlayers_.size());
+    const Clock::time_point startTime = Clock::now();
+    unsigned gf = 0;
+    for(; gf < maxGF && !game_->IsGameFinished(); gf++)
+    {
+        // Jump over GFs in which nothing happens (e.g. all AIs are defeated) but stop at the NWF executing pending commands
+        const unsigned lastGF = game_->em_->GetCurrentGF() + (maxGF - gf - 1);
+        const unsigned nextNWF = (game_->em_->GetCurrentGF() + NWF_LENGTH - 1) / NWF_LENGTH * NWF_LENGTH;
+        const bool hasPendingGCs = std::any_of(pendingGCs.begin(), pendingGCs.end(),
+                                               [](const std::vector<gc::GameCommandPtr>& gcs) { return !gcs.empty(); });
+        gf += game_->SkipIdleGFs(hasPendingGCs ? std::min(lastGF, nextNWF) : lastGF);
+
+        const unsigned curGF = game_->em_->GetCurrentGF();
+        const bool isNWF = curGF % NWF_LENGTH == 0;
+        if(isNWF)
+        {
+            for(unsigned i = 0; i < game_->aiPlayers_.size(); i++)
+            {
+                AIPlayer& ai = game_->aiPlayers_[i];
+                for(const gc::GameCommandPtr& gc : pendingGCs[i])
+                    gc->Execute(world, ai.GetPlayerId());
+                pendingGCs[i] = ai.FetchGameCommands();
+                // Nobody to talk to
+                ai.FetchChatMessages();
+            }
+        }
+        for(AIPlayer& ai : game_->aiPlayers_)
+            ai.RunGF(curGF, isNWF);
+        game_->RunGF();
+        if(isNWF)
+        {
+            game_->worldSnapshots_.Publish(world, game_->em_->GetCurrentGF());
+            if(spectatorFeed_)
+            {
+                spectatorFeed_->PublishChanges(game_->em_->GetCurrentGF());
+                spectatorFeed_->Run();
+            }
+        }
+    }
+
+    AIMatchResult result;
+    result.duration = Clock::now() - startTime;
+    result.seed = seed_;
+    result.numGFs = gf;
+    result.isFinished = game_->IsGameFinished();
+    result.checksum = AsyncChecksum::create(*game_).getHash();
+    for(unsigned i = 0; i < world.GetNumPlayers(); i++)
+    {
+        GamePlayer& player = world.GetPlayer(i);
+        player.CalcStatistics();
+        result.players.push_back(AIMatchResult::Player{player.IsDefeated(), player.GetStatisticCurrentValue(STAT_COUNTRY),
+                                                       player.GetStatisticCurrentValue(STAT_BUILDINGS),
+                                                       player.GetStatisticCurrentValue(STAT_MILITARY),
+                                                       player.GetStatisticCurrentValue(STAT_GOLD)});
+    }
+    return result;
+}
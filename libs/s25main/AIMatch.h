@@ -0,0 +1,81 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef AIMatch_h__
+#define AIMatch_h__
+
+#include "Clock.h"
+#include "GlobalGameSettings.h"
+#include "gameTypes/AIInfo.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Game;
+class SpectatorFeed;
+
+/// Outcome of an AI match
+struct AIMatchResult
+{
+    struct Player
+    {
+        bool isDefeated;
+        unsigned country, buildings, military, gold;
+    };
+    uint64_t seed;
+    /// Number of GFs run
+    unsigned numGFs;
+    /// True if the objective was reached before the GF limit
+    bool isFinished;
+    /// Checksum of the game (RNG and object counts) after the last GF
+    unsigned checksum;
+    std::vector<Player> players;
+    /// Time needed to run the GFs (excludes loading)
+    Clock::duration duration;
+};
+
+/// A game between AI players only without any network or UI.
+/// All game state lives in this object or in thread local storage so independent matches can be run at the same time,
+/// but each on its own thread. Creation, setup and running a match must happen on the same thread.
+class AIMatch
+{
+public:
+    AIMatch(const std::vector<AI::Info>& players, const GlobalGameSettings& ggs, uint64_t seed);
+    ~AIMatch();
+
+    /// Prepare the process wide state (must be called once before running matches on multiple threads)
+    static void InitProcess();
+
+    /// Load the world from a map file. Alternatively set up GetGame().world_ directly
+    bool LoadMap(const std::string& mapFilePath);
+    Game& GetGame() { return *game_; }
+
+    /// Stream the match to spectators connecting to the port while it is running. Must be called after the world was set up
+    bool StartSpectatorFeed(uint16_t port);
+
+    /// Add the AIs and run till the objective is reached or maxGF GFs are run
+    AIMatchResult Run(unsigned maxGF);
+
+private:
+    uint64_t seed_;
+    std::vector<AI::Info> aiInfos_;
+    std::shared_ptr<Game> game_;
+    std::unique_ptr<SpectatorFeed> spectatorFeed_;
+};
+
+#endif // AIMatch_h__
@@ -290,9 +290,9 @@ bool DebugInfo::SendReplay()
         if(!rpl || !rpl->IsRecording())
             return true;
 
-        BinaryFile& f = rpl->GetFile();
-
-        f.Flush();
+        BinaryFile f;
+        if(!rpl->OpenRecordedFile(f))
+            return false;
 
         if(!SendString("Replay"))
             return false;
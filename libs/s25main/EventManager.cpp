@@ -20,9 +20,11 @@
 #include "GameEvent.h"
 #include "GameObject.h"
 #include "SerializedGameData.h"
+#include "SimProfiler.h"
 #include "helpers/containerUtils.h"
 #include "libutil/Log.h"
 #include <mygettext/mygettext.h>
+#include <limits>
 
 EventManager::EventManager(unsigned startGF) : numActiveEvents(0), eventInstanceCtr(1), currentGF(startGF), curActiveEvent(nullptr) {}
 
@@ -52,6 +54,7 @@ void EventManager::Clear()
         delete obj;
     }
     killList.clear();
+    postEventsCallbacks.clear();
 
     // Reset counters (next should already be 0 but just to be sure)
     numActiveEvents = 0u;
@@ -100,6 +103,20 @@ void EventManager::ExecuteNextGF()
     DestroyCurrentObjects();
 }
 
+unsigned EventManager::GetNextActiveGF() const
+{
+    if(!killList.empty())
+        return currentGF + 1;
+    return events.empty() ? std::numeric_limits<unsigned>::max() : events.begin()->first;
+}
+
+void EventManager::SkipToGF(unsigned gf)
+{
+    RTTR_Assert(gf >= currentGF);
+    RTTR_Assert(gf < GetNextActiveGF());
+    currentGF = gf;
+}
+
 void EventManager::DestroyCurrentObjects()
 {
     // Remove all objects
@@ -149,13 +166,22 @@ void EventManager::ExecuteEvents(const EventMap::iterator& itEvents)
         RTTR_Assert(ev->obj->GetObjId() <= GameObject::GetObjIDCounter());
 
         curActiveEvent = ev;
-        ev->obj->HandleEvent(ev->id);
+        {
+            RTTR_PROFILE_SCOPE(PROF_EVENT, SimProfiler::getGOTypeName(ev->obj->GetGOT()), ev->id);
+            ev->obj->HandleEvent(ev->id);
+        }
 
         delete ev;
         --numActiveEvents;
     }
     curActiveEvent = nullptr;
     events.erase(itEvents);
+
+    // No event is active anymore, so anything requested by the callbacks is done immediately
+    std::vector<std::function<void()>> callbacks;
+    std::swap(callbacks, postEventsCallbacks);
+    for(const auto& callback : callbacks)
+        callback();
 }
 
 void EventManager::Serialize(SerializedGameData& sgd) const
@@ -277,3 +303,9 @@ void EventManager::AddToKillList(GameObject* obj)
     RTTR_Assert(!IsObjectInKillList(*obj));
     killList.push_back(obj);
 }
+
+void EventManager::AddPostEventsCallback(std::function<void()> callback)
+{
+    RTTR_Assert(IsExecutingEvents());
+    postEventsCallbacks.push_back(std::move(callback));
+}
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <functional>
 #include <list>
 #include <map>
 #include <vector>
@@ -41,6 +42,11 @@ public:
 
     /// Increase the GF# and execute all events of that GF
     void ExecuteNextGF();
+    /// Return the next GF in which anything is done: The GF of the next event or the next GF if objects are to be destroyed.
+    /// Return the maximum unsigned value if there is nothing to do
+    unsigned GetNextActiveGF() const;
+    /// Increase the GF# to the given GF without executing anything. There must not be anything to do till then
+    void SkipToGF(unsigned gf);
     /// Add an event for the given object
     /// @param length Number of GFs after which it is executed (>0)
     /// @param id     ID of the event (passed to OnEvent)
@@ -52,6 +58,11 @@ public:
     void RemoveEvent(const GameEvent*& ep);
     /// Add an object to be destroyed after current GF
     void AddToKillList(GameObject* obj);
+    /// Return true while the events of a GF are executed
+    bool IsExecutingEvents() const { return curActiveEvent != nullptr; }
+    /// Call the function once all events of the current GF are executed (in the order they were added).
+    /// Used to do expensive updates only once per GF instead of once per event. Only valid while events are executed
+    void AddPostEventsCallback(std::function<void()> callback);
 
     void Serialize(SerializedGameData& sgd) const;
     void Deserialize(SerializedGameData& sgd);
@@ -78,6 +89,8 @@ protected:
     EventMap events;      /// Mapping of GF to Events to be executed in this GF
     GameObjList killList; /// Objects that will be killed after current GF
     const GameEvent* curActiveEvent;
+    /// Functions to call after the events of the current GF
+    std::vector<std::function<void()>> postEventsCallbacks;
 
     const GameEvent* AddEventToQueue(const GameEvent* event);
     void RemoveEventFromQueue(const GameEvent& event);
@@ -18,6 +18,7 @@
 #include "rttrDefines.h" // IWYU pragma: keep
 #include "FindWhConditions.h"
 #include "buildings/nobBaseWarehouse.h"
+#include "gameTypes/Inventory.h"
 #include "gameData/ShieldConsts.h"
 
 namespace FW {
@@ -27,6 +28,11 @@ bool HasMinWares::operator()(const nobBaseWarehouse& wh) const
     return wh.GetNumRealWares(type) >= count;
 }
 
+bool HasMinWares::IsPossible(const Inventory& whsInventory) const
+{
+    return whsInventory[type] >= count;
+}
+
 bool HasFigure::operator()(const nobBaseWarehouse& wh) const
 {
     if(wh.GetNumRealFigures(type) > 0)
@@ -37,16 +43,34 @@ bool HasFigure::operator()(const nobBaseWarehouse& wh) const
         return false;
 }
 
+bool HasFigure::IsPossible(const Inventory& whsInventory) const
+{
+    // Recruiting depends on the settings of each warehouse
+    return whsInventory[type] > 0 || (recruitingAllowed && type != JOB_PACKDONKEY);
+}
+
 bool HasWareAndFigure::operator()(const nobBaseWarehouse& wh) const
 {
     return HasMinWares::operator()(wh) && HasFigure::operator()(wh);
 }
 
+bool HasWareAndFigure::IsPossible(const Inventory& whsInventory) const
+{
+    return HasMinWares::IsPossible(whsInventory) && HasFigure::IsPossible(whsInventory);
+}
+
 bool HasMinSoldiers::operator()(const nobBaseWarehouse& wh) const
 {
     return wh.GetNumSoldiers() >= count;
 }
 
+bool HasMinSoldiers::IsPossible(const Inventory& whsInventory) const
+{
+    return whsInventory[JOB_PRIVATE] + whsInventory[JOB_PRIVATEFIRSTCLASS] + whsInventory[JOB_SERGEANT] + whsInventory[JOB_OFFICER]
+             + whsInventory[JOB_GENERAL]
+           >= count;
+}
+
 bool AcceptsWare::operator()(const nobBaseWarehouse& wh) const
 {
     // Einlagern darf nicht verboten sein
@@ -22,8 +22,10 @@
 #include "gameTypes/JobTypes.h"
 
 class nobBaseWarehouse;
+struct Inventory;
 
 /// Vorgefertigte Bedingungsfunktionen für FindWarehouse, param jeweils Pointer auf die einzelnen Strukturen
+/// IsPossible gets the summed real inventory of all warehouses and returns false if no warehouse can match
 namespace FW {
 struct HasMinWares
 {
@@ -31,6 +33,7 @@ struct HasMinWares
     const unsigned count;
     HasMinWares(const GoodType type, unsigned count = 1) : type(type), count(count) {}
     bool operator()(const nobBaseWarehouse& wh) const;
+    bool IsPossible(const Inventory& whsInventory) const;
 };
 
 struct HasFigure
@@ -39,6 +42,7 @@ struct HasFigure
     const bool recruitingAllowed;
     HasFigure(const Job type, bool recruitingAllowed) : type(type), recruitingAllowed(recruitingAllowed) {}
     bool operator()(const nobBaseWarehouse& wh) const;
+    bool IsPossible(const Inventory& whsInventory) const;
 };
 
 struct HasWareAndFigure : protected HasMinWares, protected HasFigure
@@ -46,6 +50,7 @@ struct HasWareAndFigure : protected HasMinWares, protected HasFigure
     HasWareAndFigure(const GoodType good, const Job job, bool recruitingAllowed) : HasMinWares(good, 1), HasFigure(job, recruitingAllowed)
     {}
     bool operator()(const nobBaseWarehouse& wh) const;
+    bool IsPossible(const Inventory& whsInventory) const;
 };
 
 struct HasMinSoldiers
@@ -53,6 +58,7 @@ struct HasMinSoldiers
     const unsigned count;
     HasMinSoldiers(unsigned count) : count(count) {}
     bool operator()(const nobBaseWarehouse& wh) const;
+    bool IsPossible(const Inventory& whsInventory) const;
 };
 
 struct AcceptsWare
@@ -60,6 +66,7 @@ struct AcceptsWare
     const GoodType type;
     AcceptsWare(const GoodType type) : type(type) {}
     bool operator()(const nobBaseWarehouse& wh) const;
+    bool IsPossible(const Inventory& /*whsInventory*/) const { return true; }
 };
 
 struct AcceptsFigure
@@ -67,6 +74,7 @@ struct AcceptsFigure
     const Job type;
     AcceptsFigure(const Job type) : type(type) {}
     bool operator()(const nobBaseWarehouse& wh) const;
+    bool IsPossible(const Inventory& /*whsInventory*/) const { return true; }
 };
 
 struct CollectsWare
@@ -74,6 +82,7 @@ struct CollectsWare
     const GoodType type;
     CollectsWare(const GoodType type) : type(type) {}
     bool operator()(const nobBaseWarehouse& wh) const;
+    bool IsPossible(const Inventory& /*whsInventory*/) const { return true; }
 };
 
 struct CollectsFigure
@@ -81,6 +90,7 @@ struct CollectsFigure
     const Job type;
     CollectsFigure(const Job type) : type(type) {}
     bool operator()(const nobBaseWarehouse& wh) const;
+    bool IsPossible(const Inventory& /*whsInventory*/) const { return true; }
 };
 
 // Lagerhäuser enthalten die jeweiligen Waren, liefern sie aber NICHT gleichzeitig ein
@@ -88,29 +98,34 @@ struct HasWareButNoCollect : protected HasMinWares, protected CollectsWare
 {
     HasWareButNoCollect(const GoodType type) : HasMinWares(type, 1), CollectsWare(type) {}
     bool operator()(const nobBaseWarehouse& wh) const;
+    bool IsPossible(const Inventory& whsInventory) const { return HasMinWares::IsPossible(whsInventory); }
 };
 
 struct HasFigureButNoCollect : protected HasFigure, protected CollectsFigure
 {
     HasFigureButNoCollect(const Job type, bool recruitingAllowed) : HasFigure(type, recruitingAllowed), CollectsFigure(type) {}
     bool operator()(const nobBaseWarehouse& wh) const;
+    bool IsPossible(const Inventory& whsInventory) const { return HasFigure::IsPossible(whsInventory); }
 };
 
 struct AcceptsWareButNoSend : protected AcceptsWare
 {
     AcceptsWareButNoSend(const GoodType type) : AcceptsWare(type) {}
     bool operator()(const nobBaseWarehouse& wh) const;
+    bool IsPossible(const Inventory& /*whsInventory*/) const { return true; }
 };
 
 struct AcceptsFigureButNoSend : protected AcceptsFigure
 {
     AcceptsFigureButNoSend(const Job type) : AcceptsFigure(type) {}
     bool operator()(const nobBaseWarehouse& wh) const;
+    bool IsPossible(const Inventory& /*whsInventory*/) const { return true; }
 };
 
 struct NoCondition
 {
     bool operator()(const nobBaseWarehouse& /*wh*/) const { return true; }
+    bool IsPossible(const Inventory& /*whsInventory*/) const { return true; }
 };
 } // namespace FW
 
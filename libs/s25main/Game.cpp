@@ -22,6 +22,7 @@
 #include "GamePlayer.h"
 #include "ai/AIPlayer.h"
 #include "lua/LuaInterfaceGame.h"
+#include <algorithm>
 
 Game::Game(const GlobalGameSettings& settings, unsigned startGF, const std::vector<PlayerInfo>& players)
     : Game(settings, std::make_unique<EventManager>(startGF), players)
@@ -52,6 +53,9 @@ void Game::AddAIPlayer(std::unique_ptr<AIPlayer> newAI)
 }
 
 namespace {
+/// Update statistic every 750 GFs (30 seconds on 'fast')
+const unsigned STATISTIC_STEP_GFS = 750;
+
 unsigned getNumAlivePlayers(const GameWorldBase& world)
 {
     unsigned numPlayersAlive = 0;
@@ -83,14 +87,49 @@ void Game::RunGF()
 
     if(world_.HasLua())
         world_.GetLua().EventGameFrame(em_->GetCurrentGF());
-    // Update statistic every 750 GFs (30 seconds on 'fast')
-    if(em_->GetCurrentGF() % 750 == 0)
+    if(em_->GetCurrentGF() % STATISTIC_STEP_GFS == 0)
         StatisticStep();
     // If some players got defeated check objective
     if(getNumAlivePlayers(world_) < numPlayersAlive)
         CheckObjective();
 }
 
+unsigned Game::GetNextActiveGF() const
+{
+    const unsigned nextGF = em_->GetCurrentGF() + 1;
+    for(const AIPlayer& ai : aiPlayers_)
+    {
+        if(!ai.IsIdle())
+            return nextGF;
+    }
+    if(world_.HasLua() && !world_.GetLua().IsGameFrameIdle())
+        return nextGF;
+
+    unsigned nextActiveGF = std::min(em_->GetNextActiveGF(), (nextGF + STATISTIC_STEP_GFS - 1) / STATISTIC_STEP_GFS * STATISTIC_STEP_GFS);
+    for(unsigned i = 0; i < world_.GetNumPlayers(); ++i)
+    {
+        const GamePlayer& player = world_.GetPlayer(i);
+        if(!player.isUsed())
+            continue;
+        // Nothing changes the state while skipping, so the emergency program stays as is if it is up to date now
+        if(player.IsEmergencyChangePending())
+            return nextGF;
+        nextActiveGF = std::min(nextActiveGF, std::max(nextGF, player.GetNextPactExpiryGF()));
+    }
+    return nextActiveGF;
+}
+
+unsigned Game::SkipIdleGFs(unsigned maxGF)
+{
+    const unsigned curGF = em_->GetCurrentGF();
+    const unsigned nextActiveGF = GetNextActiveGF();
+    const unsigned targetGF = std::min(maxGF, nextActiveGF - 1);
+    if(targetGF <= curGF)
+        return 0;
+    em_->SkipToGF(targetGF);
+    return targetGF - curGF;
+}
+
 void Game::StatisticStep()
 {
     for(unsigned i = 0; i < world_.GetNumPlayers(); ++i)
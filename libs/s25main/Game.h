@@ -21,6 +21,7 @@
 
 #include "GlobalGameSettings.h"
 #include "world/GameWorld.h"
+#include "world/WorldSnapshot.h"
 #include <boost/ptr_container/ptr_vector.hpp>
 #include <memory>
 
@@ -38,10 +39,17 @@ public:
     std::unique_ptr<EventManager> em_;
     GameWorld world_;
     boost::ptr_vector<AIPlayer> aiPlayers_;
+    /// Read-only copies of the world for other threads. Published at NWFs when enabled
+    WorldSnapshotPublisher worldSnapshots_;
 
     /// Does the remaining initializations for starting the game
     void Start(bool startFromSave);
     void RunGF();
+    /// Return the next GF in which RunGF or any AI does more than increasing the GF counter
+    unsigned GetNextActiveGF() const;
+    /// Advance over GFs in which nothing would happen, but not beyond maxGF (e.g. the GF of the next game commands).
+    /// Return the number of skipped GFs
+    unsigned SkipIdleGFs(unsigned maxGF);
     bool IsStarted() const { return started_; }
     bool IsGameFinished() const { return finished_; }
     AIPlayer* GetAIPlayer(unsigned id);
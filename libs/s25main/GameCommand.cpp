@@ -19,14 +19,147 @@
 #include "GameCommand.h"
 #include "GameCommands.h"
 #include "helpers/toString.h"
-
+#include "libutil/Serializer.h"
+#include <algorithm>
+#include <array>
+#include <new>
 #include <stdexcept>
 
 namespace gc {
 
-GameCommandPtr GameCommand::Deserialize(Serializer& ser)
+namespace {
+    /// Number of bits of a run header used for the type. The other bits hold the number of commands in the run
+    constexpr unsigned TYPE_BITS = 6;
+
+    /// Keeps the memory of destroyed commands for reuse. Blocks are grouped by size in multiples of the alignment
+    class CommandPool
+    {
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+        static constexpr size_t BLOCK_ALIGN = alignof(std::max_align_t);
+        static constexpr unsigned NUM_SIZES = 8;
+        /// Maximum number of blocks kept per size. Others are returned to the system
+        static constexpr unsigned MAX_FREE_BLOCKS = 512;
+
+        std::array<FreeBlock*, NUM_SIZES> freeBlocks_;
+        std::array<unsigned, NUM_SIZES> numFreeBlocks_;
+
+        static size_t getSizeIdx(size_t size) { return (std::max<size_t>(size, 1) - 1) / BLOCK_ALIGN; }
+
+    public:
+        CommandPool()
+        {
+            freeBlocks_.fill(nullptr);
+            numFreeBlocks_.fill(0);
+        }
+        ~CommandPool();
+
+        void* allocate(size_t size)
+        {
+            const size_t idx = getSizeIdx(size);
+            if(idx >= NUM_SIZES)
+                return ::operator new(size);
+            FreeBlock* block = freeBlocks_[idx];
+            if(!block)
+                return ::operator new((idx + 1) * BLOCK_ALIGN);
+            freeBlocks_[idx] = block->next;
+            --numFreeBlocks_[idx];
+            return block;
+        }
+
+        void deallocate(void* ptr, size_t size)
+        {
+            const size_t idx = getSizeIdx(size);
+            if(idx >= NUM_SIZES || numFreeBlocks_[idx] >= MAX_FREE_BLOCKS)
+            {
+                ::operator delete(ptr);
+                return;
+            }
+            auto* block = static_cast<FreeBlock*>(ptr);
+            block->next = freeBlocks_[idx];
+            freeBlocks_[idx] = block;
+            ++numFreeBlocks_[idx];
+        }
+    };
+
+    /// Commands may still be destroyed after the pool of the thread (e.g. by static objects) -> Use the system allocator then
+    thread_local bool isPoolDestroyed = false;
+
+    CommandPool::~CommandPool()
+    {
+        isPoolDestroyed = true;
+        for(FreeBlock* block : freeBlocks_)
+        {
+            while(block)
+            {
+                FreeBlock* next = block->next;
+                ::operator delete(block);
+                block = next;
+            }
+        }
+    }
+
+    CommandPool* getPool()
+    {
+        if(isPoolDestroyed)
+            return nullptr;
+        static thread_local CommandPool pool;
+        return &pool;
+    }
+} // namespace
+
+void* GameCommand::operator new(size_t size)
+{
+    CommandPool* pool = getPool();
+    return pool ? pool->allocate(size) : ::operator new(size);
+}
+
+void GameCommand::operator delete(void* ptr, size_t size)
+{
+    CommandPool* pool = getPool();
+    if(pool)
+        pool->deallocate(ptr, size);
+    else
+        ::operator delete(ptr);
+}
+
+void GameCommand::SerializeBatch(Serializer& ser, const std::vector<GameCommandPtr>& gcs)
+{
+    static_assert(NOTIFY_ALLIES_OF_LOCATION < (1u << TYPE_BITS), "Type does not fit into the run header");
+    ser.PushVarSize(gcs.size());
+    Encoder encoder(ser);
+    for(auto it = gcs.begin(); it != gcs.end();)
+    {
+        const Type gcType = (*it)->gcType;
+        const auto runEnd = std::find_if(it, gcs.end(), [gcType](const GameCommandPtr& gc) { return gc->gcType != gcType; });
+        const auto runLength = static_cast<uint32_t>(runEnd - it);
+        ser.PushVarSize(((runLength - 1u) << TYPE_BITS) | gcType);
+        for(; it != runEnd; ++it)
+            (*it)->Serialize(encoder);
+    }
+}
+
+std::vector<GameCommandPtr> GameCommand::DeserializeBatch(Serializer& ser)
+{
+    std::vector<GameCommandPtr> gcs(ser.PopVarSize());
+    Decoder decoder(ser);
+    for(auto it = gcs.begin(); it != gcs.end();)
+    {
+        const uint32_t runHeader = ser.PopVarSize();
+        const auto gcType = static_cast<Type>(runHeader & ((1u << TYPE_BITS) - 1u));
+        const uint32_t runLength = (runHeader >> TYPE_BITS) + 1u;
+        if(runLength > static_cast<uint32_t>(gcs.end() - it))
+            throw std::length_error("Invalid GC count: " + helpers::toString(runLength));
+        for(const auto runEnd = it + runLength; it != runEnd; ++it)
+            *it = Create(gcType, decoder);
+    }
+    return gcs;
+}
+
+GameCommand* GameCommand::Create(Type gcType, Decoder& ser)
 {
-    auto gcType = static_cast<Type>(ser.PopUnsignedChar());
     GameCommand* gc;
     switch(gcType)
     {
@@ -70,9 +203,47 @@ GameCommandPtr GameCommand::Deserialize(Serializer& ser)
     return gc;
 }
 
-void GameCommand::Serialize(Serializer& ser) const
+const char* GameCommand::GetTypeName() const
 {
-    ser.PushUnsignedChar(static_cast<uint8_t>(gcType));
+    switch(gcType)
+    {
+        case SET_FLAG: return "SET_FLAG";
+        case DESTROY_FLAG: return "DESTROY_FLAG";
+        case BUILD_ROAD: return "BUILD_ROAD";
+        case DESTROY_ROAD: return "DESTROY_ROAD";
+        case CHANGE_DISTRIBUTION: return "CHANGE_DISTRIBUTION";
+        case CHANGE_BUILDORDER: return "CHANGE_BUILDORDER";
+        case SET_BUILDINGSITE: return "SET_BUILDINGSITE";
+        case DESTROY_BUILDING: return "DESTROY_BUILDING";
+        case CHANGE_TRANSPORT: return "CHANGE_TRANSPORT";
+        case CHANGE_MILITARY: return "CHANGE_MILITARY";
+        case CHANGE_TOOLS: return "CHANGE_TOOLS";
+        case CALL_SPECIALIST: return "CALL_SPECIALIST";
+        case CALL_SCOUT: return "CALL_SCOUT";
+        case ATTACK: return "ATTACK";
+        case SET_COINS_ALLOWED: return "SET_COINS_ALLOWED";
+        case SET_PRODUCTION_ENABLED: return "SET_PRODUCTION_ENABLED";
+        case SET_INVENTORY_SETTING: return "SET_INVENTORY_SETTING";
+        case SET_ALL_INVENTORY_SETTINGS: return "SET_ALL_INVENTORY_SETTINGS";
+        case CHANGE_RESERVE: return "CHANGE_RESERVE";
+        case SUGGEST_PACT: return "SUGGEST_PACT";
+        case ACCEPT_PACT: return "ACCEPT_PACT";
+        case CANCEL_PACT: return "CANCEL_PACT";
+        case SET_SHIPYARD_MODE: return "SET_SHIPYARD_MODE";
+        case START_STOP_EXPEDITION: return "START_STOP_EXPEDITION";
+        case EXPEDITION_COMMAND: return "EXPEDITION_COMMAND";
+        case SEA_ATTACK: return "SEA_ATTACK";
+        case START_STOP_EXPLORATION_EXPEDITION: return "START_STOP_EXPLORATION_EXPEDITION";
+        case TRADE: return "TRADE";
+        case SURRENDER: return "SURRENDER";
+        case CHEAT_ARMAGEDDON: return "CHEAT_ARMAGEDDON";
+        case DESTROY_ALL: return "DESTROY_ALL";
+        case UPGRADE_ROAD: return "UPGRADE_ROAD";
+        case SEND_SOLDIERS_HOME: return "SEND_SOLDIERS_HOME";
+        case ORDER_NEW_SOLDIERS: return "ORDER_NEW_SOLDIERS";
+        case NOTIFY_ALLIES_OF_LOCATION: return "NOTIFY_ALLIES_OF_LOCATION";
+    }
+    return "UNKNOWN";
 }
 
 } // namespace gc
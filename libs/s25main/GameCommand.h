@@ -20,6 +20,8 @@
 
 #include <boost/smart_ptr/intrusive_ptr.hpp>
 #include <RTTR_Assert.h>
+#include <cstddef>
+#include <vector>
 
 class Serializer;
 class GameWorldGame;
@@ -27,6 +29,8 @@ class GameCommandFactory;
 
 namespace gc {
 
+class Decoder;
+class Encoder;
 class GameCommand;
 // Use this for safely using Pointers to GameCommands
 using GameCommandPtr = boost::intrusive_ptr<GameCommand>;
@@ -92,17 +96,30 @@ public:
         return *this;
     }
 
-    /// Builds a GameCommand depending on Type
-    static GameCommandPtr Deserialize(Serializer& ser);
+    /// Serializes the commands of one NWF. The type is stored once for consecutive commands of the same type
+    static void SerializeBatch(Serializer& ser, const std::vector<GameCommandPtr>& gcs);
+    /// Reads the commands written by SerializeBatch
+    static std::vector<GameCommandPtr> DeserializeBatch(Serializer& ser);
 
-    /// Serializes this GameCommand
-    virtual void Serialize(Serializer& ser) const;
+    /// Serializes the data of this GameCommand (without the type)
+    virtual void Serialize(Encoder& /*ser*/) const {}
 
     /// Execute this GameCommand
     virtual void Execute(GameWorldGame& gwg, uint8_t playerId) = 0;
 
+    /// Name of the type of this command (e.g. for debugging and profiling)
+    const char* GetTypeName() const;
+
+    /// Commands are allocated from per thread free lists as lots of small commands are created and destroyed every NWF
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
+
 protected:
     GameCommand(const Type gcType) : gcType(gcType), refCounter_(0) {}
+
+private:
+    /// Builds a GameCommand depending on Type
+    static GameCommand* Create(Type gcType, Decoder& ser);
 };
 
 inline void intrusive_ptr_add_ref(GameCommand* x)
@@ -0,0 +1,88 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GameCommandEncoding_h__
+#define GameCommandEncoding_h__
+
+#include "gameTypes/MapCoordinates.h"
+#include "libutil/Serializer.h"
+#include <cstdint>
+
+namespace gc {
+
+/// Writes the data of game commands in a compact form: Integers are stored with a variable size
+/// and map points as the difference to the previous point of the same batch
+class Encoder
+{
+    Serializer& ser_;
+    MapPoint lastPt_;
+
+public:
+    explicit Encoder(Serializer& ser) : ser_(ser), lastPt_(0, 0) {}
+
+    void PushBool(bool val) { ser_.PushBool(val); }
+    void PushUnsignedChar(uint8_t val) { ser_.PushUnsignedChar(val); }
+    void PushSignedChar(int8_t val) { ser_.PushSignedChar(val); }
+    void PushUnsignedInt(uint32_t val) { ser_.PushVarSize(val); }
+    void PushMapPoint(MapPoint pt)
+    {
+        PushCoordDelta(pt.x - lastPt_.x);
+        PushCoordDelta(pt.y - lastPt_.y);
+        lastPt_ = pt;
+    }
+
+private:
+    /// Store the (wrapped) difference zigzag encoded so small negative values are small too
+    void PushCoordDelta(int delta)
+    {
+        const auto val = static_cast<uint16_t>(delta);
+        const uint16_t sign = (val & 0x8000) ? 0xFFFF : 0;
+        ser_.PushVarSize(static_cast<uint16_t>((val << 1) ^ sign));
+    }
+};
+
+/// Reads the data written by the Encoder
+class Decoder
+{
+    Serializer& ser_;
+    MapPoint lastPt_;
+
+public:
+    explicit Decoder(Serializer& ser) : ser_(ser), lastPt_(0, 0) {}
+
+    bool PopBool() { return ser_.PopBool(); }
+    uint8_t PopUnsignedChar() { return ser_.PopUnsignedChar(); }
+    int8_t PopSignedChar() { return ser_.PopSignedChar(); }
+    uint32_t PopUnsignedInt() { return ser_.PopVarSize(); }
+    MapPoint PopMapPoint()
+    {
+        lastPt_.x = static_cast<MapCoord>(lastPt_.x + PopCoordDelta());
+        lastPt_.y = static_cast<MapCoord>(lastPt_.y + PopCoordDelta());
+        return lastPt_;
+    }
+
+private:
+    int PopCoordDelta()
+    {
+        const auto val = static_cast<uint16_t>(ser_.PopVarSize());
+        return static_cast<int>(val >> 1) ^ -static_cast<int>(val & 1);
+    }
+};
+
+} // namespace gc
+
+#endif // GameCommandEncoding_h__
@@ -2,6 +2,7 @@
 #define GAME_COMMANDS_H_
 
 #include "GameCommand.h"
+#include "GameCommandEncoding.h"
 #include "gameTypes/BuildingType.h"
 #include "gameTypes/Direction.h"
 #include "gameTypes/InventorySetting.h"
@@ -9,7 +10,6 @@
 #include "gameTypes/MapCoordinates.h"
 #include "gameTypes/PactTypes.h"
 #include "gameTypes/SettingsTypes.h"
-#include "libutil/Serializer.h"
 #include <utility>
 #include <vector>
 
@@ -22,27 +22,17 @@ class Coords : public GameCommand
 {
     GC_FRIEND_DECL;
 
-private:
-    MapPoint PopMapPoint(Serializer& ser)
-    {
-        MapPoint pt;
-        pt.x = ser.PopUnsignedShort();
-        pt.y = ser.PopUnsignedShort();
-        return pt;
-    }
-
 protected:
     /// Koordinaten auf der Map, die dieses Command betreffen
     const MapPoint pt_;
     Coords(const Type gst, const MapPoint pt) : GameCommand(gst), pt_(pt) {}
-    Coords(const Type gst, Serializer& ser) : GameCommand(gst), pt_(PopMapPoint(ser)) {}
+    Coords(const Type gst, Decoder& ser) : GameCommand(gst), pt_(ser.PopMapPoint()) {}
 
 public:
-    void Serialize(Serializer& ser) const override
+    void Serialize(Encoder& ser) const override
     {
         GameCommand::Serialize(ser);
-        ser.PushUnsignedShort(pt_.x);
-        ser.PushUnsignedShort(pt_.y);
+        ser.PushMapPoint(pt_);
     }
 };
 
@@ -53,7 +43,7 @@ class SetFlag : public Coords
 
 protected:
     SetFlag(const MapPoint pt) : Coords(SET_FLAG, pt) {}
-    SetFlag(Serializer& ser) : Coords(SET_FLAG, ser) {}
+    SetFlag(Decoder& ser) : Coords(SET_FLAG, ser) {}
 
 public:
     void Execute(GameWorldGame& gwg, uint8_t playerId) override;
@@ -66,7 +56,7 @@ class DestroyFlag : public Coords
 
 protected:
     DestroyFlag(const MapPoint pt) : Coords(DESTROY_FLAG, pt) {}
-    DestroyFlag(Serializer& ser) : Coords(DESTROY_FLAG, ser) {}
+    DestroyFlag(Decoder& ser) : Coords(DESTROY_FLAG, ser) {}
 
 public:
     void Execute(GameWorldGame& gwg, uint8_t playerId) override;
@@ -85,14 +75,14 @@ protected:
     BuildRoad(const MapPoint pt, bool boat_road, std::vector<Direction> route)
         : Coords(BUILD_ROAD, pt), boat_road(boat_road), route(std::move(route))
     {}
-    BuildRoad(Serializer& ser) : Coords(BUILD_ROAD, ser), boat_road(ser.PopBool()), route(ser.PopUnsignedInt())
+    BuildRoad(Decoder& ser) : Coords(BUILD_ROAD, ser), boat_road(ser.PopBool()), route(ser.PopUnsignedInt())
     {
         for(auto& i : route)
             i = Direction(ser.PopUnsignedChar());
     }
 
 public:
-    void Serialize(Serializer& ser) const override
+    void Serialize(Encoder& ser) const override
     {
         Coords::Serialize(ser);
 
@@ -114,10 +104,10 @@ class DestroyRoad : public Coords
 
 protected:
     DestroyRoad(const MapPoint pt, const Direction start_dir) : Coords(DESTROY_ROAD, pt), start_dir(start_dir) {}
-    DestroyRoad(Serializer& ser) : Coords(DESTROY_ROAD, ser), start_dir(ser.PopUnsignedChar()) {}
+    DestroyRoad(Decoder& ser) : Coords(DESTROY_ROAD, ser), start_dir(ser.PopUnsignedChar()) {}
 
 public:
-    void Serialize(Serializer& ser) const override
+    void Serialize(Encoder& ser) const override
     {
         Coords::Serialize(ser);
 
@@ -136,10 +126,10 @@ class UpgradeRoad : public Coords
 
 protected:
     UpgradeRoad(const MapPoint pt, const Direction start_dir) : Coords(UPGRADE_ROAD, pt), start_dir(start_dir) {}
-    UpgradeRoad(Serializer& ser) : Coords(UPGRADE_ROAD, ser), start_dir(ser.PopUnsignedChar()) {}
+    UpgradeRoad(Decoder& ser) : Coords(UPGRADE_ROAD, ser), start_dir(ser.PopUnsignedChar()) {}
 
 public:
-    void Serialize(Serializer& ser) const override
+    void Serialize(Encoder& ser) const override
     {
         Coords::Serialize(ser);
         ser.PushUnsignedChar(start_dir.toUInt());
@@ -157,14 +147,14 @@ class ChangeDistribution : public GameCommand
 
 protected:
     ChangeDistribution(const Distributions& data) : GameCommand(CHANGE_DISTRIBUTION), data(data) {}
-    ChangeDistribution(Serializer& ser) : GameCommand(CHANGE_DISTRIBUTION)
+    ChangeDistribution(Decoder& ser) : GameCommand(CHANGE_DISTRIBUTION)
     {
         for(unsigned char& i : data)
             i = ser.PopUnsignedChar();
     }
 
 public:
-    void Serialize(Serializer& ser) const override
+    void Serialize(Encoder& ser) const override
     {
         GameCommand::Serialize(ser);
         for(unsigned char i : data)
@@ -187,14 +177,14 @@ protected:
     ChangeBuildOrder(const bool useCustomBuildOrder, const BuildOrders& data)
         : GameCommand(CHANGE_BUILDORDER), useCustomBuildOrder(useCustomBuildOrder), data(data)
     {}
-    ChangeBuildOrder(Serializer& ser) : GameCommand(CHANGE_BUILDORDER), useCustomBuildOrder(ser.PopBool())
+    ChangeBuildOrder(Decoder& ser) : GameCommand(CHANGE_BUILDORDER), useCustomBuildOrder(ser.PopBool())
     {
         for(auto& i : data)
             i = BuildingType(ser.PopUnsignedChar());
     }
 
 public:
-    void Serialize(Serializer& ser) const override
+    void Serialize(Encoder& ser) const override
     {
         GameCommand::Serialize(ser);
         ser.PushBool(useCustomBuildOrder);
@@ -214,10 +204,10 @@ class SetBuildingSite : public Coords
 
 protected:
     SetBuildingSite(const MapPoint pt, const BuildingType bt) : Coords(SET_BUILDINGSITE, pt), bt(bt) {}
-    SetBuildingSite(Serializer& ser) : Coords(SET_BUILDINGSITE, ser), bt(BuildingType(ser.PopUnsignedChar())) {}
+    SetBuildingSite(Decoder& ser) : Coords(SET_BUILDINGSITE, ser), bt(BuildingType(ser.PopUnsignedChar())) {}
 
 public:
-    void Serialize(Serializer& ser) const override
+    void Serialize(Encoder& ser) const override
     {
         Coords::Serialize(ser);
 
@@ -234,7 +224,7 @@ class DestroyBuilding : public Coords
 
 protected:
     DestroyBuilding(const MapPoint pt) : Coords(DESTROY_BUILDING, pt) {}
-    DestroyBuilding(Serializer& ser) : Coords(DESTROY_BUILDING, ser) {}
+    DestroyBuilding(Decoder& ser) : Coords(DESTROY_BUILDING, ser) {}
 
 public:
     void Execute(GameWorldGame& gwg, uint8_t playerId) override;
@@ -247,7 +237,7 @@ class SendSoldiersHome : public Coords
 
 protected:
     SendSoldiersHome(const MapPoint pt) : Coords(SEND_SOLDIERS_HOME, pt) {}
-    SendSoldiersHome(Serializer& ser) : Coords(SEND_SOLDIERS_HOME, ser) {}
+    SendSoldiersHome(Decoder& ser) : Coords(SEND_SOLDIERS_HOME, ser) {}
 
 public:
     void Execute(GameWorldGame& gwg, uint8_t playerId) override;
@@ -260,7 +250,7 @@ class OrderNewSoldiers : public Coords
 
 protected:
     OrderNewSoldiers(const MapPoint pt) : Coords(ORDER_NEW_SOLDIERS, pt) {}
-    OrderNewSoldiers(Serializer& ser) : Coords(ORDER_NEW_SOLDIERS, ser) {}
+    OrderNewSoldiers(Decoder& ser) : Coords(ORDER_NEW_SOLDIERS, ser) {}
 
 public:
     void Execute(GameWorldGame& gwg, uint8_t playerId) override;
@@ -275,14 +265,14 @@ class ChangeTransport : public GameCommand
 
 protected:
     ChangeTransport(const TransportOrders& data) : GameCommand(CHANGE_TRANSPORT), data(data) {}
-    ChangeTransport(Serializer& ser) : GameCommand(CHANGE_TRANSPORT)
+    ChangeTransport(Decoder& ser) : GameCommand(CHANGE_TRANSPORT)
     {
         for(unsigned char& i : data)
             i = ser.PopUnsignedChar();
     }
 
 public:
-    void Serialize(Serializer& ser) const override
+    void Serialize(Encoder& ser) const override
     {
         GameCommand::Serialize(ser);
         for(unsigned char i : data)
@@ -301,14 +291,14 @@ class ChangeMilitary : public GameCommand
 
 protected:
     ChangeMilitary(const MilitarySettings& data) : GameCommand(CHANGE_MILITARY), data(data) {}
-    ChangeMilitary(Serializer& ser) : GameCommand(CHANGE_MILITARY)
+    ChangeMilitary(Decoder& ser) : GameCommand(CHANGE_MILITARY)
     {
         for(unsigned char& i : data)
             i = ser.PopUnsignedChar();
     }
 
 public:
-    void Serialize(Serializer& ser) const override
+    void Serialize(Encoder& ser) const override
     {
         GameCommand::Serialize(ser);
         for(unsigned char i : data)
@@ -341,7 +331,7 @@ protected:
         }
     }
 
-    ChangeTools(Serializer& ser) : GameCommand(CHANGE_TOOLS)
+    ChangeTools(Decoder& ser) : GameCommand(CHANGE_TOOLS)
     {
         for(unsigned char& i : data)
             i = ser.PopUnsignedChar();
@@ -351,7 +341,7 @@ protected:
     }
 
 public:
-    void Serialize(Serializer& ser) const override
+    void Serialize(Encoder& ser) const override
     {
         GameCommand::Serialize(ser);
         for(unsigned char i : data)
@@ -372,10 +362,10 @@ class CallSpecialist : public Coords
 
 protected:
     CallSpecialist(const MapPoint pt, Job job) : Coords(CALL_SPECIALIST, pt), job(job) {}
-    CallSpecialist(Serializer& ser) : Coords(CALL_SPECIALIST, ser), job(Job(ser.PopUnsignedChar())) {}
+    CallSpecialist(Decoder& ser) : Coords(CALL_SPECIALIST, ser), job(Job(ser.PopUnsignedChar())) {}
 
 public:
-    void Serialize(Serializer& ser) const override
+    void Serialize(Encoder& ser) const override
     {
         Coords::Serialize(ser);
         ser.PushUnsignedChar(static_cast<uint8_t>(job));
@@ -398,10 +388,10 @@ protected:
     BaseAttack(const Type gst, const MapPoint pt, const uint32_t soldiers_count, bool strong_soldiers)
         : Coords(gst, pt), soldiers_count(soldiers_count), strong_soldiers(strong_soldiers)
     {}
-    BaseAttack(const Type gst, Serializer& ser) : Coords(gst, ser), soldiers_count(ser.PopUnsignedInt()), strong_soldiers(ser.PopBool()) {}
+    BaseAttack(const Type gst, Decoder& ser) : Coords(gst, ser), soldiers_count(ser.PopUnsignedInt()), strong_soldiers(ser.PopBool()) {}
 
 public:
-    void Serialize(Serializer& ser) const override
+    void Serialize(Encoder& ser) const override
     {
         Coords::Serialize(ser);
 
@@ -418,7 +408,7 @@ class Attack : public BaseAttack
 protected:
     Attack(const MapPoint pt, const uint32_t soldiers_count, bool strong_soldiers) : BaseAttack(ATTACK, pt, soldiers_count, strong_soldiers)
     {}
-    Attack(Serializer& ser) : BaseAttack(ATTACK, ser) {}
+    Attack(Decoder& ser) : BaseAttack(ATTACK, ser) {}
 
 public:
     void Execute(GameWorldGame& gwg, uint8_t playerId) override;
@@ -433,7 +423,7 @@ protected:
     SeaAttack(const MapPoint pt, const uint32_t soldiers_count, bool strong_soldiers)
         : BaseAttack(SEA_ATTACK, pt, soldiers_count, strong_soldiers)
     {}
-    SeaAttack(Serializer& ser) : BaseAttack(SEA_ATTACK, ser) {}
+    SeaAttack(Decoder& ser) : BaseAttack(SEA_ATTACK, ser) {}
 
 public:
     void Execute(GameWorldGame& gwg, uint8_t playerId) override;
@@ -447,10 +437,10 @@ class SetCoinsAllowed : public Coords
 
 protected:
     SetCoinsAllowed(const MapPoint pt, bool enabled) : Coords(SET_COINS_ALLOWED, pt), enabled(enabled) {}
-    SetCoinsAllowed(Serializer& ser) : Coords(SET_COINS_ALLOWED, ser), enabled(ser.PopBool()) {}
+    SetCoinsAllowed(Decoder& ser) : Coords(SET_COINS_ALLOWED, ser), enabled(ser.PopBool()) {}
 
 public:
-    void Serialize(Serializer& ser) const override
+    void Serialize(Encoder& ser) const override
     {
         Coords::Serialize(ser);
         ser.PushBool(enabled);
@@ -466,10 +456,10 @@ class SetProductionEnabled : public Coords
 
 protected:
     SetProductionEnabled(const MapPoint pt, bool enabled) : Coords(SET_PRODUCTION_ENABLED, pt), enabled(enabled) {}
-    SetProductionEnabled(Serializer& ser) : Coords(SET_PRODUCTION_ENABLED, ser), enabled(ser.PopBool()) {}
+    SetProductionEnabled(Decoder& ser) : Coords(SET_PRODUCTION_ENABLED, ser), enabled(ser.PopBool()) {}
 
 public:
-    void Serialize(Serializer& ser) const override
+    void Serialize(Encoder& ser) const override
     {
         Coords::Serialize(ser);
         ser.PushBool(enabled);
@@ -484,7 +474,7 @@ class NotifyAlliesOfLocation : public Coords
 
 protected:
     NotifyAlliesOfLocation(const MapPoint pt) : Coords(NOTIFY_ALLIES_OF_LOCATION, pt) {}
-    NotifyAlliesOfLocation(Serializer& ser) : Coords(NOTIFY_ALLIES_OF_LOCATION, ser) {}
+    NotifyAlliesOfLocation(Decoder& ser) : Coords(NOTIFY_ALLIES_OF_LOCATION, ser) {}
 
 public:
     void Execute(GameWorldGame& gwg, uint8_t playerId) override;
@@ -503,13 +493,13 @@ protected:
     SetInventorySetting(const MapPoint pt, bool isJob, const uint8_t type, const InventorySetting state)
         : Coords(SET_INVENTORY_SETTING, pt), isJob(isJob), type(type), state(state)
     {}
-    SetInventorySetting(Serializer& ser)
+    SetInventorySetting(Decoder& ser)
         : Coords(SET_INVENTORY_SETTING, ser), isJob(ser.PopBool()), type(ser.PopUnsignedChar()),
           state(static_cast<InventorySetting>(ser.PopUnsignedChar()))
     {}
 
 public:
-    void Serialize(Serializer& ser) const override
+    void Serialize(Encoder& ser) const override
     {
         Coords::Serialize(ser);
 
@@ -533,7 +523,7 @@ protected:
     SetAllInventorySettings(const MapPoint pt, bool isJob, std::vector<InventorySetting> states)
         : Coords(SET_ALL_INVENTORY_SETTINGS, pt), isJob(isJob), states(std::move(states))
     {}
-    SetAllInventorySettings(Serializer& ser) : Coords(SET_ALL_INVENTORY_SETTINGS, ser), isJob(ser.PopBool())
+    SetAllInventorySettings(Decoder& ser) : Coords(SET_ALL_INVENTORY_SETTINGS, ser), isJob(ser.PopBool())
     {
         const uint32_t numStates = (isJob ? NUM_JOB_TYPES : NUM_WARE_TYPES);
         states.reserve(numStates);
@@ -542,7 +532,7 @@ protected:
     }
 
 public:
-    void Serialize(Serializer& ser) const override
+    void Serialize(Encoder& ser) const override
     {
         Coords::Serialize(ser);
 
@@ -566,10 +556,10 @@ class ChangeReserve : public Coords
 
 protected:
     ChangeReserve(const MapPoint pt, const uint8_t rank, const uint32_t count) : Coords(CHANGE_RESERVE, pt), rank(rank), count(count) {}
-    ChangeReserve(Serializer& ser) : Coords(CHANGE_RESERVE, ser), rank(ser.PopUnsignedChar()), count(ser.PopUnsignedInt()) {}
+    ChangeReserve(Decoder& ser) : Coords(CHANGE_RESERVE, ser), rank(ser.PopUnsignedChar()), count(ser.PopUnsignedInt()) {}
 
 public:
-    void Serialize(Serializer& ser) const override
+    void Serialize(Encoder& ser) const override
     {
         Coords::Serialize(ser);
 
@@ -587,7 +577,7 @@ class CheatArmageddon : public GameCommand
 
 protected:
     CheatArmageddon() : GameCommand(CHEAT_ARMAGEDDON) {}
-    CheatArmageddon(Serializer& /*ser*/) : GameCommand(CHEAT_ARMAGEDDON) {}
+    CheatArmageddon(Decoder& /*ser*/) : GameCommand(CHEAT_ARMAGEDDON) {}
 
 public:
     void Execute(GameWorldGame& gwg, uint8_t playerId) override;
@@ -600,7 +590,7 @@ class Surrender : public GameCommand
 
 protected:
     Surrender() : GameCommand(SURRENDER) {}
-    Surrender(Serializer& /*ser*/) : GameCommand(SURRENDER) {}
+    Surrender(Decoder& /*ser*/) : GameCommand(SURRENDER) {}
 
 public:
     void Execute(GameWorldGame& gwg, uint8_t playerId) override;
@@ -613,7 +603,7 @@ class DestroyAll : public GameCommand
 
 protected:
     DestroyAll() : GameCommand(DESTROY_ALL) {}
-    DestroyAll(Serializer& /*ser*/) : GameCommand(DESTROY_ALL) {}
+    DestroyAll(Decoder& /*ser*/) : GameCommand(DESTROY_ALL) {}
 
 public:
     void Execute(GameWorldGame& gwg, uint8_t playerId) override;
@@ -634,13 +624,13 @@ protected:
     SuggestPact(const uint8_t targetPlayer, const PactType pt, const uint32_t duration)
         : GameCommand(SUGGEST_PACT), targetPlayer(targetPlayer), pt(pt), duration(duration)
     {}
-    SuggestPact(Serializer& ser)
+    SuggestPact(Decoder& ser)
         : GameCommand(SUGGEST_PACT), targetPlayer(ser.PopUnsignedChar()), pt(PactType(ser.PopUnsignedChar())),
           duration(ser.PopUnsignedInt())
     {}
 
 public:
-    void Serialize(Serializer& ser) const override
+    void Serialize(Encoder& ser) const override
     {
         GameCommand::Serialize(ser);
         ser.PushUnsignedChar(targetPlayer);
@@ -666,12 +656,12 @@ protected:
     AcceptPact(const uint32_t id, const PactType pt, const uint8_t fromPlayer)
         : GameCommand(ACCEPT_PACT), id(id), pt(pt), fromPlayer(fromPlayer)
     {}
-    AcceptPact(Serializer& ser)
+    AcceptPact(Decoder& ser)
         : GameCommand(ACCEPT_PACT), id(ser.PopUnsignedInt()), pt(PactType(ser.PopUnsignedChar())), fromPlayer(ser.PopUnsignedChar())
     {}
 
 public:
-    void Serialize(Serializer& ser) const override
+    void Serialize(Encoder& ser) const override
     {
         GameCommand::Serialize(ser);
         ser.PushUnsignedInt(id);
@@ -693,10 +683,10 @@ class CancelPact : public GameCommand
 
 protected:
     CancelPact(const PactType pt, const uint8_t otherPlayer) : GameCommand(CANCEL_PACT), pt(pt), otherPlayer(otherPlayer) {}
-    CancelPact(Serializer& ser) : GameCommand(CANCEL_PACT), pt(PactType(ser.PopUnsignedChar())), otherPlayer(ser.PopUnsignedChar()) {}
+    CancelPact(Decoder& ser) : GameCommand(CANCEL_PACT), pt(PactType(ser.PopUnsignedChar())), otherPlayer(ser.PopUnsignedChar()) {}
 
 public:
-    void Serialize(Serializer& ser) const override
+    void Serialize(Encoder& ser) const override
     {
         GameCommand::Serialize(ser);
         ser.PushUnsignedChar(static_cast<uint8_t>(pt));
@@ -714,11 +704,11 @@ class SetShipYardMode : public Coords
 
 protected:
     SetShipYardMode(const MapPoint pt, bool buildShips) : Coords(SET_SHIPYARD_MODE, pt), buildShips(buildShips) {}
-    SetShipYardMode(Serializer& ser) : Coords(SET_SHIPYARD_MODE, ser), buildShips(ser.PopBool()) {}
+    SetShipYardMode(Decoder& ser) : Coords(SET_SHIPYARD_MODE, ser), buildShips(ser.PopBool()) {}
 
 public:
     void Execute(GameWorldGame& gwg, uint8_t playerId) override;
-    void Serialize(Serializer& ser) const override
+    void Serialize(Encoder& ser) const override
     {
         Coords::Serialize(ser);
         ser.PushBool(buildShips);
@@ -733,11 +723,11 @@ class StartStopExpedition : public Coords
 
 protected:
     StartStopExpedition(const MapPoint pt, bool start) : Coords(START_STOP_EXPEDITION, pt), start(start) {}
-    StartStopExpedition(Serializer& ser) : Coords(START_STOP_EXPEDITION, ser), start(ser.PopBool()) {}
+    StartStopExpedition(Decoder& ser) : Coords(START_STOP_EXPEDITION, ser), start(ser.PopBool()) {}
 
 public:
     void Execute(GameWorldGame& gwg, uint8_t playerId) override;
-    void Serialize(Serializer& ser) const override
+    void Serialize(Encoder& ser) const override
     {
         Coords::Serialize(ser);
         ser.PushBool(start);
@@ -752,11 +742,11 @@ class StartStopExplorationExpedition : public Coords
 
 protected:
     StartStopExplorationExpedition(const MapPoint pt, bool start) : Coords(START_STOP_EXPLORATION_EXPEDITION, pt), start(start) {}
-    StartStopExplorationExpedition(Serializer& ser) : Coords(START_STOP_EXPLORATION_EXPEDITION, ser), start(ser.PopBool()) {}
+    StartStopExplorationExpedition(Decoder& ser) : Coords(START_STOP_EXPLORATION_EXPEDITION, ser), start(ser.PopBool()) {}
 
 public:
     void Execute(GameWorldGame& gwg, uint8_t playerId) override;
-    void Serialize(Serializer& ser) const override
+    void Serialize(Encoder& ser) const override
     {
         Coords::Serialize(ser);
         ser.PushBool(start);
@@ -784,12 +774,12 @@ protected:
 
     ExpeditionCommand(const Action action, const uint32_t ship_id) : GameCommand(EXPEDITION_COMMAND), action(action), ship_id(ship_id) {}
 
-    ExpeditionCommand(Serializer& ser)
+    ExpeditionCommand(Decoder& ser)
         : GameCommand(EXPEDITION_COMMAND), action(Action(ser.PopUnsignedChar())), ship_id(ser.PopUnsignedInt())
     {}
 
 public:
-    void Serialize(Serializer& ser) const override
+    void Serialize(Encoder& ser) const override
     {
         GameCommand::Serialize(ser);
         ser.PushUnsignedChar(static_cast<uint8_t>(action));
@@ -821,12 +811,12 @@ protected:
     {
         RTTR_Assert((gt == GD_NOTHING) != (job == JOB_NOTHING));
     }
-    TradeOverLand(Serializer& ser)
+    TradeOverLand(Decoder& ser)
         : Coords(TRADE, ser), gt(GoodType(ser.PopUnsignedChar())), job(Job(ser.PopUnsignedChar())), count(ser.PopUnsignedInt())
     {}
 
 public:
-    void Serialize(Serializer& ser) const override
+    void Serialize(Encoder& ser) const override
     {
         Coords::Serialize(ser);
 
@@ -79,6 +79,7 @@ void GameLoader::initTextures()
 
 bool GameLoader::loadTextures()
 {
+    LOADER.ResetLoadingPhases();
     LOADER.ClearOverrideFolders();
     LOADER.AddOverrideFolder("<RTTR_RTTR>/LSTS/GAME");
     LOADER.AddOverrideFolder("<RTTR_USERDATA>/LSTS/GAME");
@@ -92,6 +93,7 @@ bool GameLoader::loadTextures()
     }
 
     LOADER.fillCaches();
+    LOADER.WriteLoadingReport();
     return true;
 }
 
@@ -58,9 +58,11 @@
 #include <limits>
 
 GamePlayer::GamePlayer(unsigned playerId, const PlayerInfo& playerInfo, GameWorldGame& gwg)
-    : GamePlayerInfo(playerId, playerInfo), gwg(gwg), hqPos(MapPoint::Invalid()), emergency(false)
+    : GamePlayerInfo(playerId, playerInfo), gwg(gwg), areWarehousesLinked(false), hqPos(MapPoint::Invalid()), emergency(false),
+      isCarrierSearchPending(false), isMaterialSearchPending(false), arePendingSearchesScheduled(false)
 {
     std::fill(building_enabled.begin(), building_enabled.end(), true);
+    pendingJobSearches.fill(false);
 
     LoadStandardDistribution();
     useCustomBuildOrder_ = false;
@@ -269,6 +271,9 @@ void GamePlayer::Serialize(SerializedGameData& sgd) const
 
 void GamePlayer::Deserialize(SerializedGameData& sgd)
 {
+    // Loaded warehouses are not linked yet
+    areWarehousesLinked = false;
+    warehousesInventory.clear();
     std::fill(building_enabled.begin(), building_enabled.end(), true);
 
     // Ehemaligen PS auslesen
@@ -382,6 +387,14 @@ nobBaseWarehouse* GamePlayer::FindWarehouse(const noRoadNode& start, const T_IsW
 
     unsigned best_length = std::numeric_limits<unsigned>::max();
 
+    // No need to check each warehouse if none can match according to their summed inventory
+    if(!isWarehouseGood.IsPossible(GetWarehousesInventory().real))
+    {
+        if(length)
+            *length = best_length;
+        return nullptr;
+    }
+
     for(nobBaseWarehouse* wh : buildings.GetStorehouses())
     {
         // Lagerhaus geeignet?
@@ -419,6 +432,20 @@ nobBaseWarehouse* GamePlayer::FindWarehouse(const noRoadNode& start, const T_IsW
     return best;
 }
 
+const VirtualInventory& GamePlayer::GetWarehousesInventory() const
+{
+    if(!areWarehousesLinked)
+    {
+        for(nobBaseWarehouse* wh : buildings.GetStorehouses())
+            wh->LinkInventory(nullptr);
+        warehousesInventory.clear();
+        for(nobBaseWarehouse* wh : buildings.GetStorehouses())
+            wh->LinkInventory(&warehousesInventory);
+        areWarehousesLinked = true;
+    }
+    return warehousesInventory;
+}
+
 void GamePlayer::AddBuildingSite(noBuildingSite* bldSite)
 {
     RTTR_Assert(bldSite->GetPlayer() == GetPlayerId());
@@ -436,6 +463,8 @@ void GamePlayer::AddBuilding(noBuilding* bld, BuildingType bldType)
     RTTR_Assert(bld->GetPlayer() == GetPlayerId());
     buildings.Add(bld, bldType);
     ChangeStatisticValue(STAT_BUILDINGS, 1);
+    if(areWarehousesLinked && BuildingProperties::IsWareHouse(bldType))
+        static_cast<nobBaseWarehouse*>(bld)->LinkInventory(&warehousesInventory);
 
     // Order a worker if needed
     const auto& description = BLD_WORK_DESC[bldType];
@@ -465,6 +494,8 @@ void GamePlayer::RemoveBuilding(noBuilding* bld, BuildingType bldType)
     RTTR_Assert(bld->GetPlayer() == GetPlayerId());
     buildings.Remove(bld, bldType);
     ChangeStatisticValue(STAT_BUILDINGS, -1);
+    if(BuildingProperties::IsWareHouse(bldType))
+        static_cast<nobBaseWarehouse*>(bld)->LinkInventory(nullptr);
     if(bldType == BLD_HARBORBUILDING)
     { // Schiffen Bescheid sagen
         for(auto& ship : ships)
@@ -727,6 +758,73 @@ void GamePlayer::FindMaterialForBuildingSites()
         bldSite->OrderConstructionMaterial();
 }
 
+void GamePlayer::RequestWarehouseForAllJobs(const Job job)
+{
+    if(!gwg.GetEvMgr().IsExecutingEvents())
+        FindWarehouseForAllJobs(job);
+    else
+    {
+        pendingJobSearches[job] = true;
+        SchedulePendingSearches();
+    }
+}
+
+void GamePlayer::RequestCarrierForAllRoads()
+{
+    if(!gwg.GetEvMgr().IsExecutingEvents())
+        FindCarrierForAllRoads();
+    else
+    {
+        isCarrierSearchPending = true;
+        SchedulePendingSearches();
+    }
+}
+
+void GamePlayer::RequestMaterialForBuildingSites()
+{
+    if(!gwg.GetEvMgr().IsExecutingEvents())
+        FindMaterialForBuildingSites();
+    else
+    {
+        isMaterialSearchPending = true;
+        SchedulePendingSearches();
+    }
+}
+
+void GamePlayer::SchedulePendingSearches()
+{
+    if(arePendingSearchesScheduled)
+        return;
+    arePendingSearchesScheduled = true;
+    gwg.GetEvMgr().AddPostEventsCallback([this]() { ExecutePendingSearches(); });
+}
+
+void GamePlayer::ExecutePendingSearches()
+{
+    // Reset first. Searches requested from now on are done immediately
+    const std::array<bool, NUM_JOB_TYPES + 1> jobSearches = pendingJobSearches;
+    const bool searchCarriers = isCarrierSearchPending;
+    const bool searchMaterial = isMaterialSearchPending;
+    pendingJobSearches.fill(false);
+    isCarrierSearchPending = isMaterialSearchPending = arePendingSearchesScheduled = false;
+
+    // Fixed order independent of the order of the requests
+    if(!jobSearches[JOB_NOTHING])
+    {
+        for(unsigned i = 0; i < NUM_JOB_TYPES; i++)
+        {
+            if(jobSearches[i])
+                FindWarehouseForAllJobs(Job(i));
+        }
+    }
+    if(searchCarriers)
+        FindCarrierForAllRoads();
+    if(jobSearches[JOB_NOTHING])
+        FindWarehouseForAllJobs(JOB_NOTHING);
+    if(searchMaterial)
+        FindMaterialForBuildingSites();
+}
+
 void GamePlayer::AddJobWanted(const Job job, noRoadNode* workplace)
 {
     // Und gleich suchen
@@ -2031,22 +2129,8 @@ void GamePlayer::TestForEmergencyProgramm()
     if(isDefeated)
         return;
 
-    // In Lagern vorhandene Bretter und Steine zählen
-    unsigned boards = 0;
-    unsigned stones = 0;
-    for(nobBaseWarehouse* wh : buildings.GetStorehouses())
-    {
-        boards += wh->GetInventory().goods[GD_BOARDS];
-        stones += wh->GetInventory().goods[GD_STONES];
-    }
-
-    // Emergency happens, if we have less than 10 boards or stones...
-    bool isNewEmergency = boards <= 10 || stones <= 10;
-    // ...and no woddcutter or sawmill
-    isNewEmergency &= buildings.GetBuildings(BLD_WOODCUTTER).empty() || buildings.GetBuildings(BLD_SAWMILL).empty();
-
     // Wenn nötig, Notfallprogramm auslösen
-    if(isNewEmergency)
+    if(IsEmergencyCondition())
     {
         if(!emergency)
         {
@@ -2067,6 +2151,25 @@ void GamePlayer::TestForEmergencyProgramm()
     }
 }
 
+bool GamePlayer::IsEmergencyCondition() const
+{
+    // In Lagern vorhandene Bretter und Steine zählen
+    const Inventory& whInventory = GetWarehousesInventory().visual;
+    const unsigned boards = whInventory[GD_BOARDS];
+    const unsigned stones = whInventory[GD_STONES];
+
+    // Emergency happens, if we have less than 10 boards or stones...
+    bool isEmergency = boards <= 10 || stones <= 10;
+    // ...and no woddcutter or sawmill
+    isEmergency &= buildings.GetBuildings(BLD_WOODCUTTER).empty() || buildings.GetBuildings(BLD_SAWMILL).empty();
+    return isEmergency;
+}
+
+bool GamePlayer::IsEmergencyChangePending() const
+{
+    return !isDefeated && IsEmergencyCondition() != emergency;
+}
+
 /// Testet die Bündnisse, ob sie nicht schon abgelaufen sind
 void GamePlayer::TestPacts()
 {
@@ -2095,6 +2198,23 @@ void GamePlayer::TestPacts()
     }
 }
 
+unsigned GamePlayer::GetNextPactExpiryGF() const
+{
+    unsigned nextExpiryGF = std::numeric_limits<unsigned>::max();
+    for(unsigned i = 0; i < gwg.GetNumPlayers(); ++i)
+    {
+        if(i == GetPlayerId())
+            continue;
+        for(unsigned pactId = 0; pactId < NUM_PACTS; pactId++)
+        {
+            const Pact& pact = pacts[i][pactId];
+            if(pact.duration != 0 && pact.accepted && pact.duration != 0xFFFFFFFF)
+                nextExpiryGF = std::min(nextExpiryGF, pact.start + pact.duration);
+        }
+    }
+    return nextExpiryGF;
+}
+
 bool GamePlayer::CanBuildCatapult() const
 {
     // Wenn AddonId::LIMIT_CATAPULTS nicht aktiv ist, bauen immer erlaubt
@@ -2160,7 +2280,7 @@ std::vector<nobBaseWarehouse*> GamePlayer::GetWarehousesForTrading(const nobBase
     for(nobBaseWarehouse* wh : buildings.GetStorehouses())
     {
         // Is there a trade path from this warehouse to wh? (flag to flag)
-        if(TradePathCache::inst().PathExists(gwg, wh->GetFlag()->GetPos(), goalFlagPos, GetPlayerId()))
+        if(gwg.GetTradePathCache().PathExists(gwg, wh->GetFlag()->GetPos(), goalFlagPos, GetPlayerId()))
             result.push_back(wh);
     }
 
@@ -2230,7 +2350,7 @@ void GamePlayer::Trade(nobBaseWarehouse* goalWh, const GoodType gt, const Job jo
         if(tr.IsValid())
         {
             // Add to cache for future searches
-            TradePathCache::inst().AddEntry(gwg, tr.GetTradePath(), GetPlayerId());
+            gwg.GetTradePathCache().AddEntry(gwg, tr.GetTradePath(), GetPlayerId());
 
             wh->StartTradeCaravane(gt, job, available, tr, goalWh);
             count -= available;
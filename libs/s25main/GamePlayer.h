@@ -27,6 +27,7 @@
 #include "gameTypes/PactTypes.h"
 #include "gameTypes/SettingsTypes.h"
 #include "gameTypes/StatisticTypes.h"
+#include "gameTypes/VirtualInventory.h"
 #include "gameData/MaxPlayers.h"
 #include <array>
 #include <list>
@@ -114,7 +115,7 @@ public:
     nobBaseWarehouse* GetFirstWH() { return buildings.GetStorehouses().empty() ? nullptr : buildings.GetStorehouses().front(); }
     /// Looks for the closest warehouse for the point 'start' (including it) that matches the conditions by the functor
     /// - isWarehouseGood must be a functor taking a "const nobBaseWarhouse&", that returns a bool whether this warehouse should be
-    /// considered - to_wh true if path to wh is searched, false for path from wh - length is optional for the path length - forbidden
+    /// considered and having an IsPossible(const Inventory&) method (see FindWhConditions.h) - to_wh true if path to wh is searched, false for path from wh - length is optional for the path length - forbidden
     /// optional roadSegment that must not be used
     template<class T_IsWarehouseGood>
     nobBaseWarehouse* FindWarehouse(const noRoadNode& start, const T_IsWarehouseGood& isWarehouseGood, bool to_wh, bool use_boat_roads,
@@ -126,6 +127,11 @@ public:
 
     /// Lässt alle Baustellen ggf. noch vorhandenes Baumaterial bestellen
     void FindMaterialForBuildingSites();
+    /// Same as FindWarehouseForAllJobs, FindCarrierForAllRoads and FindMaterialForBuildingSites.
+    /// But while events are executed they are done only once after all events of the current GF, no matter how often they were requested
+    void RequestWarehouseForAllJobs(Job job);
+    void RequestCarrierForAllRoads();
+    void RequestMaterialForBuildingSites();
     /// Fügt ein RoadNode hinzu, der einen bestimmten Job braucht
     void AddJobWanted(Job job, noRoadNode* workplace);
     /// Entfernt ihn wieder aus der Liste (wenn er dann doch nich mehr gebraucht wird)
@@ -179,6 +185,8 @@ public:
 
     /// Gibt Inventory-Settings zurück
     const Inventory& GetInventory() const { return global_inventory; }
+    /// Sum of the inventories of all warehouses
+    const VirtualInventory& GetWarehousesInventory() const;
 
     /// Setzt neue Militäreinstellungen
     void ChangeMilitarySettings(const MilitarySettings& military_settings);
@@ -280,6 +288,8 @@ public:
     Team GetFixedTeam(Team rawteam);
     /// Testet die Bündnisse, ob sie nicht schon abgelaufen sind
     void TestPacts();
+    /// Return the first GF in which an accepted pact with a limited duration expires or the maximum unsigned value if there is none
+    unsigned GetNextPactExpiryGF() const;
 
     /// Returns all warehouses that can trade with the given goal
     /// IMPORTANT: Warehouses can be destroyed. So check them first before using!
@@ -331,6 +341,8 @@ public:
 
     // Testet ob Notfallprogramm aktiviert werden muss und tut dies dann
     void TestForEmergencyProgramm();
+    /// Return true if TestForEmergencyProgramm would (de)activate the emergency program
+    bool IsEmergencyChangePending() const;
     bool hasEmergency() const { return emergency; }
     /// Testet ob der Spieler noch mehr Katapulte bauen darf
     bool CanBuildCatapult() const;
@@ -374,6 +386,9 @@ private:
 
     /// Inventur
     Inventory global_inventory;
+    /// Sum of the inventories of all warehouses. Built on first access (e.g. after loading), then updated by the linked warehouses
+    mutable VirtualInventory warehousesInventory;
+    mutable bool areWarehousesLinked;
 
     /// Koordinaten des HQs des Spielers
     MapPoint hqPos;
@@ -422,6 +437,13 @@ private:
     // Notfall-Programm aktiviert ja/nein (Es gehen nur noch Res an Holzfäller- und Sägewerk-Baustellen raus)
     bool emergency;
 
+    /// Searches requested during the current GF (see Request*). Last entry (JOB_NOTHING) is for all jobs
+    std::array<bool, NUM_JOB_TYPES + 1> pendingJobSearches;
+    bool isCarrierSearchPending, isMaterialSearchPending, arePendingSearchesScheduled;
+    /// Make sure ExecutePendingSearches is called after the events of the current GF
+    void SchedulePendingSearches();
+    void ExecutePendingSearches();
+
     void LoadStandardToolSettings();
     void LoadStandardMilitarySettings();
     void LoadStandardDistribution();
@@ -433,6 +455,8 @@ private:
     bool FindWarehouseForJob(Job job, noRoadNode* goal);
     /// Prüft, ob der Spieler besiegt wurde
     void TestDefeat();
+    /// Return true if there are too few boards or stones and no wood industry
+    bool IsEmergencyCondition() const;
 
     //////////////////////////////////////////////////////////////////////////
     /// Unsynchronized state (e.g. lua, gui...)
@@ -19,6 +19,8 @@
 #include "IngameMinimap.h"
 #include "FOWObjects.h"
 #include "GamePlayer.h"
+#include "Loader.h"
+#include "helpers/ThreadPool.h"
 #include "world/GameWorldBase.h"
 #include "world/GameWorldViewer.h"
 #include "gameData/MinimapConsts.h"
@@ -29,7 +31,7 @@ IngameMinimap::IngameMinimap(const GameWorldViewer& gwv)
     : Minimap(gwv.GetWorld().GetSize()), gwv(gwv), nodes_updated(GetMapSize().x * GetMapSize().y, false),
       dos(GetMapSize().x * GetMapSize().y, DO_INVALID), territory(true), houses(true), roads(true)
 {
-    CreateMapTexture();
+    CreateMapTexture(&LOADER.GetThreadPool());
 }
 
 unsigned IngameMinimap::CalcPixelColor(const MapPoint pt, const unsigned t)
@@ -222,8 +224,8 @@ void IngameMinimap::BeforeDrawing()
             std::fill(nodes_updated.begin(), nodes_updated.end(), false);
         } else
         {
+            // Entsprechende Pixel updaten. Only the changed areas of the touched texture tiles get uploaded
             map.beginUpdate();
-            // Entsprechende Pixel updaten
             for(auto& it : nodesToUpdate)
             {
                 for(unsigned t = 0; t < 2; ++t)
@@ -246,8 +248,8 @@ void IngameMinimap::BeforeDrawing()
  */
 void IngameMinimap::UpdateAll()
 {
-    map.DeleteTexture();
-    CreateMapTexture();
+    // Colors are calculated in parallel rows
+    CreateMapTexture(&LOADER.GetThreadPool());
 }
 
 /**
@@ -255,19 +257,34 @@ void IngameMinimap::UpdateAll()
  */
 void IngameMinimap::UpdateAll(const DrawnObject drawn_object)
 {
+    // Calculate the colors of the affected nodes in parallel rows into a staging buffer first.
+    // Calculated colors are always opaque so 0 marks unchanged pixels
+    const MapExtent mapSize = GetMapSize();
+    std::vector<unsigned> colors(prodOfComponents(mapSize) * 2u, 0u);
+    LOADER.GetThreadPool().parallelFor(mapSize.y, [this, drawn_object, &colors, mapSize](size_t y) {
+        for(MapPoint pt(0, static_cast<MapCoord>(y)); pt.x < mapSize.x; ++pt.x)
+        {
+            const unsigned idx = GetMMIdx(pt);
+            if(dos[idx] == drawn_object
+               || (drawn_object == DO_PLAYER
+                   && // for DO_PLAYER check for not drawn buildings or roads as there is only the player territory visible
+                   ((dos[idx] == DO_BUILDING && !houses) || (dos[idx] == DO_ROAD && !roads))))
+            {
+                for(unsigned t = 0; t < 2; ++t)
+                    colors[idx * 2 + t] = CalcPixelColor(pt, t);
+            }
+        }
+    });
+
     map.beginUpdate();
-    // Gesamte Karte neu berechnen
-    RTTR_FOREACH_PT(MapPoint, GetMapSize())
+    RTTR_FOREACH_PT(MapPoint, mapSize)
     {
         for(unsigned t = 0; t < 2; ++t)
         {
-            if(dos[GetMMIdx(pt)] == drawn_object
-               || (drawn_object == DO_PLAYER
-                   && // for DO_PLAYER check for not drawn buildings or roads as there is only the player territory visible
-                   ((dos[GetMMIdx(pt)] == DO_BUILDING && !houses) || (dos[GetMMIdx(pt)] == DO_ROAD && !roads))))
+            const unsigned color = colors[GetMMIdx(pt) * 2 + t];
+            if(color)
             {
-                unsigned color = CalcPixelColor(pt, t);
-                DrawPoint texPos((pt.x * 2 + t + (pt.y & 1)) % (GetMapSize().x * 2), pt.y);
+                DrawPoint texPos((pt.x * 2 + t + (pt.y & 1)) % (mapSize.x * 2), pt.y);
                 map.updatePixel(texPos, libsiedler2::ColorARGB(color));
             }
         }
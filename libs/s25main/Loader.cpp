@@ -19,6 +19,7 @@
 
 #include "rttrDefines.h" // IWYU pragma: keep
 #include "Loader.h"
+#include "Clock.h"
 #include "ListDir.h"
 #include "RttrConfig.h"
 #include "Settings.h"
@@ -26,6 +27,8 @@
 #include "convertSounds.h"
 #include "drivers/VideoDriverWrapper.h"
 #include "files.h"
+#include "helpers/Fnv1aHash.h"
+#include "helpers/ThreadPool.h"
 #include "helpers/containerUtils.h"
 #include "ogl/SoundEffectItem.h"
 #include "ogl/glArchivItem_Bitmap_Player.h"
@@ -52,12 +55,34 @@
 #include <boost/filesystem.hpp>
 #include <boost/range/adaptor/map.hpp>
 #include <algorithm>
-#include <cstdio>
+#include <ctime>
 #include <iomanip>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
 
+namespace {
+/// Files are loaded from multiple threads, so writing to the log must be synchronized
+std::mutex logMutex;
+} // namespace
+
+/// Adds the time from construction till destruction as a loading phase
+class Loader::ScopedLoadingPhase
+{
+public:
+    ScopedLoadingPhase(Loader& loader, std::string name) : loader_(loader), name_(std::move(name)), startTime_(Clock::now()) {}
+    ~ScopedLoadingPhase()
+    {
+        loader_.AddLoadingPhase(name_, std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - startTime_));
+    }
+
+private:
+    Loader& loader_;
+    const std::string name_;
+    const Clock::time_point startTime_;
+};
+
 Loader::Loader() : isWinterGFX_(false), map_gfx(nullptr), stp(nullptr)
 {
     std::fill(nation_gfx.begin(), nation_gfx.end(), static_cast<libsiedler2::Archiv*>(nullptr));
@@ -202,19 +227,28 @@ bool Loader::LoadFilesAtStart()
     std::vector<unsigned> files;
 
     files += 5, 6, 7, 8, 9, 10, 17; // Paletten:     pal5.bbm, pal6.bbm, pal7.bbm, paletti0.bbm, paletti1.bbm, paletti8.bbm, colors.act
-    if(!LoadFilesFromArray(files))
-        return false;
+    {
+        ScopedLoadingPhase phase(*this, "Palettes");
+        if(!LoadFilesFromArray(files))
+            return false;
+    }
 
     files.clear();
     files += 11, 12,                                                                      // Menüdateien:  resource.dat, io.dat
       102, 103,                                                                           // Hintergründe: setup013.lbm, setup015.lbm
       64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79, 80, 81, 82, 83, 84; // Die ganzen Spielladescreens.
 
-    if(!LoadFilesFromArray(files))
-        return false;
+    {
+        ScopedLoadingPhase phase(*this, "Menu files");
+        if(!LoadFilesFromArray(files))
+            return false;
+    }
 
-    if(!LoadSounds())
-        return false;
+    {
+        ScopedLoadingPhase phase(*this, "Sounds");
+        if(!LoadSounds())
+            return false;
+    }
 
     return LoadOverrideFiles();
 }
@@ -233,7 +267,8 @@ bool Loader::LoadSounds()
         return false;
     auto const convertStartTime = VIDEODRIVER.GetTickCount();
     LOG.write(_("Starting sound conversion..."));
-    if(!convertSounds(GetArchive("sound"), RTTRCONFIG.ExpandPath(FILE_PATHS[56])))
+    if(!convertSounds(GetArchive("sound"), RTTRCONFIG.ExpandPath(FILE_PATHS[56]), RTTRCONFIG.ExpandPath(FILE_PATHS[101]),
+                      RTTRCONFIG.ExpandPath(FILE_PATHS[49]), &GetThreadPool()))
     {
         LOG.write(_("failed\n"));
         return false;
@@ -243,15 +278,15 @@ bool Loader::LoadSounds()
     const std::string oggPath = RTTRCONFIG.ExpandPath(FILE_PATHS[50]);
     std::vector<std::string> oggFiles = ListDir(oggPath, "ogg");
 
-    unsigned i = 0;
+    std::vector<libsiedler2::Archiv> sngs(oggFiles.size());
+    std::vector<char> sngLoaded(oggFiles.size(), false);
+    GetThreadPool().parallelFor(oggFiles.size(), [&](size_t i) { sngLoaded[i] = LoadArchiv(sngs[i], oggFiles[i]); });
+    if(helpers::contains(sngLoaded, false))
+        return false;
+
     sng_lst.alloc(oggFiles.size());
-    for(auto& oggFile : oggFiles)
-    {
-        libsiedler2::Archiv sng;
-        if(!LoadArchiv(sng, oggFile))
-            return false;
-        sng_lst.set(i++, sng.release(0));
-    }
+    for(unsigned i = 0; i < sngs.size(); i++)
+        sng_lst.set(i, sngs[i].release(0));
 
     if(sng_lst.empty())
     {
@@ -353,14 +388,20 @@ bool Loader::LoadFilesAtGame(const std::string& mapGfxPath, bool isWinterGFX, co
     }
 
     // Load files
-    if(!LoadFilesFromArray(files))
-        return false;
+    {
+        ScopedLoadingPhase phase(*this, "Game files");
+        if(!LoadFilesFromArray(files))
+            return false;
+    }
 
     const libsiedler2::ArchivItem_Palette* pal5 = GetPaletteN("pal5");
 
     std::string mapGFXFile = RTTRCONFIG.ExpandPath(mapGfxPath);
-    if(!LoadFile(mapGFXFile, pal5))
-        return false;
+    {
+        ScopedLoadingPhase phase(*this, "Map graphics");
+        if(!LoadFile(mapGFXFile, pal5))
+            return false;
+    }
     map_gfx = &GetArchive(boost::algorithm::to_lower_copy(bfs::path(mapGFXFile).stem().string()));
 
     isWinterGFX_ = isWinterGFX;
@@ -373,6 +414,7 @@ bool Loader::LoadFilesAtGame(const std::string& mapGfxPath, bool isWinterGFX, co
 
 bool Loader::LoadOverrideFiles()
 {
+    ScopedLoadingPhase phase(*this, "Override files");
     for(const OverrideFolder& overrideFolder : overrideFolders_)
     {
         if(!LoadOverrideDirectory(overrideFolder.path))
@@ -383,23 +425,147 @@ bool Loader::LoadOverrideFiles()
 
 bool Loader::LoadFiles(const std::vector<std::string>& files)
 {
-    const libsiedler2::ArchivItem_Palette* pal5 = GetPaletteN("pal5");
-    // load the files
+    ScopedLoadingPhase phase(*this, "Additional files");
+    std::vector<std::string> filePaths;
+    filePaths.reserve(files.size());
     for(const std::string& curFile : files)
+        filePaths.push_back(RTTRCONFIG.ExpandPath(curFile));
+    return LoadFilesInParallel(filePaths, GetPaletteN("pal5"), false);
+}
+
+bool Loader::LoadFilesInParallel(const std::vector<std::string>& filePaths, const libsiedler2::ArchivItem_Palette* palette,
+                                 bool isFromOverrideDir)
+{
+    struct LoadJob
+    {
+        FileEntry* entry;
+        std::string filePath;
+        bool success;
+    };
+    std::vector<LoadJob> jobs;
+    // Determine the entries on this thread as this modifies files_
+    for(const std::string& filePath : filePaths)
     {
-        std::string filePath = RTTRCONFIG.ExpandPath(curFile);
-        if(!LoadFile(filePath, pal5))
+        FileEntry* entry = GetEntryToLoad(filePath, isFromOverrideDir);
+        if(!entry)
+            continue;
+        // Same archive requested multiple times -> Last one wins as if loaded sequentially
+        auto itJob = std::find_if(jobs.begin(), jobs.end(), [entry](const LoadJob& job) { return job.entry == entry; });
+        if(itJob != jobs.end())
+            itJob->filePath = filePath;
+        else
+            jobs.push_back(LoadJob{entry, filePath, false});
+    }
+
+    // Every job writes only to its own entry
+    GetThreadPool().parallelFor(jobs.size(), [this, &jobs, palette](size_t i) {
+        LoadJob& job = jobs[i];
+        job.success = LoadFile(job.entry->archiv, job.filePath, palette);
+    });
+
+    bool result = true;
+    for(LoadJob& job : jobs)
+    {
+        if(job.success)
         {
-            LOG.write(_("Failed to load %s\n")) % filePath;
-            return false;
+            job.entry->loadedAfterOverrideChange = true;
+            job.entry->sourceFiles = GetFilesToLoad(job.filePath);
+        }
+        else
+        {
+            LOG.write(_("Failed to load %s\n")) % job.filePath;
+            result = false;
         }
     }
+    return result;
+}
 
-    return true;
+uint64_t Loader::CalcTextureCacheKey(const Extent& maxTexSize) const
+{
+    helpers::Fnv1aHash hash;
+    hash.add(maxTexSize.x);
+    hash.add(maxTexSize.y);
+    hash.add(isWinterGFX_);
+    // Changes to any source file (including overrides) change the key
+    for(const auto& itEntry : files_)
+    {
+        hash.add(itEntry.first);
+        for(const std::string& filePath : itEntry.second.sourceFiles)
+        {
+            std::vector<bfs::path> paths;
+            boost::system::error_code ec;
+            if(bfs::is_directory(filePath, ec))
+            {
+                for(const auto& it : bfs::recursive_directory_iterator(filePath, ec))
+                    paths.push_back(it.path());
+                std::sort(paths.begin(), paths.end());
+            } else
+                paths.push_back(filePath);
+            for(const bfs::path& path : paths)
+            {
+                hash.add(path.string());
+                if(!bfs::is_regular_file(path, ec))
+                    continue;
+                hash.add(static_cast<uint64_t>(bfs::file_size(path, ec)));
+                hash.add(static_cast<int64_t>(bfs::last_write_time(path, ec)));
+            }
+        }
+    }
+    return hash.get();
+}
+
+void Loader::RemoveOldTextureCaches(const bfs::path& cacheDir)
+{
+    // Keep the most recent ones, e.g. for different landscapes
+    constexpr unsigned maxNumCaches = 4;
+    std::vector<std::pair<std::time_t, bfs::path>> cacheFiles;
+    boost::system::error_code ec;
+    for(const auto& it : bfs::directory_iterator(cacheDir, ec))
+    {
+        const bfs::path& path = it.path();
+        if(path.extension() == ".cache" && path.filename().string().find("textures_") == 0)
+            cacheFiles.emplace_back(bfs::last_write_time(path, ec), path);
+    }
+    if(cacheFiles.size() <= maxNumCaches)
+        return;
+    std::sort(cacheFiles.begin(), cacheFiles.end(),
+              [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+    for(unsigned i = maxNumCaches; i < cacheFiles.size(); i++)
+        bfs::remove(cacheFiles[i].second, ec);
+}
+
+helpers::ThreadPool& Loader::GetThreadPool()
+{
+    if(!threadPool_)
+        threadPool_ = std::make_unique<helpers::ThreadPool>();
+    return *threadPool_;
+}
+
+void Loader::AddLoadingPhase(const std::string& name, std::chrono::milliseconds duration)
+{
+    auto it =
+      std::find_if(loadingPhases_.begin(), loadingPhases_.end(), [&name](const LoadingPhase& phase) { return phase.name == name; });
+    if(it != loadingPhases_.end())
+        it->duration += duration;
+    else
+        loadingPhases_.push_back(LoadingPhase{name, duration});
+}
+
+void Loader::WriteLoadingReport() const
+{
+    std::chrono::milliseconds total(0);
+    LOG.write(_("Loading times:\n"));
+    for(const LoadingPhase& phase : loadingPhases_)
+    {
+        LOG.write("  %1%: %2%ms\n") % phase.name % phase.duration.count();
+        total += phase.duration;
+    }
+    LOG.write(_("  Total: %1%ms\n")) % total.count();
 }
 
 void Loader::fillCaches()
 {
+    auto setupPhase = std::make_unique<ScopedLoadingPhase>(*this, "Texture cache setup");
     stp = std::make_unique<glTexturePacker>();
 
     // Animals
@@ -775,10 +941,42 @@ void Loader::fillCaches()
         }
     }
 
+    setupPhase.reset();
+
     if(SETTINGS.video.shared_textures)
     {
-        // generate mega texture
-        stp->pack();
+        // generate mega texture: Draw the bitmaps on all threads and upload the result on this (the OpenGL) thread
+        // or reuse the one from the last start if nothing changed
+        const Extent maxTexSize = glTexturePacker::getMaxTextureSize();
+        const uint64_t cacheKey = CalcTextureCacheKey(maxTexSize);
+        const bfs::path cacheDir = RTTRCONFIG.ExpandPath(FILE_PATHS[101]);
+        std::stringstream cacheFileName;
+        cacheFileName << "textures_" << std::hex << std::setw(16) << std::setfill('0') << cacheKey << ".cache";
+        const bfs::path cacheFilePath = cacheDir / cacheFileName.str();
+        bool packed;
+        {
+            ScopedLoadingPhase phase(*this, "Texture cache loading");
+            packed = stp->loadPages(cacheFilePath, cacheKey);
+        }
+        if(!packed)
+        {
+            ScopedLoadingPhase phase(*this, "Texture packing");
+            packed = stp->packPages(maxTexSize, &GetThreadPool());
+            if(packed)
+            {
+                if(stp->savePages(cacheFilePath, cacheKey))
+                    RemoveOldTextureCaches(cacheDir);
+                else
+                    LOG.write(_("Failed to write texture cache %1%\n")) % cacheFilePath.string();
+            }
+        }
+        if(packed)
+        {
+            ScopedLoadingPhase phase(*this, "Texture upload");
+            packed = stp->uploadPages();
+        }
+        if(!packed)
+            LOG.write(_("Failed to create shared textures. Using single textures instead.\n"));
     } else
         stp.reset();
 }
@@ -886,6 +1084,7 @@ bool Loader::MergeArchives(libsiedler2::Archiv& targetArchiv, libsiedler2::Archi
                 auto* otherSubArchiv = dynamic_cast<libsiedler2::Archiv*>(otherArchiv[i]);
                 if(!otherSubArchiv)
                 {
+                    std::lock_guard<std::mutex> lock(logMutex);
                     LOG.write(_("Failed to merge entry %1%. Archive expected!\n")) % i;
                     return false;
                 }
@@ -921,20 +1120,30 @@ bool Loader::LoadFile(libsiedler2::Archiv& archiv, const std::string& pfad, cons
  */
 bool Loader::LoadFile(const std::string& pfad, const libsiedler2::ArchivItem_Palette* palette, bool isFromOverrideDir)
 {
-    std::string lowerPath = boost::algorithm::to_lower_copy(pfad);
+    FileEntry* entry = GetEntryToLoad(pfad, isFromOverrideDir);
+    if(entry)
+    {
+        if(!LoadFile(entry->archiv, pfad, palette))
+            return false;
+        entry->loadedAfterOverrideChange = true;
+        entry->sourceFiles = GetFilesToLoad(pfad);
+    }
+    return true;
+}
+
+Loader::FileEntry* Loader::GetEntryToLoad(const std::string& filePath, bool isFromOverrideDir)
+{
+    std::string lowerPath = boost::algorithm::to_lower_copy(filePath);
     std::string name = bfs::path(lowerPath).filename().stem().string();
 
     FileEntry& entry = files_[name];
     // Load if: 1. Not loaded
     //          2. archive content changed BUT we are not loading an override file or the file wasn't loaded since the last override
     //          change
-    if(entry.archiv.empty() || (entry.filesUsed != GetFilesToLoad(pfad) && (!isFromOverrideDir || !entry.loadedAfterOverrideChange)))
-    {
-        if(!LoadFile(entry.archiv, pfad, palette))
-            return false;
-        entry.loadedAfterOverrideChange = true;
-    }
-    return true;
+    if(entry.archiv.empty()
+       || (entry.filesUsed != GetFilesToLoad(filePath) && (!isFromOverrideDir || !entry.loadedAfterOverrideChange)))
+        return &entry;
+    return nullptr;
 }
 
 /**
@@ -951,6 +1160,7 @@ bool Loader::LoadSingleFile(libsiedler2::Archiv& to, const std::string& filePath
 
     if(!boost::filesystem::exists(filePath))
     {
+        std::lock_guard<std::mutex> lock(logMutex);
         LOG.write(_("File or directory does not exist: %s\n")) % filePath;
         return false;
     }
@@ -958,20 +1168,26 @@ bool Loader::LoadSingleFile(libsiedler2::Archiv& to, const std::string& filePath
         return LoadArchiv(to, filePath, palette);
     if(!boost::filesystem::is_directory(filePath))
     {
+        std::lock_guard<std::mutex> lock(logMutex);
         LOG.write(_("Could not determine type of path %s\n")) % filePath;
         return false;
     }
 
-    LOG.write(_("Loading directory %s\n")) % filePath;
-    unsigned startTime = VIDEODRIVER.GetTickCount();
+    const auto startTime = Clock::now();
     std::vector<libsiedler2::FileEntry> files = libsiedler2::ReadFolderInfo(filePath);
+    const int ec = libsiedler2::LoadFolder(files, to, palette);
+    const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - startTime);
+
+    // Write all at once as other files might be loaded in parallel
+    std::lock_guard<std::mutex> lock(logMutex);
+    LOG.write(_("Loading directory %s\n")) % filePath;
     LOG.write(_("  Loading %1% entries: ")) % files.size();
-    if(int ec = libsiedler2::LoadFolder(files, to, palette))
+    if(ec)
     {
         LOG.write(_("failed: %1%\n")) % libsiedler2::getErrorString(ec);
         return false;
     }
-    LOG.write(_("done in %ums\n")) % (VIDEODRIVER.GetTickCount() - startTime);
+    LOG.write(_("done in %ums\n")) % duration.count();
 
     return true;
 }
@@ -987,20 +1203,23 @@ bool Loader::LoadSingleFile(libsiedler2::Archiv& to, const std::string& filePath
  */
 bool Loader::LoadArchiv(libsiedler2::Archiv& archiv, const std::string& pfad, const libsiedler2::ArchivItem_Palette* palette)
 {
-    unsigned ladezeit = VIDEODRIVER.GetTickCount();
+    const auto startTime = Clock::now();
 
     std::string file = RTTRCONFIG.ExpandPath(pfad);
 
-    LOG.write(_("Loading \"%s\": ")) % file;
-    fflush(stdout);
+    const int ec = libsiedler2::Load(file, archiv, palette);
+    const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - startTime);
 
-    if(int ec = libsiedler2::Load(file, archiv, palette))
+    // Write all at once as other files might be loaded in parallel
+    std::lock_guard<std::mutex> lock(logMutex);
+    LOG.write(_("Loading \"%s\": ")) % file;
+    if(ec)
     {
         LOG.write(_("failed: %1%\n")) % libsiedler2::getErrorString(ec);
         return false;
     }
 
-    LOG.write(_("done in %ums\n")) % (VIDEODRIVER.GetTickCount() - ladezeit);
+    LOG.write(_("done in %ums\n")) % duration.count();
 
     return true;
 }
@@ -1028,12 +1247,8 @@ bool Loader::LoadOverrideDirectory(const std::string& path)
     filesAndFolders = ListDir(path, "eng", true, &filesAndFolders);
     filesAndFolders = ListDir(path, "ini", true, &filesAndFolders);
 
-    const libsiedler2::ArchivItem_Palette* pal5 = GetPaletteN("pal5");
-    for(const std::string& i : filesAndFolders)
-    {
-        if(!LoadFile(i, pal5, true))
-            return false;
-    }
+    if(!LoadFilesInParallel(filesAndFolders, GetPaletteN("pal5"), true))
+        return false;
     LOG.write(_("finished in %ums\n")) % (VIDEODRIVER.GetTickCount() - ladezeit);
     return true;
 }
@@ -1045,9 +1260,9 @@ bool Loader::LoadOverrideDirectory(const std::string& path)
  */
 bool Loader::LoadFilesFromArray(const std::vector<unsigned>& files)
 {
-    std::vector<std::string> sFiles;
-    sFiles.reserve(files.size());
+    std::vector<std::string> filePaths;
+    filePaths.reserve(files.size());
     for(unsigned curFileIdx : files)
-        sFiles.push_back(FILE_PATHS[curFileIdx]);
-    return LoadFiles(sFiles);
+        filePaths.push_back(RTTRCONFIG.ExpandPath(FILE_PATHS[curFileIdx]));
+    return LoadFilesInParallel(filePaths, GetPaletteN("pal5"), false);
 }
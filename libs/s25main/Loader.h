@@ -29,7 +29,9 @@
 #include "gameData/AnimalConsts.h"
 #include "libsiedler2/Archiv.h"
 #include "libutil/Singleton.h"
+#include <boost/filesystem/path.hpp>
 #include <array>
+#include <chrono>
 #include <cstdint>
 #include <map>
 #include <memory>
@@ -45,6 +47,9 @@ class glArchivItem_Bob;
 class glArchivItem_Font;
 class SoundEffectItem;
 class glTexturePacker;
+namespace helpers {
+class ThreadPool;
+}
 namespace libsiedler2 {
 class ArchivItem_Ini;
 class ArchivItem_Palette;
@@ -60,6 +65,8 @@ class Loader : public Singleton<Loader, SingletonPolicies::WithLongevity>
         /// List of files used to build this archiv
         std::vector<std::string> filesUsed;
         bool loadedAfterOverrideChange;
+        /// Files (including overrides) the archiv was last loaded from
+        std::vector<std::string> sourceFiles;
     };
     struct OverrideFolder
     {
@@ -72,6 +79,13 @@ class Loader : public Singleton<Loader, SingletonPolicies::WithLongevity>
 public:
     static constexpr unsigned Longevity = 19;
 
+    /// Time spent in a phase of the loading (e.g. loading the game files or packing the textures)
+    struct LoadingPhase
+    {
+        std::string name;
+        std::chrono::milliseconds duration;
+    };
+
     Loader();
     ~Loader() override;
 
@@ -99,6 +113,13 @@ public:
     bool LoadFile(libsiedler2::Archiv& archiv, const std::string& pfad, const libsiedler2::ArchivItem_Palette* palette = nullptr);
 
     void fillCaches();
+
+    /// Clear the recorded loading phases
+    void ResetLoadingPhases() { loadingPhases_.clear(); }
+    /// Loading phases since the last reset. Phases with the same name are combined
+    const std::vector<LoadingPhase>& GetLoadingPhases() const { return loadingPhases_; }
+    /// Write the duration of each loading phase to the log
+    void WriteLoadingReport() const;
     static std::unique_ptr<glArchivItem_Bitmap> ExtractTexture(const glArchivItem_Bitmap& srcImg, const Rect& rect);
     static std::unique_ptr<libsiedler2::Archiv> ExtractAnimatedTexture(const glArchivItem_Bitmap& srcImg, const Rect& rect,
                                                                        uint8_t start_index, uint8_t color_count);
@@ -125,6 +146,8 @@ public:
     glArchivItem_Bitmap_Player* GetMapPlayerImage(unsigned nr);
 
     bool IsWinterGFX() const { return isWinterGFX_; }
+    /// Pool for CPU heavy work of the main thread. Created on first use
+    helpers::ThreadPool& GetThreadPool();
 
     libsiedler2::Archiv sng_lst;
 
@@ -168,6 +191,18 @@ private:
     bool LoadArchiv(libsiedler2::Archiv& archiv, const std::string& pfad, const libsiedler2::ArchivItem_Palette* palette = nullptr);
     bool LoadOverrideDirectory(const std::string& path);
     bool LoadFilesFromArray(const std::vector<unsigned>& files);
+    /// Load the given (resolved) files using all threads of the thread pool
+    bool LoadFilesInParallel(const std::vector<std::string>& filePaths, const libsiedler2::ArchivItem_Palette* palette,
+                             bool isFromOverrideDir);
+    /// Return the entry to load the file into or nullptr if it is already loaded
+    FileEntry* GetEntryToLoad(const std::string& filePath, bool isFromOverrideDir);
+    /// Key for the texture cache identifying the loaded files
+    uint64_t CalcTextureCacheKey(const Extent& maxTexSize) const;
+    /// Remove all but the most recent texture caches
+    static void RemoveOldTextureCaches(const bfs::path& cacheDir);
+
+    class ScopedLoadingPhase;
+    void AddLoadingPhase(const std::string& name, std::chrono::milliseconds duration);
 
     template<typename T>
     static T convertChecked(libsiedler2::ArchivItem* item)
@@ -183,6 +218,9 @@ private:
     std::array<libsiedler2::Archiv*, NUM_NATS> nation_gfx;
     libsiedler2::Archiv* map_gfx;
     std::unique_ptr<glTexturePacker> stp;
+    /// Created on first use
+    std::unique_ptr<helpers::ThreadPool> threadPool_;
+    std::vector<LoadingPhase> loadingPhases_;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
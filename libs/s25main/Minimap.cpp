@@ -17,27 +17,50 @@
 
 #include "rttrDefines.h" // IWYU pragma: keep
 #include "Minimap.h"
+#include "helpers/ThreadPool.h"
 #include "libsiedler2/PixelBufferARGB.h"
+#include <algorithm>
+#include <random>
+
+namespace {
+/// Number of rows calculated by one task when creating the texture in parallel
+constexpr unsigned ROWS_PER_BAND = 16;
+} // namespace
 
 Minimap::Minimap(const MapExtent& mapSize) : mapSize(mapSize) {}
 
-void Minimap::CreateMapTexture()
+void Minimap::CreateMapTexture(helpers::ThreadPool* threadPool)
 {
     map.DeleteTexture();
 
     /// Buffer für die Daten erzeugen
     libsiedler2::PixelBufferARGB buffer(mapSize.x * 2, mapSize.y);
 
-    RTTR_FOREACH_PT(MapPoint, mapSize)
-    {
-        // Die 2. Terraindreiecke durchgehen
-        for(unsigned t = 0; t < 2; ++t)
+    // Each row of nodes only writes to the same row of the buffer, so bands of rows can be calculated independently
+    const auto calcRows = [this, &buffer](unsigned startY, unsigned endY) {
+        for(MapPoint pt(0, startY); pt.y < endY; ++pt.y)
         {
-            libsiedler2::ColorARGB color(CalcPixelColor(pt, t));
-            unsigned xCoord = (pt.x * 2 + t + (pt.y & 1)) % buffer.getWidth();
-            buffer.set(xCoord, pt.y, color);
+            for(pt.x = 0; pt.x < mapSize.x; ++pt.x)
+            {
+                // Die 2. Terraindreiecke durchgehen
+                for(unsigned t = 0; t < 2; ++t)
+                {
+                    libsiedler2::ColorARGB color(CalcPixelColor(pt, t));
+                    unsigned xCoord = (pt.x * 2 + t + (pt.y & 1)) % buffer.getWidth();
+                    buffer.set(xCoord, pt.y, color);
+                }
+            }
         }
-    }
+    };
+    if(threadPool)
+    {
+        const unsigned numBands = (mapSize.y + ROWS_PER_BAND - 1) / ROWS_PER_BAND;
+        threadPool->parallelFor(numBands, [this, &calcRows](size_t band) {
+            const unsigned startY = static_cast<unsigned>(band) * ROWS_PER_BAND;
+            calcRows(startY, std::min<unsigned>(startY + ROWS_PER_BAND, mapSize.y));
+        });
+    } else
+        calcRows(0, mapSize.y);
 
     map.setInterpolateTexture(false);
     map.create(buffer);
@@ -57,7 +80,9 @@ void Minimap::BeforeDrawing() {}
  */
 unsigned Minimap::VaryBrightness(const unsigned color, const int range) const
 {
-    int add = 100 - rand() % (2 * range);
+    // Per thread as the colors may be calculated in parallel
+    static thread_local std::minstd_rand rng;
+    int add = 100 - static_cast<int>(rng() % static_cast<unsigned>(2 * range));
 
     int red = GetRed(color) * add / 100;
     if(red < 0)
@@ -21,6 +21,10 @@
 #include "ogl/glArchivItem_Bitmap_Direct.h"
 #include "gameTypes/MapCoordinates.h"
 
+namespace helpers {
+class ThreadPool;
+}
+
 class Minimap
 {
 protected:
@@ -45,8 +49,9 @@ protected:
     unsigned GetMMIdx(const MapPoint pt) const { return static_cast<unsigned>(pt.y) * mapSize.x + static_cast<unsigned>(pt.x); }
     /// Variiert die übergebene Farbe zufällig in der Helligkeit
     unsigned VaryBrightness(unsigned color, int range) const;
-    /// Erstellt die Textur
-    void CreateMapTexture();
+    /// Erstellt die Textur. If a thread pool is given the rows are calculated in parallel
+    void CreateMapTexture(helpers::ThreadPool* threadPool = nullptr);
+    /// Must be thread safe for different rows when a thread pool is used for CreateMapTexture
     virtual unsigned CalcPixelColor(MapPoint pt, unsigned t) = 0;
     /// Zusätzliche Dinge, die die einzelnen Maps vor dem Zeichenvorgang zu tun haben
     virtual void BeforeDrawing();
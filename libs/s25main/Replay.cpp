@@ -18,11 +18,245 @@
 #include "rttrDefines.h" // IWYU pragma: keep
 #include "Replay.h"
 #include "Savegame.h"
+#include "SerializedGameData.h"
 #include "network/PlayerGameCommands.h"
+#include "gameTypes/CompressedData.h"
 #include "gameTypes/MapInfo.h"
+#include "helpers/SPSCQueue.h"
+#include "libutil/Serializer.h"
 #include <boost/filesystem.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <mygettext/mygettext.h>
+#include <thread>
+
+namespace {
+/// Starts a commit in the command stream. Followed by the last GF at that point. Never a valid GF
+constexpr unsigned COMMIT_MARKER = 0xFFFFFFFF;
+/// Size of a commit (marker + last GF)
+constexpr unsigned COMMIT_SIZE = 8;
+/// Starts a keyframe: GF, RNG state, uncompressed and compressed length of the snapshot and the compressed snapshot
+constexpr unsigned KEYFRAME_MARKER = 0xFFFFFFFE;
+/// Starts and ends the keyframe index: Marker, (GF, position) of each keyframe, number of keyframes, marker
+constexpr unsigned INDEX_MARKER = 0xFFFFFFFD;
+/// Interval in which the writer checks for new commands
+constexpr std::chrono::milliseconds WRITE_INTERVAL(50);
+/// Minimum interval between 2 commits. Data written after the last commit is lost on a crash
+constexpr std::chrono::seconds COMMIT_INTERVAL(1);
+/// Maximum number of commands not yet written. Adding more blocks till the writer catches up
+constexpr size_t MAX_QUEUED_RECORDS = 4096;
+/// Maximum time to wait for the writer to write all commands when the file is read during recording
+constexpr std::chrono::seconds MAX_FLUSH_WAIT(5);
+} // namespace
+
+/// Writes the commands of a replay on a background thread.
+/// The game thread only serializes a command and puts it into a lock-free queue, the writer thread appends the commands to the file
+/// and does a group commit (marker, last GF, flush) at most every COMMIT_INTERVAL.
+/// Keyframes are compressed by the writer thread too
+class Replay::AsyncWriter
+{
+public:
+    struct Record
+    {
+        unsigned gf;
+        ReplayCommand type;
+        uint8_t player, dest;
+        std::string text;
+        Serializer data;
+        /// Set for keyframes only. data contains the RNG state then
+        std::unique_ptr<SerializedGameData> snapshot;
+    };
+
+    AsyncWriter(BinaryFile& file);
+    ~AsyncWriter() { stop(); }
+
+    void push(std::unique_ptr<Record> record);
+    void setLastGF(unsigned gf) { lastGF_ = gf; }
+    /// Write all remaining commands, do a final commit and stop the thread
+    void stop();
+    /// Write and commit all commands pushed so far. Waits at most the timeout, return true if everything was written
+    bool flush(std::chrono::milliseconds timeout);
+    /// True if writing to the file failed. Commands are dropped after that
+    bool hasError() const { return hasError_; }
+
+private:
+    void run();
+    /// Write all queued records. Return true if any was written
+    bool writeQueued();
+    void writeKeyframe(const Record& record);
+    void writeIndex();
+    void commit();
+
+    BinaryFile& file_;
+    helpers::SPSCQueue<std::unique_ptr<Record>> queue_;
+    std::atomic<unsigned> lastGF_;
+    std::atomic<bool> hasError_;
+    /// Last GF of the last commit and maximum GF of all written records. Only used by the writer thread
+    unsigned lastCommittedGF_, maxWrittenGF_;
+    /// All written keyframes. Only used by the writer thread
+    std::vector<KeyframeInfo> keyframes_;
+    /// Only used to wake up the writer on stop or flush, the producer does not lock it otherwise
+    std::mutex mutex_;
+    std::condition_variable cv_, flushedCv_;
+    bool stop_;
+    /// Number of requested and finished flushes
+    unsigned numFlushRequests_, numFlushesDone_;
+    std::thread thread_;
+};
+
+Replay::AsyncWriter::AsyncWriter(BinaryFile& file)
+    : file_(file), queue_(MAX_QUEUED_RECORDS), lastGF_(0), hasError_(false), lastCommittedGF_(0), maxWrittenGF_(0), stop_(false),
+      numFlushRequests_(0), numFlushesDone_(0)
+{
+    thread_ = std::thread(&AsyncWriter::run, this);
+}
+
+void Replay::AsyncWriter::push(std::unique_ptr<Record> record)
+{
+    RTTR_Assert(thread_.joinable());
+    // Only blocks if the disk can't keep up for a longer time
+    while(!queue_.tryPush(std::move(record)))
+        std::this_thread::yield();
+}
+
+void Replay::AsyncWriter::stop()
+{
+    if(!thread_.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+}
+
+bool Replay::AsyncWriter::flush(std::chrono::milliseconds timeout)
+{
+    if(!thread_.joinable())
+        return !hasError_;
+    std::unique_lock<std::mutex> lock(mutex_);
+    const unsigned request = ++numFlushRequests_;
+    cv_.notify_one();
+    if(!flushedCv_.wait_for(lock, timeout, [this, request]() { return numFlushesDone_ >= request; }))
+        return false;
+    return !hasError_;
+}
+
+void Replay::AsyncWriter::run()
+{
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point lastCommitTime = Clock::now();
+    bool hasUncommittedData = false;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while(true)
+    {
+        const bool isLastRun = stop_;
+        const unsigned flushRequest = numFlushRequests_;
+        lock.unlock();
+        try
+        {
+            if(writeQueued())
+                hasUncommittedData = true;
+            // Always end the file with a commit
+            const bool hasChanges = hasUncommittedData || lastGF_ != lastCommittedGF_;
+            const bool isFlushRequested = flushRequest != numFlushesDone_;
+            if(isLastRun || (hasChanges && (isFlushRequested || Clock::now() - lastCommitTime >= COMMIT_INTERVAL)))
+            {
+                if(isLastRun)
+                    writeIndex();
+                commit();
+                hasUncommittedData = false;
+                lastCommitTime = Clock::now();
+            }
+        } catch(const std::exception&)
+        {
+            hasError_ = true;
+        }
+        lock.lock();
+        if(flushRequest != numFlushesDone_)
+        {
+            numFlushesDone_ = flushRequest;
+            flushedCv_.notify_all();
+        }
+        if(isLastRun)
+            break;
+        cv_.wait_for(lock, WRITE_INTERVAL, [this]() { return stop_ || numFlushRequests_ != numFlushesDone_; });
+    }
+}
+
+bool Replay::AsyncWriter::writeQueued()
+{
+    bool written = false;
+    std::unique_ptr<Record> record;
+    while(queue_.tryPop(record))
+    {
+        // Keep the queue going to not block the game thread
+        if(hasError_)
+            continue;
+        if(record->snapshot)
+            writeKeyframe(*record);
+        else
+        {
+            file_.WriteUnsignedInt(record->gf);
+            file_.WriteUnsignedChar(record->type);
+            if(record->type == RC_CHAT)
+            {
+                file_.WriteUnsignedChar(record->player);
+                file_.WriteUnsignedChar(record->dest);
+                file_.WriteLongString(record->text);
+            } else
+                record->data.WriteToFile(file_);
+        }
+        maxWrittenGF_ = std::max(maxWrittenGF_, record->gf);
+        written = true;
+    }
+    return written;
+}
+
+void Replay::AsyncWriter::writeKeyframe(const Record& record)
+{
+    CompressedData compressed;
+    // A keyframe is only an optimization, so just skip it if compression fails
+    if(!compressed.CompressFromBuffer(reinterpret_cast<const char*>(record.snapshot->GetData()), record.snapshot->GetLength()))
+        return;
+    keyframes_.push_back(KeyframeInfo{record.gf, file_.Tell()});
+    file_.WriteUnsignedInt(KEYFRAME_MARKER);
+    file_.WriteUnsignedInt(record.gf);
+    record.data.WriteToFile(file_);
+    file_.WriteUnsignedInt(compressed.length);
+    file_.WriteUnsignedInt(compressed.data.size());
+    file_.WriteRawData(compressed.data.data(), compressed.data.size());
+}
+
+void Replay::AsyncWriter::writeIndex()
+{
+    if(hasError_)
+        return;
+    file_.WriteUnsignedInt(INDEX_MARKER);
+    for(const KeyframeInfo& keyframe : keyframes_)
+    {
+        file_.WriteUnsignedInt(keyframe.gf);
+        file_.WriteUnsignedInt(keyframe.filePos);
+    }
+    file_.WriteUnsignedInt(keyframes_.size());
+    file_.WriteUnsignedInt(INDEX_MARKER);
+}
+
+void Replay::AsyncWriter::commit()
+{
+    if(hasError_)
+        return;
+    // Commands might be added before the last GF is updated
+    lastCommittedGF_ = std::max<unsigned>(lastGF_, maxWrittenGF_);
+    file_.WriteUnsignedInt(COMMIT_MARKER);
+    file_.WriteUnsignedInt(lastCommittedGF_);
+    file_.Flush();
+}
 
 std::string Replay::GetSignature() const
 {
@@ -32,12 +266,13 @@ std::string Replay::GetSignature() const
 uint16_t Replay::GetVersion() const
 {
     /// Version des Replay-Formates
-    return 5;
+    return 8;
 }
 
 //////////////////////////////////////////////////////////////////////////
 
-Replay::Replay() : random_init(0), isRecording(false), lastGF_(0), last_gf_file_pos(0), mapType_(MAPTYPE_OLDMAP) {}
+Replay::Replay() : random_init(0), isRecording(false), lastGF_(0), dataEndPos_(0), isLastCommitMissing_(false), mapType_(MAPTYPE_OLDMAP)
+{}
 
 Replay::~Replay()
 {
@@ -46,12 +281,19 @@ Replay::~Replay()
 
 void Replay::Close()
 {
-    file.Close();
+    StopRecording();
     ClearPlayers();
 }
 
 void Replay::StopRecording()
 {
+    if(writer)
+    {
+        writer->stop();
+        if(writer->hasError())
+            lastErrorMsg = _("Could not write to the replay file. It is incomplete!");
+        writer.reset();
+    }
     file.Close();
     isRecording = false;
 }
@@ -69,6 +311,7 @@ bool Replay::StartRecording(const std::string& filename, const MapInfo& mapInfo)
     /// End-GF (erstmal nur 0, wird dann im Spiel immer geupdatet)
     lastGF_ = 0;
     mapType_ = mapInfo.type;
+    keyframes_.clear();
 
     // Write header
     WriteAllHeaderData(file, mapInfo.title);
@@ -78,9 +321,8 @@ bool Replay::StartRecording(const std::string& filename, const MapInfo& mapInfo)
     if(mapType_ == MAPTYPE_SAVEGAME)
         mapInfo.savegame->WriteFileHeader(file);
 
-    // Position merken für End-GF
-    last_gf_file_pos = file.Tell();
-    file.WriteUnsignedInt(lastGF_);
+    // Former position of the end GF. Now stored in the commits
+    file.WriteUnsignedInt(0);
 
     WritePlayerData(file);
     WriteGGS(file);
@@ -108,9 +350,20 @@ bool Replay::StartRecording(const std::string& filename, const MapInfo& mapInfo)
     // Alles sofort reinschreiben
     file.Flush();
 
+    writer = std::make_unique<AsyncWriter>(file);
     return true;
 }
 
+bool Replay::OpenRecordedFile(BinaryFile& readFile)
+{
+    if(!IsRecording())
+        return false;
+    // Even if this fails the file is valid up to the last commit
+    if(writer)
+        writer->flush(MAX_FLUSH_WAIT);
+    return readFile.Open(file.getFilePath(), OFM_READ);
+}
+
 bool Replay::LoadHeader(const std::string& filename, bool loadSettings)
 {
     // Datei öffnen
@@ -139,13 +392,15 @@ bool Replay::LoadHeader(const std::string& filename, bool loadSettings)
             }
         }
 
-        lastGF_ = file.ReadUnsignedInt();
+        // Unused, the length is stored in the last commit
+        file.ReadUnsignedInt();
 
         if(loadSettings)
         {
             ReadPlayerData(file);
             ReadGGS(file);
         }
+        isLastCommitMissing_ = !ReadLastCommit();
     } catch(std::runtime_error& e)
     {
         lastErrorMsg = e.what();
@@ -188,6 +443,8 @@ bool Replay::LoadGameData(MapInfo& mapInfo)
                 }
                 break;
         }
+        if(isLastCommitMissing_)
+            FindLastCommit();
     } catch(std::runtime_error& e)
     {
         lastErrorMsg = e.what();
@@ -196,39 +453,222 @@ bool Replay::LoadGameData(MapInfo& mapInfo)
     return true;
 }
 
+bool Replay::ReadLastCommit()
+{
+    const unsigned curPos = file.Tell();
+    file.Seek(0, SEEK_END);
+    dataEndPos_ = file.Tell();
+    lastGF_ = 0;
+    keyframes_.clear();
+    bool found = false;
+    if(dataEndPos_ >= curPos + COMMIT_SIZE)
+    {
+        file.Seek(dataEndPos_ - COMMIT_SIZE, SEEK_SET);
+        if(file.ReadUnsignedInt() == COMMIT_MARKER)
+        {
+            lastGF_ = file.ReadUnsignedInt();
+            found = true;
+        }
+    }
+    // The final commit is preceded by the keyframe index
+    if(found && dataEndPos_ >= curPos + COMMIT_SIZE + 12)
+    {
+        file.Seek(dataEndPos_ - COMMIT_SIZE - 8, SEEK_SET);
+        const unsigned numKeyframes = file.ReadUnsignedInt();
+        if(file.ReadUnsignedInt() == INDEX_MARKER && numKeyframes <= (dataEndPos_ - curPos - COMMIT_SIZE - 12) / 8)
+        {
+            const unsigned indexSize = 12 + numKeyframes * 8;
+            const unsigned indexPos = dataEndPos_ - COMMIT_SIZE - indexSize;
+            file.Seek(indexPos, SEEK_SET);
+            if(file.ReadUnsignedInt() == INDEX_MARKER)
+            {
+                keyframes_.resize(numKeyframes);
+                for(KeyframeInfo& keyframe : keyframes_)
+                {
+                    keyframe.gf = file.ReadUnsignedInt();
+                    keyframe.filePos = file.ReadUnsignedInt();
+                }
+                dataEndPos_ = indexPos;
+            }
+        }
+    }
+    file.Seek(curPos, SEEK_SET);
+    return found;
+}
+
+void Replay::FindLastCommit()
+{
+    const unsigned startPos = file.Tell();
+    unsigned lastCommitEndPos = startPos, indexPos = 0;
+    keyframes_.clear();
+    try
+    {
+        while(file.Tell() < dataEndPos_)
+        {
+            const unsigned pos = file.Tell();
+            const unsigned gfOrMarker = file.ReadUnsignedInt();
+            if(gfOrMarker == COMMIT_MARKER)
+            {
+                lastGF_ = file.ReadUnsignedInt();
+                lastCommitEndPos = file.Tell();
+                continue;
+            } else if(gfOrMarker == KEYFRAME_MARKER)
+            {
+                const unsigned gf = file.ReadUnsignedInt();
+                SkipKeyframe();
+                keyframes_.push_back(KeyframeInfo{gf, pos});
+                continue;
+            } else if(gfOrMarker == INDEX_MARKER)
+            {
+                // Contains all keyframes found so far. Only the final commit follows
+                indexPos = pos;
+                file.Seek(keyframes_.size() * 8, SEEK_CUR);
+                if(file.ReadUnsignedInt() != keyframes_.size() || file.ReadUnsignedInt() != INDEX_MARKER)
+                    break;
+                continue;
+            }
+            switch(ReadRCType())
+            {
+                case RC_CHAT:
+                {
+                    uint8_t player, dest;
+                    std::string str;
+                    ReadChatCommand(player, dest, str);
+                    break;
+                }
+                case RC_GAME:
+                {
+                    Serializer ser;
+                    ser.ReadFromFile(file);
+                    break;
+                }
+                default: throw std::runtime_error("Invalid replay command");
+            }
+        }
+    } catch(std::exception&)
+    {
+        // Incomplete data after the last commit
+    }
+    dataEndPos_ = (indexPos && indexPos < lastCommitEndPos) ? indexPos : lastCommitEndPos;
+    // Keyframes after the last commit might be incomplete
+    keyframes_.erase(std::remove_if(keyframes_.begin(), keyframes_.end(),
+                                    [lastCommitEndPos](const KeyframeInfo& keyframe) { return keyframe.filePos >= lastCommitEndPos; }),
+                     keyframes_.end());
+    file.Seek(startPos, SEEK_SET);
+}
+
+void Replay::SkipKeyframe()
+{
+    // RNG state
+    Serializer ser;
+    ser.ReadFromFile(file);
+    // Uncompressed length
+    file.ReadUnsignedInt();
+    const unsigned compressedLength = file.ReadUnsignedInt();
+    file.Seek(compressedLength, SEEK_CUR);
+}
+
 void Replay::AddChatCommand(unsigned gf, uint8_t player, uint8_t dest, const std::string& str)
 {
     RTTR_Assert(IsRecording());
-    if(!file.IsValid())
+    if(!writer)
         return;
 
-    file.WriteUnsignedInt(gf);
+    auto record = std::make_unique<AsyncWriter::Record>();
+    record->gf = gf;
+    record->type = RC_CHAT;
+    record->player = player;
+    record->dest = dest;
+    record->text = str;
+    writer->push(std::move(record));
+}
 
-    file.WriteUnsignedChar(RC_CHAT);
-    file.WriteUnsignedChar(player);
-    file.WriteUnsignedChar(dest);
-    file.WriteLongString(str);
+void Replay::AddGameCommand(unsigned gf, uint8_t player, const PlayerGameCommands& cmds)
+{
+    RTTR_Assert(IsRecording());
+    if(!writer)
+        return;
 
-    // Sofort rein damit
-    file.Flush();
+    auto record = std::make_unique<AsyncWriter::Record>();
+    record->gf = gf;
+    record->type = RC_GAME;
+    record->player = player;
+    record->dest = 0;
+    record->data.PushUnsignedChar(player);
+    cmds.Serialize(record->data);
+    writer->push(std::move(record));
 }
 
-void Replay::AddGameCommand(unsigned gf, uint8_t player, const PlayerGameCommands& cmds)
+void Replay::AddKeyframe(unsigned gf, std::unique_ptr<SerializedGameData> snapshot, const UsedPRNG& rngState)
 {
     RTTR_Assert(IsRecording());
-    if(!file.IsValid())
+    RTTR_Assert(snapshot);
+    if(!writer)
         return;
 
-    file.WriteUnsignedInt(gf);
+    auto record = std::make_unique<AsyncWriter::Record>();
+    record->gf = gf;
+    record->type = RC_GAME;
+    record->player = 0;
+    record->dest = 0;
+    rngState.serialize(record->data);
+    record->snapshot = std::move(snapshot);
+    writer->push(std::move(record));
+}
 
-    file.WriteUnsignedChar(RC_GAME);
-    Serializer ser;
-    ser.PushUnsignedChar(player);
-    cmds.Serialize(ser);
-    ser.WriteToFile(file);
+std::vector<unsigned> Replay::GetKeyframeGFs() const
+{
+    std::vector<unsigned> gfs;
+    gfs.reserve(keyframes_.size());
+    for(const KeyframeInfo& keyframe : keyframes_)
+        gfs.push_back(keyframe.gf);
+    return gfs;
+}
 
-    // Sofort rein damit
-    file.Flush();
+bool Replay::FindKeyframe(unsigned maxGF, unsigned& keyframeGF) const
+{
+    const auto it = std::upper_bound(keyframes_.begin(), keyframes_.end(), maxGF,
+                                     [](unsigned gf, const KeyframeInfo& keyframe) { return gf < keyframe.gf; });
+    if(it == keyframes_.begin())
+        return false;
+    keyframeGF = std::prev(it)->gf;
+    return true;
+}
+
+bool Replay::ReadKeyframe(unsigned gf, SerializedGameData& snapshot, UsedPRNG& rngState)
+{
+    RTTR_Assert(IsReplaying());
+    const auto it =
+      std::find_if(keyframes_.begin(), keyframes_.end(), [gf](const KeyframeInfo& keyframe) { return keyframe.gf == gf; });
+    if(it == keyframes_.end())
+    {
+        lastErrorMsg = _("Keyframe not found");
+        return false;
+    }
+    const unsigned oldPos = file.Tell();
+    try
+    {
+        file.Seek(it->filePos, SEEK_SET);
+        if(file.ReadUnsignedInt() != KEYFRAME_MARKER || file.ReadUnsignedInt() != gf)
+            throw std::runtime_error(_("Invalid keyframe"));
+        Serializer ser;
+        ser.ReadFromFile(file);
+        rngState.deserialize(ser);
+        CompressedData compressed;
+        compressed.length = file.ReadUnsignedInt();
+        compressed.data.resize(file.ReadUnsignedInt());
+        file.ReadRawData(compressed.data.data(), compressed.data.size());
+        snapshot.Clear();
+        if(!compressed.DecompressToBuffer(reinterpret_cast<char*>(snapshot.GetDataWritable(compressed.length))))
+            throw std::runtime_error(_("Invalid keyframe"));
+        snapshot.SetLength(compressed.length);
+    } catch(std::runtime_error& e)
+    {
+        lastErrorMsg = e.what();
+        file.Seek(oldPos, SEEK_SET);
+        return false;
+    }
+    return true;
 }
 
 bool Replay::ReadGF(unsigned* gf)
@@ -236,7 +676,21 @@ bool Replay::ReadGF(unsigned* gf)
     RTTR_Assert(IsReplaying());
     try
     {
-        *gf = file.ReadUnsignedInt();
+        while(file.Tell() < dataEndPos_)
+        {
+            *gf = file.ReadUnsignedInt();
+            if(*gf == KEYFRAME_MARKER)
+            {
+                // GF of the keyframe
+                file.ReadUnsignedInt();
+                SkipKeyframe();
+                continue;
+            }
+            if(*gf != COMMIT_MARKER)
+                return true;
+            // Skip the last GF of the commit
+            file.ReadUnsignedInt();
+        }
     } catch(std::runtime_error&)
     {
         *gf = 0xFFFFFFFF;
@@ -244,7 +698,8 @@ bool Replay::ReadGF(unsigned* gf)
             return false;
         throw;
     }
-    return true;
+    *gf = 0xFFFFFFFF;
+    return false;
 }
 
 Replay::ReplayCommand Replay::ReadRCType()
@@ -274,13 +729,9 @@ void Replay::ReadGameCommand(uint8_t& player, PlayerGameCommands& cmds)
 void Replay::UpdateLastGF(unsigned last_gf)
 {
     RTTR_Assert(IsRecording());
-    if(!file.IsValid())
+    if(!writer)
         return;
 
-    // An die Stelle springen
-    file.Seek(last_gf_file_pos, SEEK_SET);
-    // Dorthin schreiben
-    file.WriteUnsignedInt(last_gf);
-    // Wieder ans Ende springen
-    file.Seek(0, SEEK_END);
+    lastGF_ = last_gf;
+    writer->setLastGF(last_gf);
 }
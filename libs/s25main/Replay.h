@@ -21,16 +21,24 @@
 
 #include "SavedFile.h"
 #include "gameTypes/MapType.h"
+#include "random/Random.h"
 #include "libutil/BinaryFile.h"
+#include <memory>
 #include <string>
+#include <vector>
 
 class MapInfo;
+class SerializedGameData;
 struct PlayerGameCommands;
 
 /// Holds a replay that is being recorded or was recorded and loaded
 /// It has a header that holds minimal information:
-///     File header (version etc.), record time, map name, player names, length (last GF), savegame header (if applicable)
-/// All game relevant data is stored afterwards
+///     File header (version etc.), record time, map name, player names, savegame header (if applicable)
+/// All game relevant data is stored afterwards.
+/// While recording the commands are written by a background thread which appends them in groups, each followed by a commit
+/// (marker + last GF). So the file ends with the length of the replay and is valid up to the last commit even after a crash.
+/// Keyframes (compressed game state) can be added in between to allow seeking. Their positions are stored in an index before the
+/// final commit.
 class Replay : public SavedFile
 {
 public:
@@ -68,6 +76,9 @@ public:
     void AddChatCommand(unsigned gf, uint8_t player, uint8_t dest, const std::string& str);
     /// Fügt ein Spiel-Kommando hinzu (schreibt)
     void AddGameCommand(unsigned gf, uint8_t player, const PlayerGameCommands& cmds);
+    /// Add a keyframe with the state of the game at the start of the given GF, i.e. before any command of that GF is added.
+    /// The snapshot is compressed by the writer thread
+    void AddKeyframe(unsigned gf, std::unique_ptr<SerializedGameData> snapshot, const UsedPRNG& rngState);
 
     /// Liest RC-Type aus, liefert false, wenn das Replay zu Ende ist
     bool ReadGF(unsigned* gf);
@@ -77,9 +88,21 @@ public:
     void ReadChatCommand(uint8_t& player, uint8_t& dest, std::string& str);
     void ReadGameCommand(uint8_t& player, PlayerGameCommands& cmds);
 
-    /// Aktualisiert den End-GF, schreibt ihn in die Replaydatei (nur beim Spielen bzw. Schreiben verwenden!)
+    /// Return the GFs of all keyframes in ascending order
+    std::vector<unsigned> GetKeyframeGFs() const;
+    /// Get the last keyframe at or before maxGF. Return false if there is none
+    bool FindKeyframe(unsigned maxGF, unsigned& keyframeGF) const;
+    /// Read the keyframe at the given GF. The game for the snapshot has to be created with that GF as the start GF.
+    /// On success the next command read is the first after the keyframe, otherwise the read position is unchanged
+    bool ReadKeyframe(unsigned gf, SerializedGameData& snapshot, UsedPRNG& rngState);
+
+    /// Aktualisiert den End-GF, wird mit dem nächsten Commit in die Replaydatei geschrieben (nur beim Schreiben verwenden!)
     void UpdateLastGF(unsigned last_gf);
 
+    /// Open the file that is being recorded for reading. All commands added so far are written to it first.
+    /// Use this instead of GetFile while recording as the file is written by another thread
+    bool OpenRecordedFile(BinaryFile& readFile);
+
     BinaryFile& GetFile() { return file; }
     unsigned GetLastGF() const { return lastGF_; }
 
@@ -87,13 +110,35 @@ public:
     unsigned random_init;
 
 protected:
+    class AsyncWriter;
+    struct KeyframeInfo
+    {
+        unsigned gf;
+        /// Position of the keyframe marker in the file
+        unsigned filePos;
+    };
+
+    /// Read the length and the keyframe index from the end of the file. Return false if there is no commit (e.g. after a crash)
+    bool ReadLastCommit();
+    /// Search the last complete commit and the keyframes starting at the current position (first command)
+    /// and discard everything after that commit
+    void FindLastCommit();
+    /// Skip the keyframe after its marker was read
+    void SkipKeyframe();
+
     BinaryFile file;
     bool isRecording;
     /// End-GF
     unsigned lastGF_;
-    /// Position des End-GF in der Datei
-    unsigned last_gf_file_pos;
+    /// Position after the last commit, commands after this are not read
+    unsigned dataEndPos_;
+    /// True if the file does not end with a commit and FindLastCommit needs to be used
+    bool isLastCommitMissing_;
     MapType mapType_;
+    /// Keyframes in the file sorted by GF
+    std::vector<KeyframeInfo> keyframes_;
+    /// Writes the commands while recording
+    std::unique_ptr<AsyncWriter> writer;
 };
 
 #endif //! GAMEREPLAY_H_INCLUDED
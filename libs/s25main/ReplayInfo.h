@@ -21,11 +21,16 @@
 #define ReplayInfo_h__
 
 #include "Replay.h"
+#include "random/Random.h"
+#include <memory>
 #include <string>
 
+class Game;
+class SerializedGameData;
+
 struct ReplayInfo
 {
-    ReplayInfo() : async(0), end(false), next_gf(0), all_visible(false) {}
+    ReplayInfo() : async(0), end(false), next_gf(0), all_visible(false), nextKeyframeGF(0), lastPublishedGF(0), keyframeTargetGF(0) {}
 
     /// Replaydatei
     Replay replay;
@@ -37,6 +42,16 @@ struct ReplayInfo
     unsigned next_gf;
     /// Alles sichtbar (FoW deaktiviert)
     bool all_visible;
+    /// GF at which the next keyframe is recorded
+    unsigned nextKeyframeGF;
+    /// GF at which the world snapshot and the spectator changes were published last
+    unsigned lastPublishedGF;
+    /// Keyframe to load when the UI of the replaced game is gone, its RNG state and the GF to skip to afterwards
+    std::unique_ptr<SerializedGameData> keyframe;
+    UsedPRNG keyframeRngState;
+    unsigned keyframeTargetGF;
+    /// Game replaced by the keyframe. Kept till the keyframe is loaded
+    std::shared_ptr<Game> replacedGame;
 };
 
 #endif // ReplayInfo_h__
@@ -0,0 +1,193 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "SimProfiler.h"
+#include <boost/format.hpp>
+#include <boost/nowide/fstream.hpp>
+#include <algorithm>
+#include <ostream>
+#include <type_traits>
+
+namespace {
+/// Names of the GO_Types (class names of the objects)
+const char* const goTypeNames[] = {
+  "Unknown", "Nothing", "nobHQ", "nobMilitary", "nobStorehouse", "nobUsual", "nobShipYard", "nobHarborBuilding", "noBuildingSite",
+  "nofAggressiveDefender", "nofAttacker", "nofDefender", "nofPassiveSoldier", "nofWellguy", "nofCarrier", "nofWoodcutter", "nofFisher",
+  "nofForester", "nofCarpenter", "nofStonemason", "nofHunter", "nofFarmer", "nofMiller", "nofBaker", "nofButcher", "nofMiner", "nofBrewer",
+  "nofPigbreeder", "nofDonkeybreeder", "nofIronfounder", "nofMinter", "nofMetalworker", "nofArmorer", "nofBuilder", "nofPlaner",
+  "nofGeologist", "nofShipWright", "nofScout_Free", "nofScout_LookoutTower", "nofWarehouseWorker", "nofCatapultMan", "nofPassiveWorker",
+  "nofCharburner", "noExtension", "noEnvObject", "noFire", "noFlag", "noGrainfield", "noGranite", "noSign", "noSkeleton", "noStaticObject",
+  "noDisappearingMapEnvObject", "noTree", "noAnimal", "noFighting", "RoadSegment", "Ware", "CatapultStone", "BurnedWarehouse",
+  "noShipBuildingSite", "noShip", "noCharburnerPile", "nofTradeLeader", "nofTradeDonkey"};
+static_assert(std::extent<decltype(goTypeNames)>::value == GOT_NOF_TRADEDONKEY + 1u, "Update the names when changing GO_Type");
+
+/// Write the string as a JSON string literal
+void writeJSONString(std::ostream& os, const std::string& str)
+{
+    os << '"';
+    for(char c : str)
+    {
+        if(c == '"' || c == '\\')
+            os << '\\';
+        os << c;
+    }
+    os << '"';
+}
+
+int64_t toMicroseconds(Clock::duration duration)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+} // namespace
+
+SimProfiler::SimProfiler() : enabled_(false), traceEnabled_(false), maxTraceEvents_(0), numDroppedTraceEvents_(0) {}
+
+void SimProfiler::setTraceEnabled(bool enabled, unsigned maxEvents)
+{
+    traceEnabled_ = enabled;
+    maxTraceEvents_ = maxEvents;
+}
+
+void SimProfiler::reset()
+{
+    stats_.clear();
+    trace_.clear();
+    numDroppedTraceEvents_ = 0;
+}
+
+void SimProfiler::add(Category category, const char* name, unsigned id, Clock::time_point start, Clock::time_point end)
+{
+    const Clock::duration duration = end - start;
+    Stats& stats = stats_[Key(category, name, id)];
+    stats.count++;
+    stats.total += duration;
+    stats.max = std::max(stats.max, duration);
+    if(traceEnabled_)
+    {
+        if(trace_.empty())
+            traceStart_ = start;
+        if(trace_.size() < maxTraceEvents_)
+            trace_.push_back(TraceEvent{category, name, id, start, duration});
+        else
+            numDroppedTraceEvents_++;
+    }
+}
+
+std::vector<SimProfiler::Entry> SimProfiler::getEntries(SortBy sortBy) const
+{
+    // Name pointers of the same literal may differ between translation units -> merge by content
+    std::map<std::tuple<Category, std::string, unsigned>, Stats> mergedStats;
+    for(const auto& it : stats_)
+    {
+        Stats& stats = mergedStats[std::make_tuple(std::get<0>(it.first), std::string(std::get<1>(it.first)), std::get<2>(it.first))];
+        stats.count += it.second.count;
+        stats.total += it.second.total;
+        stats.max = std::max(stats.max, it.second.max);
+    }
+    std::vector<Entry> entries;
+    entries.reserve(mergedStats.size());
+    for(const auto& it : mergedStats)
+        entries.push_back(
+          Entry{std::get<0>(it.first), std::get<1>(it.first), std::get<2>(it.first), it.second.count, it.second.total, it.second.max});
+
+    const auto getSortValue = [sortBy](const Entry& entry) -> uint64_t {
+        switch(sortBy)
+        {
+            case SORT_COUNT: return entry.count;
+            case SORT_AVERAGE: return static_cast<uint64_t>(entry.getAverage().count());
+            case SORT_MAX: return static_cast<uint64_t>(entry.max.count());
+            case SORT_TOTAL: break;
+        }
+        return static_cast<uint64_t>(entry.total.count());
+    };
+    // Stable to keep the category/name order for equal values
+    std::stable_sort(entries.begin(), entries.end(),
+                     [&getSortValue](const Entry& lhs, const Entry& rhs) { return getSortValue(lhs) > getSortValue(rhs); });
+    return entries;
+}
+
+void SimProfiler::writeReport(std::ostream& os, SortBy sortBy) const
+{
+    const std::vector<Entry> entries = getEntries(sortBy);
+    os << boost::format("%-10s %-30s %6s %12s %12s %12s %12s\n") % "Category" % "Name" % "Id" % "Count" % "Total[ms]" % "Avg[us]"
+            % "Max[us]";
+    for(const Entry& entry : entries)
+    {
+        os << boost::format("%-10s %-30s %6u %12u %12.3f %12.3f %12.3f\n") % getCategoryName(entry.category) % entry.name % entry.id
+                % entry.count % (toMicroseconds(entry.total) / 1000.) % (std::chrono::duration<double, std::micro>(entry.getAverage()).count())
+                % (std::chrono::duration<double, std::micro>(entry.max).count());
+    }
+    if(numDroppedTraceEvents_)
+        os << numDroppedTraceEvents_ << " calls were not added to the timeline as the limit was reached\n";
+}
+
+void SimProfiler::writeTrace(std::ostream& os) const
+{
+    os << "{\"traceEvents\":[";
+    bool isFirst = true;
+    for(const TraceEvent& ev : trace_)
+    {
+        if(!isFirst)
+            os << ",";
+        isFirst = false;
+        os << "\n{\"name\":";
+        writeJSONString(os, ev.name);
+        os << ",\"cat\":\"" << getCategoryName(ev.category) << "\",\"ph\":\"X\",\"ts\":" << toMicroseconds(ev.start - traceStart_)
+           << ",\"dur\":" << toMicroseconds(ev.duration) << ",\"pid\":0,\"tid\":0,\"args\":{\"id\":" << ev.id << "}}";
+    }
+    os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+bool SimProfiler::writeFiles(const std::string& basePath) const
+{
+    bnw::ofstream reportFile(basePath + ".txt");
+    if(!reportFile)
+        return false;
+    writeReport(reportFile);
+    if(!reportFile)
+        return false;
+    if(traceEnabled_)
+    {
+        bnw::ofstream traceFile(basePath + ".json");
+        if(!traceFile)
+            return false;
+        writeTrace(traceFile);
+        if(!traceFile)
+            return false;
+    }
+    return true;
+}
+
+const char* SimProfiler::getCategoryName(Category category)
+{
+    switch(category)
+    {
+        case PROF_GF: return "GF";
+        case PROF_EVENT: return "Event";
+        case PROF_GC: return "GC";
+        case PROF_AI: return "AI";
+        case PROF_LUA: return "Lua";
+        case NUM_PROF_CATEGORIES: break;
+    }
+    return "Unknown";
+}
+
+const char* SimProfiler::getGOTypeName(GO_Type got)
+{
+    return static_cast<unsigned>(got) <= GOT_NOF_TRADEDONKEY ? goTypeNames[got] : "Invalid";
+}
@@ -0,0 +1,157 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SimProfiler_h__
+#define SimProfiler_h__
+
+#include "Clock.h"
+#include "gameTypes/GO_Type.h"
+#include "libutil/Singleton.h"
+#include <boost/preprocessor/cat.hpp>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/// Set by the CMake option RTTR_ENABLE_PROFILER. If 0 all RTTR_PROFILE_* macros expand to nothing
+#ifndef RTTR_ENABLE_PROFILER
+#define RTTR_ENABLE_PROFILER 0
+#endif
+
+/// Records wall time and call counts of the simulation (events, game commands, AI, lua callbacks).
+/// Recording is opt-in at runtime and only possible when compiled with RTTR_ENABLE_PROFILER
+class SimProfiler : public Singleton<SimProfiler>
+{
+public:
+    enum Category
+    {
+        PROF_GF,
+        PROF_EVENT,
+        PROF_GC,
+        PROF_AI,
+        PROF_LUA,
+        NUM_PROF_CATEGORIES
+    };
+    enum SortBy
+    {
+        SORT_TOTAL,
+        SORT_COUNT,
+        SORT_AVERAGE,
+        SORT_MAX
+    };
+    /// Accumulated stats of one (category, name, id) combination
+    struct Entry
+    {
+        Category category;
+        std::string name;
+        unsigned id;
+        uint64_t count;
+        Clock::duration total, max;
+        Clock::duration getAverage() const { return count ? total / static_cast<Clock::rep>(count) : Clock::duration::zero(); }
+    };
+
+    SimProfiler();
+
+    /// Start/Stop recording. Does not clear already recorded data
+    void setEnabled(bool enabled) { enabled_ = enabled; }
+    bool isEnabled() const { return enabled_; }
+    /// Additionally record each call for the timeline. At most maxEvents calls are stored, later ones are dropped
+    void setTraceEnabled(bool enabled, unsigned maxEvents = 1000000);
+    bool isTraceEnabled() const { return traceEnabled_; }
+    /// Clear all recorded data
+    void reset();
+
+    /// Record a call. Name must be a string literal (or otherwise outlive the profiler data)
+    void add(Category category, const char* name, unsigned id, Clock::time_point start, Clock::time_point end);
+
+    std::vector<Entry> getEntries(SortBy sortBy = SORT_TOTAL) const;
+    size_t getNumTraceEvents() const { return trace_.size(); }
+    size_t getNumDroppedTraceEvents() const { return numDroppedTraceEvents_; }
+
+    /// Write a human readable table of all entries
+    void writeReport(std::ostream& os, SortBy sortBy = SORT_TOTAL) const;
+    /// Write the recorded calls in the Chrome trace event format (load in chrome://tracing or similar)
+    void writeTrace(std::ostream& os) const;
+    /// Write report (<basePath>.txt) and trace if enabled (<basePath>.json). Return false on error
+    bool writeFiles(const std::string& basePath) const;
+
+    static const char* getCategoryName(Category category);
+    static const char* getGOTypeName(GO_Type got);
+
+private:
+    struct Stats
+    {
+        uint64_t count = 0;
+        Clock::duration total = Clock::duration::zero(), max = Clock::duration::zero();
+    };
+    struct TraceEvent
+    {
+        Category category;
+        const char* name;
+        unsigned id;
+        Clock::time_point start;
+        Clock::duration duration;
+    };
+    using Key = std::tuple<Category, const char*, unsigned>;
+
+    bool enabled_, traceEnabled_;
+    unsigned maxTraceEvents_;
+    size_t numDroppedTraceEvents_;
+    std::map<Key, Stats> stats_;
+    std::vector<TraceEvent> trace_;
+    /// Time of the first recorded call. Timeline timestamps are relative to this
+    Clock::time_point traceStart_;
+};
+
+#define SIMPROFILER SimProfiler::inst()
+
+/// Measures the time from construction till destruction if the profiler is enabled
+class SimProfilerScope
+{
+    SimProfiler::Category category_;
+    const char* name_;
+    unsigned id_;
+    bool active_;
+    Clock::time_point start_;
+
+public:
+    SimProfilerScope(SimProfiler::Category category, const char* name, unsigned id)
+        : category_(category), name_(name), id_(id), active_(SIMPROFILER.isEnabled())
+    {
+        if(active_)
+            start_ = Clock::now();
+    }
+    ~SimProfilerScope()
+    {
+        if(active_)
+            SIMPROFILER.add(category_, name_, id_, start_, Clock::now());
+    }
+    SimProfilerScope(const SimProfilerScope&) = delete;
+    SimProfilerScope& operator=(const SimProfilerScope&) = delete;
+};
+
+#if RTTR_ENABLE_PROFILER
+/// Profile the rest of the current scope
+#define RTTR_PROFILE_SCOPE(category, name, id) \
+    SimProfilerScope BOOST_PP_CAT(rttrProfileScope, __LINE__)(SimProfiler::category, name, static_cast<unsigned>(id))
+#else
+#define RTTR_PROFILE_SCOPE(category, name, id) static_cast<void>(0)
+#endif
+
+#endif // SimProfiler_h__
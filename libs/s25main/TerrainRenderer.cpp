@@ -35,6 +35,7 @@
 #include <glad/glad.h>
 #include <boost/algorithm/string/case_conv.hpp>
 #include <boost/range/adaptor/indexed.hpp>
+#include <algorithm>
 #include <cstdlib>
 #include <set>
 
@@ -292,6 +293,7 @@ void TerrainRenderer::GenerateOpenGL(const GameWorldViewer& gwv)
 {
     const GameWorldBase& world = gwv.GetWorld();
     Init(world.GetSize());
+    drawCache_ = DrawCache();
 
     GenerateVertices(gwv);
     const WorldDescription& desc = world.GetDescription();
@@ -663,111 +665,334 @@ void TerrainRenderer::UpdateBorderTriangleTerrain(const MapPoint pt, bool update
     }
 }
 
-/**
- *  zeichnet den Kartenausschnitt.
- */
-void TerrainRenderer::Draw(const Position& firstPt, const Position& lastPt, const GameWorldViewer& gwv, unsigned* water) const
+void TerrainRenderer::PrepareTerrain(const Position& firstPt, const Position& lastPt, const GameWorldViewer& gwv) const
 {
-    RTTR_Assert(!gl_vertices.empty());
-    RTTR_Assert(!borders.empty());
+    DrawCache& cache = drawCache_;
+    // Keep the rows and columns which are still visible and prepare only the new ones
+    std::vector<TerrainRow> rows(std::max(0, lastPt.y - firstPt.y + 1));
+    const bool canReuse = cache.isValid && firstPt.x <= cache.lastPt.x && lastPt.x >= cache.firstPt.x;
+    for(int y = firstPt.y; y <= lastPt.y; ++y)
+    {
+        TerrainRow& row = rows[y - firstPt.y];
+        if(!canReuse || y < cache.firstPt.y || y > cache.lastPt.y)
+        {
+            PrepareTerrainRow(row, y, firstPt.x, lastPt.x);
+            continue;
+        }
+        std::swap(row, cache.terrainRows[y - cache.firstPt.y]);
+        TrimTerrainRow(row, y, firstPt.x, lastPt.x);
+        if(firstPt.x < cache.firstPt.x)
+        {
+            TerrainRow newRow;
+            PrepareTerrainRow(newRow, y, firstPt.x, cache.firstPt.x - 1);
+            AppendRuns(newRow.tiles, row.tiles);
+            AppendRuns(newRow.borders, row.borders);
+            std::swap(row, newRow);
+        }
+        if(lastPt.x > cache.lastPt.x)
+            PrepareTerrainRow(row, y, cache.lastPt.x + 1, lastPt.x);
+    }
+    cache.terrainRows.swap(rows);
 
     // nach Texture in Listen sortieren
-    std::vector<std::vector<MapTile>> sorted_textures(terrainTextures.size());
-    std::vector<std::vector<BorderTile>> sorted_borders(edgeTextures.size());
-    PreparedRoads sorted_roads(roadTextures.size());
+    std::vector<std::vector<MapTile>>& sorted_textures = cache.sorted_textures;
+    std::vector<std::vector<BorderTile>>& sorted_borders = cache.sorted_borders;
+    // Keep the memory of the inner vectors
+    sorted_textures.resize(terrainTextures.size());
+    sorted_borders.resize(edgeTextures.size());
+    for(std::vector<MapTile>& tiles : sorted_textures)
+        tiles.clear();
+    for(std::vector<BorderTile>& tiles : sorted_borders)
+        tiles.clear();
+
+    for(const TerrainRow& row : cache.terrainRows)
+    {
+        for(const TerrainRun& run : row.tiles)
+        {
+            sorted_textures[run.texture].push_back(MapTile(run.tileOffset, run.posOffset));
+            sorted_textures[run.texture].back().count = run.count;
+        }
+        for(const TerrainRun& run : row.borders)
+        {
+            sorted_borders[run.texture].push_back(BorderTile(run.tileOffset, run.posOffset));
+            sorted_borders[run.texture].back().count = run.count;
+        }
+    }
 
-    Position lastOffset(0, 0);
+    cache.waterCount = 0;
+    const WorldDescription& desc = gwv.GetWorld().GetDescription();
+    for(DescIdx<TerrainDesc> t(0); t.value < sorted_textures.size(); ++t.value)
+    {
+        if(desc.get(t).kind != TerrainKind::WATER)
+            continue;
+        for(const MapTile& tile : sorted_textures[t.value])
+            cache.waterCount += tile.count;
+    }
+}
 
-    // Beim zeichnen immer nur beginnen, wo man auch was sieht
-    for(int y = firstPt.y; y <= lastPt.y; ++y)
+void TerrainRenderer::PrepareTerrainRow(TerrainRow& row, const int y, const int firstX, const int lastX) const
+{
+    for(int x = firstX; x <= lastX; ++x)
     {
-        unsigned char lastTerrain = 255;
-        unsigned char lastBorder = 255;
+        Position posOffset;
+        const MapPoint tP = ConvertCoords(Position(x, y), &posOffset);
+        const unsigned idx = GetVertexIdx(tP);
 
-        for(int x = firstPt.x; x <= lastPt.x; ++x)
-        {
-            Position posOffset;
-            MapPoint tP = ConvertCoords(Position(x, y), &posOffset);
+        AddToRuns(row.tiles, terrain[idx][0].value, GetTriangleIdx(tP), posOffset, x);
+        AddToRuns(row.tiles, terrain[idx][1].value, GetTriangleIdx(tP) + 1, posOffset, x);
 
-            unsigned char t = terrain[GetVertexIdx(tP)][0].value;
-            if(posOffset != lastOffset)
-                lastTerrain = 255;
+        const Borders& curBorders = borders[idx];
+        std::array<unsigned char, 6> tiles = {{curBorders.left_right[0], curBorders.left_right[1], curBorders.right_left[0],
+                                               curBorders.right_left[1], curBorders.top_down[0], curBorders.top_down[1]}};
 
-            if(t == lastTerrain && tP != MapPoint(0, 0))
-                ++sorted_textures[t].back().count;
-            else
-            {
-                MapTile tmp(GetTriangleIdx(tP), posOffset);
-                sorted_textures[t].push_back(tmp);
-                lastTerrain = t;
-            }
+        // Offsets into gl_* arrays
+        std::array<unsigned, 6> offsets = {{curBorders.left_right_offset[0], curBorders.left_right_offset[1],
+                                            curBorders.right_left_offset[0], curBorders.right_left_offset[1],
+                                            curBorders.top_down_offset[0], curBorders.top_down_offset[1]}};
+
+        for(unsigned char i = 0; i < 6; ++i)
+        {
+            if(tiles[i])
+                AddToRuns(row.borders, tiles[i] - 1, offsets[i], posOffset, x);
+        }
+    }
+}
 
-            t = terrain[GetVertexIdx(tP)][1].value;
+void TerrainRenderer::TrimTerrainRow(TerrainRow& row, const int y, const int firstX, const int lastX) const
+{
+    const auto isOutside = [firstX, lastX](const TerrainRun& run) { return run.lastX < firstX || run.firstX > lastX; };
+    helpers::remove_if(row.tiles, isOutside);
+    helpers::remove_if(row.borders, isOutside);
 
-            if(t == lastTerrain)
-                ++sorted_textures[t].back().count;
-            else
-            {
-                MapTile tmp(GetTriangleIdx(tP) + 1, posOffset);
-                sorted_textures[t].push_back(tmp);
-            }
+    // Runs are contiguous, so a run reaching over the boundary contains all triangles of the nodes up to there
+    for(TerrainRun& run : row.tiles)
+    {
+        if(run.firstX < firstX)
+        {
+            const unsigned newOffset = GetTriangleIdx(ConvertCoords(Position(firstX, y)));
+            run.count -= newOffset - run.tileOffset;
+            run.tileOffset = newOffset;
+            run.firstX = firstX;
+        }
+        if(run.lastX > lastX)
+        {
+            // 2 triangles per node
+            run.count = GetTriangleIdx(ConvertCoords(Position(lastX, y))) + 2 - run.tileOffset;
+            run.lastX = lastX;
+        }
+    }
+    // Nodes might not have borders, so search the first/last node which has some
+    for(TerrainRun& run : row.borders)
+    {
+        unsigned offset;
+        if(run.firstX < firstX)
+        {
+            int x = firstX;
+            while(!GetBorderOffset(ConvertCoords(Position(x, y)), true, offset))
+                ++x;
+            run.count -= offset - run.tileOffset;
+            run.tileOffset = offset;
+            run.firstX = x;
+        }
+        if(run.lastX > lastX)
+        {
+            int x = lastX;
+            while(!GetBorderOffset(ConvertCoords(Position(x, y)), false, offset))
+                --x;
+            run.count = offset + 1 - run.tileOffset;
+            run.lastX = x;
+        }
+    }
+}
 
-            lastTerrain = t;
+bool TerrainRenderer::GetBorderOffset(const MapPoint pt, bool getFirst, unsigned& offset) const
+{
+    const Borders& curBorders = borders[GetVertexIdx(pt)];
+    std::array<unsigned char, 6> tiles = {{curBorders.left_right[0], curBorders.left_right[1], curBorders.right_left[0],
+                                           curBorders.right_left[1], curBorders.top_down[0], curBorders.top_down[1]}};
+    std::array<unsigned, 6> offsets = {{curBorders.left_right_offset[0], curBorders.left_right_offset[1], curBorders.right_left_offset[0],
+                                        curBorders.right_left_offset[1], curBorders.top_down_offset[0], curBorders.top_down_offset[1]}};
+    // Offsets are assigned in this order
+    for(unsigned i = 0; i < tiles.size(); ++i)
+    {
+        const unsigned curIdx = getFirst ? i : tiles.size() - 1u - i;
+        if(tiles[curIdx])
+        {
+            offset = offsets[curIdx];
+            return true;
+        }
+    }
+    return false;
+}
 
-            const Borders& curBorders = borders[GetVertexIdx(tP)];
-            std::array<unsigned char, 6> tiles = {{curBorders.left_right[0], curBorders.left_right[1], curBorders.right_left[0],
-                                                   curBorders.right_left[1], curBorders.top_down[0], curBorders.top_down[1]}};
+void TerrainRenderer::AddToRuns(std::vector<TerrainRun>& runs, unsigned char texture, unsigned offset, const Position& posOffset, int x)
+{
+    if(!runs.empty())
+    {
+        TerrainRun& lastRun = runs.back();
+        // Check that we did not wrap around the map and the expected offset matches
+        if(lastRun.texture == texture && lastRun.posOffset == posOffset && lastRun.tileOffset + lastRun.count == offset)
+        {
+            ++lastRun.count;
+            lastRun.lastX = x;
+            return;
+        }
+    }
+    runs.push_back(TerrainRun{texture, offset, 1, posOffset, x, x});
+}
 
-            // Offsets into gl_* arrays
-            std::array<unsigned, 6> offsets = {{curBorders.left_right_offset[0], curBorders.left_right_offset[1],
-                                                curBorders.right_left_offset[0], curBorders.right_left_offset[1],
-                                                curBorders.top_down_offset[0], curBorders.top_down_offset[1]}};
+void TerrainRenderer::AppendRuns(std::vector<TerrainRun>& runs, const std::vector<TerrainRun>& newRuns)
+{
+    auto itNewRun = newRuns.begin();
+    if(!runs.empty() && itNewRun != newRuns.end())
+    {
+        TerrainRun& lastRun = runs.back();
+        if(lastRun.texture == itNewRun->texture && lastRun.posOffset == itNewRun->posOffset
+           && lastRun.tileOffset + lastRun.count == itNewRun->tileOffset)
+        {
+            lastRun.count += itNewRun->count;
+            lastRun.lastX = itNewRun->lastX;
+            ++itNewRun;
+        }
+    }
+    runs.insert(runs.end(), itNewRun, newRuns.end());
+}
 
-            for(unsigned char i = 0; i < 6; ++i)
+void TerrainRenderer::MoveCachedRoads(const Position& firstPt, const Position& lastPt) const
+{
+    const Position newSize = lastPt - firstPt + Position(1, 1);
+    std::vector<NodeRoads> newNodeRoads(std::max(0, newSize.x * newSize.y));
+    if(drawCache_.isValid)
+    {
+        const Position oldSize = drawCache_.lastPt - drawCache_.firstPt + Position(1, 1);
+        // Copy the overlapping part. Entries are relative to the view position, so they stay valid when scrolling
+        const Position overlapStart = elMax(firstPt, drawCache_.firstPt);
+        const Position overlapEnd = elMin(lastPt, drawCache_.lastPt);
+        for(int y = overlapStart.y; y <= overlapEnd.y; ++y)
+        {
+            for(int x = overlapStart.x; x <= overlapEnd.x; ++x)
             {
-                if(!tiles[i])
-                    continue;
-                if(tiles[i] == lastBorder)
-                {
-                    BorderTile& curTile = sorted_borders[lastBorder - 1].back();
-                    // Check that we did not wrap around the map and the expected offset matches
-                    if(curTile.tileOffset + curTile.count == offsets[i])
-                    {
-                        ++curTile.count;
-                        continue;
-                    }
-                }
-                lastBorder = tiles[i];
-                BorderTile tmp(offsets[i], posOffset);
-                sorted_borders[lastBorder - 1].push_back(tmp);
+                newNodeRoads[(y - firstPt.y) * newSize.x + x - firstPt.x] =
+                  drawCache_.nodeRoads[(y - drawCache_.firstPt.y) * oldSize.x + x - drawCache_.firstPt.x];
             }
+        }
+    }
+    drawCache_.nodeRoads.swap(newNodeRoads);
+}
 
-            PrepareWaysPoint(sorted_roads, gwv, tP, posOffset);
-
-            lastOffset = posOffset;
+void TerrainRenderer::InvalidateRoads(const MapPoint pt, const unsigned radius)
+{
+    DrawCache& cache = drawCache_;
+    if(!cache.isValid || cache.allRoadsDirty)
+        return;
+    // Roads are drawn from a point to its neighbours so the neighbours need to be updated too
+    cache.dirtyPts.push_back(pt);
+    for(unsigned i = 0; i < Direction::COUNT; ++i)
+    {
+        const MapPoint nb = GetNeighbour(pt, Direction::fromInt(i));
+        cache.dirtyPts.push_back(nb);
+        if(radius > 1)
+        {
+            for(unsigned j = 0; j < Direction::COUNT; ++j)
+                cache.dirtyPts.push_back(GetNeighbour(nb, Direction::fromInt(j)));
         }
     }
+    // Many changes (e.g. large visibility changes) -> Recalculate everything
+    if(cache.dirtyPts.size() > cache.nodeRoads.size() / 2u)
+    {
+        cache.allRoadsDirty = true;
+        cache.dirtyPts.clear();
+    }
+}
 
-    if(water)
+void TerrainRenderer::InvalidateCachedRoads(const MapPoint pt) const
+{
+    DrawCache& cache = drawCache_;
+    const Position viewSize = cache.lastPt - cache.firstPt + Position(1, 1);
+    // Offset of the first view node showing this point. On small maps a point might be shown multiple times
+    const Position firstOffset((static_cast<int>(pt.x) - cache.firstPt.x) % size_.x, (static_cast<int>(pt.y) - cache.firstPt.y) % size_.y);
+    const Position start(firstOffset.x < 0 ? firstOffset.x + size_.x : firstOffset.x,
+                         firstOffset.y < 0 ? firstOffset.y + size_.y : firstOffset.y);
+    for(int y = start.y; y < viewSize.y; y += size_.y)
+    {
+        for(int x = start.x; x < viewSize.x; x += size_.x)
+            cache.nodeRoads[y * viewSize.x + x].valid = false;
+    }
+}
+
+void TerrainRenderer::UpdateDrawCache(const Position& firstPt, const Position& lastPt, const GameWorldViewer& gwv) const
+{
+    DrawCache& cache = drawCache_;
+    if(!cache.isValid || firstPt != cache.firstPt || lastPt != cache.lastPt)
+    {
+        PrepareTerrain(firstPt, lastPt, gwv);
+        MoveCachedRoads(firstPt, lastPt);
+        cache.firstPt = firstPt;
+        cache.lastPt = lastPt;
+        cache.isValid = true;
+        cache.roadsChanged = true;
+    }
+
+    if(cache.allRoadsDirty)
+    {
+        for(NodeRoads& nodeRoads : cache.nodeRoads)
+            nodeRoads.valid = false;
+        cache.allRoadsDirty = false;
+        cache.roadsChanged = true;
+    } else if(!cache.dirtyPts.empty())
+    {
+        for(const MapPoint& pt : cache.dirtyPts)
+            InvalidateCachedRoads(pt);
+        cache.roadsChanged = true;
+    }
+    cache.dirtyPts.clear();
+
+    if(!cache.roadsChanged)
+        return;
+
+    cache.sorted_roads.resize(roadTextures.size());
+    for(std::vector<PreparedRoad>& roads : cache.sorted_roads)
+        roads.clear();
+    auto itNodeRoads = cache.nodeRoads.begin();
+    for(int y = firstPt.y; y <= lastPt.y; ++y)
     {
-        unsigned water_count = 0;
-        const WorldDescription& desc = gwv.GetWorld().GetDescription();
-        for(DescIdx<TerrainDesc> t(0); t.value < sorted_textures.size(); ++t.value)
+        for(int x = firstPt.x; x <= lastPt.x; ++x, ++itNodeRoads)
         {
-            if(desc.get(t).kind != TerrainKind::WATER)
-                continue;
-            for(const MapTile& tile : sorted_textures[t.value])
-                water_count += tile.count;
+            if(!itNodeRoads->valid)
+            {
+                Position posOffset;
+                MapPoint tP = ConvertCoords(Position(x, y), &posOffset);
+                PrepareWaysPoint(*itNodeRoads, gwv, tP, posOffset);
+            }
+            for(unsigned i = 0; i < itNodeRoads->count; ++i)
+                cache.sorted_roads[itNodeRoads->gfxRoadTypes[i]].push_back(itNodeRoads->roads[i]);
         }
+    }
+    cache.roadsChanged = false;
+}
+
+/**
+ *  zeichnet den Kartenausschnitt.
+ */
+void TerrainRenderer::Draw(const Position& firstPt, const Position& lastPt, const GameWorldViewer& gwv, unsigned* water) const
+{
+    RTTR_Assert(!gl_vertices.empty());
+    RTTR_Assert(!borders.empty());
 
+    UpdateDrawCache(firstPt, lastPt, gwv);
+    const std::vector<std::vector<MapTile>>& sorted_textures = drawCache_.sorted_textures;
+    const std::vector<std::vector<BorderTile>>& sorted_borders = drawCache_.sorted_borders;
+
+    if(water)
+    {
         Position diff = lastPt - firstPt;
         if(diff.x && diff.y)
-            *water = 50 * water_count / (diff.x * diff.y);
+            *water = 50 * drawCache_.waterCount / (diff.x * diff.y);
         else
             *water = 0;
     }
 
-    lastOffset = Position(0, 0);
+    Position lastOffset(0, 0);
 
     // Arrays aktivieren
     glEnableClientState(GL_COLOR_ARRAY);
@@ -853,7 +1078,7 @@ void TerrainRenderer::Draw(const Position& firstPt, const Position& lastPt, cons
     if(vbo_vertices.isValid())
         vbo_vertices.unbind();
 
-    DrawWays(sorted_roads);
+    DrawWays(drawCache_.sorted_roads);
 
     glDisableClientState(GL_COLOR_ARRAY);
     // Wieder zurück ins normale modulate
@@ -873,9 +1098,11 @@ MapPoint TerrainRenderer::ConvertCoords(const Position pt, Position* offset) con
     return ptOut;
 }
 
-void TerrainRenderer::PrepareWaysPoint(PreparedRoads& sorted_roads, const GameWorldViewer& gwViewer, MapPoint pt,
-                                       const Position& offset) const
+void TerrainRenderer::PrepareWaysPoint(NodeRoads& nodeRoads, const GameWorldViewer& gwViewer, MapPoint pt, const Position& offset) const
 {
+    nodeRoads.valid = true;
+    nodeRoads.count = 0;
+
     const WorldDescription& desc = gwViewer.GetWorld().GetDescription();
     Position startPos = Position(GetVertexPos(pt)) + offset;
 
@@ -939,7 +1166,9 @@ void TerrainRenderer::PrepareWaysPoint(PreparedRoads& sorted_roads, const GameWo
             }
         }
 
-        sorted_roads[gfxRoadType].push_back(PreparedRoad(startPos, endPos, GetColor(pt), GetColor(ta), dir));
+        nodeRoads.gfxRoadTypes[nodeRoads.count] = gfxRoadType;
+        nodeRoads.roads[nodeRoads.count] = PreparedRoad(startPos, endPos, GetColor(pt), GetColor(ta), dir);
+        ++nodeRoads.count;
     }
 }
 
@@ -1068,6 +1297,9 @@ void TerrainRenderer::AltitudeChanged(const MapPoint pt, const GameWorldViewer&
 
     for(unsigned i = 0; i < 12; ++i)
         UpdateBorderTriangleColor(gwv.GetWorld().GetNeighbour2(pt, i), true);
+
+    // Positions and colors of the roads changed
+    InvalidateRoads(pt, 2);
 }
 
 void TerrainRenderer::VisibilityChanged(const MapPoint pt, const GameWorldViewer& gwv)
@@ -1094,6 +1326,14 @@ void TerrainRenderer::VisibilityChanged(const MapPoint pt, const GameWorldViewer
     UpdateBorderTriangleColor(pt, true);
     for(unsigned i = 0; i < 6; ++i)
         UpdateBorderTriangleColor(gwv.GetNeighbour(pt, Direction::fromInt(i)), true);
+
+    // Visible roads and their colors changed
+    InvalidateRoads(pt, 2);
+}
+
+void TerrainRenderer::RoadChanged(const MapPoint pt)
+{
+    InvalidateRoads(pt, 1);
 }
 
 void TerrainRenderer::UpdateAllColors(const GameWorldViewer& gwv)
@@ -1115,6 +1355,9 @@ void TerrainRenderer::UpdateAllColors(const GameWorldViewer& gwv)
         vbo_colors.update(gl_colors);
         vbo_colors.unbind();
     }
+
+    if(drawCache_.isValid)
+        drawCache_.allRoadsDirty = true;
 }
 
 MapPoint TerrainRenderer::GetNeighbour(const MapPoint& pt, const Direction dir) const
@@ -64,6 +64,8 @@ public:
     void AltitudeChanged(MapPoint pt, const GameWorldViewer& gwv);
     /// Callback function for visibility changes
     void VisibilityChanged(MapPoint pt, const GameWorldViewer& gwv);
+    /// Callback function for changes of (visible) roads
+    void RoadChanged(MapPoint pt);
 
     /// Recalculates all colors on the map
     void UpdateAllColors(const GameWorldViewer& gwv);
@@ -91,11 +93,22 @@ private:
         float color1, color2;
         unsigned char dir;
 
+        PreparedRoad() : color1(0), color2(0), dir(0) {}
         PreparedRoad(Position pos, Position pos2, float color1, float color2, unsigned char dir)
             : pos(pos), pos2(pos2), color1(color1), color2(color2), dir(dir)
         {}
     };
 
+    /// Roads starting at a node (at most 3) with their gfx road type
+    struct NodeRoads
+    {
+        bool valid;
+        unsigned char count;
+        std::array<unsigned char, 3> gfxRoadTypes;
+        std::array<PreparedRoad, 3> roads;
+        NodeRoads() : valid(false), count(0), gfxRoadTypes() {}
+    };
+
     struct Vertex
     {
         PointF pos; // Position vom jeweiligen Punkt
@@ -132,6 +145,48 @@ private:
 
     using PreparedRoads = std::vector<std::vector<PreparedRoad>>;
 
+    /// Run of consecutive triangles using the same texture in one row of the view
+    struct TerrainRun
+    {
+        unsigned char texture;
+        unsigned tileOffset;
+        unsigned count;
+        Position posOffset;
+        /// View x of the nodes of the first and last triangle
+        int firstX, lastX;
+    };
+    /// Terrain and border runs of one row of the view from left to right
+    struct TerrainRow
+    {
+        std::vector<TerrainRun> tiles, borders;
+    };
+
+    /// Draw lists of the last drawn view rectangle which are reused in the next frames.
+    /// Terrain and border runs only depend on the view and are cached per view row, so scrolling only prepares the new rows/columns.
+    /// Roads are cached per view node and recalculated when they changed
+    struct DrawCache
+    {
+        /// View rectangle the lists were created for (only valid if isValid)
+        Position firstPt, lastPt;
+        bool isValid;
+        /// Runs of each row of the view (starting at firstPt.y)
+        std::vector<TerrainRow> terrainRows;
+        std::vector<std::vector<MapTile>> sorted_textures;
+        std::vector<std::vector<BorderTile>> sorted_borders;
+        /// Number of water triangles in sorted_textures
+        unsigned waterCount;
+        /// Roads of each node of the view (row-major, starting at firstPt)
+        std::vector<NodeRoads> nodeRoads;
+        PreparedRoads sorted_roads;
+        /// True if sorted_roads must be rebuilt from nodeRoads
+        bool roadsChanged;
+        /// Points whose roads (or roads of neighbours) have to be recalculated
+        std::vector<MapPoint> dirtyPts;
+        /// Recalculate roads of all nodes
+        bool allRoadsDirty;
+        DrawCache() : isValid(false), waterCount(0), roadsChanged(false), allRoadsDirty(false) {}
+    };
+
     /// Size of the map
     MapExtent size_;
     /// Map sized array of vertex related data
@@ -155,6 +210,8 @@ private:
     /// Flat 2D array: [Landscape][RoadType]
     std::vector<BmpPtr> roadTextures;
 
+    mutable DrawCache drawCache_;
+
     /// Returns the index of a vertex. Used to access vertices and borders
     unsigned GetVertexIdx(const MapPoint pt) const
     {
@@ -198,8 +255,28 @@ private:
     /// liefert den Rand-Vertex-Farbwert an der Stelle X,Y
     float GetBorderColor(const MapPoint pt, unsigned char triangle) const { return GetVertex(pt).borderColor[triangle]; }
 
+    /// Brings the draw cache up to date for the given view rectangle
+    void UpdateDrawCache(const Position& firstPt, const Position& lastPt, const GameWorldViewer& gwv) const;
+    /// Fills the terrain and border lists of the draw cache for the given view rectangle
+    void PrepareTerrain(const Position& firstPt, const Position& lastPt, const GameWorldViewer& gwv) const;
+    /// Adds the runs of the nodes from firstX to lastX in the view row y
+    void PrepareTerrainRow(TerrainRow& row, int y, int firstX, int lastX) const;
+    /// Removes the runs (or parts) of nodes outside of firstX to lastX from the view row y
+    void TrimTerrainRow(TerrainRow& row, int y, int firstX, int lastX) const;
+    /// Gets the offset of the first or last border triangle of the node. Returns false if there is none
+    bool GetBorderOffset(MapPoint pt, bool getFirst, unsigned& offset) const;
+    /// Adds the triangle to the last run if it continues it or starts a new one
+    static void AddToRuns(std::vector<TerrainRun>& runs, unsigned char texture, unsigned offset, const Position& posOffset, int x);
+    /// Appends runs of the nodes right of the existing runs
+    static void AppendRuns(std::vector<TerrainRun>& runs, const std::vector<TerrainRun>& newRuns);
+    /// Keeps the cached roads of nodes which are still in the new view rectangle (rows/columns scrolled in are invalid)
+    void MoveCachedRoads(const Position& firstPt, const Position& lastPt) const;
+    /// Marks the roads at the given point and its neighbours in the given radius (1 or 2) for recalculation
+    void InvalidateRoads(MapPoint pt, unsigned radius);
+    /// Invalidates the cached roads at all view nodes showing the given point
+    void InvalidateCachedRoads(MapPoint pt) const;
     /// Adds possible roads from the given point to the prepared data struct
-    void PrepareWaysPoint(PreparedRoads& sorted_roads, const GameWorldViewer& gwViewer, MapPoint pt, const Position& offset) const;
+    void PrepareWaysPoint(NodeRoads& nodeRoads, const GameWorldViewer& gwViewer, MapPoint pt, const Position& offset) const;
     /// Draw the prepared roads
     void DrawWays(const PreparedRoads& sorted_roads) const;
 };
@@ -19,12 +19,12 @@
 #define TradePathCache_h__
 
 #include "world/TradePath.h"
-#include "libutil/Singleton.h"
 #include <array>
 
 class GameWorldGame;
 
-class TradePathCache : public Singleton<TradePathCache>
+/// Remembers the recently found trade pathes. Owned by the world
+class TradePathCache
 {
     struct Entry
     {
@@ -21,6 +21,8 @@
 
 #include "AIInterface.h"
 #include "GameCommand.h"
+#include <string>
+#include <vector>
 
 class GameWorldBase;
 class GamePlayer;
@@ -38,6 +40,8 @@ public:
 
     /// Called for every GF
     virtual void RunGF(unsigned gf, bool gfisnwf) = 0;
+    /// Return true if RunGF does nothing (anymore) and no commands are waiting to be fetched, so GFs may be skipped
+    virtual bool IsIdle() const { return false; }
 
     const std::string& GetPlayerName() const { return player.name; }
     unsigned char GetPlayerId() const { return playerId; }
@@ -49,6 +53,13 @@ public:
         std::swap(tmp, gcs);
         return tmp;
     }
+    /// Get the chat messages (to all players) and mark them as sent
+    std::vector<std::string> FetchChatMessages()
+    {
+        std::vector<std::string> tmp;
+        std::swap(tmp, chatMsgs);
+        return tmp;
+    }
 
     // access to ais CommandFactory
     const AIInterface& getAIInterface() const { return aii; }
@@ -67,6 +78,8 @@ public:
 protected:
     /// Queue der GameCommands, die noch bearbeitet werden müssen
     std::vector<gc::GameCommandPtr> gcs;
+    /// Chat messages that still need to be sent. The AI does not know about the network so the client sends them
+    std::vector<std::string> chatMsgs;
     /// Stärke der KI
     const AI::Level level;
     /// Abstrahiertes Interfaces, leitet Befehle weiter an
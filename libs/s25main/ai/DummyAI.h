@@ -30,6 +30,7 @@ public:
     DummyAI(unsigned char playerId, const GameWorldBase& gwb, const AI::Level level) : AIPlayer(playerId, gwb, level) {}
 
     void RunGF(unsigned /*gf*/, bool /*gfisnwf*/) override {}
+    bool IsIdle() const override { return true; }
 };
 
 #endif //! DUMMYAI_H_INCLUDED
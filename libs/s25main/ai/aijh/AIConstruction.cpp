@@ -18,6 +18,7 @@
 #include "rttrDefines.h" // IWYU pragma: keep
 #include "AIConstruction.h"
 #include "BuildingPlanner.h"
+#include "EventManager.h"
 #include "GlobalGameSettings.h"
 #include "Jobs.h"
 #include "Point.h"
@@ -30,6 +31,9 @@
 #include "buildings/nobMilitary.h"
 #include "buildings/nobUsual.h"
 #include "helpers/containerUtils.h"
+#include "pathfinding/PathConditionRoad.h"
+#include "pathfinding/RoadPathFinder.h"
+#include "world/GameWorldBase.h"
 #include "nodeObjs/noFlag.h"
 #include "nodeObjs/noRoadNode.h"
 #include "gameTypes/BuildingQuality.h"
@@ -49,7 +53,8 @@
 namespace AIJH {
 
 AIConstruction::AIConstruction(AIPlayerJH& aijh)
-    : aijh(aijh), aii(aijh.GetInterface()), bldPlanner(aijh.GetBldPlanner()), constructionorders(NUM_BUILDING_TYPES)
+    : aijh(aijh), aii(aijh.GetInterface()), bldPlanner(aijh.GetBldPlanner()), constructionorders(NUM_BUILDING_TYPES), newRoadVisit(0),
+      roadCostsGF(0)
 {}
 
 AIConstruction::~AIConstruction()
@@ -275,13 +280,137 @@ bool AIConstruction::MilitaryBuildingWantsRoad(const nobMilitary& milbld)
     return bldIdx > static_cast<int>(aii.GetMilitaryBuildings().size() - aijh.GetNumPlannedConnectedInlandMilitaryBlds());
 }
 
-bool AIConstruction::ConnectFlagToRoadSytem(const noFlag* flag, std::vector<Direction>& route, unsigned maxSearchRadius /*= 14*/)
+std::vector<AIConstruction::NewRoadTarget> AIConstruction::FindNewRoadTargets(const noFlag& flag, unsigned maxSearchRadius)
 {
-    // TODO: die methode kann  ganz schön böse Laufzeiten bekommen... Optimieren?
+    // Maximum length of the new road
+    const unsigned maxLength = 100;
+    // One layer for the points reached after an even and one for those after an odd number of steps
+    const unsigned numLayers = 2;
+
+    const GameWorldBase& gwb = aii.gwb;
+    const MapPoint startPt = flag.GetPos();
+    const std::vector<const noFlag*> flags = FindFlags(startPt, maxSearchRadius);
+    if(flags.empty())
+        return std::vector<NewRoadTarget>();
+
+    const unsigned numNodes = prodOfComponents(gwb.GetSize()) * numLayers;
+    if(newRoadNodes.size() != numNodes)
+    {
+        newRoadNodes.clear();
+        newRoadNodes.resize(numNodes, NewRoadNode{0, 0, 0, Direction::WEST, MapPoint::Invalid()});
+        newRoadVisit = 0;
+    }
+    if(++newRoadVisit == std::numeric_limits<unsigned>::max())
+    {
+        for(NewRoadNode& node : newRoadNodes)
+            node.lastVisit = 0;
+        newRoadVisit = 1;
+    }
 
-    // Radius in dem nach würdigen Fahnen gesucht wird
-    // const unsigned short maxSearchRadius = 10;
+    const auto pathCondition = makePathConditionRoad(gwb, false);
+    const unsigned startIdx = gwb.GetIdx(startPt) * numLayers;
+    newRoadNodes[startIdx].lastVisit = newRoadVisit;
+    newRoadNodes[startIdx].length = 0;
+    newRoadNodes[startIdx].pt = startPt;
+    // Check if a point on an even step of the route is too close to one of the others on the route
+    const auto isTooCloseToEvenPts = [this, &gwb, startIdx](unsigned nodeIdx, const MapPoint pt) {
+        for(; nodeIdx != startIdx; nodeIdx = newRoadNodes[nodeIdx].prev)
+        {
+            const NewRoadNode& node = newRoadNodes[nodeIdx];
+            if(node.length % 2 == 0 && gwb.CalcDistance(pt, node.pt) < 2)
+                return true;
+        }
+        return false;
+    };
+
+    std::vector<NewRoadTarget> targets;
+    unsigned numFlagsLeft = flags.size();
+    // Same conditions and order of directions as AIInterface::FindFreePathForNewRoad but for all flags at once.
+    // Nodes are pushed in order of their length (BFS) so a simple queue suffices
+    std::deque<unsigned> todo(1, startIdx);
+    while(!todo.empty() && numFlagsLeft > 0)
+    {
+        const unsigned curIdx = todo.front();
+        todo.pop_front();
+        const NewRoadNode& curNode = newRoadNodes[curIdx];
+        if(curNode.length >= maxLength)
+            continue;
+        const unsigned nextLength = curNode.length + 1u;
+        // Even steps need space for a flag, so a flag can be placed on every 2nd point of the road
+        const bool isEvenStep = nextLength % 2 == 0;
+        for(unsigned iDir = 0; iDir < Direction::COUNT; iDir++)
+        {
+            const Direction dir(Direction::EAST + iDir);
+            const MapPoint nextPt = gwb.GetNeighbour(curNode.pt, dir);
+            if(nextPt == startPt)
+                continue;
+            const unsigned nextPtIdx = gwb.GetIdx(nextPt);
+            const auto* nextFlag = gwb.GetSpecObj<noFlag>(nextPt);
+            if(nextFlag)
+            {
+                // Flags are the targets and end the road. Use the first (shortest) route found
+                NewRoadNode& flagNode = newRoadNodes[nextPtIdx * numLayers];
+                if(flagNode.lastVisit == newRoadVisit || nextFlag->GetPlayer() != aii.GetPlayerId()
+                   || gwb.CalcDistance(startPt, nextPt) > maxSearchRadius)
+                    continue;
+                // The even points must not be next to the target flag. Another route might still reach it
+                if(isTooCloseToEvenPts(curIdx, nextPt))
+                    continue;
+                flagNode.lastVisit = newRoadVisit;
+                NewRoadTarget target{nextFlag, std::vector<Direction>(nextLength)};
+                target.route.back() = dir;
+                for(unsigned idx = curIdx; idx != startIdx; idx = newRoadNodes[idx].prev)
+                    target.route[newRoadNodes[idx].length - 1u] = newRoadNodes[idx].dir;
+                targets.push_back(std::move(target));
+                numFlagsLeft--;
+                continue;
+            }
+            const unsigned nextIdx = nextPtIdx * numLayers + nextLength % 2;
+            NewRoadNode& nextNode = newRoadNodes[nextIdx];
+            if(nextNode.lastVisit == newRoadVisit || !pathCondition.IsNodeOk(nextPt))
+                continue;
+            if(isEvenStep
+               && (gwb.GetBQ(nextPt, gwb.GetNode(nextPt).owner - 1) == BQ_NOTHING || gwb.CalcDistance(nextPt, startPt) < 2
+                   || isTooCloseToEvenPts(curIdx, nextPt)))
+                continue;
+            nextNode.lastVisit = newRoadVisit;
+            nextNode.prev = curIdx;
+            nextNode.length = nextLength;
+            nextNode.dir = dir;
+            nextNode.pt = nextPt;
+            todo.push_back(nextIdx);
+        }
+    }
+    // Same order as the flags so equally good targets are chosen as before
+    std::sort(targets.begin(), targets.end(), [&flags](const NewRoadTarget& lhs, const NewRoadTarget& rhs) {
+        return helpers::indexOf(flags, lhs.flag) < helpers::indexOf(flags, rhs.flag);
+    });
+    return targets;
+}
+
+const std::vector<unsigned>& AIConstruction::GetRoadCostsToFlag(const noFlag& targetFlag)
+{
+    const unsigned curGF = aii.gwb.GetEvMgr().GetCurrentGF();
+    if(curGF != roadCostsGF)
+    {
+        roadCosts.clear();
+        roadCostsGF = curGF;
+    }
+    auto it = roadCosts.find(targetFlag.GetObjId());
+    if(it == roadCosts.end())
+    {
+        // Roads (without boat roads) can be used in both directions with the same costs
+        // so the costs from the target to all flags equal the costs from all flags to the target
+        std::vector<unsigned> costs(prodOfComponents(aii.gwb.GetSize()), std::numeric_limits<unsigned>::max());
+        for(const auto& nodeAndCosts : aii.gwb.GetRoadPathFinder().FindAllCosts(targetFlag))
+            costs[aii.gwb.GetIdx(nodeAndCosts.first->GetPos())] = nodeAndCosts.second;
+        it = roadCosts.emplace(targetFlag.GetObjId(), std::move(costs)).first;
+    }
+    return it->second;
+}
 
+bool AIConstruction::ConnectFlagToRoadSytem(const noFlag* flag, std::vector<Direction>& route, unsigned maxSearchRadius /*= 14*/)
+{
     // flag of a military building? -> check if we really want to connect this right now
     const MapPoint bldPos = aii.gwb.GetNeighbour(flag->GetPos(), Direction::NORTHWEST);
     if(const auto* milBld = aii.gwb.GetSpecObj<const nobMilitary>(bldPos))
@@ -297,39 +426,43 @@ bool AIConstruction::ConnectFlagToRoadSytem(const noFlag* flag, std::vector<Dire
     if(!targetFlag)
         return false;
 
-    // Flaggen in der Umgebung holen
-    std::vector<const noFlag*> flags = FindFlags(flag->GetPos(), maxSearchRadius);
+    const std::vector<unsigned>& roadCostsToTarget = GetRoadCostsToFlag(*targetFlag);
+    // Sind wir schon verbunden? Dann ist es auch jede Fahne mit Anschluß an das Lager
+    if(roadCostsToTarget[aii.gwb.GetIdx(flag->GetPos())] != std::numeric_limits<unsigned>::max())
+        return false;
+
+    // Alle erreichbaren Fahnen in der Umgebung mit einer Suche holen
+    std::vector<NewRoadTarget> targets = FindNewRoadTargets(*flag, maxSearchRadius);
 
 #ifdef DEBUG_AI
-    std::cout << "FindFlagsNum: " << flags.size() << std::endl;
+    std::cout << "FindNewRoadTargetsNum: " << targets.size() << std::endl;
 #endif
 
-    const noFlag* shortest = nullptr;
+    NewRoadTarget* shortest = nullptr;
     unsigned shortestLength = 99999;
-    std::vector<Direction> tmpRoute;
 
     // Jede Flagge testen...
-    for(const noFlag* curFlag : flags)
+    for(NewRoadTarget& target : targets)
     {
-        tmpRoute.clear();
-        unsigned length;
+        const noFlag* curFlag = target.flag;
         // the flag should not be at a military building!
         if(aii.gwb.IsMilitaryBuildingOnNode(aii.gwb.GetNeighbour(curFlag->GetPos(), Direction::NORTHWEST), true))
             continue;
-        // Gibts überhaupt einen Pfad zu dieser Flagge
-        if(!aii.FindFreePathForNewRoad(flag->GetPos(), curFlag->GetPos(), &tmpRoute, &length))
+
+        // Gewählte Fahne hat leider auch kein Anschluß an ein Lager, zu schade!
+        const unsigned distance = roadCostsToTarget[aii.gwb.GetIdx(curFlag->GetPos())];
+        if(distance == std::numeric_limits<unsigned>::max())
             continue;
 
-        // Wenn ja, dann gucken ob dieser Pfad möglichst kurz zum "höheren" Ziel (allgemeines Lager im Moment) ist
+        // Longest run of non-flag points on the planned route
         unsigned maxNonFlagPts = 0;
-        // check for non-flag points on planned route: more than 2 nonflaggable spaces on the route -> not really valid path
         unsigned curNonFlagPts = 0;
         MapPoint tmpPos = flag->GetPos();
-        for(auto j : tmpRoute)
+        for(const Direction dir : target.route)
         {
-            tmpPos = aii.gwb.GetNeighbour(tmpPos, j);
+            tmpPos = aii.gwb.GetNeighbour(tmpPos, dir);
             RTTR_Assert(aii.GetBuildingQuality(tmpPos) == aijh.GetAINode(tmpPos).bq);
-            if(aii.GetBuildingQuality(tmpPos) == BQ_NOTHING)
+            if(aijh.GetAINode(tmpPos).bq == BQ_NOTHING)
                 curNonFlagPts++;
             else
             {
@@ -338,40 +471,30 @@ bool AIConstruction::ConnectFlagToRoadSytem(const noFlag* flag, std::vector<Dire
                 curNonFlagPts = 0;
             }
         }
+        // More than 2 non-flag points on the route -> not really a valid path
         if(maxNonFlagPts > 2)
             continue;
 
-        // Find path from current flag to target. If the current flag IS the target then we have already a path with distance=0
-        unsigned distance = 0;
-        bool pathFound = curFlag == targetFlag || aii.FindPathOnRoads(*curFlag, *targetFlag, &distance);
-
-        // Gewählte Fahne hat leider auch kein Anschluß an ein Lager, zu schade!
-        if(!pathFound)
-            continue;
-
-        // Sind wir mit der Fahne schon verbunden? Einmal reicht!
-        if(aii.FindPathOnRoads(*curFlag, *flag))
-            continue;
-
         // Kürzer als der letzte? Nehmen! Existierende Strecke höher gewichten (2), damit möglichst kurze Baustrecken
         // bevorzugt werden bei ähnlich langen Wegmöglichkeiten
+        const unsigned length = target.route.size();
         if(2 * length + distance + 10 * maxNonFlagPts < shortestLength)
         {
-            shortest = curFlag;
+            shortest = &target;
             shortestLength = 2 * length + distance + 10 * maxNonFlagPts;
-            route = tmpRoute;
         }
     }
 
     if(shortest)
     {
+        route = std::move(shortest->route);
         // LOG.write(("ai build main road player %i at %i %i\n", flag->GetPlayer(), flag->GetPos());
-        if(!MinorRoadImprovements(flag, shortest, route))
+        if(!MinorRoadImprovements(flag, shortest->flag, route))
             return false;
         // add new construction area to the list of active orders in the current nwf
         // to wait till path is constructed
         constructionlocations.push_back(flag->GetPos());
-        constructionlocations.push_back(shortest->GetPos());
+        constructionlocations.push_back(shortest->flag->GetPos());
         return true;
     }
     return false;
@@ -23,6 +23,7 @@
 #include "gameTypes/Direction.h"
 #include "gameTypes/MapCoordinates.h"
 #include <deque>
+#include <map>
 #include <vector>
 
 class AIInterface;
@@ -97,6 +98,31 @@ public:
     void ConstructionsExecuted();
 
 private:
+    /// Node of the search for new roads. There is one per map point reached after an even and an odd number of steps
+    struct NewRoadNode
+    {
+        unsigned lastVisit;
+        /// Index of the previous search node
+        unsigned prev;
+        unsigned length;
+        Direction dir;
+        MapPoint pt;
+    };
+    /// Candidate found by FindNewRoadTargets
+    struct NewRoadTarget
+    {
+        const noFlag* flag;
+        std::vector<Direction> route;
+    };
+
+    /// Searches free road paths from the flag to all own flags within maxSearchRadius in one pass with the conditions of
+    /// AIInterface::FindFreePathForNewRoad (flag space on every even step). Every flag is returned once with the shortest route.
+    /// Ordered like FindFlags
+    std::vector<NewRoadTarget> FindNewRoadTargets(const noFlag& flag, unsigned maxSearchRadius);
+    /// Return the road costs from all flags connected to the target flag indexed by map point (unreachable = max value)
+    /// Calculated in one search and cached for the current GF as the world does not change while the AI runs
+    const std::vector<unsigned>& GetRoadCostsToFlag(const noFlag& targetFlag);
+
     AIPlayerJH& aijh;
     AIInterface& aii;
     const BuildingPlanner& bldPlanner;
@@ -108,6 +134,12 @@ private:
     std::deque<MapPoint> constructionlocations;
     // contains the type and amount of buildings ordered since the last nwf
     std::vector<uint8_t> constructionorders;
+    /// Nodes for FindNewRoadTargets, 2 per map point
+    std::vector<NewRoadNode> newRoadNodes;
+    unsigned newRoadVisit;
+    /// Road costs to target flags (by object id) valid in roadCostsGF
+    std::map<unsigned, std::vector<unsigned>> roadCosts;
+    unsigned roadCostsGF;
 };
 
 } // namespace AIJH
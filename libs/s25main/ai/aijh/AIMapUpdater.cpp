@@ -0,0 +1,88 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "AIMapUpdater.h"
+#include "ai/aijh/AIMap.h"
+#include "ai/aijh/AIReachability.h"
+#include "notifications/NodeNote.h"
+#include "world/GameWorldBase.h"
+
+namespace AIJH {
+
+AIMapUpdater::AIMapUpdater(const GameWorldBase& gwb, unsigned char playerId, AIMap& aiMap, AIReachability& reachability)
+    : gwb(gwb), playerId(playerId), aiMap(aiMap), reachability(reachability)
+{}
+
+void AIMapUpdater::Init()
+{
+    isDirty.clear();
+    isDirty.resize(prodOfComponents(aiMap.GetSize()), false);
+    dirtyPts.clear();
+    RTTR_FOREACH_PT(MapPoint, aiMap.GetSize())
+        RefreshNode(pt);
+    reachability.Init();
+}
+
+void AIMapUpdater::OnNodeChanged(const NodeNote& note)
+{
+    switch(note.type)
+    {
+        case NodeNote::Altitude:
+        case NodeNote::Object: return;
+        // The BQ of a player depends on the objects of the neighbours (e.g. flags)
+        case NodeNote::BQ: MarkDirty(note.pos, 1); break;
+        case NodeNote::Road: break;
+        // Border stones and the BQ depend on the owners of the neighbours and the neighbours of the SE neighbour
+        case NodeNote::Owner: MarkDirty(note.pos, 2); break;
+    }
+    reachability.MarkDirty(note.pos);
+}
+
+void AIMapUpdater::MarkDirty(const MapPoint pt, unsigned radius)
+{
+    for(const MapPoint& curPt : gwb.GetPointsInRadiusWithCenter(pt, radius))
+    {
+        const unsigned idx = aiMap.GetIdx(curPt);
+        if(!isDirty[idx])
+        {
+            isDirty[idx] = true;
+            dirtyPts.push_back(curPt);
+        }
+    }
+}
+
+void AIMapUpdater::Update()
+{
+    for(const MapPoint& pt : dirtyPts)
+    {
+        isDirty[aiMap.GetIdx(pt)] = false;
+        RefreshNode(pt);
+    }
+    dirtyPts.clear();
+    reachability.Update();
+}
+
+void AIMapUpdater::RefreshNode(const MapPoint pt)
+{
+    Node& node = aiMap[pt];
+    node.bq = gwb.GetBQ(pt, playerId);
+    node.owned = gwb.GetNode(pt).owner == playerId + 1;
+    node.border = gwb.GetNode(pt).boundary_stones[0] == playerId + 1;
+}
+
+} // namespace AIJH
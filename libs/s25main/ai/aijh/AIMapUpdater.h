@@ -0,0 +1,63 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef AIMapUpdater_h__
+#define AIMapUpdater_h__
+
+#include "gameTypes/MapCoordinates.h"
+#include <vector>
+
+class GameWorldBase;
+struct NodeNote;
+
+namespace AIJH {
+
+class AIMap;
+class AIReachability;
+
+/// Keeps the world dependent values of the AI nodes (bq, owned, border and reachable) up to date.
+/// Changes of the world are collected from the notifications (each point only once) and the affected nodes are
+/// refreshed in one batch on Update
+class AIMapUpdater
+{
+public:
+    AIMapUpdater(const GameWorldBase& gwb, unsigned char playerId, AIMap& aiMap, AIReachability& reachability);
+
+    /// Recalculate all nodes of the (resized) map
+    void Init();
+    /// Mark the nodes that depend on the changed node
+    void OnNodeChanged(const NodeNote& note);
+    bool HasDirtyNodes() const { return !dirtyPts.empty(); }
+    /// Refresh all nodes marked since the last update
+    void Update();
+
+private:
+    const GameWorldBase& gwb;
+    const unsigned char playerId;
+    AIMap& aiMap;
+    AIReachability& reachability;
+    /// Nodes to refresh on the next update. isDirty avoids duplicates
+    std::vector<bool> isDirty;
+    std::vector<MapPoint> dirtyPts;
+
+    void MarkDirty(MapPoint pt, unsigned radius);
+    void RefreshNode(MapPoint pt);
+};
+
+} // namespace AIJH
+
+#endif // AIMapUpdater_h__
@@ -21,7 +21,9 @@
 #include "BuildingPlanner.h"
 #include "FindWhConditions.h"
 #include "GamePlayer.h"
+#include "GlobalGameSettings.h"
 #include "Jobs.h"
+#include "SimProfiler.h"
 #include "addons/const_addons.h"
 #include "ai/AIEvents.h"
 #include "boost/filesystem/fstream.hpp"
@@ -30,15 +32,12 @@
 #include "buildings/nobMilitary.h"
 #include "buildings/nobUsual.h"
 #include "helpers/containerUtils.h"
-#include "network/GameClient.h"
-#include "network/GameMessages.h"
 #include "notifications/BuildingNote.h"
 #include "notifications/ExpeditionNote.h"
 #include "notifications/NodeNote.h"
 #include "notifications/ResourceNote.h"
 #include "notifications/RoadNote.h"
 #include "notifications/ShipNote.h"
-#include "pathfinding/PathConditionRoad.h"
 #include "nodeObjs/noAnimal.h"
 #include "nodeObjs/noFlag.h"
 #include "nodeObjs/noShip.h"
@@ -104,7 +103,9 @@ void HandleShipNote(AIEventManager& eventMgr, const ShipNote& note)
 namespace AIJH {
 
 AIPlayerJH::AIPlayerJH(const unsigned char playerId, const GameWorldBase& gwb, const AI::Level level)
-    : AIPlayer(playerId, gwb, level), UpgradeBldPos(MapPoint::Invalid()), isInitGfCompleted(false), defeated(player.IsDefeated())
+    : AIPlayer(playerId, gwb, level), UpgradeBldPos(MapPoint::Invalid()), reachability(gwb, playerId, aiMap),
+      mapUpdater(gwb, playerId, aiMap, reachability), isInitGfCompleted(false),
+      defeated(player.IsDefeated())
 {
     bldPlanner = new BuildingPlanner(*this);
     construction = new AIConstruction(*this);
@@ -152,10 +153,7 @@ AIPlayerJH::AIPlayerJH(const unsigned char playerId, const GameWorldBase& gwb, c
         if(note.player == playerId)
             HandleShipNote(eventManager, note);
     });
-    subBQ = notifications.subscribe<NodeNote>([this](const NodeNote& note) {
-        if(note.type == NodeNote::BQ)
-            UpdateNodeBQ(note.pos);
-    });
+    subNode = notifications.subscribe<NodeNote>([this](const NodeNote& note) { mapUpdater.OnNodeChanged(note); });
 }
 
 AIPlayerJH::~AIPlayerJH()
@@ -172,8 +170,14 @@ void AIPlayerJH::RunGF(const unsigned gf, bool gfisnwf)
 
     if(TestDefeat())
         return;
+    {
+        // Apply the world changes since the last GF
+        RTTR_PROFILE_SCOPE(PROF_AI, "UpdateAIMap", playerId);
+        mapUpdater.Update();
+    }
     if(!isInitGfCompleted)
     {
+        RTTR_PROFILE_SCOPE(PROF_AI, "Init", playerId);
         InitStoreAndMilitarylists();
         InitDistribution();
     }
@@ -182,10 +186,16 @@ void AIPlayerJH::RunGF(const unsigned gf, bool gfisnwf)
         isInitGfCompleted++;
         return; //  1 init -> 2 test defeat -> 3 do other ai stuff -> goto 2
     }
-    bldPlanner->Update(gf, *this);
+    {
+        RTTR_PROFILE_SCOPE(PROF_AI, "BuildingPlanner", playerId);
+        bldPlanner->Update(gf, *this);
+    }
 
     if(gfisnwf) // nwf -> now the orders have been executed -> new constructions can be started
+    {
+        RTTR_PROFILE_SCOPE(PROF_AI, "ConstructionsExecuted", playerId);
         construction->ConstructionsExecuted();
+    }
 
     if(gf == 100)
     {
@@ -199,27 +209,39 @@ void AIPlayerJH::RunGF(const unsigned gf, bool gfisnwf)
 
     // LOG.write(("ai doing stuff %i \n",playerId);
     if(gf % 100 == 0)
+    {
+        RTTR_PROFILE_SCOPE(PROF_AI, "UpdateBuildingsWanted", playerId);
         bldPlanner->UpdateBuildingsWanted(*this);
-    ExecuteAIJob();
+    }
+    {
+        RTTR_PROFILE_SCOPE(PROF_AI, "ExecuteAIJob", playerId);
+        ExecuteAIJob();
+    }
 
     if((gf + playerId * 17) % attack_interval == 0)
     {
         // CheckExistingMilitaryBuildings();
+        RTTR_PROFILE_SCOPE(PROF_AI, "TryToAttack", playerId);
         TryToAttack();
     }
     if(((gf + playerId * 17) % 73 == 0) && (level != AI::EASY))
     {
+        RTTR_PROFILE_SCOPE(PROF_AI, "MilUpgradeOptim", playerId);
         MilUpgradeOptim();
     }
 
     if((gf + 41 + playerId * 17) % attack_interval == 0)
     {
         if(ggs.getSelection(AddonId::SEA_ATTACK) < 2) // not deactivated by addon? -> go ahead
+        {
+            RTTR_PROFILE_SCOPE(PROF_AI, "TrySeaAttack", playerId);
             TrySeaAttack();
+        }
     }
 
     if((gf + playerId * 13) % 1500 == 0)
     {
+        RTTR_PROFILE_SCOPE(PROF_AI, "CheckExpeditionsAndResources", playerId);
         CheckExpeditions();
         CheckForester();
         CheckGranitMine();
@@ -227,6 +249,7 @@ void AIPlayerJH::RunGF(const unsigned gf, bool gfisnwf)
 
     if((gf + playerId * 11) % 150 == 0)
     {
+        RTTR_PROFILE_SCOPE(PROF_AI, "AdjustSettings", playerId);
         AdjustSettings();
         // check for useless sawmills
         const std::list<nobUsual*>& sawMills = aii.GetBuildings(BLD_SAWMILL);
@@ -248,6 +271,7 @@ void AIPlayerJH::RunGF(const unsigned gf, bool gfisnwf)
 
     if((gf + playerId * 7) % build_interval == 0) // plan new buildings
     {
+        RTTR_PROFILE_SCOPE(PROF_AI, "PlanNewBuildings", playerId);
         CheckForUnconnectedBuildingSites();
         PlanNewBuildings(gf);
     }
@@ -470,123 +494,27 @@ AIResource AIPlayerJH::CalcResource(const MapPoint pt)
     }
 }
 
-void AIPlayerJH::InitReachableNodes()
-{
-    std::queue<MapPoint> toCheck;
-
-    // Alle auf not reachable setzen
-    RTTR_FOREACH_PT(MapPoint, aiMap.GetSize())
-    {
-        Node& node = aiMap[pt];
-        node.reachable = false;
-        node.failed_penalty = 0;
-        const auto* myFlag = gwb.GetSpecObj<noFlag>(pt);
-        if(myFlag && myFlag->GetPlayer() == playerId)
-        {
-            node.reachable = true;
-            toCheck.push(pt);
-        }
-    }
-
-    IterativeReachableNodeChecker(toCheck);
-}
-
-void AIPlayerJH::IterativeReachableNodeChecker(std::queue<MapPoint> toCheck)
-{
-    // TODO auch mal bootswege bauen können
-
-    PathConditionRoad<GameWorldBase> roadPathChecker(gwb, false);
-    while(!toCheck.empty())
-    {
-        // Reachable coordinate
-        MapPoint curPt = toCheck.front();
-
-        // Coordinates to test around this reachable coordinate
-        for(unsigned dir = 0; dir < Direction::COUNT; ++dir)
-        {
-            MapPoint curNeighbour = aiMap.GetNeighbour(curPt, Direction::fromInt(dir));
-            Node& node = aiMap[curNeighbour];
-
-            // already reached, don't test again
-            if(node.reachable)
-                continue;
-
-            // Test whether point is reachable; yes->add to check list
-            if(roadPathChecker.IsNodeOk(curNeighbour))
-            {
-                if(node.failed_penalty == 0)
-                {
-                    node.reachable = true;
-                    toCheck.push(curNeighbour);
-                } else
-                {
-                    node.failed_penalty--;
-                }
-            }
-        }
-        toCheck.pop();
-    }
-}
-
-void AIPlayerJH::UpdateReachableNodes(const std::vector<MapPoint>& pts)
-{
-    std::queue<MapPoint> toCheck;
-
-    for(const MapPoint& curPt : pts)
-    {
-        const auto* flag = gwb.GetSpecObj<noFlag>(curPt);
-        if(flag && flag->GetPlayer() == playerId)
-        {
-            aiMap[curPt].reachable = true;
-            toCheck.push(curPt);
-        } else
-            aiMap[curPt].reachable = false;
-    }
-    IterativeReachableNodeChecker(toCheck);
-}
-
 void AIPlayerJH::InitNodes()
 {
     aiMap.Resize(gwb.GetSize());
 
-    InitReachableNodes();
+    mapUpdater.Init();
 
     RTTR_FOREACH_PT(MapPoint, aiMap.GetSize())
     {
         Node& node = aiMap[pt];
 
-        node.bq = aii.GetBuildingQuality(pt);
         node.res = CalcResource(pt);
-        node.owned = aii.IsOwnTerritory(pt);
-        node.border = aii.IsBorder(pt);
         node.farmed = false;
     }
 }
 
 void AIPlayerJH::UpdateNodesAround(const MapPoint pt, unsigned radius)
 {
-    std::vector<MapPoint> pts = gwb.GetPointsInRadius(pt, radius);
-    UpdateReachableNodes(pts);
-    for(const MapPoint& pt : pts)
-    {
-        Node& node = aiMap[pt];
-        // Change of ownership might change bq
-        node.bq = aii.GetBuildingQuality(pt);
-        node.owned = aii.IsOwnTerritory(pt);
-        node.border = aii.IsBorder(pt);
-    }
-}
-
-void AIPlayerJH::UpdateNodeBQ(const MapPoint& pt)
-{
-    BuildingQuality newBQ = aii.GetBuildingQuality(pt);
-    if(aiMap[pt].bq != newBQ)
-    {
-        aiMap[pt].bq = newBQ;
-        // Neighbour points might change to (flags at borders etc.)
-        for(const MapPoint& curPt : gwb.GetPointsInRadius(pt, 1))
-            UpdateNodeBQ(curPt);
-    }
+    // bq, owned and border are kept updated by the notifications. Only recheck the reachability so failed spots can be retried
+    for(const MapPoint& curPt : gwb.GetPointsInRadius(pt, radius))
+        reachability.MarkDirty(curPt);
+    mapUpdater.Update();
 }
 
 void AIPlayerJH::InitResourceMaps()
@@ -1349,8 +1277,6 @@ void AIPlayerJH::HandleTreeChopped(const MapPoint pt)
 {
     // std::cout << "Tree chopped." << std::endl;
 
-    aiMap[pt].reachable = true;
-
     UpdateNodesAround(pt, 3);
 
     int random = rand();
@@ -1544,7 +1470,7 @@ void AIPlayerJH::MilUpgradeOptim()
 
 void AIPlayerJH::Chat(const std::string& message)
 {
-    GAMECLIENT.GetMainPlayer().sendMsgAsync(new GameMessage_Chat(playerId, CD_ALL, message));
+    chatMsgs.push_back(message);
 }
 
 bool AIPlayerJH::HasFrontierBuildings()
@@ -22,12 +22,13 @@
 #include "ai/AIEventManager.h"
 #include "ai/AIPlayer.h"
 #include "ai/aijh/AIMap.h"
+#include "ai/aijh/AIMapUpdater.h"
+#include "ai/aijh/AIReachability.h"
 #include "ai/aijh/AIResourceMap.h"
 #include "gameTypes/MapCoordinates.h"
 #include <boost/container/static_vector.hpp>
 #include <list>
 #include <memory>
-#include <queue>
 
 class noFlag;
 class noShip;
@@ -58,6 +59,7 @@ public:
     unsigned GetNumJobs() const;
 
     void RunGF(unsigned gf, bool gfisnwf) override;
+    bool IsIdle() const override { return defeated && gcs.empty(); }
 
     /// Test whether the player should resign or not
     bool TestDefeat();
@@ -203,10 +205,6 @@ public:
 
     void SaveResourceMapsToFile();
 
-    void InitReachableNodes();
-    void IterativeReachableNodeChecker(std::queue<MapPoint> toCheck);
-    void UpdateReachableNodes(const std::vector<MapPoint>& pts);
-
     /// disconnects 'inland' military buildings from road system(and sends out soldiers), sets stop gold, uses the upgrade building (order
     /// new private, kick out general)
     void MilUpgradeOptim();
@@ -246,6 +244,10 @@ private:
     std::list<MapPoint> milBuildingSites;
     /// Nodes containing some information about every map node
     AIMap aiMap;
+    /// Keeps the reachable flag of the nodes updated
+    AIReachability reachability;
+    /// Refreshes the nodes changed in the world
+    AIMapUpdater mapUpdater;
     /// Resource maps, containing a rating for every map point concerning a resource
     boost::container::static_vector<AIResourceMap, NUM_AIRESOURCES> resourceMaps;
 
@@ -258,9 +260,7 @@ private:
     BuildingPlanner* bldPlanner;
     AIConstruction* construction;
 
-    Subscribtion subBuilding, subExpedition, subResource, subRoad, subShip, subBQ;
-
-    void UpdateNodeBQ(const MapPoint& pt);
+    Subscribtion subBuilding, subExpedition, subResource, subRoad, subShip, subNode;
 };
 
 } // namespace AIJH
@@ -0,0 +1,224 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "AIReachability.h"
+#include "ai/aijh/AIMap.h"
+#include "pathfinding/PathConditionRoad.h"
+#include "world/GameWorldBase.h"
+#include "nodeObjs/noFlag.h"
+#include <limits>
+
+namespace AIJH {
+
+AIReachability::AIReachability(const GameWorldBase& gwb, unsigned char playerId, AIMap& aiMap)
+    : gwb(gwb), playerId(playerId), aiMap(aiMap), curSearchId(0), firstSearchId(0)
+{}
+
+bool AIReachability::IsSource(const MapPoint pt) const
+{
+    const auto* flag = gwb.GetSpecObj<noFlag>(pt);
+    return flag && flag->GetPlayer() == playerId;
+}
+
+bool AIReachability::IsRoadNodeOk(const MapPoint pt) const
+{
+    // TODO auch mal bootswege bauen können
+    // Own territory only, so we never search through the unowned part of the map
+    return gwb.GetNode(pt).owner == playerId + 1 && makePathConditionRoad(gwb, false).IsNodeOk(pt);
+}
+
+bool AIReachability::IsPart(const MapPoint pt) const
+{
+    return IsSource(pt) || (aiMap[pt].failed_penalty == 0 && IsRoadNodeOk(pt));
+}
+
+void AIReachability::Init()
+{
+    const unsigned numNodes = prodOfComponents(aiMap.GetSize());
+    isDirty.clear();
+    isDirty.resize(numNodes, false);
+    dirtyPts.clear();
+    lastSearchId.clear();
+    lastSearchId.resize(numNodes, 0);
+    checkedReachable.clear();
+    checkedReachable.resize(numNodes, false);
+    curSearchId = firstSearchId = 0;
+
+    std::vector<MapPoint> flags;
+    RTTR_FOREACH_PT(MapPoint, aiMap.GetSize())
+    {
+        Node& node = aiMap[pt];
+        node.reachable = false;
+        node.failed_penalty = 0;
+        if(IsSource(pt))
+            flags.push_back(pt);
+    }
+    Flood(flags, ++curSearchId);
+}
+
+void AIReachability::MarkDirty(const MapPoint pt)
+{
+    // Owner and objects of a point influence its neighbours too
+    const auto markPt = [this](const MapPoint curPt) {
+        const unsigned idx = aiMap.GetIdx(curPt);
+        if(!isDirty[idx])
+        {
+            isDirty[idx] = true;
+            dirtyPts.push_back(curPt);
+        }
+    };
+    markPt(pt);
+    for(unsigned dir = 0; dir < Direction::COUNT; ++dir)
+        markPt(aiMap.GetNeighbour(pt, Direction::fromInt(dir)));
+}
+
+void AIReachability::Update()
+{
+    if(dirtyPts.empty())
+        return;
+    // Points marked during this update are handled in the next one
+    std::vector<MapPoint> pts;
+    std::swap(pts, dirtyPts);
+    for(const MapPoint& pt : pts)
+        isDirty[aiMap.GetIdx(pt)] = false;
+
+    // Make sure the ids of this update can't overflow
+    if(curSearchId > std::numeric_limits<unsigned>::max() - lastSearchId.size() - 1u)
+    {
+        std::fill(lastSearchId.begin(), lastSearchId.end(), 0u);
+        curSearchId = 0;
+    }
+    firstSearchId = curSearchId + 1u;
+    // Check might add more points
+    for(unsigned i = 0; i < pts.size(); i++)
+        Check(pts[i], pts);
+}
+
+void AIReachability::Check(const MapPoint pt, std::vector<MapPoint>& toCheck)
+{
+    const unsigned ptIdx = aiMap.GetIdx(pt);
+    // Already decided in this update
+    if(lastSearchId[ptIdx] >= firstSearchId)
+        return;
+    const unsigned searchId = ++curSearchId;
+    lastSearchId[ptIdx] = searchId;
+    if(!IsPart(pt))
+    {
+        // Areas connected via this point might not be reachable anymore
+        if(aiMap[pt].reachable)
+        {
+            for(unsigned dir = 0; dir < Direction::COUNT; ++dir)
+                toCheck.push_back(aiMap.GetNeighbour(pt, Direction::fromInt(dir)));
+        }
+        aiMap[pt].reachable = false;
+        checkedReachable[ptIdx] = false;
+        DecreaseFailedPenalty(pt);
+        return;
+    }
+
+    // Breadth first search through the connected area till we find a flag or a node checked before.
+    // Close flags are the common case so this usually stops quickly.
+    std::vector<MapPoint> visited(1, pt);
+    bool decided = false, isReachable = false;
+    for(unsigned i = 0; i < visited.size() && !decided; i++)
+    {
+        const MapPoint curPt = visited[i];
+        if(IsSource(curPt))
+        {
+            decided = isReachable = true;
+            break;
+        }
+        for(unsigned dir = 0; dir < Direction::COUNT; ++dir)
+        {
+            const MapPoint nb = aiMap.GetNeighbour(curPt, Direction::fromInt(dir));
+            const unsigned nbIdx = aiMap.GetIdx(nb);
+            if(lastSearchId[nbIdx] == searchId || !IsPart(nb))
+                continue;
+            if(lastSearchId[nbIdx] >= firstSearchId)
+            {
+                // Same connected area as an already checked node
+                decided = true;
+                isReachable = checkedReachable[nbIdx];
+                break;
+            }
+            lastSearchId[nbIdx] = searchId;
+            visited.push_back(nb);
+        }
+    }
+
+    if(isReachable)
+        Flood(visited, searchId);
+    else
+    {
+        // Searched the whole area without finding a flag or it is connected to an unreachable area
+        for(const MapPoint& curPt : visited)
+        {
+            aiMap[curPt].reachable = false;
+            checkedReachable[aiMap.GetIdx(curPt)] = false;
+        }
+    }
+}
+
+void AIReachability::DecreaseFailedPenalty(const MapPoint pt)
+{
+    // Construction failed here: It has to be reached a couple of times before we try again
+    Node& node = aiMap[pt];
+    if(node.failed_penalty == 0 || !IsRoadNodeOk(pt))
+        return;
+    bool hasReachableNeighbour = false;
+    for(unsigned dir = 0; dir < Direction::COUNT && !hasReachableNeighbour; ++dir)
+        hasReachableNeighbour = aiMap[aiMap.GetNeighbour(pt, Direction::fromInt(dir))].reachable;
+    if(hasReachableNeighbour && --node.failed_penalty == 0)
+        MarkDirty(pt);
+}
+
+void AIReachability::Flood(std::vector<MapPoint>& pts, const unsigned searchId)
+{
+    for(const MapPoint& pt : pts)
+    {
+        aiMap[pt].reachable = true;
+        const unsigned idx = aiMap.GetIdx(pt);
+        lastSearchId[idx] = searchId;
+        checkedReachable[idx] = true;
+    }
+    // pts is used as the queue
+    for(unsigned i = 0; i < pts.size(); i++)
+    {
+        const MapPoint curPt = pts[i];
+        for(unsigned dir = 0; dir < Direction::COUNT; ++dir)
+        {
+            const MapPoint nb = aiMap.GetNeighbour(curPt, Direction::fromInt(dir));
+            Node& node = aiMap[nb];
+            // already reached, don't test again
+            if(node.reachable || !IsRoadNodeOk(nb))
+                continue;
+            if(node.failed_penalty > 0)
+            {
+                DecreaseFailedPenalty(nb);
+                continue;
+            }
+            const unsigned nbIdx = aiMap.GetIdx(nb);
+            node.reachable = true;
+            lastSearchId[nbIdx] = searchId;
+            checkedReachable[nbIdx] = true;
+            pts.push_back(nb);
+        }
+    }
+}
+
+} // namespace AIJH
@@ -0,0 +1,74 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef AIReachability_h__
+#define AIReachability_h__
+
+#include "gameTypes/MapCoordinates.h"
+#include <vector>
+
+class GameWorldBase;
+
+namespace AIJH {
+
+class AIMap;
+
+/// Keeps the reachable state of the AI nodes up to date.
+/// A node is reachable if it is an own flag or a road can be built from an own flag to it.
+/// Points that might have changed are collected and only the areas connected to them are rechecked (batched) on Update
+class AIReachability
+{
+public:
+    AIReachability(const GameWorldBase& gwb, unsigned char playerId, AIMap& aiMap);
+
+    /// Recalculate all nodes of the (resized) map
+    void Init();
+    /// Mark that the reachability of the point and its neighbours might have changed
+    void MarkDirty(MapPoint pt);
+    bool HasDirtyNodes() const { return !dirtyPts.empty(); }
+    /// Recheck all points marked since the last update
+    void Update();
+
+private:
+    const GameWorldBase& gwb;
+    const unsigned char playerId;
+    AIMap& aiMap;
+    /// Points to check on the next update. isDirty avoids duplicates
+    std::vector<bool> isDirty;
+    std::vector<MapPoint> dirtyPts;
+    /// Id of the search that visited a node. Nodes of finished searches of the current update have an id >= firstSearchId
+    /// and their result in checkedReachable
+    std::vector<unsigned> lastSearchId;
+    std::vector<bool> checkedReachable;
+    unsigned curSearchId, firstSearchId;
+
+    bool IsSource(MapPoint pt) const;
+    /// Node could be part of a road (ignoring failed constructions)
+    bool IsRoadNodeOk(MapPoint pt) const;
+    bool IsPart(MapPoint pt) const;
+    /// Determine whether the point is reachable by searching its connected area until a flag is found.
+    /// Adds points to toCheck whose area might have been split off
+    void Check(MapPoint pt, std::vector<MapPoint>& toCheck);
+    /// Count down the penalty of a failed construction if the point could be reached otherwise
+    void DecreaseFailedPenalty(MapPoint pt);
+    /// Mark the given nodes and all unreachable nodes connected to them as reachable
+    void Flood(std::vector<MapPoint>& pts, unsigned searchId);
+};
+
+} // namespace AIJH
+
+#endif // AIReachability_h__
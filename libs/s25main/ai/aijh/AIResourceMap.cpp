@@ -21,12 +21,103 @@
 #include "ai/aijh/AIMap.h"
 #include "buildings/noBuildingSite.h"
 #include "buildings/nobUsual.h"
+#include "world/MapGeometry.h"
 #include "gameData/TerrainDesc.h"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
 
 namespace AIJH {
 
+namespace {
+    const unsigned NOT_IN_RADIUS = std::numeric_limits<unsigned>::max();
+
+    /// Add value * weights[i] to dst[i]. Written as a plain loop over contiguous memory so it gets vectorized
+    void addWeighted(int* dst, const int* weights, unsigned count, int value)
+    {
+        for(unsigned i = 0; i < count; i++)
+            dst[i] += value * weights[i];
+    }
+
+    /// Return value modulo size in [0, size)
+    unsigned wrapCoord(int value, unsigned size)
+    {
+        const int result = value % static_cast<int>(size);
+        return static_cast<unsigned>(result < 0 ? result + static_cast<int>(size) : result);
+    }
+} // namespace
+
+AIResourceMap::Kernel::Kernel(const unsigned radius) : radius(radius)
+{
+    const int r = static_cast<int>(radius);
+    const unsigned diameter = 2 * radius + 1;
+    for(unsigned parity = 0; parity < 2; parity++)
+    {
+        // Same walk as in MapBase::GetPointsInRadius but on an infinite map
+        const Position center(0, parity);
+        std::vector<Position>& curOffsets = offsets[parity];
+        std::vector<unsigned> distances;
+        curOffsets.push_back(Position(0, 0));
+        distances.push_back(0);
+        Position curStartPt = center;
+        for(unsigned curRadius = 1; curRadius <= radius; ++curRadius)
+        {
+            curStartPt = ::GetNeighbour(curStartPt, Direction::WEST);
+            Position curPt = curStartPt;
+            for(unsigned i = Direction::NORTHEAST; i < Direction::NORTHEAST + Direction::COUNT; ++i)
+            {
+                for(unsigned step = 0; step < curRadius; ++step)
+                {
+                    curOffsets.push_back(curPt - center);
+                    distances.push_back(curRadius);
+                    curPt = ::GetNeighbour(curPt, Direction(i));
+                }
+            }
+        }
+
+        std::vector<unsigned>& curOrder = order[parity];
+        curOrder.resize(diameter * diameter, NOT_IN_RADIUS);
+        for(unsigned i = 0; i < curOffsets.size(); i++)
+        {
+            const Position& offset = curOffsets[i];
+            RTTR_Assert(std::abs(offset.x) <= r && std::abs(offset.y) <= r);
+            unsigned& curIdx = curOrder[(offset.y + r) * diameter + offset.x + r];
+            RTTR_Assert(curIdx == NOT_IN_RADIUS);
+            curIdx = i;
+        }
+
+        // Each row of the hexagon is a consecutive range of points
+        for(int dy = -r; dy <= r; dy++)
+        {
+            Row row;
+            row.dy = dy;
+            row.firstDx = 0;
+            for(int dx = -r; dx <= r; dx++)
+            {
+                const unsigned curIdx = getOrder(parity, dx, dy);
+                if(curIdx == NOT_IN_RADIUS)
+                    continue;
+                const int weight = static_cast<int>(radius - distances[curIdx]);
+                if(row.weights.empty())
+                {
+                    // Points on the outer ring don't change anything
+                    if(weight == 0)
+                        continue;
+                    row.firstDx = dx;
+                }
+                RTTR_Assert(row.firstDx + static_cast<int>(row.weights.size()) == dx);
+                row.weights.push_back(weight);
+            }
+            while(!row.weights.empty() && row.weights.back() == 0)
+                row.weights.pop_back();
+            if(!row.weights.empty())
+                rows[parity].push_back(row);
+        }
+    }
+}
+
 AIResourceMap::AIResourceMap(const AIResource res, const AIInterface& aii, const AIMap& aiMap)
-    : res(res), resRadius(RES_RADIUS[static_cast<unsigned>(res)]), aii(aii), aiMap(aiMap)
+    : res(res), resRadius(RES_RADIUS[static_cast<unsigned>(res)]), numTilesX(0), aii(aii), aiMap(aiMap)
 {}
 
 AIResourceMap::~AIResourceMap() = default;
@@ -36,6 +127,10 @@ void AIResourceMap::Init()
     const MapExtent mapSize = aiMap.GetSize();
 
     map.Resize(mapSize);
+    numTilesX = (mapSize.x + TILE_SIZE - 1) >> TILE_SIZE_SHIFT;
+    const unsigned numTilesY = (mapSize.y + TILE_SIZE - 1) >> TILE_SIZE_SHIFT;
+    tileMax.assign(numTilesX * numTilesY, 0);
+    tileDirty.assign(numTilesX * numTilesY, true);
     RTTR_FOREACH_PT(MapPoint, mapSize)
     {
         const Node& node = aiMap[pt];
@@ -85,25 +180,60 @@ void AIResourceMap::AdjustRatingForBlds(BuildingType bld, unsigned radius, int v
     }
 }
 
-namespace {
-    struct ValueAdjuster
-    {
-        NodeMapBase<int>& map;
-        unsigned radius;
-        int value;
+const AIResourceMap::Kernel& AIResourceMap::GetKernel(unsigned radius) const
+{
+    std::shared_ptr<const Kernel>& kernel = kernels[radius];
+    if(!kernel)
+        kernel = std::make_shared<const Kernel>(radius);
+    return *kernel;
+}
 
-        ValueAdjuster(NodeMapBase<int>& map, unsigned radius, int value) : map(map), radius(radius), value(value) {}
-        bool operator()(const MapPoint pt, unsigned r) const
+int AIResourceMap::GetTileMax(unsigned tileIdx) const
+{
+    if(tileDirty[tileIdx])
+    {
+        const unsigned startX = (tileIdx % numTilesX) << TILE_SIZE_SHIFT;
+        const unsigned startY = (tileIdx / numTilesX) << TILE_SIZE_SHIFT;
+        const unsigned endX = std::min<unsigned>(startX + TILE_SIZE, map.GetWidth());
+        const unsigned endY = std::min<unsigned>(startY + TILE_SIZE, map.GetHeight());
+        int maxValue = std::numeric_limits<int>::min();
+        for(unsigned y = startY; y < endY; y++)
         {
-            map[pt] += value * (radius - r);
-            return false; // Don't exit
+            const unsigned rowIdx = y * map.GetWidth();
+            for(unsigned x = startX; x < endX; x++)
+                maxValue = std::max(maxValue, map[rowIdx + x]);
         }
-    };
-} // namespace
+        tileMax[tileIdx] = maxValue;
+        tileDirty[tileIdx] = false;
+    }
+    return tileMax[tileIdx];
+}
 
 void AIResourceMap::Change(const MapPoint pt, unsigned radius, int value)
 {
-    aii.gwb.CheckPointsInRadius(pt, radius, ValueAdjuster(map, radius, value), true);
+    // Same as adding value * (radius - distance) to every point returned by CheckPointsInRadius but row by row.
+    // Rows wider than the map wrap around and add to the same nodes multiple times
+    const Kernel& kernel = GetKernel(radius);
+    const MapExtent mapSize = map.GetSize();
+    for(const Kernel::Row& row : kernel.rows[pt.y & 1])
+    {
+        const unsigned y = wrapCoord(pt.y + row.dy, mapSize.y);
+        int* rowData = &map[y * mapSize.x];
+        const unsigned tileRowIdx = (y >> TILE_SIZE_SHIFT) * numTilesX;
+        unsigned x = wrapCoord(pt.x + row.firstDx, mapSize.x);
+        const int* weights = row.weights.data();
+        unsigned remaining = static_cast<unsigned>(row.weights.size());
+        while(remaining)
+        {
+            const unsigned count = std::min<unsigned>(remaining, mapSize.x - x);
+            addWeighted(rowData + x, weights, count, value);
+            for(unsigned tileX = x >> TILE_SIZE_SHIFT; tileX <= (x + count - 1) >> TILE_SIZE_SHIFT; tileX++)
+                tileDirty[tileRowIdx + tileX] = true;
+            weights += count;
+            remaining -= count;
+            x = 0;
+        }
+    }
 }
 
 MapPoint AIResourceMap::FindGoodPosition(const MapPoint& pt, int threshold, BuildingQuality size, int radius, bool inTerritory) const
@@ -114,9 +244,11 @@ MapPoint AIResourceMap::FindGoodPosition(const MapPoint& pt, int threshold, Buil
     if(radius == -1)
         radius = 30;
 
-    std::vector<MapPoint> pts = aii.gwb.GetPointsInRadiusWithCenter(pt, radius);
-    for(const MapPoint& curPt : pts)
+    // Visit the points in the same order as GetPointsInRadiusWithCenter
+    const Kernel& kernel = GetKernel(radius);
+    for(const Position& offset : kernel.offsets[pt.y & 1])
     {
+        const MapPoint curPt = map.MakeMapPoint(Position(pt) + offset);
         const unsigned idx = map.GetIdx(curPt);
         if(map[idx] >= threshold)
         {
@@ -141,9 +273,15 @@ MapPoint AIResourceMap::FindBestPosition(const MapPoint& pt, BuildingQuality siz
     MapPoint best = MapPoint::Invalid();
     int best_value = (minimum == std::numeric_limits<int>::min()) ? minimum : minimum - 1;
 
-    std::vector<MapPoint> pts = aii.gwb.GetPointsInRadiusWithCenter(pt, radius);
-    for(const MapPoint& curPt : pts)
+    const unsigned diameter = 2 * radius + 1;
+    if(diameter <= map.GetWidth() && diameter <= map.GetHeight())
+        return FindBestPositionInTiles(pt, size, best_value, radius, inTerritory);
+
+    // Map is too small, some points would be visited multiple times
+    const Kernel& kernel = GetKernel(radius);
+    for(const Position& offset : kernel.offsets[pt.y & 1])
     {
+        const MapPoint curPt = map.MakeMapPoint(Position(pt) + offset);
         const unsigned idx = map.GetIdx(curPt);
         if(map[idx] > best_value)
         {
@@ -161,4 +299,86 @@ MapPoint AIResourceMap::FindBestPosition(const MapPoint& pt, BuildingQuality siz
     return best;
 }
 
+MapPoint AIResourceMap::FindBestPositionInTiles(const MapPoint& pt, BuildingQuality size, int startValue, unsigned radius,
+                                                bool inTerritory) const
+{
+    // The sequential search returns the first valid point (in the order of GetPointsInRadiusWithCenter) with the highest value.
+    // So we can check the tiles with the highest values first and only need to compare the order for equal values.
+    const Kernel& kernel = GetKernel(radius);
+    const unsigned parity = pt.y & 1;
+    const MapExtent mapSize = map.GetSize();
+    const int r = static_cast<int>(radius);
+
+    // Tiles overlapping the bounding box of the search area
+    std::vector<bool> usedTileCols(numTilesX), usedTileRows(tileMax.size() / numTilesX);
+    for(int d = -r; d <= r; d++)
+    {
+        usedTileCols[wrapCoord(pt.x + d, mapSize.x) >> TILE_SIZE_SHIFT] = true;
+        usedTileRows[wrapCoord(pt.y + d, mapSize.y) >> TILE_SIZE_SHIFT] = true;
+    }
+    std::vector<std::pair<int, unsigned>> tiles; // Max value and index
+    for(unsigned tileY = 0; tileY < usedTileRows.size(); tileY++)
+    {
+        if(!usedTileRows[tileY])
+            continue;
+        for(unsigned tileX = 0; tileX < numTilesX; tileX++)
+        {
+            const unsigned tileIdx = tileY * numTilesX + tileX;
+            if(usedTileCols[tileX] && GetTileMax(tileIdx) > startValue)
+                tiles.emplace_back(tileMax[tileIdx], tileIdx);
+        }
+    }
+    std::sort(tiles.begin(), tiles.end(),
+              [](const std::pair<int, unsigned>& lhs, const std::pair<int, unsigned>& rhs) { return lhs.first > rhs.first; });
+
+    MapPoint best = MapPoint::Invalid();
+    int bestValue = startValue;
+    // Values equal to startValue are never accepted as no order is smaller than 0
+    unsigned bestOrder = 0;
+    for(const auto& tile : tiles)
+    {
+        // Equal values might still be earlier in the search order
+        if(tile.first < bestValue)
+            break;
+        const unsigned startX = (tile.second % numTilesX) << TILE_SIZE_SHIFT;
+        const unsigned startY = (tile.second / numTilesX) << TILE_SIZE_SHIFT;
+        const unsigned endX = std::min<unsigned>(startX + TILE_SIZE, mapSize.x);
+        const unsigned endY = std::min<unsigned>(startY + TILE_SIZE, mapSize.y);
+        for(unsigned y = startY; y < endY; y++)
+        {
+            int dy = static_cast<int>(wrapCoord(static_cast<int>(y) - pt.y, mapSize.y));
+            if(dy > r)
+                dy -= mapSize.y;
+            if(dy < -r)
+                continue;
+            for(unsigned x = startX; x < endX; x++)
+            {
+                const unsigned idx = y * mapSize.x + x;
+                const int value = map[idx];
+                if(value < bestValue)
+                    continue;
+                int dx = static_cast<int>(wrapCoord(static_cast<int>(x) - pt.x, mapSize.x));
+                if(dx > r)
+                    dx -= mapSize.x;
+                if(dx < -r)
+                    continue;
+                const unsigned curOrder = kernel.getOrder(parity, dx, dy);
+                if(curOrder == NOT_IN_RADIUS || (value == bestValue && curOrder >= bestOrder))
+                    continue;
+                if(!aiMap[idx].reachable || (inTerritory && !aiMap[idx].owned) || aiMap[idx].farmed)
+                    continue;
+                const MapPoint curPt(x, y);
+                RTTR_Assert(aii.GetBuildingQuality(curPt) == aiMap[curPt].bq);
+                if(canUseBq(aii.GetBuildingQuality(curPt), size))
+                {
+                    best = curPt;
+                    bestValue = value;
+                    bestOrder = curOrder;
+                }
+            }
+        }
+    }
+    return best;
+}
+
 } // namespace AIJH
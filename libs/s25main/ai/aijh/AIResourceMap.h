@@ -23,6 +23,10 @@
 #include "world/NodeMapBase.h"
 #include "gameTypes/BuildingQuality.h"
 #include "gameTypes/BuildingType.h"
+#include <array>
+#include <map>
+#include <memory>
+#include <vector>
 
 class AIInterface;
 namespace AIJH {
@@ -51,16 +55,59 @@ public:
         return FindBestPosition(pt, size, 1, radius, inTerritory);
     }
 
-    int& operator[](const MapPoint& pt) { return map[pt]; }
+    int& operator[](const MapPoint& pt)
+    {
+        MarkTileDirty(pt.x, pt.y);
+        return map[pt];
+    }
     int operator[](const MapPoint& pt) const { return map[pt]; }
 
 private:
+    /// Offsets of all points in a radius around a center in the order of MapBase::GetPointsInRadius.
+    /// The hex geometry differs for even and odd rows, so all arrays are indexed by the parity of the center row
+    struct Kernel
+    {
+        /// Consecutive points of the same row
+        struct Row
+        {
+            int dy, firstDx;
+            /// radius - distance for each point, zeros at the ends are removed
+            std::vector<int> weights;
+        };
+        explicit Kernel(unsigned radius);
+        unsigned radius;
+        std::array<std::vector<Position>, 2> offsets;
+        std::array<std::vector<Row>, 2> rows;
+        /// Index into offsets for each offset in [-radius, radius]^2 or UINT_MAX if not in the radius
+        std::array<std::vector<unsigned>, 2> order;
+        unsigned getOrder(unsigned parity, int dx, int dy) const
+        {
+            return order[parity][(dy + radius) * (2 * radius + 1) + dx + radius];
+        }
+    };
+    /// Side length of the tiles used to skip areas in FindBestPosition
+    static constexpr unsigned TILE_SIZE_SHIFT = 3;
+    static constexpr unsigned TILE_SIZE = 1u << TILE_SIZE_SHIFT;
+
     void AdjustRatingForBlds(BuildingType bld, unsigned radius, int value);
+    const Kernel& GetKernel(unsigned radius) const;
+    void MarkTileDirty(unsigned x, unsigned y) { tileDirty[(y >> TILE_SIZE_SHIFT) * numTilesX + (x >> TILE_SIZE_SHIFT)] = true; }
+    /// Return the maximum value of the nodes in the tile
+    int GetTileMax(unsigned tileIdx) const;
+    /// Same as FindBestPosition (only values > startValue are considered) but skips tiles whose maximum cannot beat the current best.
+    /// Requires that all points in the radius are distinct
+    MapPoint FindBestPositionInTiles(const MapPoint& pt, BuildingQuality size, int startValue, unsigned radius, bool inTerritory) const;
     /// Which resource is stored in the map and radius of affected nodes
     const AIResource res;
     const unsigned resRadius;
 
     NodeMapBase<int> map;
+    /// Maximum value per tile, only valid if the tile is not dirty
+    mutable std::vector<int> tileMax;
+    mutable std::vector<bool> tileDirty;
+    unsigned numTilesX;
+    /// Kernels per radius, created on first use
+    mutable std::map<unsigned, std::shared_ptr<const Kernel>> kernels;
     const AIInterface& aii;
     const AIMap& aiMap;
 };
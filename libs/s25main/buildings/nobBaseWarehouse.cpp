@@ -521,9 +521,9 @@ void nobBaseWarehouse::HandleProduceHelperEvent()
         {
             // Wenn vorher keine Träger da waren, müssen alle unbesetzen Wege gucken, ob sie nen Weg hierher finden, könnte ja sein, dass
             // vorher nich genug Träger da waren
-            owner.FindCarrierForAllRoads();
+            owner.RequestCarrierForAllRoads();
             // evtl Träger mit Werkzeug kombiniert -> neuer Beruf
-            owner.FindWarehouseForAllJobs(JOB_NOTHING);
+            owner.RequestWarehouseForAllJobs(JOB_NOTHING);
         }
     } else if(inventory[JOB_HELPER] > 100)
     {
@@ -755,13 +755,13 @@ void nobBaseWarehouse::CheckUsesForNewWare(const GoodType gt)
         for(unsigned i = 0; i < NUM_JOB_TYPES; ++i)
         {
             if(JOB_CONSTS[i].tool == gt)
-                gwg->GetPlayer(player).FindWarehouseForAllJobs(Job(i));
+                gwg->GetPlayer(player).RequestWarehouseForAllJobs(Job(i));
         }
     }
 
     // Wars Baumaterial? Dann den Baustellen Bescheid sagen
     if(gt == GD_BOARDS || gt == GD_STONES)
-        gwg->GetPlayer(player).FindMaterialForBuildingSites();
+        gwg->GetPlayer(player).RequestMaterialForBuildingSites();
 
     // Evtl wurden Bier oder Waffen reingetragen --> versuchen zu rekrutieren
     TryRecruiting();
@@ -798,14 +798,14 @@ void nobBaseWarehouse::CheckJobsForNewFigure(const Job job)
         {
             // Evtl. Abnehmer für die Figur wieder finden
             GamePlayer& owner = gwg->GetPlayer(player);
-            owner.FindWarehouseForAllJobs(job);
+            owner.RequestWarehouseForAllJobs(job);
             // Wenns ein Träger war, auch Wege prüfen
             if(job == JOB_HELPER && inventory[JOB_HELPER] == 1)
             {
                 // evtl als Träger auf Straßen schicken
-                owner.FindCarrierForAllRoads();
+                owner.RequestCarrierForAllRoads();
                 // evtl Träger mit Werkzeug kombiniert -> neuer Beruf
-                owner.FindWarehouseForAllJobs(JOB_NOTHING);
+                owner.RequestWarehouseForAllJobs(JOB_NOTHING);
             }
         }
     }
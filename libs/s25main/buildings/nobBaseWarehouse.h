@@ -151,6 +151,8 @@ public:
     void Serialize(SerializedGameData& sgd) const override { Serialize_nobBaseWarehouse(sgd); }
 
     const Inventory& GetInventory() const;
+    /// Apply all further inventory changes also to the given sum (nullptr to stop). Used by the owner for the sum over all warehouses
+    void LinkInventory(VirtualInventory* sum) { inventory.SetSum(sum); }
 
     /// Adds specified goods. If addToPlayer is true,
     /// then they are also added to the owners inventory (for newly created/arrived goods)
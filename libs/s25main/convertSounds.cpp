@@ -15,10 +15,17 @@
 // along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
 
 #include "convertSounds.h"
+#include "helpers/Fnv1aHash.h"
+#include "helpers/ThreadPool.h"
 #include <libsiedler2/Archiv.h>
 #include <libsiedler2/ArchivItem_Sound_Wave.h>
+#include <boost/filesystem/operations.hpp>
 #include <boost/nowide/fstream.hpp>
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <iomanip>
+#include <iterator>
 #include <samplerate.hpp>
 #include <sstream>
 #include <stdexcept>
@@ -26,14 +33,180 @@
 
 namespace bnw = boost::nowide;
 
-bool convertSounds(libsiedler2::Archiv& sounds, const bfs::path& scriptPath)
+namespace {
+constexpr unsigned targetFrequency = 44100;
+const std::array<char, 8> cacheMagic = {{'R', 'T', 'T', 'R', 'S', 'N', 'D', 'S'}};
+/// Increase when the conversion changes so old caches are not used anymore
+constexpr uint32_t cacheVersion = 1;
+
+struct ConversionJob
+{
+    unsigned item;
+    libsiedler2::ArchivItem_Sound_Wave* sound;
+    std::vector<uint8_t> data;
+};
+
+std::vector<uint8_t> resample(const std::vector<uint8_t>& srcData, unsigned srcFrequency)
 {
-    bnw::ifstream file(scriptPath); // script
     samplerate::State converter(samplerate::Converter::SincFastest, 1);
-    std::vector<float> input, output;
+    const double rate = static_cast<double>(targetFrequency) / srcFrequency;
+    std::vector<float> input(srcData.size());
+    std::transform(srcData.begin(), srcData.end(), input.begin(),
+                   [](uint8_t value) { return static_cast<float>(value) / std::numeric_limits<uint8_t>::max() * 2.f - 1.f; });
+    std::vector<float> output(static_cast<size_t>(std::ceil(input.size() * rate)));
+    const auto result = converter.process(samplerate::Data(input.data(), input.size(), output.data(), output.size(), rate));
+    std::vector<uint8_t> data(result.output_frames_gen);
+    std::transform(output.begin(), output.begin() + result.output_frames_gen, data.begin(), [](float value) {
+        int converted = std::lrint((value + 1.f) / 2.f * std::numeric_limits<uint8_t>::max());
+        return static_cast<uint8_t>(std::min<int>(std::numeric_limits<uint8_t>::max(), std::max(0, converted)));
+    });
+    return data;
+}
+
+void setConvertedData(libsiedler2::ArchivItem_Sound_Wave& sound, const std::vector<uint8_t>& data)
+{
+    auto header = sound.getHeader();
+    header.samplesPerSec = targetFrequency;
+    header.bytesPerSec = targetFrequency;
+    header.frameSize = 1;
+    header.bitsPerSample = 8;
+    header.dataSize = data.size();
+    header.fileSize = data.size() + sizeof(header);
+    sound.setHeader(header);
+    sound.setData(data);
+}
+
+/// Key of the conversion result: Changes when the script or any of the converted source sounds changes.
+/// The sounds are identified by the size and modification time of their file if possible, else by their data
+uint64_t calcCacheKey(const std::string& script, const std::vector<ConversionJob>& jobs, const bfs::path& sourceFile)
+{
+    helpers::Fnv1aHash hash;
+    hash.add(cacheVersion);
+    hash.add(targetFrequency);
+    hash.add(script);
+    for(const ConversionJob& job : jobs)
+    {
+        hash.add(job.item);
+        hash.add(job.sound->getHeader().samplesPerSec);
+    }
+    if(!sourceFile.empty())
+    {
+        boost::system::error_code ec, ec2;
+        const uint64_t fileSize = bfs::file_size(sourceFile, ec);
+        const std::time_t fileTime = bfs::last_write_time(sourceFile, ec2);
+        if(!ec && !ec2)
+        {
+            hash.add(fileSize);
+            hash.add(static_cast<int64_t>(fileTime));
+            return hash.get();
+        }
+    }
+    for(const ConversionJob& job : jobs)
+    {
+        const std::vector<uint8_t>& data = job.sound->getData();
+        hash.add(static_cast<uint64_t>(data.size()));
+        hash.add(data.data(), data.size());
+    }
+    return hash.get();
+}
+
+bfs::path getCacheFilePath(const bfs::path& cacheDir, uint64_t key)
+{
+    std::stringstream fileName;
+    fileName << "sounds_" << std::hex << std::setw(16) << std::setfill('0') << key << ".cache";
+    return cacheDir / fileName.str();
+}
+
+template<typename T>
+void writeValue(bnw::ofstream& stream, const T& value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template<typename T>
+bool readValue(bnw::ifstream& stream, T& value)
+{
+    return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+/// Load the converted data of all jobs. Return false if the cache does not exist or does not match
+bool loadCache(const bfs::path& filePath, uint64_t key, std::vector<ConversionJob>& jobs)
+{
+    boost::system::error_code ec;
+    if(!bfs::is_regular_file(filePath, ec))
+        return false;
+    bnw::ifstream file(filePath.string(), std::ios::binary);
+    std::array<char, 8> magic;
+    uint32_t version, numItems;
+    uint64_t fileKey;
+    if(!readValue(file, magic) || magic != cacheMagic || !readValue(file, version) || version != cacheVersion
+       || !readValue(file, numItems) || !readValue(file, fileKey) || fileKey != key || numItems != jobs.size())
+        return false;
+    for(ConversionJob& job : jobs)
+    {
+        uint32_t item, dataSize;
+        if(!readValue(file, item) || item != job.item || !readValue(file, dataSize))
+            return false;
+        job.data.resize(dataSize);
+        if(dataSize > 0 && !file.read(reinterpret_cast<char*>(job.data.data()), dataSize))
+            return false;
+    }
+    return true;
+}
+
+bool saveCache(const bfs::path& filePath, uint64_t key, const std::vector<ConversionJob>& jobs)
+{
+    boost::system::error_code ec;
+    bfs::create_directories(filePath.parent_path(), ec);
+    // Write to a temporary file first so an aborted write never leaves a broken cache
+    const bfs::path tmpFilePath = filePath.string() + ".tmp";
+    {
+        bnw::ofstream file(tmpFilePath.string(), std::ios::binary);
+        if(!file)
+            return false;
+        file.write(cacheMagic.data(), cacheMagic.size());
+        writeValue(file, cacheVersion);
+        writeValue(file, static_cast<uint32_t>(jobs.size()));
+        writeValue(file, key);
+        for(const ConversionJob& job : jobs)
+        {
+            writeValue(file, static_cast<uint32_t>(job.item));
+            writeValue(file, static_cast<uint32_t>(job.data.size()));
+            file.write(reinterpret_cast<const char*>(job.data.data()), job.data.size());
+        }
+        if(!file)
+        {
+            file.close();
+            bfs::remove(tmpFilePath, ec);
+            return false;
+        }
+    }
+    bfs::rename(tmpFilePath, filePath, ec);
+    return !ec;
+}
+
+/// Only the cache for the current sounds is useful, so remove all others
+void removeOldCaches(const bfs::path& cacheDir, const bfs::path& currentCache)
+{
+    boost::system::error_code ec;
+    for(const auto& it : bfs::directory_iterator(cacheDir, ec))
+    {
+        const bfs::path& path = it.path();
+        if(path != currentCache && path.extension() == ".cache" && path.filename().string().find("sounds_") == 0)
+            bfs::remove(path, ec);
+    }
+}
+} // namespace
+
+bool convertSounds(libsiedler2::Archiv& sounds, const bfs::path& scriptPath, const bfs::path& cacheDir, const bfs::path& sourceFile,
+                   helpers::ThreadPool* threadPool)
+{
+    bnw::ifstream file(scriptPath); // script
+    const std::string script((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::istringstream scriptStream(script);
+    std::vector<ConversionJob> jobs;
     std::string line;
-    const unsigned targetFrequency = 44100;
-    while(std::getline(file, line))
+    while(std::getline(scriptStream, line))
     {
         if(line.empty() || line[0] == '#' || line == "empty")
             continue;
@@ -44,33 +217,48 @@ bool convertSounds(libsiedler2::Archiv& sounds, const bfs::path& scriptPath)
         auto* sound = dynamic_cast<libsiedler2::ArchivItem_Sound_Wave*>(sounds[item]);
         if(!sound)
             return false;
-        auto header = sound->getHeader();
+        const auto& header = sound->getHeader();
         if(header.samplesPerSec == targetFrequency)
             continue;
         if(header.numChannels != 1)
             throw std::runtime_error("Unexpected number of channels for item " + std::to_string(item));
         if(header.frameSize != 1 || header.bitsPerSample != 8)
             throw std::runtime_error("Unsupported format for item " + std::to_string(item));
-        converter.reset();
-        double rate = static_cast<double>(targetFrequency) / sound->getHeader().samplesPerSec;
-        input.resize(sound->getData().size());
-        std::transform(sound->getData().begin(), sound->getData().end(), input.begin(),
-                       [](uint8_t value) { return static_cast<float>(value) / std::numeric_limits<uint8_t>::max() * 2.f - 1.f; });
-        output.resize(static_cast<size_t>(std::ceil(input.size() * rate)));
-        const auto result = converter.process(samplerate::Data(input.data(), input.size(), output.data(), output.size(), rate));
-        std::vector<uint8_t> data(result.output_frames_gen);
-        std::transform(output.begin(), output.begin() + result.output_frames_gen, data.begin(), [](float value) {
-            int converted = std::lrint((value + 1.f) / 2.f * std::numeric_limits<uint8_t>::max());
-            return static_cast<uint8_t>(std::min<int>(std::numeric_limits<uint8_t>::max(), std::max(0, converted)));
-        });
-        header.samplesPerSec = targetFrequency;
-        header.bytesPerSec = targetFrequency;
-        header.frameSize = 1;
-        header.bitsPerSample = 8;
-        header.dataSize = data.size();
-        header.fileSize = data.size() + sizeof(header);
-        sound->setHeader(header);
-        sound->setData(data);
+        // Converting an item twice would not change it anymore
+        if(std::none_of(jobs.begin(), jobs.end(), [sound](const ConversionJob& job) { return job.sound == sound; }))
+            jobs.push_back(ConversionJob{static_cast<unsigned>(item), sound, std::vector<uint8_t>()});
     }
+    if(jobs.empty())
+        return true;
+
+    bfs::path cacheFilePath;
+    uint64_t cacheKey = 0;
+    bool loaded = false;
+    if(!cacheDir.empty())
+    {
+        cacheKey = calcCacheKey(script, jobs, sourceFile);
+        cacheFilePath = getCacheFilePath(cacheDir, cacheKey);
+        loaded = loadCache(cacheFilePath, cacheKey, jobs);
+    }
+    if(!loaded)
+    {
+        // Each job only reads and writes its own sound
+        const auto convert = [&jobs](size_t i) {
+            jobs[i].data = resample(jobs[i].sound->getData(), jobs[i].sound->getHeader().samplesPerSec);
+        };
+        if(threadPool)
+            threadPool->parallelFor(jobs.size(), convert);
+        else
+        {
+            for(size_t i = 0; i < jobs.size(); i++)
+                convert(i);
+        }
+        // A failure to write the cache only costs time on the next start
+        if(!cacheFilePath.empty() && saveCache(cacheFilePath, cacheKey, jobs))
+            removeOldCaches(cacheDir, cacheFilePath);
+    }
+
+    for(const ConversionJob& job : jobs)
+        setConvertedData(*job.sound, job.data);
     return true;
 }
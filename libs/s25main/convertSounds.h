@@ -20,10 +20,18 @@
 #include <boost/filesystem/path.hpp>
 
 namespace bfs = boost::filesystem;
+namespace helpers {
+class ThreadPool;
+}
 namespace libsiedler2 {
 class Archiv;
 }
 
-bool convertSounds(libsiedler2::Archiv& sounds, const bfs::path& scriptPath);
+/// Resample the sounds listed in the script to 44.1kHz. Return false if an item is missing
+/// If cacheDir is given the result is stored there and reused as long as the script and the source sounds do not change.
+/// If the file the sounds were loaded from is given, its size and modification time identify the sounds instead of their data.
+/// Items that need to be converted are processed in parallel if a threadPool is given
+bool convertSounds(libsiedler2::Archiv& sounds, const bfs::path& scriptPath, const bfs::path& cacheDir = bfs::path(),
+                   const bfs::path& sourceFile = bfs::path(), helpers::ThreadPool* threadPool = nullptr);
 
 #endif // convertSounds_h__
@@ -36,6 +36,7 @@
 #include "buildings/nobUsual.h"
 #include "controls/ctrlImageButton.h"
 #include "controls/ctrlText.h"
+#include "desktops/dskGameLoader.h"
 #include "driver/MouseCoords.h"
 #include "drivers/VideoDriverWrapper.h"
 #include "helpers/format.hpp"
@@ -1081,6 +1082,12 @@ void dskGameInterface::GI_FlagDestroyed(const MapPoint pt)
     }
 }
 
+void dskGameInterface::CI_GameLoading(const std::shared_ptr<Game>& game)
+{
+    // The game was replaced (e.g. jump to a replay keyframe) -> Recreate the UI for it
+    WINDOWMANAGER.Switch(std::make_unique<dskGameLoader>(game));
+}
+
 void dskGameInterface::CI_PlayerLeft(const unsigned playerId)
 {
     // Info-Meldung ausgeben
@@ -61,6 +61,7 @@ public:
 
     RoadBuildMode GetRoadMode() const { return road.mode; }
 
+    void CI_GameLoading(const std::shared_ptr<Game>& game) override;
     void CI_PlayerLeft(unsigned playerId) override;
     void CI_GGSChanged(const GlobalGameSettings& ggs) override;
     void CI_Chat(unsigned playerId, ChatDestination cd, const std::string& msg) override;
@@ -89,6 +89,9 @@ void dskGameLoader::Msg_Timer(const unsigned /*ctrl_id*/)
     switch(position)
     {
         case 0: // Kartename anzeigen
+            // The UI of a game replaced by a replay keyframe is gone now
+            if(!GAMECLIENT.LoadPendingReplayKeyframe())
+                return;
             text->SetText(GAMECLIENT.GetMapTitle());
             break;
 
@@ -75,8 +75,10 @@ void dskSplash::LoadFiles()
     LOADER.ClearOverrideFolders();
     LOADER.AddOverrideFolder("<RTTR_RTTR>/LSTS");
     LOADER.AddOverrideFolder("<RTTR_USERDATA>/LSTS");
+    LOADER.ResetLoadingPhases();
     if(LOADER.LoadFilesAtStart())
     {
+        LOADER.WriteLoadingReport();
         isLoaded = true;
         AddTimer(2, 5000);
         SetFpsDisplay(true);
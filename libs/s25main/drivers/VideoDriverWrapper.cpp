@@ -28,6 +28,7 @@
 #include "mygettext/mygettext.h"
 #include "ogl/DummyRenderer.h"
 #include "ogl/OpenGLRenderer.h"
+#include "ogl/SpriteBatch.h"
 #include "openglCfg.hpp"
 #include "libutil/Log.h"
 #include "libutil/error.h"
@@ -244,6 +245,14 @@ void VideoDriverWrapper::BindTexture(unsigned t)
     }
 }
 
+ogl::SpriteBatch* VideoDriverWrapper::GetActiveSpriteBatch()
+{
+    if(!renderer_)
+        return nullptr;
+    ogl::SpriteBatch& batch = renderer_->GetSpriteBatch();
+    return batch.isActive() ? &batch : nullptr;
+}
+
 void VideoDriverWrapper::DeleteTexture(unsigned t)
 {
     if(!t)
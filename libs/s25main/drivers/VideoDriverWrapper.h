@@ -29,6 +29,9 @@ class IVideoDriver;
 class IRenderer;
 class FrameCounter;
 class FrameLimiter;
+namespace ogl {
+class SpriteBatch;
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 // DriverWrapper
@@ -62,6 +65,8 @@ public:
     void DeleteTexture(unsigned t);
 
     IRenderer* GetRenderer() { return renderer_.get(); }
+    /// Return the sprite batch of the renderer if it is currently collecting sprites, nullptr otherwise
+    ogl::SpriteBatch* GetActiveSpriteBatch();
 
     /// Swapped den Buffer
     void SwapBuffers();
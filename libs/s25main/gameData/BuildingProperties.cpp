@@ -17,18 +17,22 @@
 
 #include "rttrDefines.h" // IWYU pragma: keep
 #include "BuildingProperties.h"
+#include <mutex>
 
 boost::container::static_vector<BuildingType, NUM_BUILDING_TYPES / 4u> BuildingProperties::militaryBldTypes;
 
 void BuildingProperties::Init()
 {
-    militaryBldTypes.clear();
-    for(unsigned i = 0; i < NUM_BUILDING_TYPES; i++)
-    {
-        auto bld = BuildingType(i);
-        if(IsMilitary(bld))
-            militaryBldTypes.push_back(bld);
-    }
+    // Constant data, so fill only once. Worlds might be created concurrently
+    static std::once_flag initialized;
+    std::call_once(initialized, []() {
+        for(unsigned i = 0; i < NUM_BUILDING_TYPES; i++)
+        {
+            auto bld = BuildingType(i);
+            if(IsMilitary(bld))
+                militaryBldTypes.push_back(bld);
+        }
+    });
 }
 
 bool BuildingProperties::IsMilitary(BuildingType bld)
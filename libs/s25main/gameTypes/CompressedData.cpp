@@ -26,6 +26,25 @@
 #include <cstring>
 #include <memory>
 
+namespace {
+int decompress(const std::vector<char>& compressedData, char* buffer, unsigned& bufferLength)
+{
+    // bzip2 does not use const but does not modify the input
+    return BZ2_bzBuffToBuffDecompress(buffer, &bufferLength, const_cast<char*>(compressedData.data()), compressedData.size(), 0, 0);
+}
+
+int compress(const char* buffer, unsigned bufferLength, std::vector<char>& compressedData)
+{
+    // Buffer should be at most 1% bigger + 600 Bytes according to docu
+    compressedData.resize(static_cast<int>(std::ceil(bufferLength * 1.1)) + 600);
+    unsigned compressedLen = compressedData.size();
+    int err = BZ2_bzBuffToBuffCompress(&compressedData[0], &compressedLen, const_cast<char*>(buffer), bufferLength, 9, 0, 250);
+    if(err == BZ_OK)
+        compressedData.resize(compressedLen);
+    return err;
+}
+} // namespace
+
 bool CompressedData::DecompressToFile(const std::string& filePath, unsigned* checksum)
 {
     bnw::ofstream file(filePath, std::ios::binary);
@@ -40,7 +59,7 @@ bool CompressedData::DecompressToFile(const std::string& filePath, unsigned* che
 
     unsigned outLength = length;
 
-    int err = BZ2_bzBuffToBuffDecompress(uncompressedData.get(), &outLength, &data[0], data.size(), 0, 0);
+    int err = decompress(data, uncompressedData.get(), outLength);
     if(err != BZ_OK)
     {
         LOG.write("FATAL ERROR: BZ2_bzBuffToBuffDecompress failed with code %d\n") % err;
@@ -69,7 +88,6 @@ bool CompressedData::CompressFromFile(const std::string& filePath, unsigned* che
 {
     bnw::ifstream file(filePath, std::ios::binary | std::ios::ate);
     length = static_cast<unsigned>(file.tellg());
-    data.resize(static_cast<int>(std::ceil(length * 1.1)) + 600); // Buffer should be at most 1% bigger + 600 Bytes according to docu
     file.seekg(0);
 
     auto uncompressedData = std::unique_ptr<char[]>(new char[length]);
@@ -80,16 +98,29 @@ bool CompressedData::CompressFromFile(const std::string& filePath, unsigned* che
         return false;
     }
 
-    unsigned compressedLen = data.size();
-    int err = BZ2_bzBuffToBuffCompress(&data[0], &compressedLen, uncompressedData.get(), length, 9, 0, 250);
+    int err = compress(uncompressedData.get(), length, data);
     if(err != BZ_OK)
     {
         LOG.write("FATAL ERROR: BZ2_bzBuffToBuffCompress failed with error: %d\n") % err;
         return false;
     }
-    data.resize(compressedLen);
 
     if(checksum)
         *checksum = CalcChecksumOfBuffer(uncompressedData.get(), length);
     return true;
 }
+
+bool CompressedData::DecompressToBuffer(char* buffer) const
+{
+    unsigned outLength = length;
+    return decompress(data, buffer, outLength) == BZ_OK && outLength == length;
+}
+
+bool CompressedData::CompressFromBuffer(const char* buffer, unsigned bufferLength)
+{
+    length = bufferLength;
+    if(compress(buffer, bufferLength, data) == BZ_OK)
+        return true;
+    Clear();
+    return false;
+}
@@ -32,6 +32,10 @@ struct CompressedData
     }
     bool DecompressToFile(const std::string& filePath, unsigned* checksum = nullptr);
     bool CompressFromFile(const std::string& filePath, unsigned* checksum = nullptr);
+    /// Decompress into the buffer which must be able to hold length bytes. Does not log so it can be used from any thread
+    bool DecompressToBuffer(char* buffer) const;
+    /// Compress the buffer replacing the current data. Does not log so it can be used from any thread
+    bool CompressFromBuffer(const char* buffer, unsigned bufferLength);
 
     /// Uncompressed length
     unsigned length;
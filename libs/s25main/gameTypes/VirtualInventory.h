@@ -20,12 +20,92 @@
 
 #include "gameTypes/Inventory.h"
 
+/// Inventory which additionally applies all changes to a linked sum inventory (e.g. the sum over all warehouses of a player)
+/// Direct writes to goods/people are not forwarded, so only do that while not linked
+struct LinkedInventory : Inventory
+{
+    LinkedInventory() : sum(nullptr) {}
+    /// Copies the content only, the copy is not linked
+    LinkedInventory(const LinkedInventory& other) : Inventory(other), sum(nullptr) {}
+    LinkedInventory& operator=(const LinkedInventory& other) { return *this = static_cast<const Inventory&>(other); }
+    /// Replaces the content and keeps the link
+    LinkedInventory& operator=(const Inventory& other)
+    {
+        if(sum)
+            RemoveFrom(*sum);
+        Inventory::operator=(other);
+        if(sum)
+            AddTo(*sum);
+        return *this;
+    }
+
+    /// Link to the given sum (nullptr to unlink). The current content is moved from the old sum to the new one
+    void SetSum(Inventory* newSum)
+    {
+        if(sum)
+            RemoveFrom(*sum);
+        sum = newSum;
+        if(sum)
+            AddTo(*sum);
+    }
+
+    /// Sets everything to 0
+    void clear()
+    {
+        if(sum)
+            RemoveFrom(*sum);
+        Inventory::clear();
+    }
+    void Add(const GoodType good, unsigned amount = 1)
+    {
+        Inventory::Add(good, amount);
+        if(sum)
+            sum->Add(good, amount);
+    }
+    void Add(const Job job, unsigned amount = 1)
+    {
+        Inventory::Add(job, amount);
+        if(sum)
+            sum->Add(job, amount);
+    }
+    void Remove(const GoodType good, unsigned amount = 1)
+    {
+        Inventory::Remove(good, amount);
+        if(sum)
+            sum->Remove(good, amount);
+    }
+    void Remove(const Job job, unsigned amount = 1)
+    {
+        Inventory::Remove(job, amount);
+        if(sum)
+            sum->Remove(job, amount);
+    }
+
+private:
+    Inventory* sum;
+
+    void AddTo(Inventory& other) const
+    {
+        for(unsigned i = 0; i < NUM_WARE_TYPES; i++)
+            other.Add(GoodType(i), goods[i]);
+        for(unsigned i = 0; i < NUM_JOB_TYPES; i++)
+            other.Add(Job(i), people[i]);
+    }
+    void RemoveFrom(Inventory& other) const
+    {
+        for(unsigned i = 0; i < NUM_WARE_TYPES; i++)
+            other.Remove(GoodType(i), goods[i]);
+        for(unsigned i = 0; i < NUM_JOB_TYPES; i++)
+            other.Remove(Job(i), people[i]);
+    }
+};
+
 /// Inventory which is divided into a real and a visual part
 /// Mainly for warehouses, where the visual part is the amount currently in the warehouse (including those, that are to be moved out)
 /// and the real part is the amount that is available for use
 struct VirtualInventory
 {
-    Inventory visual, real;
+    LinkedInventory visual, real;
 
     VirtualInventory() { clear(); }
     /// Sets everything to 0
@@ -34,6 +114,12 @@ struct VirtualInventory
         visual.clear();
         real.clear();
     }
+    /// Link both parts to the respective parts of the sum (nullptr to unlink)
+    void SetSum(VirtualInventory* sum)
+    {
+        visual.SetSum(sum ? &sum->visual : nullptr);
+        real.SetSum(sum ? &sum->real : nullptr);
+    }
     /// Adds goods to both inventories
     void Add(const GoodType good, unsigned amount = 1)
     {
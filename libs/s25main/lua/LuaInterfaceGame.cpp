@@ -19,6 +19,7 @@
 #include "LuaInterfaceGame.h"
 #include "EventManager.h"
 #include "Game.h"
+#include "SimProfiler.h"
 #include "WindowManager.h"
 #include "ai/AIInterface.h"
 #include "ai/AIPlayer.h"
@@ -31,7 +32,12 @@
 #include "gameTypes/Resource.h"
 #include "libutil/Serializer.h"
 
-LuaInterfaceGame::LuaInterfaceGame(const std::weak_ptr<Game>& gameInstance) : gw(gameInstance.lock()->world_), game(gameInstance)
+const std::array<const char*, LuaInterfaceGame::NUM_HOOKS> LuaInterfaceGame::hookNames = {
+  {"onSave", "onLoad", "onStart", "onGameFrame", "onExplored", "onExploredPoints", "onOccupied", "onOccupiedPoints", "onResourceFound",
+   "onCancelPactRequest", "onSuggestPact", "onPactCanceled", "onPactCreated"}};
+
+LuaInterfaceGame::LuaInterfaceGame(const std::weak_ptr<Game>& gameInstance)
+    : gw(gameInstance.lock()->world_), game(gameInstance), presentHooks(0)
 {
 #pragma region ConstDefs
 #define ADD_LUA_CONST(name) lua[#name] = name
@@ -172,10 +178,55 @@ LuaInterfaceGame::LuaInterfaceGame(const std::weak_ptr<Game>& gameInstance) : gw
     LuaWorld::Register(lua);
 
     lua["rttr"] = this;
+
+    InstallHookTracking();
 }
 
 LuaInterfaceGame::~LuaInterfaceGame() = default;
 
+void LuaInterfaceGame::InstallHookTracking()
+{
+    // The hooks are never stored in the globals table itself, so every assignment (also redefinitions) goes through __newindex
+    // and reading them from Lua gets them via __index
+    lua["rttrSetHook"] = kaguya::function([this](const std::string& name, const kaguya::LuaRef& func) { SetHook(name, func); });
+    std::string code = "local setHook = rttrSetHook\n"
+                       "rttrSetHook = nil\n"
+                       "local isHook, hooks = {}, {}\n";
+    for(const char* name : hookNames)
+        code += std::string("isHook['") + name + "'] = true\n";
+    code += "setmetatable(_G, {\n"
+            "  __index = hooks,\n"
+            "  __newindex = function(t, k, v)\n"
+            "    if isHook[k] then\n"
+            "      hooks[k] = v\n"
+            "      setHook(k, v)\n"
+            "    else\n"
+            "      rawset(t, k, v)\n"
+            "    end\n"
+            "  end\n"
+            "})\n";
+    lua.dostring(code);
+}
+
+void LuaInterfaceGame::SetHook(const std::string& name, const kaguya::LuaRef& func)
+{
+    for(unsigned i = 0; i < NUM_HOOKS; i++)
+    {
+        if(name != hookNames[i])
+            continue;
+        if(func.type() == LUA_TFUNCTION)
+        {
+            hookFuncs[i] = func;
+            presentHooks |= 1u << i;
+        } else
+        {
+            hookFuncs[i] = kaguya::LuaRef();
+            presentHooks &= ~(1u << i);
+        }
+        return;
+    }
+}
+
 KAGUYA_MEMBER_FUNCTION_OVERLOADS(SetMissionGoalWrapper, LuaInterfaceGame, SetMissionGoal, 1, 2)
 
 void LuaInterfaceGame::Register(kaguya::State& state)
@@ -206,11 +257,10 @@ void LuaInterfaceGame::Register(kaguya::State& state)
 
 bool LuaInterfaceGame::Serialize(Serializer& luaSaveState)
 {
-    kaguya::LuaRef save = lua["onSave"];
-    if(save.type() == LUA_TFUNCTION)
+    if(HasHook(HOOK_SAVE))
     {
         ClearErrorOccured();
-        if(save.call<bool>(kaguya::standard::ref(luaSaveState)) && !HasErrorOccurred())
+        if(hookFuncs[HOOK_SAVE].call<bool>(kaguya::standard::ref(luaSaveState)) && !HasErrorOccurred())
             return true;
         else
         {
@@ -223,11 +273,10 @@ bool LuaInterfaceGame::Serialize(Serializer& luaSaveState)
 
 bool LuaInterfaceGame::Deserialize(Serializer& luaSaveState)
 {
-    kaguya::LuaRef load = lua["onLoad"];
-    if(load.type() == LUA_TFUNCTION)
+    if(HasHook(HOOK_LOAD))
     {
         ClearErrorOccured();
-        return load.call<bool>(kaguya::standard::ref(luaSaveState)) && !HasErrorOccurred();
+        return hookFuncs[HOOK_LOAD].call<bool>(kaguya::standard::ref(luaSaveState)) && !HasErrorOccurred();
     } else
         return true;
 }
@@ -306,94 +355,183 @@ LuaWorld LuaInterfaceGame::GetWorld()
 
 void LuaInterfaceGame::EventExplored(unsigned player, const MapPoint pt, unsigned char owner)
 {
-    kaguya::LuaRef onExplored = lua["onExplored"];
-    if(onExplored.type() == LUA_TFUNCTION)
+    if(HasHook(HOOK_EXPLORED_POINTS))
+    {
+        if(exploredPts.size() <= player)
+            exploredPts.resize(player + 1);
+        exploredPts[player].emplace_back(pt, owner);
+    }
+    if(HasHook(HOOK_EXPLORED))
     {
+        RTTR_PROFILE_SCOPE(PROF_LUA, "onExplored", player);
         if(owner == 0)
         {
             // No owner? Pass nil value to Lua.
-            onExplored.call<void>(player, pt.x, pt.y, kaguya::NilValue());
+            hookFuncs[HOOK_EXPLORED].call<void>(player, pt.x, pt.y, kaguya::NilValue());
         } else
         {
             // Adapt owner to be comparable with the player index
-            onExplored.call<void>(player, pt.x, pt.y, owner - 1);
+            hookFuncs[HOOK_EXPLORED].call<void>(player, pt.x, pt.y, owner - 1);
         }
     }
 }
 
 void LuaInterfaceGame::EventOccupied(unsigned player, const MapPoint pt)
 {
-    kaguya::LuaRef onOccupied = lua["onOccupied"];
-    if(onOccupied.type() == LUA_TFUNCTION)
-        onOccupied.call<void>(player, pt.x, pt.y);
+    if(HasHook(HOOK_OCCUPIED_POINTS))
+    {
+        if(occupiedPts.size() <= player)
+            occupiedPts.resize(player + 1);
+        occupiedPts[player].push_back(pt);
+    }
+    if(HasHook(HOOK_OCCUPIED))
+    {
+        RTTR_PROFILE_SCOPE(PROF_LUA, "onOccupied", player);
+        hookFuncs[HOOK_OCCUPIED].call<void>(player, pt.x, pt.y);
+    }
 }
 
 void LuaInterfaceGame::EventStart(bool isFirstStart)
 {
-    kaguya::LuaRef onStart = lua["onStart"];
-    if(onStart.type() == LUA_TFUNCTION)
-        onStart.call<void>(isFirstStart);
+    if(HasHook(HOOK_START))
+    {
+        RTTR_PROFILE_SCOPE(PROF_LUA, "onStart", 0);
+        hookFuncs[HOOK_START].call<void>(isFirstStart);
+    }
 }
 
 void LuaInterfaceGame::EventGameFrame(unsigned nr)
 {
-    kaguya::LuaRef onGameFrame = lua["onGameFrame"];
-    if(onGameFrame.type() == LUA_TFUNCTION)
-        onGameFrame.call<void>(nr);
+    SendBatchedPoints();
+    if(HasHook(HOOK_GAMEFRAME))
+    {
+        RTTR_PROFILE_SCOPE(PROF_LUA, "onGameFrame", 0);
+        hookFuncs[HOOK_GAMEFRAME].call<void>(nr);
+    }
+}
+
+bool LuaInterfaceGame::IsGameFrameIdle() const
+{
+    if(HasHook(HOOK_GAMEFRAME))
+        return false;
+    for(const auto& pts : exploredPts)
+    {
+        if(!pts.empty())
+            return false;
+    }
+    for(const auto& pts : occupiedPts)
+    {
+        if(!pts.empty())
+            return false;
+    }
+    return true;
+}
+
+void LuaInterfaceGame::SendBatchedPoints()
+{
+    // Points are passed as {{x, y, owner}, ...} and {{x, y}, ...}. Owner is nil for unowned points
+    for(unsigned player = 0; player < exploredPts.size(); player++)
+    {
+        std::vector<std::pair<MapPoint, unsigned char>>& pts = exploredPts[player];
+        if(pts.empty())
+            continue;
+        // The hook might have been removed since the points were collected
+        if(HasHook(HOOK_EXPLORED_POINTS))
+        {
+            RTTR_PROFILE_SCOPE(PROF_LUA, "onExploredPoints", player);
+            kaguya::LuaTable luaPts = lua.newTable();
+            for(unsigned i = 0; i < pts.size(); i++)
+            {
+                kaguya::LuaTable luaPt = lua.newTable();
+                luaPt[1] = pts[i].first.x;
+                luaPt[2] = pts[i].first.y;
+                if(pts[i].second != 0)
+                    luaPt[3] = pts[i].second - 1;
+                luaPts[i + 1] = luaPt;
+            }
+            pts.clear();
+            hookFuncs[HOOK_EXPLORED_POINTS].call<void>(player, luaPts);
+        } else
+            pts.clear();
+    }
+    for(unsigned player = 0; player < occupiedPts.size(); player++)
+    {
+        std::vector<MapPoint>& pts = occupiedPts[player];
+        if(pts.empty())
+            continue;
+        if(HasHook(HOOK_OCCUPIED_POINTS))
+        {
+            RTTR_PROFILE_SCOPE(PROF_LUA, "onOccupiedPoints", player);
+            kaguya::LuaTable luaPts = lua.newTable();
+            for(unsigned i = 0; i < pts.size(); i++)
+            {
+                kaguya::LuaTable luaPt = lua.newTable();
+                luaPt[1] = pts[i].x;
+                luaPt[2] = pts[i].y;
+                luaPts[i + 1] = luaPt;
+            }
+            pts.clear();
+            hookFuncs[HOOK_OCCUPIED_POINTS].call<void>(player, luaPts);
+        } else
+            pts.clear();
+    }
 }
 
 void LuaInterfaceGame::EventResourceFound(unsigned char player, const MapPoint pt, unsigned char type, unsigned char quantity)
 {
-    kaguya::LuaRef onResourceFound = lua["onResourceFound"];
-    if(onResourceFound.type() == LUA_TFUNCTION)
-        onResourceFound.call<void>(player, pt.x, pt.y, type, quantity);
+    if(HasHook(HOOK_RESOURCE_FOUND))
+    {
+        RTTR_PROFILE_SCOPE(PROF_LUA, "onResourceFound", player);
+        hookFuncs[HOOK_RESOURCE_FOUND].call<void>(player, pt.x, pt.y, type, quantity);
+    }
 }
 
 bool LuaInterfaceGame::EventCancelPactRequest(PactType pt, unsigned char canceledByPlayerId, unsigned char targetPlayerId)
 {
-    kaguya::LuaRef onPactCancel = lua["onCancelPactRequest"];
-    if(onPactCancel.type() == LUA_TFUNCTION)
-        return onPactCancel.call<bool>(pt, canceledByPlayerId, targetPlayerId);
+    if(HasHook(HOOK_CANCEL_PACT_REQUEST))
+    {
+        RTTR_PROFILE_SCOPE(PROF_LUA, "onCancelPactRequest", targetPlayerId);
+        return hookFuncs[HOOK_CANCEL_PACT_REQUEST].call<bool>(pt, canceledByPlayerId, targetPlayerId);
+    }
     return true; // always accept pact cancel if there is no handler
 }
 
 void LuaInterfaceGame::EventSuggestPact(const PactType pt, unsigned char suggestedByPlayerId, unsigned char targetPlayerId,
                                         const unsigned duration)
 {
+    if(!HasHook(HOOK_SUGGEST_PACT))
+        return;
     auto gameInst = game.lock();
     if(!gameInst)
         return;
     AIPlayer* ai = gameInst->GetAIPlayer(targetPlayerId);
     if(ai != nullptr)
     {
-        kaguya::LuaRef onPactCancel = lua["onSuggestPact"];
-        if(onPactCancel.type() == LUA_TFUNCTION)
-        {
-            AIInterface& aii = ai->getAIInterface();
-            auto luaResult = onPactCancel.call<bool>(pt, suggestedByPlayerId, targetPlayerId, duration);
-            if(luaResult)
-                aii.AcceptPact(gw.GetEvMgr().GetCurrentGF(), pt, suggestedByPlayerId);
-            else
-                aii.CancelPact(pt, suggestedByPlayerId);
-        }
+        RTTR_PROFILE_SCOPE(PROF_LUA, "onSuggestPact", targetPlayerId);
+        AIInterface& aii = ai->getAIInterface();
+        auto luaResult = hookFuncs[HOOK_SUGGEST_PACT].call<bool>(pt, suggestedByPlayerId, targetPlayerId, duration);
+        if(luaResult)
+            aii.AcceptPact(gw.GetEvMgr().GetCurrentGF(), pt, suggestedByPlayerId);
+        else
+            aii.CancelPact(pt, suggestedByPlayerId);
     }
 }
 
 void LuaInterfaceGame::EventPactCanceled(const PactType pt, unsigned char canceledByPlayerId, unsigned char targetPlayerId)
 {
-    kaguya::LuaRef onPactCanceled = lua["onPactCanceled"];
-    if(onPactCanceled.type() == LUA_TFUNCTION)
+    if(HasHook(HOOK_PACT_CANCELED))
     {
-        onPactCanceled.call<void>(pt, canceledByPlayerId, targetPlayerId);
+        RTTR_PROFILE_SCOPE(PROF_LUA, "onPactCanceled", targetPlayerId);
+        hookFuncs[HOOK_PACT_CANCELED].call<void>(pt, canceledByPlayerId, targetPlayerId);
     }
 }
 
 void LuaInterfaceGame::EventPactCreated(const PactType pt, unsigned char suggestedByPlayerId, unsigned char targetPlayerId,
                                         const unsigned duration)
 {
-    kaguya::LuaRef onPactCreated = lua["onPactCreated"];
-    if(onPactCreated.type() == LUA_TFUNCTION)
+    if(HasHook(HOOK_PACT_CREATED))
     {
-        onPactCreated.call<void>(pt, suggestedByPlayerId, targetPlayerId, duration);
+        RTTR_PROFILE_SCOPE(PROF_LUA, "onPactCreated", targetPlayerId);
+        hookFuncs[HOOK_PACT_CREATED].call<void>(pt, suggestedByPlayerId, targetPlayerId, duration);
     }
 }
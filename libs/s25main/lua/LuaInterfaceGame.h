@@ -21,8 +21,11 @@
 #include "LuaInterfaceGameBase.h"
 #include "gameTypes/MapCoordinates.h"
 #include "gameTypes/PactTypes.h"
+#include <array>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 class GameWorldGame;
 class LuaPlayer;
@@ -41,10 +44,14 @@ public:
     bool Serialize(Serializer& luaSaveState);
     bool Deserialize(Serializer& luaSaveState);
 
+    /// Per node events. Call onExplored/onOccupied directly and collect the points for onExploredPoints/onOccupiedPoints
     void EventExplored(unsigned player, MapPoint pt, unsigned char owner);
     void EventOccupied(unsigned player, MapPoint pt);
     void EventStart(bool isFirstStart);
+    /// Passes the points collected since the last GF to onExploredPoints/onOccupiedPoints and then calls onGameFrame
     void EventGameFrame(unsigned nr);
+    /// Return true if EventGameFrame does not call into Lua (no onGameFrame hook and no collected points)
+    bool IsGameFrameIdle() const;
     void EventResourceFound(unsigned char player, MapPoint pt, unsigned char type, unsigned char quantity);
     // Called if player wants to cancel a pact
     bool EventCancelPactRequest(PactType pt, unsigned char canceledByPlayerId, unsigned char targetPlayerId);
@@ -67,8 +74,40 @@ public:
     void PostMessageWithLocation(unsigned playerIdx, const std::string& msg, int x, int y);
 
 private:
+    /// Functions called by the game. Kept in sync with the definitions in the script (see InstallHookTracking)
+    enum Hook
+    {
+        HOOK_SAVE,
+        HOOK_LOAD,
+        HOOK_START,
+        HOOK_GAMEFRAME,
+        HOOK_EXPLORED,
+        HOOK_EXPLORED_POINTS,
+        HOOK_OCCUPIED,
+        HOOK_OCCUPIED_POINTS,
+        HOOK_RESOURCE_FOUND,
+        HOOK_CANCEL_PACT_REQUEST,
+        HOOK_SUGGEST_PACT,
+        HOOK_PACT_CANCELED,
+        HOOK_PACT_CREATED,
+        NUM_HOOKS
+    };
+    static const std::array<const char*, NUM_HOOKS> hookNames;
+
     GameWorldGame& gw;
     std::weak_ptr<Game> game;
+    std::array<kaguya::LuaRef, NUM_HOOKS> hookFuncs;
+    /// Bit i set <=> hookFuncs[i] is a function
+    unsigned presentHooks;
+    /// Points explored/occupied in the current GF per player. Owner is 0 for no owner, else playerIdx + 1
+    std::vector<std::vector<std::pair<MapPoint, unsigned char>>> exploredPts;
+    std::vector<std::vector<MapPoint>> occupiedPts;
+
+    bool HasHook(Hook hook) const { return (presentHooks & (1u << hook)) != 0u; }
+    /// Route assignments to the hook names through a metatable of the globals so the cached functions are always current
+    void InstallHookTracking();
+    void SetHook(const std::string& name, const kaguya::LuaRef& func);
+    void SendBatchedPoints();
     LuaPlayer GetPlayer(unsigned playerIdx);
     LuaWorld GetWorld();
 };
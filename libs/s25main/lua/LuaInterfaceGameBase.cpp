@@ -30,7 +30,7 @@ unsigned LuaInterfaceGameBase::GetVersion()
 
 unsigned LuaInterfaceGameBase::GetFeatureLevel()
 {
-    return 3;
+    return 4;
 }
 
 LuaInterfaceGameBase::LuaInterfaceGameBase()
@@ -20,6 +20,7 @@
 #include "mapGenerator/MapSettings.h"
 #include "mapGenerator/RandomConfig.h"
 #include "mapGenerator/RandomMapGenerator.h"
+#include "helpers/ThreadPool.h"
 #include "libsiedler2/Archiv.h"
 #include "libsiedler2/libsiedler2.h"
 #include <stdexcept>
@@ -30,7 +31,8 @@ void MapGenerator::Create(const std::string& filePath, const MapSettings& settin
     RandomConfig config;
     if(!config.Init(settings.style, settings.type))
         throw std::runtime_error("Error initializing random map config");
-    RandomMapGenerator generator(config);
+    helpers::ThreadPool threadPool;
+    RandomMapGenerator generator(config, &threadPool);
     Map randomMap = generator.Create(settings);
 
     // generate the random map
@@ -0,0 +1,92 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "mapGenerator/MapMetrics.h"
+#include "mapGenerator/Map.h"
+#include "mapGenerator/ObjectGenerator.h"
+#include "mapGenerator/RandomConfig.h"
+#include "mapGenerator/VertexUtility.h"
+#include "gameData/TerrainDesc.h"
+#include "libsiedler2/enumTypes.h"
+#include <algorithm>
+
+namespace {
+/// Add the amount if the resource value is of the given type (type + amount 0..7)
+bool addResource(uint8_t resource, uint8_t type, unsigned& total)
+{
+    if(resource < type || resource >= type + 8)
+        return false;
+    total += resource - type;
+    return true;
+}
+} // namespace
+
+MapMetrics MapMetrics::Compute(const Map& map, const RandomConfig& config)
+{
+    MapMetrics metrics;
+    metrics.buildableArea.resize(map.numPlayers, 0);
+    unsigned numWater = 0;
+
+    RTTR_FOREACH_PT(Position, map.size)
+    {
+        const int index = VertexUtility::GetIndexOf(pt, map.size);
+        const TerrainDesc& tRsu = config.GetTerrainByS2Id(map.textureRsu[index]);
+        const TerrainDesc& tLsd = config.GetTerrainByS2Id(map.textureLsd[index]);
+
+        if(tRsu.kind == TerrainKind::WATER && tLsd.kind == TerrainKind::WATER)
+            numWater++;
+
+        if(ObjectGenerator::IsTree(map, index))
+            metrics.trees++;
+        else if(map.objectInfo[index] == libsiedler2::OI_Stone1 || map.objectInfo[index] == libsiedler2::OI_Stone2)
+            metrics.stones++;
+
+        const uint8_t res = map.resource[index];
+        if(res == libsiedler2::R_Water)
+            metrics.water++;
+        else if(res == libsiedler2::R_Fish)
+            metrics.fish++;
+        else if(!addResource(res, libsiedler2::R_Gold, metrics.gold) && !addResource(res, libsiedler2::R_Iron, metrics.iron)
+                && !addResource(res, libsiedler2::R_Coal, metrics.coal))
+            addResource(res, libsiedler2::R_Granite, metrics.granite);
+
+        if(map.numPlayers == 0 || !ObjectGenerator::IsEmpty(map, index) || !tRsu.Is(ETerrain::Buildable)
+           || !tLsd.Is(ETerrain::Buildable))
+            continue;
+        unsigned closestPlayer = 0;
+        double closestDistance = VertexUtility::Distance(pt, Position(map.hqPositions[0]), map.size);
+        for(unsigned i = 1; i < map.numPlayers; i++)
+        {
+            const double distance = VertexUtility::Distance(pt, Position(map.hqPositions[i]), map.size);
+            if(distance < closestDistance)
+            {
+                closestPlayer = i;
+                closestDistance = distance;
+            }
+        }
+        metrics.buildableArea[closestPlayer]++;
+    }
+
+    metrics.waterShare = static_cast<double>(numWater) / prodOfComponents(map.size);
+    if(!metrics.buildableArea.empty())
+    {
+        const auto minMax = std::minmax_element(metrics.buildableArea.begin(), metrics.buildableArea.end());
+        metrics.hqFairness = *minMax.second ? static_cast<double>(*minMax.first) / *minMax.second : 1.;
+    }
+    return metrics;
+}
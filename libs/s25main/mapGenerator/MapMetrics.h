@@ -0,0 +1,71 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef MapMetrics_h__
+#define MapMetrics_h__
+
+#include <vector>
+
+class RandomConfig;
+struct Map;
+
+/**
+ * Quality metrics of a generated map, e.g. to compare generator versions or to find unfair maps.
+ */
+struct MapMetrics
+{
+    /**
+     * Number of free buildable vertices (both triangles buildable, no object) closer to the headquarter
+     * of the player than to any other headquarter.
+     */
+    std::vector<unsigned> buildableArea;
+
+    /**
+     * Smallest buildable area of all players divided by the largest one (1 = same area for all players).
+     */
+    double hqFairness = 1.;
+
+    /**
+     * Share of the vertices completely surrounded by water in [0, 1].
+     */
+    double waterShare = 0.;
+
+    /**
+     * Sum of the amounts of the mountain resources.
+     */
+    unsigned gold = 0, iron = 0, coal = 0, granite = 0;
+
+    /**
+     * Number of vertices with water or fish resources.
+     */
+    unsigned water = 0, fish = 0;
+
+    /**
+     * Number of trees and stone piles.
+     */
+    unsigned trees = 0, stones = 0;
+
+    /**
+     * Computes the metrics of the map.
+     * @param map generated map
+     * @param config configuration the map was generated with
+     * @return the metrics of the map
+     */
+    static MapMetrics Compute(const Map& map, const RandomConfig& config);
+};
+
+#endif // MapMetrics_h__
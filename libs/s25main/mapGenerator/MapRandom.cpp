@@ -0,0 +1,52 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "mapGenerator/MapRandom.h"
+
+namespace {
+/// Finalizer of SplitMix64: Maps consecutive inputs to well distributed outputs
+uint64_t mix(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15u;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9u;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBu;
+    return x ^ (x >> 31);
+}
+} // namespace
+
+MapRandom::MapRandom(uint64_t seed, uint64_t key) : key_(mix(seed ^ mix(key))), counter_(0) {}
+
+uint64_t MapRandom::Next()
+{
+    return mix(key_ + mix(counter_++));
+}
+
+int MapRandom::Rand(const int min, const int max)
+{
+    RTTR_Assert(max > min);
+    // Don't use the std distributions as their results differ between implementations
+    const auto range = static_cast<uint64_t>(static_cast<int64_t>(max) - min);
+    return min + static_cast<int>(((Next() >> 32) * range) >> 32);
+}
+
+double MapRandom::DRand(const double min, const double max)
+{
+    // 53 random bits -> [0, 1)
+    const double value = static_cast<double>(Next() >> 11) / static_cast<double>(uint64_t(1) << 53);
+    return min + value * (max - min);
+}
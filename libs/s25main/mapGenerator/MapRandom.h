@@ -0,0 +1,64 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef MapRandom_h__
+#define MapRandom_h__
+
+#include <cstdint>
+
+/**
+ * Counter based random number generator for the map generation.
+ * The numbers only depend on the seed, the key and the number of values drawn so far.
+ * Using e.g. the vertex index as the key allows to generate the vertices in any order (or in parallel)
+ * and still get the same map for a seed.
+ */
+class MapRandom
+{
+public:
+    MapRandom(uint64_t seed, uint64_t key);
+
+    /**
+     * Generates a random number between 0 and max-1.
+     * @param max maximum value
+     * @return a new random number
+     */
+    int Rand(int max) { return Rand(0, max); }
+
+    /**
+     * Generates a random number between min and max-1.
+     * @param min minimum value
+     * @param max maximum value
+     * @return a new random number
+     */
+    int Rand(int min, int max);
+
+    /**
+     * Generates a random number between min and max.
+     * @param min minimum value
+     * @param max maximum value
+     * @return a new random number
+     */
+    double DRand(double min, double max);
+
+private:
+    uint64_t Next();
+
+    uint64_t key_;
+    uint64_t counter_;
+};
+
+#endif // MapRandom_h__
@@ -85,58 +85,67 @@ unsigned MapUtility::GetBodySize(Map& map, const Position& p, unsigned max)
     return body.size();
 }
 
-void MapUtility::Smooth(Map& map)
+void MapUtility::Smooth(Map& map, helpers::ThreadPool* threadPool)
 {
+    // Each pass only writes the vertices of its rows and reads values not written in the same pass,
+    // so the rows can be processed in any order
+
     // fixed broken textures
-    for(int x = 0; x < map.size.x; x++)
-    {
-        for(int y = 0; y < map.size.y; y++)
+    ForEachRowBand(map.size, threadPool, [this, &map](int yStart, int yEnd) {
+        for(int y = yStart; y < yEnd; y++)
         {
-            int index = VertexUtility::GetIndexOf(Position(x, y), map.size);
-            int indexLeft = VertexUtility::GetIndexOf(Position(x - 1, y), map.size);
-            int indexBottom = VertexUtility::GetIndexOf(Position(x, y + 1), map.size);
+            for(int x = 0; x < map.size.x; x++)
+            {
+                int index = VertexUtility::GetIndexOf(Position(x, y), map.size);
+                int indexLeft = VertexUtility::GetIndexOf(Position(x - 1, y), map.size);
+                int indexBottom = VertexUtility::GetIndexOf(Position(x, y + 1), map.size);
 
-            int texLeft = map.textureLsd[indexLeft];
-            int texBottom = map.textureLsd[indexBottom];
-            int tex = map.textureRsu[index];
+                int texLeft = map.textureLsd[indexLeft];
+                int texBottom = map.textureLsd[indexBottom];
+                int tex = map.textureRsu[index];
 
-            if(tex != texLeft && tex != texBottom && texLeft == texBottom && cfg.GetTerrainByS2Id(texBottom).kind != TerrainKind::WATER)
-            {
-                map.textureRsu[index] = texBottom;
+                if(tex != texLeft && tex != texBottom && texLeft == texBottom
+                   && cfg.GetTerrainByS2Id(texBottom).kind != TerrainKind::WATER)
+                {
+                    map.textureRsu[index] = texBottom;
+                }
             }
         }
-    }
+    });
 
-    for(int x = 0; x < map.size.x; x++)
-    {
-        for(int y = 0; y < map.size.y; y++)
+    ForEachRowBand(map.size, threadPool, [this, &map](int yStart, int yEnd) {
+        for(int y = yStart; y < yEnd; y++)
         {
-            int index = VertexUtility::GetIndexOf(Position(x, y), map.size);
-            int indexRight = VertexUtility::GetIndexOf(Position(x + 1, y), map.size);
-            int indexTop = VertexUtility::GetIndexOf(Position(x, y - 1), map.size);
+            for(int x = 0; x < map.size.x; x++)
+            {
+                int index = VertexUtility::GetIndexOf(Position(x, y), map.size);
+                int indexRight = VertexUtility::GetIndexOf(Position(x + 1, y), map.size);
+                int indexTop = VertexUtility::GetIndexOf(Position(x, y - 1), map.size);
 
-            int texRight = map.textureRsu[indexRight];
-            int texTop = map.textureRsu[indexTop];
-            int tex = map.textureLsd[index];
+                int texRight = map.textureRsu[indexRight];
+                int texTop = map.textureRsu[indexTop];
+                int tex = map.textureLsd[index];
 
-            if(tex != texTop && tex != texRight && texTop == texRight && cfg.GetTerrainByS2Id(texTop).kind != TerrainKind::WATER)
-            {
-                map.textureLsd[index] = texTop;
+                if(tex != texTop && tex != texRight && texTop == texRight && cfg.GetTerrainByS2Id(texTop).kind != TerrainKind::WATER)
+                {
+                    map.textureLsd[index] = texTop;
+                }
             }
         }
-    }
+    });
 
     // increase elevation of mountains to visually outline height of mountains
-    RTTR_FOREACH_PT(Position, map.size)
-    {
-        int index = VertexUtility::GetIndexOf(pt, map.size);
-        int tex = map.textureLsd[index];
-        const TerrainDesc& t = cfg.GetTerrainByS2Id(tex);
-        if(t.Is(ETerrain::Mineable) || t.kind == TerrainKind::SNOW)
+    ForEachRowBand(map.size, threadPool, [this, &map](int yStart, int yEnd) {
+        for(int index = yStart * map.size.x; index < yEnd * map.size.x; index++)
         {
-            map.z[index] = (int)(1.33 * map.z[index]);
+            int tex = map.textureLsd[index];
+            const TerrainDesc& t = cfg.GetTerrainByS2Id(tex);
+            if(t.Is(ETerrain::Mineable) || t.kind == TerrainKind::SNOW)
+            {
+                map.z[index] = (int)(1.33 * map.z[index]);
+            }
         }
-    }
+    });
 
     DescIdx<TerrainDesc> highestNonMountain(0);
     for(unsigned i = 1; i < cfg.landscapeTerrains.size(); i++)
@@ -149,27 +158,40 @@ void MapUtility::Smooth(Map& map)
     }
 
     // replace mountain-meadow without mountain by meadow
-    RTTR_FOREACH_PT(Position, map.size)
-    {
-        int index = VertexUtility::GetIndexOf(pt, map.size);
-        int tex = map.textureLsd[index];
-        const TerrainDesc& t = cfg.GetTerrainByS2Id(tex);
-        if(t.kind == TerrainKind::MOUNTAIN && t.Is(ETerrain::Buildable))
+    // Neighbours are read, so find all vertices first and replace them afterwards
+    std::vector<uint8_t> replace(map.z.size(), 0);
+    ForEachRowBand(map.size, threadPool, [this, &map, &replace](int yStart, int yEnd) {
+        for(int y = yStart; y < yEnd; y++)
         {
-            bool mountainNeighbor = false;
-            std::vector<int> neighbors = VertexUtility::GetNeighbors(pt, map.size, 1);
-            for(int& neighbor : neighbors)
+            for(int x = 0; x < map.size.x; x++)
             {
-                if(objGen.IsTexture(map, neighbor, [](const auto& desc) { return desc.Is(ETerrain::Mineable); }))
+                const Position pt(x, y);
+                int index = VertexUtility::GetIndexOf(pt, map.size);
+                int tex = map.textureLsd[index];
+                const TerrainDesc& t = cfg.GetTerrainByS2Id(tex);
+                if(t.kind == TerrainKind::MOUNTAIN && t.Is(ETerrain::Buildable))
                 {
-                    mountainNeighbor = true;
-                    break;
+                    bool mountainNeighbor = false;
+                    std::vector<int> neighbors = VertexUtility::GetNeighbors(pt, map.size, 1);
+                    for(int& neighbor : neighbors)
+                    {
+                        if(objGen.IsTexture(map, neighbor, [](const auto& desc) { return desc.Is(ETerrain::Mineable); }))
+                        {
+                            mountainNeighbor = true;
+                            break;
+                        }
+                    }
+
+                    if(!mountainNeighbor)
+                        replace[index] = 1;
                 }
             }
-
-            if(!mountainNeighbor)
-                objGen.CreateTexture(map, index, highestNonMountain);
         }
+    });
+    for(unsigned index = 0; index < replace.size(); index++)
+    {
+        if(replace[index])
+            objGen.CreateTexture(map, index, highestNonMountain);
     }
 }
 
@@ -206,7 +228,7 @@ void MapUtility::SetHarbour(Map& map, const Position& center, int waterLevel)
     }
 }
 
-void MapUtility::SetTree(Map& map, const Position& position)
+void MapUtility::SetTree(Map& map, const Position& position, MapRandom& rnd)
 {
     int index = VertexUtility::GetIndexOf(position, map.size);
 
@@ -215,13 +237,13 @@ void MapUtility::SetTree(Map& map, const Position& position)
        && !objGen.IsTexture(map, index, [](const auto& desc) { return desc.Is(ETerrain::Unreachable); }))
     {
         if(objGen.IsTexture(map, index, [](const auto& desc) { return desc.humidity < 90; }))
-            objGen.CreateRandomPalm(map, index);
+            objGen.CreateRandomPalm(map, index, rnd);
         else
-            objGen.CreateRandomTree(map, index);
+            objGen.CreateRandomTree(map, index, rnd);
     }
 }
 
-void MapUtility::SetStones(Map& map, const Position& center, double radius)
+void MapUtility::SetStones(Map& map, const Position& center, double radius, MapRandom& rnd)
 {
     int cx = center.x;
     int cy = center.y;
@@ -234,13 +256,13 @@ void MapUtility::SetStones(Map& map, const Position& center, double radius)
             Position p(x, y);
             if(VertexUtility::Distance(center, p, map.size) < radius)
             {
-                SetStone(map, p);
+                SetStone(map, p, rnd);
             }
         }
     }
 }
 
-void MapUtility::SetStone(Map& map, const Position& position)
+void MapUtility::SetStone(Map& map, const Position& position, MapRandom& rnd)
 {
     int index = VertexUtility::GetIndexOf(position, map.size);
 
@@ -248,7 +270,7 @@ void MapUtility::SetStone(Map& map, const Position& position)
        && !objGen.IsTexture(map, index, [](const auto& desc) { return desc.kind == TerrainKind::WATER; })
        && !objGen.IsTexture(map, index, [](const auto& desc) { return desc.Is(ETerrain::Unreachable); }))
     {
-        objGen.CreateRandomStone(map, index);
+        objGen.CreateRandomStone(map, index, rnd);
     }
 }
 
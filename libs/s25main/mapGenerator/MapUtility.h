@@ -20,6 +20,8 @@
 
 #include "ObjectGenerator.h"
 #include "Point.h"
+#include "helpers/ThreadPool.h"
+#include <algorithm>
 
 struct Map;
 
@@ -40,8 +42,9 @@ public:
      * meadow textures without neighboring mountain-textures are replaced by simple meadow
      * textures.
      * @param map map to smooth textures for
+     * @param threadPool optional pool to process the rows in parallel
      */
-    void Smooth(Map& map);
+    void Smooth(Map& map, helpers::ThreadPool* threadPool = nullptr);
 
     /**
      * Creates a hill at the specified center with the specified height.
@@ -64,8 +67,9 @@ public:
      * Places a tree to the specified position if possible.
      * @param map map to modify the terrain for
      * @param position position of the tree
+     * @param rnd random number generator to use
      */
-    void SetTree(Map& map, const Position& position);
+    void SetTree(Map& map, const Position& position, MapRandom& rnd);
 
     /**
      * Sets stone on the map around the specified center within the specified radius.
@@ -73,15 +77,17 @@ public:
      * @param map map to modify the terrain for
      * @param center center point for stone placement
      * @param radius radius around the center to place stone in
+     * @param rnd random number generator to use
      */
-    void SetStones(Map& map, const Position& center, double radius);
+    void SetStones(Map& map, const Position& center, double radius, MapRandom& rnd);
 
     /**
      * Places a stone to the specified position if possible.
      * @param map map to modify the terrain for
      * @param position position of the stone
+     * @param rnd random number generator to use
      */
-    void SetStone(Map& map, const Position& position);
+    void SetStone(Map& map, const Position& position, MapRandom& rnd);
 
     /**
      * Computes the size of a terrain body starting from the specified position.
@@ -104,7 +110,34 @@ public:
      */
     static Position ComputePointOnCircle(int index, int points, const Position& center, double radius);
 
+    /**
+     * Calls func(yStart, yEnd) for bands of rows covering all rows of the map. The bands are processed in parallel
+     * if a thread pool is given, so func must only write to the vertices of its rows.
+     * @param size size of the map
+     * @param threadPool thread pool to use or nullptr to process all rows on the calling thread
+     * @param func function to call for each band
+     */
+    template<class T_Func>
+    static void ForEachRowBand(const MapExtent& size, helpers::ThreadPool* threadPool, T_Func&& func);
+
     ObjectGenerator objGen;
 };
 
+template<class T_Func>
+inline void MapUtility::ForEachRowBand(const MapExtent& size, helpers::ThreadPool* threadPool, T_Func&& func)
+{
+    if(!threadPool)
+    {
+        func(0, static_cast<int>(size.y));
+        return;
+    }
+    // Small bands balance the load, as the cost per row varies
+    const int bandSize = 8;
+    const int numBands = (static_cast<int>(size.y) + bandSize - 1) / bandSize;
+    threadPool->parallelFor(numBands, [&func, &size, bandSize](size_t band) {
+        const int yStart = static_cast<int>(band) * bandSize;
+        func(yStart, std::min(yStart + bandSize, static_cast<int>(size.y)));
+    });
+}
+
 #endif // MapUtility_h__
@@ -57,24 +57,24 @@ bool ObjectGenerator::IsEmpty(const Map& map, int index)
     return (map.objectType[index] == libsiedler2::OT_Empty && map.objectInfo[index] == libsiedler2::OI_Empty);
 }
 
-uint8_t ObjectGenerator::CreateDuck(int likelihood)
+uint8_t ObjectGenerator::CreateDuck(int likelihood, MapRandom& rnd)
 {
-    return config.Rand(100) < likelihood ? libsiedler2::A_Duck : libsiedler2::A_None;
+    return rnd.Rand(100) < likelihood ? libsiedler2::A_Duck : libsiedler2::A_None;
 }
 
-uint8_t ObjectGenerator::CreateSheep(int likelihood)
+uint8_t ObjectGenerator::CreateSheep(int likelihood, MapRandom& rnd)
 {
-    return config.Rand(100) < likelihood ? libsiedler2::A_Sheep : libsiedler2::A_None;
+    return rnd.Rand(100) < likelihood ? libsiedler2::A_Sheep : libsiedler2::A_None;
 }
 
-uint8_t ObjectGenerator::CreateRandomForestAnimal(int likelihood)
+uint8_t ObjectGenerator::CreateRandomForestAnimal(int likelihood, MapRandom& rnd)
 {
-    if(config.Rand(100) >= likelihood)
+    if(rnd.Rand(100) >= likelihood)
     {
         return libsiedler2::A_None;
     }
 
-    switch(config.Rand(5))
+    switch(rnd.Rand(5))
     {
         case 0: return libsiedler2::A_Rabbit;
         case 1: return libsiedler2::A_Fox;
@@ -84,14 +84,14 @@ uint8_t ObjectGenerator::CreateRandomForestAnimal(int likelihood)
     }
 }
 
-uint8_t ObjectGenerator::CreateRandomAnimal(int likelihood)
+uint8_t ObjectGenerator::CreateRandomAnimal(int likelihood, MapRandom& rnd)
 {
-    if(config.Rand(100) >= likelihood)
+    if(rnd.Rand(100) >= likelihood)
     {
         return libsiedler2::A_None;
     }
 
-    switch(config.Rand(7))
+    switch(rnd.Rand(7))
     {
         case 0: return libsiedler2::A_Rabbit;
         case 1: return libsiedler2::A_Fox;
@@ -103,18 +103,19 @@ uint8_t ObjectGenerator::CreateRandomAnimal(int likelihood)
     }
 }
 
-uint8_t ObjectGenerator::CreateRandomResource(unsigned ratioGold, unsigned ratioIron, unsigned ratioCoal, unsigned ratioGranite)
+uint8_t ObjectGenerator::CreateRandomResource(unsigned ratioGold, unsigned ratioIron, unsigned ratioCoal, unsigned ratioGranite,
+                                              MapRandom& rnd)
 {
-    auto rnd = (unsigned)config.Rand(ratioGold + ratioIron + ratioCoal + ratioGranite);
+    auto value = (unsigned)rnd.Rand(ratioGold + ratioIron + ratioCoal + ratioGranite);
 
-    if(rnd < ratioGold)
-        return libsiedler2::R_Gold + config.Rand(8);
-    else if(rnd < ratioGold + ratioIron)
-        return libsiedler2::R_Iron + config.Rand(8);
-    else if(rnd < ratioGold + ratioIron + ratioCoal)
-        return libsiedler2::R_Coal + config.Rand(8);
+    if(value < ratioGold)
+        return libsiedler2::R_Gold + rnd.Rand(8);
+    else if(value < ratioGold + ratioIron)
+        return libsiedler2::R_Iron + rnd.Rand(8);
+    else if(value < ratioGold + ratioIron + ratioCoal)
+        return libsiedler2::R_Coal + rnd.Rand(8);
     else
-        return libsiedler2::R_Granite + config.Rand(8);
+        return libsiedler2::R_Granite + rnd.Rand(8);
 }
 
 bool ObjectGenerator::IsTree(const Map& map, int index)
@@ -122,43 +123,43 @@ bool ObjectGenerator::IsTree(const Map& map, int index)
     return map.objectInfo[index] == libsiedler2::OI_TreeOrPalm || map.objectInfo[index] == libsiedler2::OI_Palm;
 }
 
-void ObjectGenerator::CreateRandomTree(Map& map, int index)
+void ObjectGenerator::CreateRandomTree(Map& map, int index, MapRandom& rnd)
 {
-    switch(config.Rand(3))
+    switch(rnd.Rand(3))
     {
-        case 0: map.objectType[index] = config.Rand(libsiedler2::OT_Tree1_Begin, libsiedler2::OT_Tree1_End + 1); break;
-        case 1: map.objectType[index] = config.Rand(libsiedler2::OT_Tree2_Begin, libsiedler2::OT_Tree2_End + 1); break;
-        case 2: map.objectType[index] = config.Rand(libsiedler2::OT_TreeOrPalm_Begin, libsiedler2::OT_TreeOrPalm_End + 1); break;
+        case 0: map.objectType[index] = rnd.Rand(libsiedler2::OT_Tree1_Begin, libsiedler2::OT_Tree1_End + 1); break;
+        case 1: map.objectType[index] = rnd.Rand(libsiedler2::OT_Tree2_Begin, libsiedler2::OT_Tree2_End + 1); break;
+        case 2: map.objectType[index] = rnd.Rand(libsiedler2::OT_TreeOrPalm_Begin, libsiedler2::OT_TreeOrPalm_End + 1); break;
     }
     map.objectInfo[index] = libsiedler2::OI_TreeOrPalm;
 }
 
-void ObjectGenerator::CreateRandomPalm(Map& map, int index)
+void ObjectGenerator::CreateRandomPalm(Map& map, int index, MapRandom& rnd)
 {
-    if(config.Rand(2) == 0)
+    if(rnd.Rand(2) == 0)
     {
-        map.objectType[index] = config.Rand(libsiedler2::OT_TreeOrPalm_Begin, libsiedler2::OT_TreeOrPalm_End + 1);
+        map.objectType[index] = rnd.Rand(libsiedler2::OT_TreeOrPalm_Begin, libsiedler2::OT_TreeOrPalm_End + 1);
         map.objectInfo[index] = libsiedler2::OI_Palm;
     } else
     {
-        map.objectType[index] = config.Rand(libsiedler2::OT_Palm_Begin, libsiedler2::OT_Palm_End + 1);
+        map.objectType[index] = rnd.Rand(libsiedler2::OT_Palm_Begin, libsiedler2::OT_Palm_End + 1);
         map.objectInfo[index] = libsiedler2::OI_TreeOrPalm;
     }
 }
 
-void ObjectGenerator::CreateRandomMixedTree(Map& map, int index)
+void ObjectGenerator::CreateRandomMixedTree(Map& map, int index, MapRandom& rnd)
 {
-    if(config.Rand(2) == 0)
+    if(rnd.Rand(2) == 0)
     {
-        CreateRandomTree(map, index);
+        CreateRandomTree(map, index, rnd);
     } else
     {
-        CreateRandomPalm(map, index);
+        CreateRandomPalm(map, index, rnd);
     }
 }
 
-void ObjectGenerator::CreateRandomStone(Map& map, int index)
+void ObjectGenerator::CreateRandomStone(Map& map, int index, MapRandom& rnd)
 {
-    map.objectType[index] = config.Rand(libsiedler2::OT_Stone_Begin, libsiedler2::OT_Stone_End + 1);
-    map.objectInfo[index] = config.Rand(2) == 0 ? libsiedler2::OI_Stone1 : libsiedler2::OI_Stone2;
+    map.objectType[index] = rnd.Rand(libsiedler2::OT_Stone_Begin, libsiedler2::OT_Stone_End + 1);
+    map.objectInfo[index] = rnd.Rand(2) == 0 ? libsiedler2::OI_Stone1 : libsiedler2::OI_Stone2;
 }
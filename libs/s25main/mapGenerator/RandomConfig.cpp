@@ -36,11 +36,25 @@ bool RandomConfig::Init(MapStyle mapStyle, DescIdx<LandscapeDesc> landscape, uin
     GameDataLoader gdLoader(worldDesc);
     if(!gdLoader.Load())
         return false;
+    Setup(mapStyle, landscape, seed);
+    return true;
+}
+
+bool RandomConfig::Init(MapStyle mapStyle, DescIdx<LandscapeDesc> landscape, uint64_t seed, const WorldDescription& loadedWorldDesc)
+{
+    worldDesc = loadedWorldDesc;
+    Setup(mapStyle, landscape, seed);
+    return true;
+}
+
+void RandomConfig::Setup(MapStyle mapStyle, DescIdx<LandscapeDesc> landscape, uint64_t seed)
+{
     for(DescIdx<TerrainDesc> t(0); t.value < worldDesc.terrain.size(); t.value++)
     {
         if(worldDesc.get(t).landscape == landscape)
             landscapeTerrains.push_back(t);
     }
+    seed_ = seed;
     rng_.seed(static_cast<UsedRNG::result_type>(seed));
     switch(mapStyle)
     {
@@ -53,7 +67,6 @@ bool RandomConfig::Init(MapStyle mapStyle, DescIdx<LandscapeDesc> landscape, uin
         case MapStyle::Random: CreateRandom(); break;
         default: throw std::logic_error("Invalid enum value");
     }
-    return true;
 }
 
 void RandomConfig::CreateGreenland()
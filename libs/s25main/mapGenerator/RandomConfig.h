@@ -19,6 +19,7 @@
 #define RandomConfig_h__
 
 #include "mapGenerator/AreaDesc.h"
+#include "mapGenerator/MapRandom.h"
 #include "mapGenerator/MapStyle.h"
 #include "random/XorShift.h"
 #include "gameData/DescIdx.h"
@@ -35,6 +36,8 @@ class RandomConfig
 public:
     bool Init(MapStyle mapStyle, DescIdx<LandscapeDesc> landscape);
     bool Init(MapStyle mapStyle, DescIdx<LandscapeDesc> landscape, uint64_t seed);
+    /// Use an already loaded world description instead of loading it again (e.g. when generating many maps)
+    bool Init(MapStyle mapStyle, DescIdx<LandscapeDesc> landscape, uint64_t seed, const WorldDescription& loadedWorldDesc);
 
     WorldDescription worldDesc;
     std::vector<DescIdx<TerrainDesc>> landscapeTerrains;
@@ -75,6 +78,13 @@ public:
      */
     double DRand(double min, double max);
 
+    /**
+     * Creates a generator for random numbers that only depend on the seed and the key (e.g. a vertex index).
+     * @param key key of the random numbers (e.g. generation step and vertex index)
+     * @return a new generator
+     */
+    MapRandom GetRandom(uint64_t key) const { return MapRandom(seed_, key); }
+
     const TerrainDesc& GetTerrainByS2Id(uint8_t s2Id) const;
 
     template<class T_Predicate>
@@ -85,6 +95,8 @@ public:
     std::vector<DescIdx<TerrainDesc>> FilterTerrains(const std::vector<DescIdx<TerrainDesc>>& inTerrains, T_Predicate predicate) const;
 
 private:
+    void Setup(MapStyle mapStyle, DescIdx<LandscapeDesc> landscape, uint64_t seed);
+
     void CreateGreenland();
 
     void CreateDefaultTextures(bool snowOrLava = true);
@@ -98,6 +110,7 @@ private:
 
     using UsedRNG = XorShift;
     UsedRNG rng_;
+    uint64_t seed_ = 0;
 };
 
 template<class T_Predicate>
@@ -30,7 +30,26 @@
 #define MIN_HARBOR_DISTANCE 35.0
 #define MIN_HARBOR_WATER 200
 
-RandomMapGenerator::RandomMapGenerator(RandomConfig& config) : config(config), helper(config) {}
+namespace {
+/// Generation steps with their own random numbers for each vertex
+enum RandomStream
+{
+    RS_PLAYER_RESOURCES = 1,
+    RS_HILLS,
+    RS_OBJECTS,
+    RS_ANIMALS,
+    RS_RESOURCES
+};
+
+uint64_t getRandomKey(RandomStream stream, unsigned index)
+{
+    return (static_cast<uint64_t>(stream) << 32) | index;
+}
+} // namespace
+
+RandomMapGenerator::RandomMapGenerator(RandomConfig& config, helpers::ThreadPool* threadPool)
+    : config(config), threadPool(threadPool), helper(config)
+{}
 
 unsigned RandomMapGenerator::GetMaxTerrainHeight(const DescIdx<TerrainDesc> terrain)
 {
@@ -79,101 +98,161 @@ void RandomMapGenerator::PlacePlayerResources(const MapSettings& settings, Map&
         int offset2 = config.Rand(180, 360);
         const Position p(map.hqPositions[i]);
 
-        helper.SetStones(map, MapUtility::ComputePointOnCircle(offset1, 360, p, 12), 2.0F);
-        helper.SetStones(map, MapUtility::ComputePointOnCircle(offset2, 360, p, 12), 2.7F);
+        MapRandom rnd = config.GetRandom(getRandomKey(RS_PLAYER_RESOURCES, i));
+        helper.SetStones(map, MapUtility::ComputePointOnCircle(offset1, 360, p, 12), 2.0F, rnd);
+        helper.SetStones(map, MapUtility::ComputePointOnCircle(offset2, 360, p, 12), 2.7F, rnd);
     }
 }
 
-void RandomMapGenerator::CreateHills(const MapSettings& settings, Map& map)
+std::vector<double> RandomMapGenerator::ComputeHQDistances(const MapSettings& settings, const Map& map)
 {
-    const int players = settings.numPlayers;
-    std::vector<AreaDesc> areas = config.areas;
-
-    for(int x = 0; x < map.size.x; x++)
-    {
-        for(int y = 0; y < map.size.y; y++)
+    std::vector<double> distances(prodOfComponents(map.size));
+    MapUtility::ForEachRowBand(map.size, threadPool, [&settings, &map, &distances](int yStart, int yEnd) {
+        for(int y = yStart; y < yEnd; y++)
         {
-            auto distanceToPlayer = (double)(map.size.x + map.size.y);
-            Position tile(x, y);
-
-            for(int i = 0; i < players; i++)
+            for(int x = 0; x < map.size.x; x++)
             {
-                distanceToPlayer = std::min(distanceToPlayer, VertexUtility::Distance(tile, Position(map.hqPositions[i]), map.size));
+                const Position tile(x, y);
+                auto distanceToPlayer = (double)(map.size.x + map.size.y);
+                for(unsigned i = 0; i < settings.numPlayers; i++)
+                    distanceToPlayer = std::min(distanceToPlayer, VertexUtility::Distance(tile, Position(map.hqPositions[i]), map.size));
+                distances[VertexUtility::GetIndexOf(tile, map.size)] = distanceToPlayer;
             }
+        }
+    });
+    return distances;
+}
+
+void RandomMapGenerator::CreateHills(Map& map, const std::vector<double>& hqDistances)
+{
+    const std::vector<AreaDesc>& areas = config.areas;
 
-            for(auto& area : areas)
+    // Only the highest hill at a vertex matters as it covers the lower ones completely
+    std::vector<unsigned char> hillHeights(hqDistances.size(), 0);
+    MapUtility::ForEachRowBand(map.size, threadPool, [this, &map, &hqDistances, &areas, &hillHeights](int yStart, int yEnd) {
+        for(int y = yStart; y < yEnd; y++)
+        {
+            for(int x = 0; x < map.size.x; x++)
             {
-                if(area.IsInArea(tile, distanceToPlayer, map.size))
-                {
-                    const auto pr = (int)area.likelyhoodHill;
-                    const int maxZ = area.maxElevation;
+                const Position tile(x, y);
+                const int index = VertexUtility::GetIndexOf(tile, map.size);
+                MapRandom rnd = config.GetRandom(getRandomKey(RS_HILLS, index));
 
-                    if(maxZ > 0 && config.Rand(101) <= pr)
+                for(const AreaDesc& area : areas)
+                {
+                    if(area.IsInArea(tile, hqDistances[index], map.size))
                     {
-                        auto z = (unsigned)config.Rand(area.minElevation, maxZ + 1);
-                        MapUtility::SetHill(map, tile, z);
+                        const auto pr = (int)area.likelyhoodHill;
+                        const int maxZ = area.maxElevation;
+
+                        if(maxZ > 0 && rnd.Rand(101) <= pr)
+                        {
+                            auto z = (unsigned)rnd.Rand(area.minElevation, maxZ + 1);
+                            hillHeights[index] = std::max(hillHeights[index], static_cast<unsigned char>(z));
+                        }
                     }
                 }
             }
         }
-    }
-}
-
-void RandomMapGenerator::FillRemainingTerrain(const MapSettings& settings, Map& map)
-{
-    const int players = settings.numPlayers;
-    std::vector<AreaDesc> areas = config.areas;
-    std::vector<DescIdx<TerrainDesc>> textures = config.textures;
+    });
 
-    RTTR_FOREACH_PT(Position, map.size)
+    std::vector<int> hills;
+    for(unsigned index = 0; index < hillHeights.size(); index++)
     {
-        const int index = VertexUtility::GetIndexOf(pt, map.size);
-        const int level = map.z[index];
-
-        // create texture for current height value
-        helper.objGen.CreateTexture(map, index, textures[level]);
+        if(hillHeights[index] > 0)
+            hills.push_back(index);
+    }
 
-        auto distanceToPlayer = (double)(map.size.x + map.size.y);
+    // Same as MapUtility::SetHill for all hills but each band only raises the vertices of its rows
+    MapUtility::ForEachRowBand(map.size, threadPool, [&map, &hills, &hillHeights](int yStart, int yEnd) {
+        for(int hill : hills)
+        {
+            const Position center = VertexUtility::GetPosition(hill, map.size);
+            const int z = hillHeights[hill];
+            for(int ny = center.y - z; ny <= center.y + z; ny++)
+            {
+                const int y = (ny % map.size.y + map.size.y) % map.size.y;
+                if(y < yStart || y >= yEnd)
+                    continue;
+                for(int nx = center.x - z; nx <= center.x + z; nx++)
+                {
+                    const Position neighbor(nx, ny);
+                    if(VertexUtility::Distance(center, neighbor, map.size) > z)
+                        continue;
+                    const int index = VertexUtility::GetIndexOf(neighbor, map.size);
+                    const double d = VertexUtility::Distance(center, VertexUtility::GetPosition(index, map.size), map.size);
+                    map.z[index] = std::max((unsigned char)(z - d), (unsigned char)map.z[index]);
+                }
+            }
+        }
+    });
+}
 
-        for(int i = 0; i < players; i++)
-            distanceToPlayer = std::min(distanceToPlayer, VertexUtility::Distance(pt, Position(map.hqPositions[i]), map.size));
+void RandomMapGenerator::FillRemainingTerrain(Map& map, const std::vector<double>& hqDistances)
+{
+    const std::vector<AreaDesc>& areas = config.areas;
+    const std::vector<DescIdx<TerrainDesc>>& textures = config.textures;
 
-        for(auto& area : areas)
+    // Textures and objects only depend on the vertex itself
+    MapUtility::ForEachRowBand(map.size, threadPool, [this, &map, &hqDistances, &areas, &textures](int yStart, int yEnd) {
+        for(int y = yStart; y < yEnd; y++)
         {
-            if(area.IsInArea(pt, distanceToPlayer, map.size))
+            for(int x = 0; x < map.size.x; x++)
             {
-                if(static_cast<unsigned>(config.Rand(0, 100)) < area.likelyhoodTree)
-                    helper.SetTree(map, pt);
-                else if(static_cast<unsigned>(config.Rand(0, 100)) < area.likelyhoodStone)
-                    helper.SetStone(map, pt);
+                const Position pt(x, y);
+                const int index = VertexUtility::GetIndexOf(pt, map.size);
+                const int level = map.z[index];
+
+                // create texture for current height value
+                helper.objGen.CreateTexture(map, index, textures[level]);
+
+                MapRandom rnd = config.GetRandom(getRandomKey(RS_OBJECTS, index));
+                for(const AreaDesc& area : areas)
+                {
+                    if(area.IsInArea(pt, hqDistances[index], map.size))
+                    {
+                        if(static_cast<unsigned>(rnd.Rand(0, 100)) < area.likelyhoodTree)
+                            helper.SetTree(map, pt, rnd);
+                        else if(static_cast<unsigned>(rnd.Rand(0, 100)) < area.likelyhoodStone)
+                            helper.SetStone(map, pt, rnd);
+                    }
+                }
             }
         }
-    }
+    });
     // post-processing of texture (add animals, adapt height, ...)
-    RTTR_FOREACH_PT(Position, map.size)
-    {
-        const int index = VertexUtility::GetIndexOf(pt, map.size);
-        const int level = map.z[index];
-        const TerrainDesc& t = config.worldDesc.get(textures[level]);
-        if(t.kind == TerrainKind::WATER)
+    MapUtility::ForEachRowBand(map.size, threadPool, [this, &map, &textures](int yStart, int yEnd) {
+        for(int y = yStart; y < yEnd; y++)
         {
-            map.z[index] = GetMaxTerrainHeight(textures[level]);
-            map.animal[index] = helper.objGen.CreateDuck(3);
-        } else if(t.humidity > 0 && t.IsUsableByAnimals())
-        {
-            std::vector<int> positions = VertexUtility::GetNeighbors(pt, map.size, 1);
-            bool treeFound = false;
-            for(int curIdx : positions)
+            for(int x = 0; x < map.size.x; x++)
             {
-                if(ObjectGenerator::IsTree(map, curIdx))
+                const Position pt(x, y);
+                const int index = VertexUtility::GetIndexOf(pt, map.size);
+                const int level = map.z[index];
+                const TerrainDesc& t = config.worldDesc.get(textures[level]);
+                MapRandom rnd = config.GetRandom(getRandomKey(RS_ANIMALS, index));
+                if(t.kind == TerrainKind::WATER)
                 {
-                    treeFound = true;
-                    break;
+                    map.z[index] = GetMaxTerrainHeight(textures[level]);
+                    map.animal[index] = helper.objGen.CreateDuck(3, rnd);
+                } else if(t.humidity > 0 && t.IsUsableByAnimals())
+                {
+                    std::vector<int> positions = VertexUtility::GetNeighbors(pt, map.size, 1);
+                    bool treeFound = false;
+                    for(int curIdx : positions)
+                    {
+                        if(ObjectGenerator::IsTree(map, curIdx))
+                        {
+                            treeFound = true;
+                            break;
+                        }
+                    }
+                    map.animal[index] =
+                      treeFound ? helper.objGen.CreateRandomForestAnimal(4, rnd) : helper.objGen.CreateSheep(4, rnd);
                 }
             }
-            map.animal[index] = treeFound ? helper.objGen.CreateRandomForestAnimal(4) : helper.objGen.CreateSheep(4);
         }
-    }
+    });
 
     ///////
     /// Harbour placement
@@ -235,45 +314,55 @@ void RandomMapGenerator::FillRemainingTerrain(const MapSettings& settings, Map&
 
 void RandomMapGenerator::SetResources(const MapSettings& settings, Map& map)
 {
-    RTTR_FOREACH_PT(Position, map.size)
-    {
-        const int index = VertexUtility::GetIndexOf(pt, map.size);
-        const TerrainDesc& tRsu = config.GetTerrainByS2Id(map.textureRsu[index]);
-        const TerrainDesc& tLsd = config.GetTerrainByS2Id(map.textureLsd[index]);
+    MapUtility::ForEachRowBand(map.size, threadPool, [this, &settings, &map](int yStart, int yEnd) {
+        for(int y = yStart; y < yEnd; y++)
+        {
+            for(int x = 0; x < map.size.x; x++)
+            {
+                const Position pt(x, y);
+                const int index = VertexUtility::GetIndexOf(pt, map.size);
+                const TerrainDesc& tRsu = config.GetTerrainByS2Id(map.textureRsu[index]);
+                const TerrainDesc& tLsd = config.GetTerrainByS2Id(map.textureLsd[index]);
 
-        uint8_t res = libsiedler2::R_None;
+                uint8_t res = libsiedler2::R_None;
 
-        if(tRsu.kind == TerrainKind::WATER && tLsd.kind == TerrainKind::WATER)
-        {
-            res = libsiedler2::R_Fish;
-        } else if(tRsu.IsVital() && tLsd.IsVital())
-        {
-            int nb = VertexUtility::GetIndexOf(GetNeighbour(pt, Direction::NORTHWEST), map.size);
-            const TerrainDesc& t1 = config.GetTerrainByS2Id(map.textureRsu[nb]);
-            const TerrainDesc& t2 = config.GetTerrainByS2Id(map.textureLsd[nb]);
-            nb = VertexUtility::GetIndexOf(GetNeighbour(pt, Direction::NORTHEAST), map.size);
-            const TerrainDesc& t3 = config.GetTerrainByS2Id(map.textureLsd[nb]);
-            nb = VertexUtility::GetIndexOf(GetNeighbour(pt, Direction::EAST), map.size);
-            const TerrainDesc& t4 = config.GetTerrainByS2Id(map.textureRsu[nb]);
-            // Less strict check: Include all terrain that can also be used by animals
-            if(tRsu.humidity > 0 && tLsd.humidity > 0 && t1.IsUsableByAnimals() && t2.IsUsableByAnimals() && t3.IsUsableByAnimals()
-               && t4.IsUsableByAnimals())
-                res = libsiedler2::R_Water;
-        } else if(tRsu.Is(ETerrain::Mineable) && tLsd.Is(ETerrain::Mineable))
-        {
-            int nb = VertexUtility::GetIndexOf(GetNeighbour(pt, Direction::NORTHWEST), map.size);
-            const TerrainDesc& t1 = config.GetTerrainByS2Id(map.textureRsu[nb]);
-            const TerrainDesc& t2 = config.GetTerrainByS2Id(map.textureLsd[nb]);
-            nb = VertexUtility::GetIndexOf(GetNeighbour(pt, Direction::NORTHEAST), map.size);
-            const TerrainDesc& t3 = config.GetTerrainByS2Id(map.textureLsd[nb]);
-            nb = VertexUtility::GetIndexOf(GetNeighbour(pt, Direction::EAST), map.size);
-            const TerrainDesc& t4 = config.GetTerrainByS2Id(map.textureRsu[nb]);
-            if(t1.Is(ETerrain::Mineable) && t2.Is(ETerrain::Mineable) && t3.Is(ETerrain::Mineable) && t4.Is(ETerrain::Mineable))
-                res = helper.objGen.CreateRandomResource(settings.ratioGold, settings.ratioIron, settings.ratioCoal, settings.ratioGranite);
-        }
+                if(tRsu.kind == TerrainKind::WATER && tLsd.kind == TerrainKind::WATER)
+                {
+                    res = libsiedler2::R_Fish;
+                } else if(tRsu.IsVital() && tLsd.IsVital())
+                {
+                    int nb = VertexUtility::GetIndexOf(GetNeighbour(pt, Direction::NORTHWEST), map.size);
+                    const TerrainDesc& t1 = config.GetTerrainByS2Id(map.textureRsu[nb]);
+                    const TerrainDesc& t2 = config.GetTerrainByS2Id(map.textureLsd[nb]);
+                    nb = VertexUtility::GetIndexOf(GetNeighbour(pt, Direction::NORTHEAST), map.size);
+                    const TerrainDesc& t3 = config.GetTerrainByS2Id(map.textureLsd[nb]);
+                    nb = VertexUtility::GetIndexOf(GetNeighbour(pt, Direction::EAST), map.size);
+                    const TerrainDesc& t4 = config.GetTerrainByS2Id(map.textureRsu[nb]);
+                    // Less strict check: Include all terrain that can also be used by animals
+                    if(tRsu.humidity > 0 && tLsd.humidity > 0 && t1.IsUsableByAnimals() && t2.IsUsableByAnimals()
+                       && t3.IsUsableByAnimals() && t4.IsUsableByAnimals())
+                        res = libsiedler2::R_Water;
+                } else if(tRsu.Is(ETerrain::Mineable) && tLsd.Is(ETerrain::Mineable))
+                {
+                    int nb = VertexUtility::GetIndexOf(GetNeighbour(pt, Direction::NORTHWEST), map.size);
+                    const TerrainDesc& t1 = config.GetTerrainByS2Id(map.textureRsu[nb]);
+                    const TerrainDesc& t2 = config.GetTerrainByS2Id(map.textureLsd[nb]);
+                    nb = VertexUtility::GetIndexOf(GetNeighbour(pt, Direction::NORTHEAST), map.size);
+                    const TerrainDesc& t3 = config.GetTerrainByS2Id(map.textureLsd[nb]);
+                    nb = VertexUtility::GetIndexOf(GetNeighbour(pt, Direction::EAST), map.size);
+                    const TerrainDesc& t4 = config.GetTerrainByS2Id(map.textureRsu[nb]);
+                    if(t1.Is(ETerrain::Mineable) && t2.Is(ETerrain::Mineable) && t3.Is(ETerrain::Mineable) && t4.Is(ETerrain::Mineable))
+                    {
+                        MapRandom rnd = config.GetRandom(getRandomKey(RS_RESOURCES, index));
+                        res = helper.objGen.CreateRandomResource(settings.ratioGold, settings.ratioIron, settings.ratioCoal,
+                                                                 settings.ratioGranite, rnd);
+                    }
+                }
 
-        map.resource[index] = res;
-    }
+                map.resource[index] = res;
+            }
+        }
+    });
 }
 
 Map RandomMapGenerator::Create(MapSettings settings)
@@ -285,13 +374,28 @@ Map RandomMapGenerator::Create(MapSettings settings)
     map.type = config.worldDesc.get(settings.type).s2Id;
     map.numPlayers = settings.numPlayers;
 
+    stepTimings.clear();
+    Clock::time_point stepStart = Clock::now();
+    const auto finishStep = [this, &stepStart](const char* name) {
+        const Clock::time_point now = Clock::now();
+        stepTimings.push_back(StepTiming{name, now - stepStart});
+        stepStart = now;
+    };
+
     // the actual map generation
     PlacePlayers(settings, map);
     PlacePlayerResources(settings, map);
-    CreateHills(settings, map);
-    FillRemainingTerrain(settings, map);
-    helper.Smooth(map);
+    finishStep("Players");
+    const std::vector<double> hqDistances = ComputeHQDistances(settings, map);
+    finishStep("HQDistances");
+    CreateHills(map, hqDistances);
+    finishStep("Hills");
+    FillRemainingTerrain(map, hqDistances);
+    finishStep("Terrain");
+    helper.Smooth(map, threadPool);
+    finishStep("Smooth");
     SetResources(settings, map);
+    finishStep("Resources");
 
     return map;
 }
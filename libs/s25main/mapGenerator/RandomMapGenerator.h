@@ -18,7 +18,9 @@
 #ifndef RandomMapGenerator_h__
 #define RandomMapGenerator_h__
 
+#include "Clock.h"
 #include "mapGenerator/MapUtility.h"
+#include <vector>
 
 class RandomConfig;
 struct TerrainDesc;
@@ -27,16 +29,21 @@ struct Map;
 
 /**
  * Random map generator.
+ * The random numbers of the vertices only depend on the seed and the vertex, so the same map is generated for a seed
+ * no matter how many threads are used.
  */
 class RandomMapGenerator
 {
     RandomConfig& config;
+    helpers::ThreadPool* threadPool;
 
 public:
     /**
      * Creates a new RandomMapGenerator with random properties.
+     * @param config configuration for the random map generator
+     * @param threadPool optional pool used to generate the rows of the map in parallel
      */
-    RandomMapGenerator(RandomConfig& config);
+    RandomMapGenerator(RandomConfig& config, helpers::ThreadPool* threadPool = nullptr);
 
     /**
      * Generates a new random map with the specified settings.
@@ -45,7 +52,18 @@ public:
      */
     Map Create(MapSettings settings);
 
+    /// Duration of a step of the map generation
+    struct StepTiming
+    {
+        const char* name;
+        Clock::duration duration;
+    };
+    /// Durations of the steps of the last Create call in the order they were executed
+    const std::vector<StepTiming>& GetStepTimings() const { return stepTimings; }
+
 private:
+    std::vector<StepTiming> stepTimings;
+
     /**
      * Helper to generate random maps (tree placement, water, coastlines, ...).
      */
@@ -82,20 +100,26 @@ private:
     void PlacePlayerResources(const MapSettings& settings, Map& map);
 
     /**
-     * Create a elevation (hills) for the specified map.
+     * Computes the distance of each vertex to the closest headquarter.
      * @param settings settings used for map generation
-     * @param config configuration for the random map generator
+     * @param map map with the placed players
+     * @return distance for each vertex index
+     */
+    std::vector<double> ComputeHQDistances(const MapSettings& settings, const Map& map);
+
+    /**
+     * Create a elevation (hills) for the specified map.
      * @param map map to modify
+     * @param hqDistances distance of each vertex to the closest headquarter
      */
-    void CreateHills(const MapSettings& settings, Map& map);
+    void CreateHills(Map& map, const std::vector<double>& hqDistances);
 
     /**
      * Fill the remaining terrain (apart from the player positions) according to the generated hills.
-     * @param settings settings used for map generation
-     * @param config configuration for the random map generator
      * @param map map to modify
+     * @param hqDistances distance of each vertex to the closest headquarter
      */
-    void FillRemainingTerrain(const MapSettings& settings, Map& map);
+    void FillRemainingTerrain(Map& map, const std::vector<double>& hqDistances);
 
     /// Set the resources (water, fish, coal...) for the map
     void SetResources(const MapSettings& settings, Map& map);
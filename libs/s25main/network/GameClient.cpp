@@ -34,6 +34,7 @@
 #include "Savegame.h"
 #include "SerializedGameData.h"
 #include "Settings.h"
+#include "SimProfiler.h"
 #include "addons/const_addons.h"
 #include "ai/AIPlayer.h"
 #include "drivers/VideoDriverWrapper.h"
@@ -45,6 +46,7 @@
 #include "network/ClientInterface.h"
 #include "network/GameMessages.h"
 #include "network/GameServer.h"
+#include "network/SpectatorFeed.h"
 #include "ogl/FontStyle.h"
 #include "ogl/glArchivItem_Bitmap.h"
 #include "ogl/glArchivItem_Font.h"
@@ -66,6 +68,13 @@
 #include <helpers/chronoIO.h>
 #include <memory>
 
+namespace {
+/// Interval in GFs between keyframes of recorded replays (10min at normal speed)
+constexpr unsigned REPLAY_KEYFRAME_INTERVAL = 6000;
+/// Interval in GFs between world snapshots in replays which have no NWFs
+constexpr unsigned REPLAY_SNAPSHOT_INTERVAL = 10;
+} // namespace
+
 void GameClient::ClientConfig::Clear()
 {
     server.clear();
@@ -75,7 +84,7 @@ void GameClient::ClientConfig::Clear()
     isHost = false;
 }
 
-GameClient::GameClient() : skiptogf(0), mainPlayer(0), state(CS_STOPPED), ci(nullptr), replayMode(false) {}
+GameClient::GameClient() : skiptogf(0), mainPlayer(0), state(CS_STOPPED), ci(nullptr), replayMode(false), spectatorPort(0) {}
 
 GameClient::~GameClient()
 {
@@ -179,7 +188,11 @@ void GameClient::Run()
         if(nwfInfo->isReady())
             OnGameStart();
     } else if(state == CS_GAME)
+    {
         ExecuteGameFrame();
+        if(spectatorFeed)
+            spectatorFeed->Run();
+    }
 
     // maximal 10 Pakete verschicken
     mainPlayer.sendMsgs(10);
@@ -195,6 +208,11 @@ void GameClient::Stop()
     if(state == CS_STOPPED)
         return;
 
+#if RTTR_ENABLE_PROFILER
+    if(game && SIMPROFILER.isEnabled())
+        WriteProfile();
+#endif
+
     if(game)
         ExitGame();
     else if(state == CS_CONNECT || state == CS_CONFIG)
@@ -209,9 +227,13 @@ void GameClient::Stop()
 
     if(replayinfo)
     {
+        const bool wasRecording = replayinfo->replay.IsRecording();
         replayinfo->replay.Close();
+        if(wasRecording && !replayinfo->replay.GetLastErrorMsg().empty())
+            LOG.write("%1%\n") % replayinfo->replay.GetLastErrorMsg();
         replayinfo.reset();
     }
+    replayMode = false;
 
     mainPlayer.closeConnection();
 
@@ -338,6 +360,11 @@ void GameClient::StartGame(const unsigned random_init)
 
     // Daten nach dem Schreiben des Replays ggf wieder löschen
     mapinfo.mapData.Clear();
+
+#if RTTR_ENABLE_PROFILER
+    // Each game gets its own profile
+    SIMPROFILER.reset();
+#endif
 }
 
 void GameClient::GameLoaded()
@@ -369,6 +396,7 @@ void GameClient::GameLoaded()
 void GameClient::ExitGame()
 {
     RTTR_Assert(state == CS_GAME || state == CS_LOADED || state == CS_LOADING);
+    spectatorFeed.reset();
     game.reset();
     nwfInfo.reset();
     // Clear remaining commands
@@ -1278,7 +1306,8 @@ void GameClient::ExecuteGameFrame()
             }
             Stop();
         }
-        if(skiptogf == GetGFNumber())
+        // Idle GFs might be skipped at once
+        if(skiptogf <= GetGFNumber())
             skiptogf = 0;
     } else
     {
@@ -1288,6 +1317,18 @@ void GameClient::ExecuteGameFrame()
     }
 }
 
+#if RTTR_ENABLE_PROFILER
+void GameClient::WriteProfile()
+{
+    const std::string basePath =
+      RTTRCONFIG.ExpandPath(FILE_PATHS[47]) + "/" + s25util::Time::FormatTime("profile_%Y-%m-%d_%H-%i-%s");
+    if(SIMPROFILER.writeFiles(basePath))
+        LOG.write(_("Profiling data saved at \"%1%.txt\"\n")) % basePath;
+    else
+        LOG.write(_("Could not save profiling data to \"%1%.txt\"\n")) % basePath;
+}
+#endif
+
 void GameClient::HandleAutosave()
 {
     // If inactive or during replay -> no autosave
@@ -1317,15 +1358,29 @@ void GameClient::HandleAutosave()
 /// Führt notwendige Dinge für nächsten GF aus
 void GameClient::NextGF(bool wasNWF)
 {
+    RTTR_PROFILE_SCOPE(PROF_GF, "GameFrame", 0);
     for(AIPlayer& ai : game->aiPlayers_)
         ai.RunGF(GetGFNumber(), wasNWF);
     game->RunGF();
+    // Readers on other threads and spectators see the world as it was at the last NWF.
+    // Replays have no NWFs and may skip idle GFs, so publish when the interval since the last time has passed
+    if(wasNWF || (replayMode && GetGFNumber() >= replayinfo->lastPublishedGF + REPLAY_SNAPSHOT_INTERVAL))
+    {
+        if(replayMode)
+            replayinfo->lastPublishedGF = GetGFNumber();
+        game->worldSnapshots_.Publish(game->world_, GetGFNumber());
+        if(spectatorFeed)
+            spectatorFeed->PublishChanges(GetGFNumber());
+    }
 }
 
 void GameClient::ExecuteAllGCs(uint8_t playerId, const PlayerGameCommands& gcs)
 {
     for(const gc::GameCommandPtr& gc : gcs.gcs)
+    {
+        RTTR_PROFILE_SCOPE(PROF_GC, gc->GetTypeName(), playerId);
         gc->Execute(game->world_, playerId);
+    }
 }
 
 void GameClient::SendNothingNC(uint8_t player)
@@ -1348,6 +1403,15 @@ void GameClient::OnGameStart()
         GAMEMANAGER.ResetAverageGFPS();
         framesinfo.lastTime = FramesInfo::UsedClock::now();
         state = CS_GAME;
+        // Keep the feed when the game was replaced by a replay keyframe
+        if(spectatorPort && !spectatorFeed)
+        {
+            // A player must not see more of a running game via the feed than in the game itself
+            const unsigned char viewer = replayMode ? SpectatorFeed::ALL_VISIBLE : static_cast<unsigned char>(GetPlayerId());
+            spectatorFeed = std::make_unique<SpectatorFeed>(game->world_, viewer);
+            if(!spectatorFeed->Listen(spectatorPort))
+                spectatorFeed.reset();
+        }
         if(ci)
             ci->CI_GameStarted(game);
     } else if(state == CS_GAME && !game->IsStarted())
@@ -1370,6 +1434,8 @@ void GameClient::StartReplayRecording(const unsigned random_init)
 
     WritePlayerInfo(replayinfo->replay);
     replayinfo->replay.ggs = game->ggs_;
+    // The start of the replay does not need a keyframe
+    replayinfo->nextKeyframeGF = GetGFNumber() + REPLAY_KEYFRAME_INTERVAL;
 
     // Datei speichern
     if(!replayinfo->replay.StartRecording(RTTRCONFIG.ExpandPath(FILE_PATHS[51]) + "/" + replayinfo->fileName, mapinfo))
@@ -1379,6 +1445,87 @@ void GameClient::StartReplayRecording(const unsigned random_init)
     }
 }
 
+void GameClient::AddReplayKeyframe()
+{
+    const unsigned curGF = GetGFNumber();
+    replayinfo->nextKeyframeGF = curGF + REPLAY_KEYFRAME_INTERVAL;
+    auto sgd = std::make_unique<SerializedGameData>();
+    try
+    {
+        sgd->MakeSnapshot(game);
+    } catch(SerializedGameData::Error& error)
+    {
+        LOG.write(_("Error when adding a keyframe to the replay: %s\n")) % error.what();
+        return;
+    }
+    // Compression is done by the replay writer thread
+    replayinfo->replay.AddKeyframe(curGF, std::move(sgd), RANDOM.GetCurrentState());
+}
+
+bool GameClient::LoadReplayKeyframe(unsigned gf, unsigned targetGF)
+{
+    RTTR_Assert(replayMode);
+    auto keyframe = std::make_unique<SerializedGameData>();
+    UsedPRNG rngState;
+    if(!replayinfo->replay.ReadKeyframe(gf, *keyframe, rngState))
+    {
+        LOG.write(_("Error when loading replay keyframe: %s\n")) % replayinfo->replay.GetLastErrorMsg();
+        return false;
+    }
+    replayinfo->keyframe = std::move(keyframe);
+    replayinfo->keyframeRngState = rngState;
+    replayinfo->keyframeTargetGF = targetGF;
+
+    const GlobalGameSettings ggs = game->ggs_;
+    std::vector<PlayerInfo> players;
+    for(unsigned i = 0; i < GetNumPlayers(); ++i)
+        players.push_back(GetPlayer(i));
+    // The UI still uses the current game and its objects. So replace the UI by the loading screen first and load the keyframe
+    // when that is shown (LoadPendingReplayKeyframe). Till then the current world stays the active one
+    replayinfo->replacedGame = game;
+    game = std::make_shared<Game>(ggs, gf, players);
+    GameObject::AttachWorld(&replayinfo->replacedGame->world_);
+    framesinfo.isPaused = true;
+    state = CS_LOADING;
+    if(ci)
+        ci->CI_GameLoading(game);
+    return true;
+}
+
+bool GameClient::LoadPendingReplayKeyframe()
+{
+    if(!replayinfo || !replayinfo->keyframe)
+        return true;
+    RTTR_Assert(state == CS_LOADING);
+    const std::unique_ptr<SerializedGameData> keyframe = std::move(replayinfo->keyframe);
+    // The object counters are global -> Destroy all objects of the replaced game first
+    replayinfo->replacedGame->world_.Unload();
+    replayinfo->replacedGame.reset();
+    GameObject::AttachWorld(&game->world_);
+    try
+    {
+        keyframe->ReadSnapshot(game);
+    } catch(SerializedGameData::Error& error)
+    {
+        LOG.write(_("Error when loading replay keyframe: %s\n")) % error.what();
+        OnError(CE_INVALID_MAP);
+        return false;
+    }
+    game->world_.InitAfterLoad();
+    RANDOM.ResetState(replayinfo->keyframeRngState);
+    ResetVisualSettings();
+    game->Start(true);
+    if(spectatorFeed)
+        spectatorFeed->SetWorld(game->world_, GetGFNumber());
+
+    replayinfo->lastPublishedGF = GetGFNumber();
+    replayinfo->end = false;
+    replayinfo->replay.ReadGF(&replayinfo->next_gf);
+    // Execute the remaining GFs while the loading screen is shown
+    FastForward(replayinfo->keyframeTargetGF, nullptr);
+    return true;
+}
+
 bool GameClient::StartReplay(const std::string& path)
 {
     RTTR_Assert(state == CS_STOPPED);
@@ -1472,6 +1619,7 @@ bool GameClient::StartReplay(const std::string& path)
     }
 
     replayinfo->replay.ReadGF(&replayinfo->next_gf);
+    replayinfo->lastPublishedGF = GetGFNumber();
 
     return true;
 }
@@ -1535,10 +1683,30 @@ void GameClient::ServerLost()
  */
 void GameClient::SkipGF(unsigned gf, GameWorldView& gwv)
 {
-    if(gf <= GetGFNumber())
+    DoSkipGF(gf, &gwv);
+}
+
+void GameClient::SkipGF(unsigned gf)
+{
+    DoSkipGF(gf, nullptr);
+}
+
+void GameClient::DoSkipGF(unsigned gf, GameWorldView* gwv)
+{
+    // E.g. still loading a replay keyframe
+    if(state != CS_GAME)
         return;
 
-    unsigned start_ticks = VIDEODRIVER.GetTickCount();
+    // Jump to the nearest keyframe if that is closer or we need to go back. The remaining GFs are executed after it was loaded
+    unsigned keyframeGF;
+    if(replayMode && replayinfo->replay.FindKeyframe(gf, keyframeGF) && (gf < GetGFNumber() || keyframeGF > GetGFNumber()))
+    {
+        LoadReplayKeyframe(keyframeGF, gf);
+        return;
+    }
+
+    if(gf <= GetGFNumber())
+        return;
 
     if(!replayMode)
     {
@@ -1548,35 +1716,50 @@ void GameClient::SkipGF(unsigned gf, GameWorldView& gwv)
         return;
     }
 
+    FastForward(gf, gwv);
+}
+
+void GameClient::FastForward(unsigned gf, GameWorldView* gwv)
+{
+    unsigned start_ticks = VIDEODRIVER.GetTickCount();
     SetPause(false);
     skiptogf = gf;
 
-    // GFs überspringen
-    for(unsigned i = GetGFNumber(); i < skiptogf; ++i)
+    // GFs überspringen. Idle GFs are skipped at once, so show the progress whenever a multiple of 1000 was passed
+    unsigned nextProgressGF = (GetGFNumber() + 999) / 1000 * 1000;
+    // Stop at the target or when the game gets paused because the replay ends or gets async
+    while(GetGFNumber() < gf && !framesinfo.isPaused)
     {
-        if(i % 1000 == 0)
+        const unsigned i = GetGFNumber();
+        if(i >= nextProgressGF)
         {
-            RoadBuildState road;
-            road.mode = RM_DISABLED;
+            nextProgressGF = i - i % 1000 + 1000;
+            if(gwv)
+            {
+                RoadBuildState road;
+                road.mode = RM_DISABLED;
 
-            // spiel aktualisieren
-            gwv.Draw(road, MapPoint::Invalid(), false);
+                // spiel aktualisieren
+                gwv->Draw(road, MapPoint::Invalid(), false);
 
-            // text oben noch hinschreiben
-            boost::format nwfString(_("current GF: %u - still fast forwarding: %d GFs left (%d %%)"));
-            nwfString % GetGFNumber() % (gf - i) % (i * 100 / gf);
-            LargeFont->Draw(DrawPoint(VIDEODRIVER.GetRenderSize() / 2u), nwfString.str(), FontStyle::CENTER, 0xFFFFFF00);
+                // text oben noch hinschreiben
+                boost::format nwfString(_("current GF: %u - still fast forwarding: %d GFs left (%d %%)"));
+                nwfString % GetGFNumber() % (gf - i) % (i * 100 / gf);
+                LargeFont->Draw(DrawPoint(VIDEODRIVER.GetRenderSize() / 2u), nwfString.str(), FontStyle::CENTER, 0xFFFFFF00);
 
-            VIDEODRIVER.SwapBuffers();
+                VIDEODRIVER.SwapBuffers();
+            }
         }
         ExecuteGameFrame();
     }
+    skiptogf = 0;
 
     // Spiel pausieren & text ausgabe wie lang das jetzt gedauert hat
     unsigned ticks = VIDEODRIVER.GetTickCount() - start_ticks;
     boost::format text(_("Jump finished (%1$.3g seconds)."));
     text % (ticks / 1000.0);
-    ci->CI_Chat(mainPlayer.playerId, CD_SYSTEM, text.str());
+    if(ci)
+        ci->CI_Chat(mainPlayer.playerId, CD_SYSTEM, text.str());
     SetPause(true);
 }
 
@@ -40,6 +40,7 @@ struct Info;
 class AIPlayer;
 class ClientInterface;
 class SavedFile;
+class SpectatorFeed;
 class GamePlayer;
 class GameEvent;
 class GameLobby;
@@ -154,7 +155,13 @@ public:
     /// Is tournament mode activated (0 if not)? Returns the durations of the tournament mode in gf otherwise
     unsigned GetTournamentModeDuration() const;
 
+    /// Jump to the given GF showing the progress in the view. In replays this may replace the game by a keyframe
     void SkipGF(unsigned gf, GameWorldView& gwv);
+    /// Same as above but without showing the progress
+    void SkipGF(unsigned gf);
+    /// Load the replay keyframe requested by SkipGF and execute the GFs up to the target.
+    /// Must be called when the UI of the replaced game is gone, i.e. by the loading screen. Return false on error
+    bool LoadPendingReplayKeyframe();
 
     /// Changes the player ingame (for replay or debugging)
     void ChangePlayerIngame(unsigned char playerId1, unsigned char playerId2);
@@ -173,6 +180,9 @@ public:
 
     NetworkPlayer& GetMainPlayer() { return mainPlayer; }
 
+    /// Stream the following games to spectators on the port (0 = disabled)
+    void SetSpectatorPort(uint16_t port) { spectatorPort = port; }
+
     /// TESTS ONLY: Set player id. TODO: Anything better?
     void SetTestPlayerId(unsigned id);
 
@@ -201,6 +211,10 @@ private:
     void NextGF(bool wasNWF);
     /// Checks if its time for autosaving (if enabled) and does it
     void HandleAutosave();
+#if RTTR_ENABLE_PROFILER
+    /// Write the recorded profiling data of the current game to the log folder
+    void WriteProfile();
+#endif
 
     //  Netzwerknachrichten
     RTTR_IGNORE_OVERLOADED_VIRTUAL
@@ -255,6 +269,14 @@ private:
     /// Schreibt den Header der Replaydatei
     void StartReplayRecording(unsigned random_init);
     void WritePlayerInfo(SavedFile& file);
+    /// Add a keyframe with the current game state to the recorded replay
+    void AddReplayKeyframe();
+    /// Start replacing the game by the state of the replay keyframe at the given GF and switch the UI to the loading screen.
+    /// The keyframe is loaded and the GFs up to targetGF are executed by LoadPendingReplayKeyframe. Return false on error
+    bool LoadReplayKeyframe(unsigned gf, unsigned targetGF);
+    void DoSkipGF(unsigned gf, GameWorldView* gwv);
+    /// Execute the replay GFs up to the given GF as fast as possible and pause afterwards. Shows the progress in the view if given
+    void FastForward(unsigned gf, GameWorldView* gwv);
 
 public:
     /// Virtuelle Werte der Einstellungsfenster, die aber noch nicht wirksam sind, nur um die Verzögerungen zu verstecken
@@ -300,6 +322,11 @@ private:
 
     std::unique_ptr<ReplayInfo> replayinfo;
     bool replayMode;
+
+    /// Port for the spectator feed (0 = disabled)
+    uint16_t spectatorPort;
+    /// Streams the current game to spectators if enabled
+    std::unique_ptr<SpectatorFeed> spectatorFeed;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
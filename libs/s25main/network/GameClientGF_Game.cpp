@@ -22,6 +22,7 @@
 #include "ReplayInfo.h"
 #include "ai/AIPlayer.h"
 #include "network/GameClient.h"
+#include "network/GameMessages.h"
 
 void GameClient::ExecuteNWF()
 {
@@ -30,6 +31,10 @@ void GameClient::ExecuteNWF()
     AsyncChecksum checksum = AsyncChecksum::create(*game);
     const unsigned curGF = GetGFNumber();
 
+    // Keyframes are taken before the commands of their GF are executed
+    if(replayinfo && replayinfo->replay.IsRecording() && curGF >= replayinfo->nextKeyframeGF)
+        AddReplayKeyframe();
+
     for(const NWFPlayerInfo& player : nwfInfo->getPlayerInfos())
     {
         const PlayerGameCommands& currentGCs = player.commands.front();
@@ -57,6 +62,8 @@ void GameClient::ExecuteNWF()
             gameCommands_.insert(gameCommands_.end(), aiGCs.begin(), aiGCs.end());
         else
             mainPlayer.sendMsgAsync(new GameMessage_GameCommand(ai.GetPlayerId(), checksum, aiGCs));
+        for(const std::string& msg : ai.FetchChatMessages())
+            mainPlayer.sendMsgAsync(new GameMessage_Chat(ai.GetPlayerId(), CD_ALL, msg));
     }
     mainPlayer.sendMsgAsync(new GameMessage_GameCommand(0xFF, checksum, gameCommands_));
     gameCommands_.clear();
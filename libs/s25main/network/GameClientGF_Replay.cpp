@@ -16,6 +16,7 @@
 // along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
 
 #include "rttrDefines.h" // IWYU pragma: keep
+#include "Game.h"
 #include "GameManager.h"
 #include "PlayerGameCommands.h"
 #include "ReplayInfo.h"
@@ -23,9 +24,14 @@
 #include "network/ClientInterface.h"
 #include "network/GameClient.h"
 #include "libutil/Log.h"
+#include <algorithm>
 
 void GameClient::ExecuteGameFrame_Replay()
 {
+    // When fast forwarding jump over GFs without events or commands. Stop before the target GF, the GF of the next commands and the end
+    if(skiptogf > GetGFNumber() + 1)
+        game->SkipIdleGFs(std::min({skiptogf - 1, replayinfo->next_gf, replayinfo->replay.GetLastGF()}));
+
     AsyncChecksum checksum = AsyncChecksum::create(*game);
 
     const unsigned curGF = GetGFNumber();
@@ -68,7 +68,12 @@ enum
     NMS_REMOVE_LUA,
 
     NMS_GET_ASYNC_LOG = 0x0600,
-    NMS_ASYNC_LOG
+    NMS_ASYNC_LOG,
+
+    // Spectator feed (spectator> | <host)
+    NMS_SPECTATOR_SUBSCRIBE = 0x0701, // 4 region
+    NMS_SPECTATOR_SNAPSHOT,           // 4 gf, 4 mapsize, 4 region, 4 length, 4 total size, 4 offset, x compressed nodes
+    NMS_SPECTATOR_DELTA               // 4 gf, 1 last, x changed nodes
 };
 
 /* Hinweise:
@@ -168,5 +173,9 @@ const unsigned LOAD_TIMEOUT = 10 * 60;
 /// Größe eines Map-Paketes
 /// ACHTUNG: IPV4 garantiert nur maximal 576!!
 const unsigned MAP_PART_SIZE = 512;
+/// Maximum size of the compressed snapshot data in a spectator message
+const unsigned SPECTATOR_SNAPSHOT_PART_SIZE = 16 * 1024;
+/// Maximum number of nodes in a spectator delta message
+const unsigned SPECTATOR_MAX_DELTA_NODES = 1024;
 
 #endif // !GAMEPROTOCOL_H_INCLUDED
@@ -17,10 +17,9 @@
 
 #include "rttrDefines.h" // IWYU pragma: keep
 #include "NetworkPlayer.h"
-#include "GameMessage.h"
 
-NetworkPlayer::NetworkPlayer(unsigned playerId)
-    : playerId(playerId), recvQueue(GameMessage::create_game), sendQueue(GameMessage::create_game)
+NetworkPlayer::NetworkPlayer(unsigned playerId, CreateMsgFunction createMsg)
+    : playerId(playerId), recvQueue(createMsg), sendQueue(createMsg)
 {}
 
 void NetworkPlayer::closeConnection()
@@ -18,17 +18,17 @@
 #ifndef NetworkPlayer_h__
 #define NetworkPlayer_h__
 
+#include "GameMessage.h"
 #include "libutil/MessageQueue.h"
 #include "libutil/Socket.h"
 
-class Message;
 class MessageInterface;
 
 /// A player with a network connection and send/recv queues
 class NetworkPlayer
 {
 public:
-    NetworkPlayer(unsigned playerId);
+    NetworkPlayer(unsigned playerId, CreateMsgFunction createMsg = GameMessage::create_game);
     virtual ~NetworkPlayer() = default;
     /// Close the socket and clear queues
     virtual void closeConnection();
@@ -23,16 +23,12 @@ void PlayerGameCommands::Serialize(Serializer& ser) const
 {
     checksum.Serialize(ser);
 
-    ser.PushUnsignedInt(gcs.size());
-    for(const gc::GameCommandPtr& gc : gcs)
-        gc->Serialize(ser);
+    gc::GameCommand::SerializeBatch(ser, gcs);
 }
 
 void PlayerGameCommands::Deserialize(Serializer& ser)
 {
     checksum.Deserialize(ser);
 
-    gcs.resize(ser.PopUnsignedInt());
-    for(gc::GameCommandPtr& gc : gcs)
-        gc = gc::GameCommand::Deserialize(ser);
+    gcs = gc::GameCommand::DeserializeBatch(ser);
 }
@@ -0,0 +1,142 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "SpectatorClient.h"
+#include "libutil/Log.h"
+#include "libutil/Serializer.h"
+#include "libutil/SocketSet.h"
+
+SpectatorClient::SpectatorClient() : connection_(0, SpectatorMessage::create_spectator), hasData_(false), gf_(0), mapSize_(0, 0) {}
+
+SpectatorClient::~SpectatorClient()
+{
+    Disconnect();
+}
+
+bool SpectatorClient::Connect(const std::string& host, uint16_t port, bool ipv6)
+{
+    Disconnect();
+    if(!connection_.socket.Connect(host, port, ipv6))
+    {
+        LOG.write("Could not connect to the spectator feed at %1%:%2%\n") % host % port;
+        return false;
+    }
+    return true;
+}
+
+void SpectatorClient::Disconnect()
+{
+    connection_.closeConnection();
+    hasData_ = false;
+    pendingSnapshot_.Clear();
+}
+
+void SpectatorClient::Subscribe(const SpectatorRegion& region)
+{
+    // Changes of the old region might still arrive -> Ignore everything till the new snapshot
+    hasData_ = false;
+    pendingSnapshot_.Clear();
+    requestedRegion_ = region;
+    connection_.sendMsgAsync(new SpectatorMessage_Subscribe(region));
+}
+
+bool SpectatorClient::Run()
+{
+    if(!IsConnected())
+        return false;
+    SocketSet set;
+    set.Add(connection_.socket);
+    if(set.Select(0, 0) > 0 && !connection_.receiveMsgs())
+    {
+        LOG.write("Connection to the spectator feed lost\n");
+        Disconnect();
+        return false;
+    }
+    if(!connection_.sendMsgs(-1))
+    {
+        Disconnect();
+        return false;
+    }
+    connection_.executeMsgs(*this);
+    return true;
+}
+
+const SpectatorNode& SpectatorClient::GetNode(MapPoint pt) const
+{
+    RTTR_Assert(hasData_);
+    return nodes_[region_.GetIdx(pt, mapSize_)];
+}
+
+bool SpectatorClient::OnSpectatorMessage(const SpectatorMessage_Snapshot& msg, unsigned /*connectionId*/)
+{
+    // Check all sizes before allocating anything: The region must be the requested one which limits the uncompressed length
+    // and bzip2 makes the data at most 1% + 600 bytes bigger
+    const SpectatorRegion region = (msg.mapSize.x && msg.mapSize.y) ? requestedRegion_.ClampTo(msg.mapSize) : SpectatorRegion();
+    if(region.GetNumNodes() == 0 || msg.region.origin != region.origin || msg.region.size != region.size
+       || msg.length != region.GetNumNodes() * SpectatorNode::SERIALIZED_SIZE || msg.compressedSize > msg.length + msg.length / 100 + 600)
+    {
+        LOG.write("Received an invalid snapshot from the spectator feed\n");
+        pendingSnapshot_.Clear();
+        return true;
+    }
+    if(msg.offset != pendingSnapshot_.data.size() || msg.data.size() > msg.compressedSize - msg.offset)
+    {
+        // Out of order (e.g. rest of an older snapshot) -> Wait for the next one
+        pendingSnapshot_.Clear();
+        return true;
+    }
+    pendingSnapshot_.data.insert(pendingSnapshot_.data.end(), msg.data.begin(), msg.data.end());
+    if(pendingSnapshot_.data.size() < msg.compressedSize)
+        return true;
+
+    pendingSnapshot_.length = msg.length;
+    Serializer ser;
+    const bool isValid = pendingSnapshot_.DecompressToBuffer(reinterpret_cast<char*>(ser.GetDataWritable(msg.length)));
+    pendingSnapshot_.Clear();
+    if(!isValid)
+    {
+        LOG.write("Received an invalid snapshot from the spectator feed\n");
+        return true;
+    }
+    ser.SetLength(msg.length);
+    mapSize_ = msg.mapSize;
+    region_ = region;
+    nodes_.resize(region_.GetNumNodes());
+    for(SpectatorNode& node : nodes_)
+        node.Deserialize(ser);
+    gf_ = msg.gf;
+    hasData_ = true;
+    return true;
+}
+
+bool SpectatorClient::OnSpectatorMessage(const SpectatorMessage_Delta& msg, unsigned /*connectionId*/)
+{
+    if(!hasData_)
+        return true;
+    // Indices are ordered, so only the last one needs to be checked
+    if(!msg.nodes.empty() && msg.nodes.back().first >= nodes_.size())
+    {
+        LOG.write("Received invalid changes from the spectator feed\n");
+        return true;
+    }
+    for(const SpectatorMessage_Delta::Change& change : msg.nodes)
+        nodes_[change.first] = change.second;
+    if(msg.isLast)
+        gf_ = msg.gf;
+    return true;
+}
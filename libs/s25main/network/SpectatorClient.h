@@ -0,0 +1,69 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SpectatorClient_h__
+#define SpectatorClient_h__
+
+#include "NetworkPlayer.h"
+#include "SpectatorMessages.h"
+#include "gameTypes/CompressedData.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Receives the stream of a SpectatorFeed and keeps the subscribed region of the map up to date
+class SpectatorClient : public SpectatorMessageInterface
+{
+public:
+    SpectatorClient();
+    ~SpectatorClient() override;
+
+    bool Connect(const std::string& host, uint16_t port, bool ipv6 = false);
+    void Disconnect();
+    bool IsConnected() const { return connection_.socket.isValid(); }
+
+    /// Request the region. The data is available when the snapshot of it was received
+    void Subscribe(const SpectatorRegion& region);
+    /// Send requests and apply received data. Return false if the connection was lost
+    bool Run();
+
+    /// True if the data of the subscribed region was received
+    bool HasData() const { return hasData_; }
+    /// GF the data belongs to
+    unsigned GetGF() const { return gf_; }
+    MapExtent GetMapSize() const { return mapSize_; }
+    /// Subscribed region limited to the map
+    const SpectatorRegion& GetRegion() const { return region_; }
+    /// Data of a node in the region
+    const SpectatorNode& GetNode(MapPoint pt) const;
+
+    bool OnSpectatorMessage(const SpectatorMessage_Snapshot& msg, unsigned connectionId) override;
+    bool OnSpectatorMessage(const SpectatorMessage_Delta& msg, unsigned connectionId) override;
+
+private:
+    NetworkPlayer connection_;
+    bool hasData_;
+    unsigned gf_;
+    MapExtent mapSize_;
+    /// Region as requested and as limited to the map
+    SpectatorRegion requestedRegion_, region_;
+    std::vector<SpectatorNode> nodes_;
+    /// Parts of the snapshot received so far
+    CompressedData pendingSnapshot_;
+};
+
+#endif // SpectatorClient_h__
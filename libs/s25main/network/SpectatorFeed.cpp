@@ -0,0 +1,272 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "SpectatorFeed.h"
+#include "GamePlayer.h"
+#include "helpers/containerUtils.h"
+#include "world/GameWorldBase.h"
+#include "nodeObjs/noBase.h"
+#include "notifications/BuildingNote.h"
+#include "notifications/NodeNote.h"
+#include "notifications/PlayerNodeNote.h"
+#include "notifications/RoadNote.h"
+#include "gameTypes/CompressedData.h"
+#include "libutil/Log.h"
+#include "libutil/Serializer.h"
+#include "libutil/SocketSet.h"
+#include <mygettext/mygettext.h>
+#include <algorithm>
+
+SpectatorFeed::Spectator::Spectator(unsigned id, const Socket& socket) //-V818
+    : NetworkPlayer(id, SpectatorMessage::create_spectator)
+{
+    this->socket = socket;
+}
+
+constexpr unsigned char SpectatorFeed::ALL_VISIBLE;
+
+SpectatorFeed::SpectatorFeed(const GameWorldBase& world, unsigned char viewer)
+    : world_(nullptr), viewer_(viewer), nextSpectatorId_(0), lastGF_(0)
+{
+    SetWorld(world, 0);
+}
+
+SpectatorFeed::~SpectatorFeed()
+{
+    Stop();
+}
+
+bool SpectatorFeed::Listen(uint16_t port, bool ipv6)
+{
+    Stop();
+    if(!serverSocket_.Listen(port, ipv6, false))
+    {
+        LOG.write(_("Could not start the spectator feed on port %1%\n")) % port;
+        return false;
+    }
+    LOG.write(_("Spectator feed started on port %1%\n")) % port;
+    return true;
+}
+
+void SpectatorFeed::Stop()
+{
+    for(Spectator& spectator : spectators_)
+        spectator.closeConnection();
+    spectators_.clear();
+    serverSocket_.Close();
+}
+
+void SpectatorFeed::Run()
+{
+    if(!IsRunning())
+        return;
+
+    SocketSet set;
+    set.Add(serverSocket_);
+    if(set.Select(0, 0) > 0)
+    {
+        Socket socket = serverSocket_.Accept();
+        if(socket.isValid())
+            spectators_.push_back(Spectator(nextSpectatorId_++, socket));
+    }
+
+    if(!spectators_.empty())
+    {
+        set.Clear();
+        for(const Spectator& spectator : spectators_)
+            set.Add(spectator.socket);
+        if(set.Select(0, 0) > 0)
+        {
+            for(Spectator& spectator : spectators_)
+            {
+                if(set.InSet(spectator.socket) && !spectator.receiveMsgs())
+                    spectator.closeConnection();
+            }
+        }
+    }
+
+    for(Spectator& spectator : spectators_)
+    {
+        if(spectator.socket.isValid())
+            spectator.executeMsgs(*this);
+    }
+    for(Spectator& spectator : spectators_)
+    {
+        if(spectator.socket.isValid() && !spectator.sendMsgs(-1))
+            spectator.closeConnection();
+    }
+    helpers::remove_if(spectators_, [](const Spectator& spectator) { return !spectator.socket.isValid(); });
+}
+
+void SpectatorFeed::PublishChanges(unsigned gf)
+{
+    lastGF_ = gf;
+    const MapExtent mapSize = world_->GetSize();
+    for(Spectator& spectator : spectators_)
+    {
+        if(spectator.region.GetNumNodes() == 0)
+            continue;
+        std::vector<SpectatorMessage_Delta::Change> changes;
+        for(const MapPoint pt : changedPts_)
+        {
+            if(spectator.region.Contains(pt, mapSize))
+                changes.emplace_back(spectator.region.GetIdx(pt, mapSize), GetNode(*world_, pt, viewer_));
+        }
+        using Change = SpectatorMessage_Delta::Change;
+        std::sort(changes.begin(), changes.end(), [](const Change& lhs, const Change& rhs) { return lhs.first < rhs.first; });
+        // Always send at least one message so the spectator knows the GF
+        size_t start = 0;
+        do
+        {
+            const size_t end = std::min<size_t>(start + SPECTATOR_MAX_DELTA_NODES, changes.size());
+            spectator.sendMsgAsync(new SpectatorMessage_Delta(gf, end == changes.size(),
+                                                              std::vector<SpectatorMessage_Delta::Change>(changes.begin() + start,
+                                                                                                          changes.begin() + end)));
+            start = end;
+        } while(start < changes.size());
+    }
+    for(const MapPoint pt : changedPts_)
+        isChanged_[world_->GetIdx(pt)] = false;
+    changedPts_.clear();
+}
+
+void SpectatorFeed::SetWorld(const GameWorldBase& world, unsigned gf)
+{
+    world_ = &world;
+    lastGF_ = gf;
+    changedPts_.clear();
+    isChanged_.assign(world.GetWidth() * world.GetHeight(), false);
+
+    NotificationManager& notifications = world.GetNotifications();
+    evNode_ = notifications.subscribe<NodeNote>([this](const NodeNote& note) { AddChangedVisiblePt(note.pos); });
+    evBuilding_ = notifications.subscribe<BuildingNote>([this](const BuildingNote& note) {
+        AddChangedVisiblePt(note.pos);
+        AddChangedVisiblePt(world_->GetNeighbour(note.pos, Direction::SOUTHEAST));
+    });
+    evRoad_ = notifications.subscribe<RoadNote>([this](const RoadNote& note) {
+        if(note.type != RoadNote::Constructed)
+            return;
+        // Flags might have been placed along the road
+        MapPoint pt = note.pos;
+        AddChangedVisiblePt(pt);
+        for(const Direction dir : note.route)
+        {
+            pt = world_->GetNeighbour(pt, dir);
+            AddChangedVisiblePt(pt);
+        }
+    });
+    // Points getting visible show their current state, points getting out of sight the state last seen
+    if(viewer_ != ALL_VISIBLE)
+    {
+        evVisibility_ = notifications.subscribe<PlayerNodeNote>([this](const PlayerNodeNote& note) {
+            if(note.player == viewer_ || world_->GetPlayer(viewer_).IsAlly(note.player))
+                AddChangedPt(note.pt);
+        });
+    }
+
+    for(Spectator& spectator : spectators_)
+    {
+        if(spectator.region.GetNumNodes() == 0)
+            continue;
+        spectator.region = spectator.region.ClampTo(world.GetSize());
+        SendSnapshot(spectator, gf);
+    }
+}
+
+SpectatorNode SpectatorFeed::GetNode(const GameWorldBase& world, MapPoint pt, unsigned char viewer)
+{
+    const MapNode& node = world.GetNode(pt);
+    SpectatorNode result;
+    const Visibility visibility = (viewer == ALL_VISIBLE) ? VIS_VISIBLE : world.CalcVisiblityWithAllies(pt, viewer);
+    if(visibility != VIS_VISIBLE)
+    {
+        // Only the terrain and what was seen last are known. Objects in the fog of war have no game object type
+        const FoWNode& fow = node.fow[viewer];
+        const bool isFoW = visibility == VIS_FOW;
+        result.altitude = isFoW ? node.altitude : 0;
+        result.owner = isFoW ? fow.owner : 0;
+        result.bq = BQ_NOTHING;
+        if(isFoW)
+            result.roads = fow.roads;
+        else
+            result.roads.fill(0);
+        result.got = GOT_NOTHING;
+        return result;
+    }
+    result.altitude = node.altitude;
+    result.owner = node.owner;
+    result.bq = node.bq;
+    result.roads = node.roads;
+    result.got = world.GetNO(pt)->GetGOT();
+    return result;
+}
+
+bool SpectatorFeed::OnSpectatorMessage(const SpectatorMessage_Subscribe& msg, unsigned connectionId)
+{
+    const auto it = std::find_if(spectators_.begin(), spectators_.end(),
+                                 [connectionId](const Spectator& spectator) { return spectator.playerId == connectionId; });
+    if(it == spectators_.end())
+        return true;
+    it->region = msg.region.ClampTo(world_->GetSize());
+    SendSnapshot(*it, lastGF_);
+    return true;
+}
+
+void SpectatorFeed::AddChangedPt(MapPoint pt)
+{
+    // Nobody to tell about it
+    if(spectators_.empty())
+        return;
+    const unsigned idx = world_->GetIdx(pt);
+    if(isChanged_[idx])
+        return;
+    isChanged_[idx] = true;
+    changedPts_.push_back(pt);
+}
+
+void SpectatorFeed::AddChangedVisiblePt(MapPoint pt)
+{
+    // Changes out of sight are sent when the point gets visible
+    if(viewer_ == ALL_VISIBLE || world_->CalcVisiblityWithAllies(pt, viewer_) == VIS_VISIBLE)
+        AddChangedPt(pt);
+}
+
+void SpectatorFeed::SendSnapshot(Spectator& spectator, unsigned gf)
+{
+    const MapExtent mapSize = world_->GetSize();
+    const SpectatorRegion& region = spectator.region;
+    Serializer ser;
+    for(unsigned idx = 0; idx < region.GetNumNodes(); idx++)
+        GetNode(*world_, region.GetPoint(idx, mapSize), viewer_).Serialize(ser);
+    CompressedData compressed;
+    if(!compressed.CompressFromBuffer(reinterpret_cast<const char*>(ser.GetData()), ser.GetLength()))
+    {
+        LOG.write(_("Could not compress the snapshot for spectator %1%\n")) % spectator.playerId;
+        spectator.region = SpectatorRegion();
+        return;
+    }
+    // Split into parts so a big snapshot does not block the connection for too long
+    unsigned offset = 0;
+    do
+    {
+        const unsigned partSize = std::min<unsigned>(compressed.data.size() - offset, SPECTATOR_SNAPSHOT_PART_SIZE);
+        spectator.sendMsgAsync(new SpectatorMessage_Snapshot(gf, mapSize, region, compressed.length, compressed.data.size(), offset,
+                                                             &compressed.data[offset], partSize));
+        offset += partSize;
+    } while(offset < compressed.data.size());
+}
@@ -0,0 +1,91 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SpectatorFeed_h__
+#define SpectatorFeed_h__
+
+#include "NetworkPlayer.h"
+#include "SpectatorMessages.h"
+#include "notifications/Subscribtion.h"
+#include "libutil/Socket.h"
+#include <cstdint>
+#include <vector>
+
+class GameWorldBase;
+
+/// Streams a running game to spectators which do not simulate it themselves (e.g. viewers of tournament games).
+/// Each spectator subscribes to a region of the map. It gets a compressed snapshot of that region first and then at each NWF the nodes
+/// of it which changed. Changes are tracked via the node, building and road notifications of the world.
+/// In games with a local player only what that player sees is streamed, so the feed cannot be used to look behind the fog of war.
+/// Everything happens on the game thread
+class SpectatorFeed : public SpectatorMessageInterface
+{
+public:
+    /// Viewer for streaming the whole map (replays, AI matches)
+    static constexpr unsigned char ALL_VISIBLE = 0xFF;
+
+    /// Stream the world as seen by the viewing player
+    explicit SpectatorFeed(const GameWorldBase& world, unsigned char viewer = ALL_VISIBLE);
+    ~SpectatorFeed() override;
+
+    /// Start accepting spectators on the port
+    bool Listen(uint16_t port, bool ipv6 = false);
+    /// Disconnect all spectators and stop listening
+    void Stop();
+    bool IsRunning() const { return serverSocket_.isValid(); }
+    unsigned GetNumSpectators() const { return spectators_.size(); }
+
+    /// Accept new spectators, handle their requests and send queued data. Call regularly (e.g. each frame and at each NWF)
+    void Run();
+    /// Queue the changes since the last call for all spectators. Call at each NWF
+    void PublishChanges(unsigned gf);
+    /// Stream another world from now on (e.g. after loading a replay keyframe). Spectators get a new snapshot
+    void SetWorld(const GameWorldBase& world, unsigned gf);
+
+    /// Current data of the node as sent to spectators. Points not visible to the viewer contain what the viewer saw last
+    static SpectatorNode GetNode(const GameWorldBase& world, MapPoint pt, unsigned char viewer = ALL_VISIBLE);
+
+    bool OnSpectatorMessage(const SpectatorMessage_Subscribe& msg, unsigned connectionId) override;
+
+private:
+    struct Spectator : NetworkPlayer
+    {
+        Spectator(unsigned id, const Socket& socket);
+        /// Region of the map (limited to the map). Empty if not subscribed
+        SpectatorRegion region;
+    };
+
+    void AddChangedPt(MapPoint pt);
+    /// Add the point if the viewer sees changes on it
+    void AddChangedVisiblePt(MapPoint pt);
+    void SendSnapshot(Spectator& spectator, unsigned gf);
+
+    const GameWorldBase* world_;
+    const unsigned char viewer_;
+    Socket serverSocket_;
+    std::vector<Spectator> spectators_;
+    unsigned nextSpectatorId_;
+    /// GF of the last published changes, used for snapshots
+    unsigned lastGF_;
+    Subscribtion evNode_, evBuilding_, evRoad_, evVisibility_;
+    /// Points changed since the last published changes
+    std::vector<MapPoint> changedPts_;
+    /// Flag for each node if it is in changedPts_
+    std::vector<bool> isChanged_;
+};
+
+#endif // SpectatorFeed_h__
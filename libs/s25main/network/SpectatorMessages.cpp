@@ -0,0 +1,188 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "SpectatorMessages.h"
+#include "helpers/toString.h"
+#include "libutil/Serializer.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+/// Distance from origin to value going in positive direction on a wrapping axis of the given size
+unsigned getWrappedOffset(unsigned value, unsigned origin, unsigned size)
+{
+    return (value + size - origin) % size;
+}
+} // namespace
+
+void SpectatorNode::Serialize(Serializer& ser) const
+{
+    ser.PushUnsignedChar(altitude);
+    ser.PushUnsignedChar(owner);
+    ser.PushUnsignedChar(static_cast<uint8_t>(bq));
+    for(unsigned char road : roads)
+        ser.PushUnsignedChar(road);
+    ser.PushUnsignedChar(static_cast<uint8_t>(got));
+}
+
+void SpectatorNode::Deserialize(Serializer& ser)
+{
+    altitude = ser.PopUnsignedChar();
+    owner = ser.PopUnsignedChar();
+    bq = BuildingQuality(ser.PopUnsignedChar());
+    for(unsigned char& road : roads)
+        road = ser.PopUnsignedChar();
+    got = GO_Type(ser.PopUnsignedChar());
+}
+
+SpectatorRegion SpectatorRegion::ClampTo(MapExtent mapSize) const
+{
+    return SpectatorRegion(MapPoint(origin.x % mapSize.x, origin.y % mapSize.y), elMin(size, mapSize));
+}
+
+bool SpectatorRegion::Contains(MapPoint pt, MapExtent mapSize) const
+{
+    return getWrappedOffset(pt.x, origin.x, mapSize.x) < size.x && getWrappedOffset(pt.y, origin.y, mapSize.y) < size.y;
+}
+
+unsigned SpectatorRegion::GetIdx(MapPoint pt, MapExtent mapSize) const
+{
+    RTTR_Assert(Contains(pt, mapSize));
+    return getWrappedOffset(pt.y, origin.y, mapSize.y) * size.x + getWrappedOffset(pt.x, origin.x, mapSize.x);
+}
+
+MapPoint SpectatorRegion::GetPoint(unsigned idx, MapExtent mapSize) const
+{
+    RTTR_Assert(idx < GetNumNodes());
+    return MapPoint((origin.x + idx % size.x) % mapSize.x, (origin.y + idx / size.x) % mapSize.y);
+}
+
+void SpectatorRegion::Serialize(Serializer& ser) const
+{
+    ser.PushUnsignedShort(origin.x);
+    ser.PushUnsignedShort(origin.y);
+    ser.PushUnsignedShort(size.x);
+    ser.PushUnsignedShort(size.y);
+}
+
+void SpectatorRegion::Deserialize(Serializer& ser)
+{
+    origin.x = ser.PopUnsignedShort();
+    origin.y = ser.PopUnsignedShort();
+    size.x = ser.PopUnsignedShort();
+    size.y = ser.PopUnsignedShort();
+}
+
+bool SpectatorMessage::run(MessageInterface* callback, unsigned connectionId)
+{
+    return Run(checkedCast<SpectatorMessageInterface*>(callback), connectionId);
+}
+
+Message* SpectatorMessage::create_spectator(unsigned short id)
+{
+    switch(id)
+    {
+        case NMS_SPECTATOR_SUBSCRIBE: return new SpectatorMessage_Subscribe();
+        case NMS_SPECTATOR_SNAPSHOT: return new SpectatorMessage_Snapshot();
+        case NMS_SPECTATOR_DELTA: return new SpectatorMessage_Delta();
+        default: return create_base(id);
+    }
+}
+
+void SpectatorMessage_Subscribe::Serialize(Serializer& ser) const
+{
+    SpectatorMessage::Serialize(ser);
+    region.Serialize(ser);
+}
+
+void SpectatorMessage_Subscribe::Deserialize(Serializer& ser)
+{
+    SpectatorMessage::Deserialize(ser);
+    region.Deserialize(ser);
+}
+
+void SpectatorMessage_Snapshot::Serialize(Serializer& ser) const
+{
+    SpectatorMessage::Serialize(ser);
+    ser.PushUnsignedInt(gf);
+    ser.PushUnsignedShort(mapSize.x);
+    ser.PushUnsignedShort(mapSize.y);
+    region.Serialize(ser);
+    ser.PushUnsignedInt(length);
+    ser.PushUnsignedInt(compressedSize);
+    ser.PushUnsignedInt(offset);
+    ser.PushUnsignedInt(data.size());
+    ser.PushRawData(data.data(), data.size());
+}
+
+void SpectatorMessage_Snapshot::Deserialize(Serializer& ser)
+{
+    SpectatorMessage::Deserialize(ser);
+    gf = ser.PopUnsignedInt();
+    mapSize.x = ser.PopUnsignedShort();
+    mapSize.y = ser.PopUnsignedShort();
+    region.Deserialize(ser);
+    length = ser.PopUnsignedInt();
+    compressedSize = ser.PopUnsignedInt();
+    offset = ser.PopUnsignedInt();
+    const unsigned dataSize = ser.PopUnsignedInt();
+    if(dataSize > SPECTATOR_SNAPSHOT_PART_SIZE)
+        throw std::length_error("Invalid snapshot part size: " + helpers::toString(dataSize));
+    data.resize(dataSize);
+    ser.PopRawData(data.data(), data.size());
+}
+
+void SpectatorMessage_Delta::Serialize(Serializer& ser) const
+{
+    SpectatorMessage::Serialize(ser);
+    ser.PushUnsignedInt(gf);
+    ser.PushBool(isLast);
+    ser.PushVarSize(nodes.size());
+    // Indices are ordered -> Store only the (small) distance to the previous one
+    unsigned lastIdx = 0;
+    for(const Change& change : nodes)
+    {
+        RTTR_Assert(change.first >= lastIdx);
+        ser.PushVarSize(change.first - lastIdx);
+        change.second.Serialize(ser);
+        lastIdx = change.first;
+    }
+}
+
+void SpectatorMessage_Delta::Deserialize(Serializer& ser)
+{
+    SpectatorMessage::Deserialize(ser);
+    gf = ser.PopUnsignedInt();
+    isLast = ser.PopBool();
+    const unsigned numNodes = ser.PopVarSize();
+    if(numNodes > SPECTATOR_MAX_DELTA_NODES)
+        throw std::length_error("Invalid number of changed nodes: " + helpers::toString(numNodes));
+    nodes.resize(numNodes);
+    unsigned lastIdx = 0;
+    for(Change& change : nodes)
+    {
+        const unsigned idxDiff = ser.PopVarSize();
+        // Keep the indices ordered even for broken data
+        if(idxDiff > std::numeric_limits<unsigned>::max() - lastIdx)
+            throw std::length_error("Invalid node index difference: " + helpers::toString(idxDiff));
+        change.first = lastIdx + idxDiff;
+        change.second.Deserialize(ser);
+        lastIdx = change.first;
+    }
+}
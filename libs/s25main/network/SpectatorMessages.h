@@ -0,0 +1,178 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SpectatorMessages_h__
+#define SpectatorMessages_h__
+
+#include "GameProtocol.h"
+#include "gameTypes/BuildingQuality.h"
+#include "gameTypes/GO_Type.h"
+#include "gameTypes/MapCoordinates.h"
+#include "libutil/Message.h"
+#include "libutil/MessageInterface.h"
+#include <array>
+#include <utility>
+#include <vector>
+
+class Serializer;
+class SpectatorMessage_Subscribe;
+class SpectatorMessage_Snapshot;
+class SpectatorMessage_Delta;
+
+/// What a spectator sees of a node
+struct SpectatorNode
+{
+    /// Number of bytes written by Serialize
+    static constexpr unsigned SERIALIZED_SIZE = 7;
+
+    unsigned char altitude;
+    /// Owner (playerIdx + 1, 0 = nobody)
+    unsigned char owner;
+    BuildingQuality bq;
+    /// Roads from this point: E, SE, SW
+    std::array<unsigned char, 3> roads;
+    /// Type of the object on the node
+    GO_Type got;
+
+    bool operator==(const SpectatorNode& rhs) const
+    {
+        return altitude == rhs.altitude && owner == rhs.owner && bq == rhs.bq && roads == rhs.roads && got == rhs.got;
+    }
+    bool operator!=(const SpectatorNode& rhs) const { return !(*this == rhs); }
+
+    void Serialize(Serializer& ser) const;
+    void Deserialize(Serializer& ser);
+};
+
+/// Rectangular part of the map. Wraps around the map borders like the map itself
+struct SpectatorRegion
+{
+    MapPoint origin;
+    MapExtent size;
+
+    SpectatorRegion() : origin(0, 0), size(0, 0) {}
+    SpectatorRegion(MapPoint origin, MapExtent size) : origin(origin), size(size) {}
+
+    /// Return the region limited to a map of the given size
+    SpectatorRegion ClampTo(MapExtent mapSize) const;
+    unsigned GetNumNodes() const { return static_cast<unsigned>(size.x) * size.y; }
+    bool Contains(MapPoint pt, MapExtent mapSize) const;
+    /// Index of a point in the region (row major)
+    unsigned GetIdx(MapPoint pt, MapExtent mapSize) const;
+    /// Point at the index
+    MapPoint GetPoint(unsigned idx, MapExtent mapSize) const;
+
+    void Serialize(Serializer& ser) const;
+    void Deserialize(Serializer& ser);
+};
+
+class SpectatorMessageInterface : public MessageInterface
+{
+protected:
+    ~SpectatorMessageInterface() override {}
+
+public:
+    virtual bool OnSpectatorMessage(const SpectatorMessage_Subscribe& /*msg*/, unsigned /*connectionId*/) { return false; }
+    virtual bool OnSpectatorMessage(const SpectatorMessage_Snapshot& /*msg*/, unsigned /*connectionId*/) { return false; }
+    virtual bool OnSpectatorMessage(const SpectatorMessage_Delta& /*msg*/, unsigned /*connectionId*/) { return false; }
+};
+
+class SpectatorMessage : public Message
+{
+public:
+    SpectatorMessage(uint16_t id) : Message(id) {}
+
+    virtual bool Run(SpectatorMessageInterface* callback, unsigned connectionId) const = 0;
+    bool run(MessageInterface* callback, unsigned connectionId) override;
+
+    static Message* create_spectator(unsigned short id);
+    Message* create(unsigned short id) const override { return create_spectator(id); }
+};
+
+/// Spectator > Host: Send the region from now on
+class SpectatorMessage_Subscribe : public SpectatorMessage
+{
+public:
+    SpectatorRegion region;
+
+    SpectatorMessage_Subscribe() : SpectatorMessage(NMS_SPECTATOR_SUBSCRIBE) {} //-V730
+    SpectatorMessage_Subscribe(const SpectatorRegion& region) : SpectatorMessage(NMS_SPECTATOR_SUBSCRIBE), region(region) {}
+
+    void Serialize(Serializer& ser) const override;
+    void Deserialize(Serializer& ser) override;
+    bool Run(SpectatorMessageInterface* callback, unsigned connectionId) const override
+    {
+        return callback->OnSpectatorMessage(*this, connectionId);
+    }
+};
+
+/// Host > Spectator: Part of the bzip2 compressed nodes of the subscribed region (row major).
+/// The snapshot is complete when offset + data.size() == compressedSize
+class SpectatorMessage_Snapshot : public SpectatorMessage
+{
+public:
+    uint32_t gf;
+    MapExtent mapSize;
+    /// Subscribed region limited to the map
+    SpectatorRegion region;
+    /// Uncompressed and compressed size of the snapshot
+    uint32_t length, compressedSize;
+    /// Offset of this part in the compressed data
+    uint32_t offset;
+    std::vector<char> data;
+
+    SpectatorMessage_Snapshot() : SpectatorMessage(NMS_SPECTATOR_SNAPSHOT) {} //-V730
+    SpectatorMessage_Snapshot(unsigned gf, MapExtent mapSize, const SpectatorRegion& region, unsigned length, unsigned compressedSize,
+                              unsigned offset, const char* data, unsigned dataSize)
+        : SpectatorMessage(NMS_SPECTATOR_SNAPSHOT), gf(gf), mapSize(mapSize), region(region), length(length),
+          compressedSize(compressedSize), offset(offset), data(data, data + dataSize)
+    {}
+
+    void Serialize(Serializer& ser) const override;
+    void Deserialize(Serializer& ser) override;
+    bool Run(SpectatorMessageInterface* callback, unsigned connectionId) const override
+    {
+        return callback->OnSpectatorMessage(*this, connectionId);
+    }
+};
+
+/// Host > Spectator: Nodes of the region which changed since the snapshot or the last delta.
+/// The changes of a GF may be split into multiple messages of which only the last one has isLast set
+class SpectatorMessage_Delta : public SpectatorMessage
+{
+public:
+    using Change = std::pair<unsigned, SpectatorNode>;
+
+    uint32_t gf;
+    bool isLast;
+    /// Region index and new data of the nodes ordered by index
+    std::vector<Change> nodes;
+
+    SpectatorMessage_Delta() : SpectatorMessage(NMS_SPECTATOR_DELTA) {} //-V730
+    SpectatorMessage_Delta(unsigned gf, bool isLast, std::vector<Change> nodes)
+        : SpectatorMessage(NMS_SPECTATOR_DELTA), gf(gf), isLast(isLast), nodes(std::move(nodes))
+    {}
+
+    void Serialize(Serializer& ser) const override;
+    void Deserialize(Serializer& ser) override;
+    bool Run(SpectatorMessageInterface* callback, unsigned connectionId) const override
+    {
+        return callback->OnSpectatorMessage(*this, connectionId);
+    }
+};
+
+#endif // SpectatorMessages_h__
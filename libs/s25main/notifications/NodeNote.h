@@ -28,7 +28,10 @@ struct NodeNote
     enum Type
     {
         Altitude, // Nodes altitude was changed
-        BQ        // Building quality
+        BQ,       // Building quality
+        Road,     // Road at node was changed
+        Owner,    // Owner of the node was changed
+        Object    // Object at the node was set, replaced or destroyed
     };
 
     NodeNote(Type type, const MapPoint& pt) : type(type), pos(pt) {}
@@ -19,18 +19,23 @@
 #define DummyRenderer_h__
 
 #include "IRenderer.h"
+#include "ogl/SpriteBatch.h"
 
 class glArchivItem_Bitmap;
 
 class DummyRenderer : public IRenderer
 {
+    ogl::SpriteBatch spriteBatch_;
+
 public:
     virtual bool initOpenGL(OpenGL_Loader_Proc) override;
     void Draw3DBorder(const Rect&, bool /*elevated*/, glArchivItem_Bitmap& /*texture*/) override {}
     void Draw3DContent(const Rect&, bool /*elevated*/, glArchivItem_Bitmap& /*texture*/, bool /*illuminated*/, unsigned /*color*/) override
     {}
-    void DrawRect(const Rect&, unsigned) override {}
-    void DrawLine(DrawPoint, DrawPoint, unsigned, unsigned) override {}
+    // Flush like the real renderer so the number of flushes can be tested
+    void DrawRect(const Rect&, unsigned) override { spriteBatch_.flush(); }
+    void DrawLine(DrawPoint, DrawPoint, unsigned, unsigned) override { spriteBatch_.flush(); }
+    ogl::SpriteBatch& GetSpriteBatch() override { return spriteBatch_; }
 };
 
 #endif // DummyRenderer_h__
@@ -66,6 +66,9 @@ public:
         return (value & detail::GetFontStyleMask<T_Enum>::value) == style;
     }
 
+    /// All flags combined, e.g. for use as a key
+    constexpr unsigned getValue() const { return value; }
+
 private:
     unsigned value = 0;
 };
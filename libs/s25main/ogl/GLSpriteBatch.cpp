@@ -0,0 +1,77 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "GLSpriteBatch.h"
+#include "Settings.h"
+#include "drivers/VideoDriverWrapper.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace ogl {
+
+GLSpriteBatch::GLSpriteBatch() : vboCapacity_(0) {}
+
+void GLSpriteBatch::uploadVertices(const std::vector<Vertex>& vertices)
+{
+    uintptr_t baseAddr;
+    if(SETTINGS.video.vbo)
+    {
+        if(!vbo_.isValid())
+        {
+            vbo_ = VBO<Vertex>(Target::Array);
+            vboCapacity_ = 0;
+        }
+        if(vertices.size() > vboCapacity_)
+            vboCapacity_ = std::max<size_t>(vertices.size(), vboCapacity_ * 2u);
+        // Orphan the old storage so we don't need to wait for pending draws of the last frame
+        vbo_.fill(nullptr, vboCapacity_, Usage::Stream);
+        vbo_.update(vertices);
+        baseAddr = 0;
+    } else
+    {
+        if(vbo_.isValid())
+        {
+            vbo_ = VBO<Vertex>();
+            vboCapacity_ = 0;
+        }
+        baseAddr = reinterpret_cast<uintptr_t>(vertices.data());
+    }
+
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(2, GL_FLOAT, sizeof(Vertex), reinterpret_cast<const GLvoid*>(baseAddr + offsetof(Vertex, pos)));
+    glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), reinterpret_cast<const GLvoid*>(baseAddr + offsetof(Vertex, texCoord)));
+    glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), reinterpret_cast<const GLvoid*>(baseAddr + offsetof(Vertex, color)));
+}
+
+void GLSpriteBatch::drawQuads(unsigned texture, unsigned firstQuad, unsigned numQuads)
+{
+    VIDEODRIVER.BindTexture(texture);
+    glDrawArrays(GL_QUADS, firstQuad * 4, numQuads * 4);
+}
+
+void GLSpriteBatch::finishFlush()
+{
+    glDisableClientState(GL_COLOR_ARRAY);
+    // Unbind VBO to not interfere with other program parts
+    if(vbo_.isValid())
+        vbo_.unbind();
+}
+
+} // namespace ogl
@@ -0,0 +1,44 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GLSpriteBatch_h__
+#define GLSpriteBatch_h__
+
+#include "ogl/SpriteBatch.h"
+#include "ogl/VBO.h"
+
+namespace ogl {
+
+/// Sprite batch drawing via OpenGL. Uses a persistent VBO (if enabled) which grows as required
+class GLSpriteBatch : public SpriteBatch
+{
+    VBO<Vertex> vbo_;
+    /// Number of vertices the VBO can hold
+    size_t vboCapacity_;
+
+protected:
+    void uploadVertices(const std::vector<Vertex>& vertices) override;
+    void drawQuads(unsigned texture, unsigned firstQuad, unsigned numQuads) override;
+    void finishFlush() override;
+
+public:
+    GLSpriteBatch();
+};
+
+} // namespace ogl
+
+#endif // GLSpriteBatch_h__
@@ -22,6 +22,9 @@
 #include "Rect.h"
 
 class glArchivItem_Bitmap;
+namespace ogl {
+class SpriteBatch;
+}
 
 /// Render functions for basic stuff
 /// Abstracts away the used algorithms
@@ -47,6 +50,9 @@ public:
     virtual void Draw3DContent(const Rect& rect, bool elevated, glArchivItem_Bitmap& texture, bool illuminated, unsigned color) = 0;
     virtual void DrawRect(const Rect& rect, unsigned color) = 0;
     virtual void DrawLine(DrawPoint pt1, DrawPoint pt2, unsigned width, unsigned color) = 0;
+    /// Get the batch collecting sprites (textured quads) to draw them with few draw calls.
+    /// If it is active, drawing functions of this renderer flush it first to keep the drawing order
+    virtual ogl::SpriteBatch& GetSpriteBatch() = 0;
 };
 
 #endif // IRenderer_h__
@@ -51,6 +51,7 @@ void OpenGLRenderer::Draw3DBorder(const Rect& rect, bool elevated, glArchivItem_
     texture.DrawPart(Rect(vertImgBorderPos, Extent(2, rectSize.y)));
 
     // Draw black borders over the img borders
+    spriteBatch_.flush();
     glDisable(GL_TEXTURE_2D);
     glColor3f(0.0f, 0.0f, 0.0f);
     glBegin(GL_TRIANGLE_STRIP);
@@ -83,6 +84,8 @@ void OpenGLRenderer::Draw3DContent(const Rect& rect, bool elevated, glArchivItem
 {
     if(illuminated)
     {
+        // Texture env applies to all pending sprites
+        spriteBatch_.flush();
         // Modulate2x anmachen
         glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
         glTexEnvf(GL_TEXTURE_ENV, GL_RGB_SCALE, 2.0f);
@@ -98,6 +101,7 @@ void OpenGLRenderer::Draw3DContent(const Rect& rect, bool elevated, glArchivItem
 
     if(illuminated)
     {
+        spriteBatch_.flush();
         // Modulate2x wieder ausmachen
         glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
     }
@@ -105,6 +109,7 @@ void OpenGLRenderer::Draw3DContent(const Rect& rect, bool elevated, glArchivItem
 
 void OpenGLRenderer::DrawRect(const Rect& rect, unsigned color)
 {
+    spriteBatch_.flush();
     glDisable(GL_TEXTURE_2D);
 
     glColor4ub(GetRed(color), GetGreen(color), GetBlue(color), GetAlpha(color));
@@ -121,6 +126,7 @@ void OpenGLRenderer::DrawRect(const Rect& rect, unsigned color)
 
 void OpenGLRenderer::DrawLine(DrawPoint pt1, DrawPoint pt2, unsigned width, unsigned color)
 {
+    spriteBatch_.flush();
     glDisable(GL_TEXTURE_2D);
     glColor4ub(GetRed(color), GetGreen(color), GetBlue(color), GetAlpha(color));
 
@@ -19,11 +19,14 @@
 #define OpenGLRenderer_h__
 
 #include "IRenderer.h"
+#include "ogl/GLSpriteBatch.h"
 
 class glArchivItem_Bitmap;
 
 class OpenGLRenderer : public IRenderer
 {
+    ogl::GLSpriteBatch spriteBatch_;
+
 public:
     bool initOpenGL(OpenGL_Loader_Proc) override;
     void synchronize() override;
@@ -31,6 +34,7 @@ public:
     void Draw3DContent(const Rect& rect, bool elevated, glArchivItem_Bitmap& texture, bool illuminated, unsigned color) override;
     void DrawRect(const Rect& rect, unsigned color) override;
     void DrawLine(DrawPoint pt1, DrawPoint pt2, unsigned width, unsigned color) override;
+    ogl::SpriteBatch& GetSpriteBatch() override { return spriteBatch_; }
 };
 
 #endif // OpenGLRenderer_h__
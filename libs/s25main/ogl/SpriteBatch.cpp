@@ -0,0 +1,88 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "SpriteBatch.h"
+#include "libutil/colors.h"
+
+namespace ogl {
+
+SpriteBatch::SpriteBatch() : active_(false), numFlushes_(0), numDrawCalls_(0) {}
+
+void SpriteBatch::begin()
+{
+    RTTR_Assert(!active_);
+    RTTR_Assert(textures_.empty());
+    active_ = true;
+}
+
+void SpriteBatch::end()
+{
+    RTTR_Assert(active_);
+    flush();
+    active_ = false;
+}
+
+void SpriteBatch::add(unsigned texture, const Point<float>* vertices, const Point<float>* texCoords, unsigned color)
+{
+    Quad quad;
+    const std::array<uint8_t, 4> rgba = {{GetRed(color), GetGreen(color), GetBlue(color), GetAlpha(color)}};
+    for(unsigned i = 0; i < quad.size(); i++)
+    {
+        quad[i].pos = vertices[i];
+        quad[i].texCoord = texCoords[i];
+        quad[i].color = rgba;
+    }
+    add(texture, quad);
+}
+
+void SpriteBatch::add(unsigned texture, const Quad& quad)
+{
+    RTTR_Assert(active_);
+    textures_.push_back(texture);
+    vertices_.insert(vertices_.end(), quad.begin(), quad.end());
+}
+
+void SpriteBatch::flush()
+{
+    if(textures_.empty())
+        return;
+
+    uploadVertices(vertices_);
+
+    unsigned runStart = 0;
+    for(unsigned i = 1; i <= textures_.size(); i++)
+    {
+        if(i < textures_.size() && textures_[i] == textures_[runStart])
+            continue;
+        drawQuads(textures_[runStart], runStart, i - runStart);
+        ++numDrawCalls_;
+        runStart = i;
+    }
+    finishFlush();
+    ++numFlushes_;
+
+    textures_.clear();
+    vertices_.clear();
+}
+
+void SpriteBatch::resetCounters()
+{
+    numFlushes_ = numDrawCalls_ = 0;
+}
+
+} // namespace ogl
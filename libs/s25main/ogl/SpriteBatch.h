@@ -0,0 +1,86 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SpriteBatch_h__
+#define SpriteBatch_h__
+
+#include "Point.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace ogl {
+
+/// Collects textured quads (sprites) and draws them with as few draw calls as possible.
+/// Quads are drawn in submission order (painters order) and consecutive quads using the same texture
+/// (e.g. the same page of a glTexturePacker) are drawn in one call.
+/// This class only builds the draw lists, the actual drawing is done by the derived classes
+class SpriteBatch
+{
+public:
+    struct Vertex
+    {
+        Point<float> pos;
+        Point<float> texCoord;
+        std::array<uint8_t, 4> color;
+    };
+    using Quad = std::array<Vertex, 4>;
+
+    SpriteBatch();
+    virtual ~SpriteBatch() = default;
+
+    /// Start collecting quads. Every quad added afterwards is deferred until flush() or end()
+    void begin();
+    /// Draw all pending quads and stop collecting
+    void end();
+    /// True if quads are currently collected instead of being drawn directly
+    bool isActive() const { return active_; }
+
+    /// Add a quad given by 4 vertices (in the order used for GL_QUADS) and texCoords with the given color (ARGB) for all vertices
+    void add(unsigned texture, const Point<float>* vertices, const Point<float>* texCoords, unsigned color);
+    void add(unsigned texture, const Quad& quad);
+    /// Draw all pending quads. Must be called before anything is drawn directly while the batch is active
+    void flush();
+
+    /// Number of quads waiting to be drawn
+    unsigned getNumPendingQuads() const { return static_cast<unsigned>(textures_.size()); }
+    /// Number of flushes which actually had something to draw
+    unsigned getNumFlushes() const { return numFlushes_; }
+    /// Number of draw calls issued (one per run of quads using the same texture)
+    unsigned getNumDrawCalls() const { return numDrawCalls_; }
+    void resetCounters();
+
+protected:
+    /// Called once per flush with the vertices of all quads in draw order
+    virtual void uploadVertices(const std::vector<Vertex>& /*vertices*/) {}
+    /// Draw numQuads quads starting at firstQuad (index into the uploaded vertices / 4) using the given texture
+    virtual void drawQuads(unsigned /*texture*/, unsigned /*firstQuad*/, unsigned /*numQuads*/) {}
+    /// Called after all quads of a flush were drawn
+    virtual void finishFlush() {}
+
+private:
+    /// Texture of each pending quad
+    std::vector<unsigned> textures_;
+    /// Vertices of the pending quads in draw order. Kept as a member to avoid reallocations each frame
+    std::vector<Vertex> vertices_;
+    bool active_;
+    unsigned numFlushes_, numDrawCalls_;
+};
+
+} // namespace ogl
+
+#endif // SpriteBatch_h__
@@ -19,6 +19,7 @@
 #include "glArchivItem_Bitmap.h"
 #include "Point.h"
 #include "drivers/VideoDriverWrapper.h"
+#include "ogl/SpriteBatch.h"
 #include "libsiedler2/PixelBufferARGB.h"
 #include <glad/glad.h>
 
@@ -70,6 +71,12 @@ void glArchivItem_Bitmap::Draw(Rect dstArea, Rect srcArea, unsigned color /*= CO
     texCoords[0].y = texCoords[3].y = srcOrig.y;
     texCoords[1].y = texCoords[2].y = srcEndPt.y;
 
+    if(ogl::SpriteBatch* batch = VIDEODRIVER.GetActiveSpriteBatch())
+    {
+        batch->add(GetTexture(), vertices.data(), texCoords.data(), color);
+        return;
+    }
+
     glVertexPointer(2, GL_FLOAT, 0, vertices.data());
     glTexCoordPointer(2, GL_FLOAT, 0, texCoords.data());
     VIDEODRIVER.BindTexture(GetTexture());
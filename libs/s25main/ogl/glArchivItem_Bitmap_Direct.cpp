@@ -22,10 +22,10 @@
 #include <glad/glad.h>
 #include <stdexcept>
 
-glArchivItem_Bitmap_Direct::glArchivItem_Bitmap_Direct() : isUpdating_(false) {}
+glArchivItem_Bitmap_Direct::glArchivItem_Bitmap_Direct() : isUpdating_(false), numTilesX_(0) {}
 
 glArchivItem_Bitmap_Direct::glArchivItem_Bitmap_Direct(const glArchivItem_Bitmap_Direct& item)
-    : ArchivItem_BitmapBase(item), baseArchivItem_Bitmap(item), glArchivItem_Bitmap(item), isUpdating_(false)
+    : ArchivItem_BitmapBase(item), baseArchivItem_Bitmap(item), glArchivItem_Bitmap(item), isUpdating_(false), numTilesX_(0)
 {}
 
 void glArchivItem_Bitmap_Direct::beginUpdate()
@@ -33,7 +33,12 @@ void glArchivItem_Bitmap_Direct::beginUpdate()
     if(isUpdating_)
         throw std::logic_error("Already updating! Forgot an endUpdate?");
     isUpdating_ = true;
-    areaToUpdate_ = Rect(0, 0, 0, 0);
+    RTTR_Assert(dirtyTiles_.empty());
+    const Extent size = GetSize();
+    numTilesX_ = (size.x + TILE_SIZE - 1) / TILE_SIZE;
+    const unsigned numTiles = numTilesX_ * ((size.y + TILE_SIZE - 1) / TILE_SIZE);
+    if(tileAreas_.size() != numTiles)
+        tileAreas_.assign(numTiles, Rect(0, 0, 0, 0));
 }
 
 void glArchivItem_Bitmap_Direct::endUpdate()
@@ -41,17 +46,25 @@ void glArchivItem_Bitmap_Direct::endUpdate()
     if(!isUpdating_)
         throw std::logic_error("Already updating! Forgot an endUpdate?");
     isUpdating_ = false;
-    // Nothing to update or no texture created yet
-    if(prodOfComponents(areaToUpdate_.getSize()) == 0 || !GetTexNoCreate())
-        return;
-
-    libsiedler2::PixelBufferARGB buffer(areaToUpdate_.getSize().x, areaToUpdate_.getSize().y);
-    Position origin = areaToUpdate_.getOrigin();
-    int ec = print(buffer, nullptr, 0, 0, origin.x, origin.y);
-    RTTR_Assert(ec == 0);
-    VIDEODRIVER.BindTexture(GetTexNoCreate());
-    glTexSubImage2D(GL_TEXTURE_2D, 0, origin.x, origin.y, buffer.getWidth(), buffer.getHeight(), GL_BGRA, GL_UNSIGNED_BYTE,
-                    buffer.getPixelPtr());
+    // No texture created yet -> Data gets uploaded on creation
+    const bool hasTexture = GetTexNoCreate() != 0;
+    if(hasTexture && !dirtyTiles_.empty())
+        VIDEODRIVER.BindTexture(GetTexNoCreate());
+    for(unsigned tileIdx : dirtyTiles_)
+    {
+        Rect& area = tileAreas_[tileIdx];
+        if(hasTexture)
+        {
+            libsiedler2::PixelBufferARGB buffer(area.getSize().x, area.getSize().y);
+            Position origin = area.getOrigin();
+            int ec = print(buffer, nullptr, 0, 0, origin.x, origin.y);
+            RTTR_Assert(ec == 0);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, origin.x, origin.y, buffer.getWidth(), buffer.getHeight(), GL_BGRA, GL_UNSIGNED_BYTE,
+                            buffer.getPixelPtr());
+        }
+        area = Rect(0, 0, 0, 0);
+    }
+    dirtyTiles_.clear();
 }
 
 void glArchivItem_Bitmap_Direct::updatePixel(const DrawPoint& pos, const libsiedler2::ColorARGB& clr)
@@ -60,19 +73,23 @@ void glArchivItem_Bitmap_Direct::updatePixel(const DrawPoint& pos, const libsied
     RTTR_Assert(pos.x >= 0 && pos.y >= 0);
     RTTR_Assert(static_cast<unsigned>(pos.x) < GetSize().x && static_cast<unsigned>(pos.y) < GetSize().y);
     setPixel(pos.x, pos.y, clr);
+    const unsigned tileIdx = (pos.y / TILE_SIZE) * numTilesX_ + pos.x / TILE_SIZE;
+    Rect& area = tileAreas_[tileIdx];
     // If the area is empty, create one
-    if(areaToUpdate_.getSize().x == 0)
-        areaToUpdate_ = Rect(Position(pos), Extent(1, 1));
-    else
+    if(area.getSize().x == 0)
+    {
+        area = Rect(Position(pos), Extent(1, 1));
+        dirtyTiles_.push_back(tileIdx);
+    } else
     {
         // Else resize if required
-        if(pos.x < areaToUpdate_.left)
-            areaToUpdate_.left = pos.x;
-        if(pos.x >= areaToUpdate_.right)
-            areaToUpdate_.right = pos.x + 1;
-        if(pos.y < areaToUpdate_.top)
-            areaToUpdate_.top = pos.y;
-        if(pos.y >= areaToUpdate_.bottom)
-            areaToUpdate_.bottom = pos.y + 1;
+        if(pos.x < area.left)
+            area.left = pos.x;
+        if(pos.x >= area.right)
+            area.right = pos.x + 1;
+        if(pos.y < area.top)
+            area.top = pos.y;
+        if(pos.y >= area.bottom)
+            area.bottom = pos.y + 1;
     }
 }
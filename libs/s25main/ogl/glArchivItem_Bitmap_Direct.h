@@ -21,6 +21,7 @@
 
 #include "Rect.h"
 #include "glArchivItem_Bitmap.h"
+#include <vector>
 
 namespace libsiedler2 {
 struct ColorARGB;
@@ -36,7 +37,7 @@ public:
 
     /// Call before updating texture
     void beginUpdate();
-    /// Call after updating texture
+    /// Call after updating texture. Uploads the changed area of each changed tile
     void endUpdate();
     /// Updates a pixels color
     void updatePixel(const DrawPoint& pos, const libsiedler2::ColorARGB& clr);
@@ -47,8 +48,15 @@ public:
     int write(std::ostream& /*file*/, const libsiedler2::ArchivItem_Palette* /*palette*/) const override { return 254; }
 
 private:
+    /// Changes are tracked and uploaded in square tiles of this size, so scattered changes don't upload the whole texture
+    static constexpr unsigned TILE_SIZE = 64;
+
     bool isUpdating_;
-    Rect areaToUpdate_;
+    unsigned numTilesX_;
+    /// Changed area of each tile. Empty for unchanged tiles
+    std::vector<Rect> tileAreas_;
+    /// Indices of the changed tiles
+    std::vector<unsigned> dirtyTiles_;
 };
 
 #endif // !GLARCHIVITEM_BITMAP_DIRECT_H_INCLUDED
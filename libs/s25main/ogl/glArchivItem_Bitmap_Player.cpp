@@ -20,6 +20,7 @@
 #include "Loader.h"
 #include "Point.h"
 #include "drivers/VideoDriverWrapper.h"
+#include "ogl/SpriteBatch.h"
 #include "libsiedler2/PixelBufferARGB.h"
 #include <glad/glad.h>
 
@@ -91,6 +92,13 @@ void glArchivItem_Bitmap_Player::Draw(Rect dstArea, Rect srcArea, unsigned color
     texCoords[6].x += 0.5f;
     texCoords[7].x += 0.5f;
 
+    if(ogl::SpriteBatch* batch = VIDEODRIVER.GetActiveSpriteBatch())
+    {
+        batch->add(GetTexture(), vertices.data(), texCoords.data(), color);
+        batch->add(GetTexture(), &vertices[4], &texCoords[4], player_color);
+        return;
+    }
+
     std::array<GL_RGBAColor, 8> colors;
     colors[0].r = GetRed(color);
     colors[0].g = GetGreen(color);
@@ -22,6 +22,7 @@
 #include "drivers/VideoDriverWrapper.h"
 #include "glArchivItem_Bitmap.h"
 #include "helpers/containerUtils.h"
+#include "ogl/SpriteBatch.h"
 #include "libsiedler2/ArchivItem_Bitmap_Player.h"
 #include "libsiedler2/IAllocator.h"
 #include "libsiedler2/PixelBufferARGB.h"
@@ -29,6 +30,7 @@
 #include "libutil/Log.h"
 #include <utf8.h>
 #include <boost/algorithm/string.hpp>
+#include <array>
 #include <cmath>
 #include <vector>
 
@@ -36,6 +38,12 @@
 
 using utf8Iterator = utf8::iterator<std::string::const_iterator>;
 
+namespace {
+/// Number of Draw calls whose quads are kept. Enough for all texts of a frame
+constexpr size_t maxCachedTextLayouts = 512;
+constexpr size_t maxCachedWrapInfos = 64;
+} // namespace
+
 template<typename T>
 struct GetNextCharAndIncIt;
 
@@ -97,13 +105,15 @@ T_Iterator nextIt(T_Iterator it)
 
 //////////////////////////////////////////////////////////////////////////
 
-glArchivItem_Font::glArchivItem_Font() : fontNoOutline(nullptr), fontWithOutline(nullptr)
+glArchivItem_Font::glArchivItem_Font()
+    : fontNoOutline(nullptr), fontWithOutline(nullptr), layoutCache(maxCachedTextLayouts), wrapInfoCache(maxCachedWrapInfos)
 {
     ClearCharInfoMapping();
 }
 
 glArchivItem_Font::glArchivItem_Font(const glArchivItem_Font& obj)
-    : ArchivItem_Font(obj), asciiMapping(obj.asciiMapping), utf8_mapping(obj.utf8_mapping)
+    : ArchivItem_Font(obj), asciiMapping(obj.asciiMapping), utf8_mapping(obj.utf8_mapping), layoutCache(obj.layoutCache),
+      wrapInfoCache(obj.wrapInfoCache)
 {
     fontNoOutline = libsiedler2::clone(obj.fontNoOutline);
     fontWithOutline = libsiedler2::clone(obj.fontWithOutline);
@@ -207,8 +217,66 @@ void glArchivItem_Font::Draw(DrawPoint pos, const std::string& text, FontStyle f
     if(!fontNoOutline)
         initFont();
 
+    // Get texture first as it might need to be created
+    glArchivItem_Bitmap& usedFont = format.is(FontStyle::NO_OUTLINE) ? *fontNoOutline : *fontWithOutline;
+    unsigned texture = usedFont.GetTexture();
+    if(!texture)
+        return;
+
+    const VertexArrays& layout = GetTextLayout(text, format, length, maxWidth, end, GlPoint(usedFont.GetTexSize()));
+    if(layout.vertices.empty())
+        return;
+
+    const GlPoint offset(pos);
+    if(ogl::SpriteBatch* batch = VIDEODRIVER.GetActiveSpriteBatch())
+    {
+        std::array<GlPoint, 4> vertices;
+        for(unsigned i = 0; i < layout.vertices.size(); i += 4)
+        {
+            for(unsigned j = 0; j < 4; j++)
+                vertices[j] = layout.vertices[i + j] + offset;
+            batch->add(texture, vertices.data(), &layout.texCoords[i], color);
+        }
+        return;
+    }
+
+    glPushMatrix();
+    glTranslatef(offset.x, offset.y, 0.f);
+    glVertexPointer(2, GL_FLOAT, 0, &layout.vertices[0]);
+    glTexCoordPointer(2, GL_FLOAT, 0, &layout.texCoords[0]);
+    VIDEODRIVER.BindTexture(texture);
+    glColor4ub(GetRed(color), GetGreen(color), GetBlue(color), GetAlpha(color));
+    glDrawArrays(GL_QUADS, 0, layout.vertices.size());
+    glPopMatrix();
+}
+
+const glArchivItem_Font::VertexArrays& glArchivItem_Font::GetTextLayout(const std::string& text, FontStyle format, unsigned short length,
+                                                                        unsigned short maxWidth, const std::string& end,
+                                                                        const GlPoint& texSize)
+{
+    const unsigned formatValue = format.getValue();
+    if(const VertexArrays* layout = layoutCache.find(std::tie(text, formatValue, length, maxWidth, end)))
+        return *layout;
+
+    VertexArrays layout = CreateTextLayout(text, format, length, maxWidth, end);
+    RTTR_Assert(layout.texCoords.size() == layout.vertices.size());
+    RTTR_Assert(layout.texCoords.size() % 4u == 0);
+    // Vectorizable loop
+    for(unsigned i = 0; i < layout.texCoords.size(); i += 4)
+    {
+        for(int j = 0; j < 4; j++)
+            layout.texCoords[i + j] /= texSize;
+    }
+    return layoutCache.insert(std::make_tuple(text, formatValue, length, maxWidth, end), std::move(layout));
+}
+
+glArchivItem_Font::VertexArrays glArchivItem_Font::CreateTextLayout(const std::string& text, FontStyle format, unsigned short length,
+                                                                    unsigned short maxWidth, const std::string& end) const
+{
     RTTR_Assert(utf8::is_valid(text));
 
+    VertexArrays layout;
+
     // Breite bestimmen
     if(length == 0)
         length = (unsigned short)text.length();
@@ -231,7 +299,7 @@ void glArchivItem_Font::Draw(DrawPoint pos, const std::string& text, FontStyle f
 
             // If "end" does not fit, draw nothing
             if(textWidth < endWidth)
-                return;
+                return layout;
 
             // Wieviele Buchstaben gehen in den "Rest" (ohne "end")
             textWidth = getWidth(text, length, textWidth - endWidth, &maxNumChars) + endWidth;
@@ -241,10 +309,12 @@ void glArchivItem_Font::Draw(DrawPoint pos, const std::string& text, FontStyle f
     }
 
     if(maxNumChars == 0)
-        return;
+        return layout;
     auto itEnd = text.cbegin();
     std::advance(itEnd, maxNumChars);
 
+    // Quads are relative to the draw position
+    DrawPoint pos(0, 0);
     // Vertical alignment (assumes 1 line only!)
     if(format.is(FontStyle::BOTTOM))
         pos.y -= dy;
@@ -266,9 +336,6 @@ void glArchivItem_Font::Draw(DrawPoint pos, const std::string& text, FontStyle f
         curPos.x = pos.x - line_width / 2;
     }
 
-    texList.texCoords.clear();
-    texList.vertices.clear();
-
     for(auto it = text.begin(); it != itEnd;)
     {
         const uint32_t curChar = utf8::next(it, itEnd);
@@ -284,7 +351,7 @@ void glArchivItem_Font::Draw(DrawPoint pos, const std::string& text, FontStyle f
                 curPos.x = pos.x;
             curPos.y += dy;
         } else
-            DrawChar(curChar, texList, curPos);
+            DrawChar(curChar, layout, curPos);
     }
 
     if(drawEnd)
@@ -297,33 +364,10 @@ void glArchivItem_Font::Draw(DrawPoint pos, const std::string& text, FontStyle f
                 curPos.x = pos.x;
                 curPos.y += dy;
             } else
-                DrawChar(curChar, texList, curPos);
+                DrawChar(curChar, layout, curPos);
         }
     }
-
-    if(texList.vertices.empty())
-        return;
-
-    // Get texture first as it might need to be created
-    glArchivItem_Bitmap& usedFont = format.is(FontStyle::NO_OUTLINE) ? *fontNoOutline : *fontWithOutline;
-    unsigned texture = usedFont.GetTexture();
-    if(!texture)
-        return;
-    const GlPoint texSize(usedFont.GetTexSize());
-    RTTR_Assert(texList.texCoords.size() == texList.vertices.size());
-    RTTR_Assert(texList.texCoords.size() % 4u == 0);
-    // Vectorizable loop
-    for(unsigned i = 0; i < texList.texCoords.size(); i += 4)
-    {
-        for(int j = 0; j < 4; j++)
-            texList.texCoords[i + j] /= texSize;
-    }
-
-    glVertexPointer(2, GL_FLOAT, 0, &texList.vertices[0]);
-    glTexCoordPointer(2, GL_FLOAT, 0, &texList.texCoords[0]);
-    VIDEODRIVER.BindTexture(texture);
-    glColor4ub(GetRed(color), GetGreen(color), GetBlue(color), GetAlpha(color));
-    glDrawArrays(GL_QUADS, 0, texList.vertices.size());
+    return layout;
 }
 
 template<bool T_limitWidth, class T_Iterator>
@@ -451,6 +495,15 @@ glArchivItem_Font::WrapInfo glArchivItem_Font::GetWrapInfo(const std::string& te
     if(!fontNoOutline)
         initFont();
 
+    if(const WrapInfo* wi = wrapInfoCache.find(std::tie(text, primary_width, secondary_width)))
+        return *wi;
+    return wrapInfoCache.insert(std::make_tuple(text, primary_width, secondary_width),
+                                CreateWrapInfo(text, primary_width, secondary_width));
+}
+
+glArchivItem_Font::WrapInfo glArchivItem_Font::CreateWrapInfo(const std::string& text, const unsigned short primary_width,
+                                                              const unsigned short secondary_width) const
+{
     RTTR_Assert(utf8::is_valid(text)); // Can only handle UTF-8 strings!
 
     // Current line width
@@ -548,6 +601,8 @@ glArchivItem_Font::WrapInfo glArchivItem_Font::GetWrapInfo(const std::string& te
 void glArchivItem_Font::initFont()
 {
     ClearCharInfoMapping();
+    layoutCache.clear();
+    wrapInfoCache.clear();
     fontWithOutline = libsiedler2::getAllocator().create<glArchivItem_Bitmap>(libsiedler2::BOBTYPE_BITMAP_RLE);
     fontNoOutline = libsiedler2::getAllocator().create<glArchivItem_Bitmap>(libsiedler2::BOBTYPE_BITMAP_RLE);
 
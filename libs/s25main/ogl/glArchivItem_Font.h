@@ -22,6 +22,7 @@
 #include "DrawPoint.h"
 #include "Rect.h"
 #include "ogl/FontStyle.h"
+#include "helpers/LRUCache.h"
 #include "ogl/glArchivItem_Bitmap.h"
 #include "libsiedler2/ArchivItem_Font.h"
 #include "libutil/colors.h"
@@ -30,6 +31,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <vector>
 
 /// Klasse für GL-Fontfiles.
@@ -74,6 +76,7 @@ public:
 
     /// Gibt Infos, über die Unterbrechungspunkte in einem Text, versucht Wörter nicht zu trennen, tut dies aber, falls
     /// es unumgänglich ist (Wort länger als die Zeile)
+    /// The result is cached as e.g. the chat and tooltips request the same wrapping each frame
     WrapInfo GetWrapInfo(const std::string& text, unsigned short primary_width, unsigned short secondary_width);
 
     struct CharInfo
@@ -103,6 +106,13 @@ private:
     /// liefert das Char-Info eines Zeichens
     const CharInfo& GetCharInfo(unsigned c) const;
     void DrawChar(unsigned curChar, VertexArrays& vertices, DrawPoint& curPos) const;
+    /// Return the quads for the Draw call relative to the draw position with texCoords normalized to the texture size
+    /// Uses the cache or creates the quads if required. Texture size must be valid (texture created)
+    const VertexArrays& GetTextLayout(const std::string& text, FontStyle format, unsigned short length, unsigned short maxWidth,
+                                      const std::string& end, const GlPoint& texSize);
+    VertexArrays CreateTextLayout(const std::string& text, FontStyle format, unsigned short length, unsigned short maxWidth,
+                                  const std::string& end) const;
+    WrapInfo CreateWrapInfo(const std::string& text, unsigned short primary_width, unsigned short secondary_width) const;
 
     std::unique_ptr<glArchivItem_Bitmap> fontNoOutline;
     std::unique_ptr<glArchivItem_Bitmap> fontWithOutline;
@@ -111,7 +121,14 @@ private:
     std::array<std::pair<bool, CharInfo>, 256> asciiMapping;
     std::map<unsigned, CharInfo> utf8_mapping;
     CharInfo placeHolder; /// Placeholder if glyph is missing
-    VertexArrays texList; /// Buffer to hold last textures. Used so memory reallocations are avoided
+
+    /// (text, format, length, maxWidth, end) of a Draw call
+    using TextLayoutKey = std::tuple<std::string, unsigned, unsigned short, unsigned short, std::string>;
+    /// (text, primary_width, secondary_width) of a GetWrapInfo call
+    using WrapInfoKey = std::tuple<std::string, unsigned short, unsigned short>;
+    /// Most texts (building names, productivity, chat, ...) are drawn unchanged each frame, so keep their quads
+    helpers::LRUCache<TextLayoutKey, VertexArrays> layoutCache;
+    helpers::LRUCache<WrapInfoKey, WrapInfo> wrapInfoCache;
 
     /// Get width of the sequence defined by the begin/end pair of iterators
     template<class T_Iterator>
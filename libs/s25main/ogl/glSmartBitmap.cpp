@@ -19,6 +19,7 @@
 #include "glSmartBitmap.h"
 #include "Loader.h"
 #include "drivers/VideoDriverWrapper.h"
+#include "ogl/SpriteBatch.h"
 #include "ogl/glBitmapItem.h"
 #include "libsiedler2/ArchivItem_Bitmap.h"
 #include "libsiedler2/ArchivItem_Bitmap_Player.h"
@@ -115,9 +116,12 @@ void glSmartBitmap::calcDimensions()
 
 void glSmartBitmap::drawTo(libsiedler2::PixelBufferARGB& buffer, const Extent& bufOffset) const
 {
-    libsiedler2::ArchivItem_Palette* p_colors = LOADER.GetPaletteN("colors");
-    libsiedler2::ArchivItem_Palette* p_5 = LOADER.GetPaletteN("pal5");
+    drawTo(buffer, bufOffset, LOADER.GetPaletteN("pal5"), LOADER.GetPaletteN("colors"));
+}
 
+void glSmartBitmap::drawTo(libsiedler2::PixelBufferARGB& buffer, const Extent& bufOffset, const libsiedler2::ArchivItem_Palette* p_5,
+                           const libsiedler2::ArchivItem_Palette* p_colors) const
+{
     for(const glBitmapItem& bmpItem : items)
     {
         if((bmpItem.size.x == 0) || (bmpItem.size.y == 0))
@@ -311,6 +315,14 @@ void glSmartBitmap::drawPercent(DrawPoint drawPt, unsigned percent, unsigned col
     } else
         numQuads = 4;
 
+    if(ogl::SpriteBatch* batch = VIDEODRIVER.GetActiveSpriteBatch())
+    {
+        batch->add(texture, vertices.data(), curTexCoords.data(), color);
+        if(numQuads == 8)
+            batch->add(texture, &vertices[4], &curTexCoords[4], player_color);
+        return;
+    }
+
     glEnableClientState(GL_COLOR_ARRAY);
     glVertexPointer(2, GL_FLOAT, 0, vertices.data());
     glTexCoordPointer(2, GL_FLOAT, 0, curTexCoords.data());
@@ -28,6 +28,7 @@
 namespace libsiedler2 {
 class baseArchivItem_Bitmap;
 class ArchivItem_Bitmap_Player;
+class ArchivItem_Palette;
 class PixelBufferARGB;
 } // namespace libsiedler2
 
@@ -78,6 +79,9 @@ public:
     void drawPercent(DrawPoint drawPt, unsigned percent, unsigned color = 0xFFFFFFFF, unsigned player_color = 0);
     /// Draw the bitmap(s) to the specified buffer at the position starting at bufOffset (must be positive)
     void drawTo(libsiedler2::PixelBufferARGB& buffer, const Extent& bufOffset = Extent(0, 0)) const;
+    /// Same as above but with the palettes given. Does not access the LOADER so it can be used from other threads
+    void drawTo(libsiedler2::PixelBufferARGB& buffer, const Extent& bufOffset, const libsiedler2::ArchivItem_Palette* p_5,
+                const libsiedler2::ArchivItem_Palette* p_colors) const;
 
     void add(libsiedler2::baseArchivItem_Bitmap* bmp, bool transferOwnership = false);
     void add(libsiedler2::ArchivItem_Bitmap_Player* bmp, bool transferOwnership = false);
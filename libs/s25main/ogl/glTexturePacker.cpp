@@ -17,13 +17,22 @@
 
 #include "rttrDefines.h" // IWYU pragma: keep
 #include "glTexturePacker.h"
+#include "Loader.h"
 #include "drivers/VideoDriverWrapper.h"
+#include "helpers/Fnv1aHash.h"
+#include "helpers/ThreadPool.h"
 #include "ogl/glSmartBitmap.h"
 #include "ogl/glTexturePackerNode.h"
 #include "ogl/saveBitmap.h"
 #include "libsiedler2/PixelBufferARGB.h"
 #include <glad/glad.h>
+#include <boost/filesystem/operations.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/nowide/fstream.hpp>
 #include <algorithm>
+#include <array>
+#include <cstring>
+#include <map>
 #include <utility>
 
 static bool isSizeGreater(glSmartBitmap* a, glSmartBitmap* b)
@@ -33,114 +42,387 @@ static bool isSizeGreater(glSmartBitmap* a, glSmartBitmap* b)
     return (sizeA.x * sizeA.y) > (sizeB.x * sizeB.y);
 }
 
-bool glTexturePacker::packHelper(std::vector<glSmartBitmap*>& list)
+static void setTexCoords(glSmartBitmap& bmp, const Extent& pos, const Extent& texSize)
 {
-    glTexture texture;
+    const Point<float> bufferSize(texSize);
+    Extent size(bmp.getRequiredTexSize());
+    const Extent playerSize = size;
+    if(bmp.isPlayer())
+        size.x /= 2;
 
-    if(!texture)
-        return false;
+    bmp.texCoords[0] = pos / bufferSize;
+    bmp.texCoords[2] = (pos + size) / bufferSize;
+    bmp.texCoords[1] = {bmp.texCoords[0].x, bmp.texCoords[2].y};
+    bmp.texCoords[3] = {bmp.texCoords[2].x, bmp.texCoords[0].y};
 
-    // find space needed in total and biggest texture to store (as a start)
-    Extent maxBmpSize(0, 0);
-    unsigned total = 0;
-    for(glSmartBitmap* bmp : list)
+    if(bmp.isPlayer())
     {
-        Extent texSize = bmp->getRequiredTexSize();
-        maxBmpSize = elMax(maxBmpSize, texSize);
-
-        total += texSize.x * texSize.y;
+        bmp.texCoords[4] = bmp.texCoords[3];
+        bmp.texCoords[6] = (pos + playerSize) / bufferSize;
+        bmp.texCoords[5] = {bmp.texCoords[4].x, bmp.texCoords[6].y};
+        bmp.texCoords[7] = {bmp.texCoords[6].x, bmp.texCoords[4].y};
     }
+}
 
-    // most cards work much better with texture sizes of powers of two.
-    maxBmpSize = VIDEODRIVER.calcPreferredTextureSize(maxBmpSize);
-
-    if(!texture.checkSize(maxBmpSize))
-        return false;
+glTexturePacker::glTexturePacker() = default;
+glTexturePacker::~glTexturePacker() = default;
 
-    // maximum texture size reached?
-    bool maxTex = false;
+bool glTexturePacker::layoutPages(std::vector<glSmartBitmap*> list, const Extent& maxTexSize)
+{
     std::vector<glTexturePackerNode*> tmpVec;
     tmpVec.reserve(list.size());
 
-    Extent curSize = maxBmpSize;
-    do
+    while(!list.empty())
     {
-        // two possibilities: enough space OR maximum texture size reached
-        if((curSize.x * curSize.y >= total) || maxTex)
+        // find space needed in total and biggest texture to store (as a start)
+        Extent maxBmpSize(0, 0);
+        unsigned total = 0;
+        for(glSmartBitmap* bmp : list)
         {
-            // texture packer
-            auto* root = new glTexturePackerNode(curSize);
+            Extent texSize = bmp->getRequiredTexSize();
+            maxBmpSize = elMax(maxBmpSize, texSize);
+
+            total += texSize.x * texSize.y;
+        }
 
-            // list to store bitmaps we could not fit in our current texture
-            std::vector<glSmartBitmap*> left;
+        // most cards work much better with texture sizes of powers of two.
+        Extent curSize = VIDEODRIVER.calcPreferredTextureSize(maxBmpSize);
 
-            libsiedler2::PixelBufferARGB buffer(curSize.x, curSize.y);
+        if(curSize.x > maxTexSize.x || curSize.y > maxTexSize.y)
+            return false;
 
-            // try storing bitmaps in the big texture
-            for(glSmartBitmap* bmp : list)
+        // maximum texture size reached?
+        bool maxTex = false;
+        do
+        {
+            // two possibilities: enough space OR maximum texture size reached
+            if((curSize.x * curSize.y >= total) || maxTex)
             {
-                if(!root->insert(bmp, buffer, tmpVec))
+                glTexturePackerNode root(curSize);
+                Page page;
+                page.size = curSize;
+                // list to store bitmaps we could not fit in our current texture
+                std::vector<glSmartBitmap*> left;
+
+                // try storing bitmaps in the big texture
+                for(glSmartBitmap* bmp : list)
                 {
-                    // inserting this bitmap failed? just remember it for next texture
-                    left.push_back(bmp);
-                } else
+                    Extent pos;
+                    if(root.insert(bmp->getRequiredTexSize(), pos, tmpVec))
+                        page.bitmaps.emplace_back(bmp, pos);
+                    else
+                        left.push_back(bmp); // inserting this bitmap failed? just remember it for next texture
+                }
+                root.destroy(list.size());
+
+                if(left.empty() || maxTex)
                 {
-                    // tell or glSmartBitmap, that it uses a shared texture (so it won't try to delete/free it)
-                    bmp->setSharedTexture(texture.get());
+                    if(page.bitmaps.empty())
+                        return false;
+                    pages.emplace_back(std::move(page));
+                    // continue with what is left (if anything)
+                    list.swap(left);
+                    break;
                 }
+                // our pre-estimated size if the big texture was not enough for the algorithm to fit all textures in
+                // try again with an increased big texture
             }
-            if((false))
-            {
-                bfs::path outFilepath =
-                  std::to_string(texture.get()) + "-" + std::to_string(curSize.x) + "x" + std::to_string(curSize.y) + ".bmp";
-                saveBitmap(buffer, outFilepath);
-            }
-            // free texture packer, as it is not needed any more
-            root->destroy(list.size());
-            delete root;
 
-            if(!texture.uploadData(buffer))
-                return false;
+            // increase width or height, try whether opengl is able to handle textures that big
+            const auto newSize = (curSize.x <= curSize.y) ? Extent(curSize.x * 2, curSize.y) : Extent(curSize.x, curSize.y * 2);
+            if(newSize.x > maxTexSize.x || newSize.y > maxTexSize.y)
+                maxTex = true;
+            else
+                curSize = newSize;
+        } while(true);
+    }
+    return true;
+}
 
-            if(left.empty()) // nothing left, just generate texture and return success
-            {
-                textures.emplace_back(std::move(texture));
-                return true;
-            } else if(maxTex) // maximum texture size reached and something still left
-            {
-                textures.emplace_back(std::move(texture));
-                // recursively generate textures for what is left
-                return packHelper(left);
-            }
+bool glTexturePacker::packPages(const Extent& maxTexSize, helpers::ThreadPool* threadPool)
+{
+    pages.clear();
+    cacheFile.reset();
+    // Keep the order of items for the cache
+    std::vector<glSmartBitmap*> sortedItems = items;
+    std::sort(sortedItems.begin(), sortedItems.end(), isSizeGreater);
 
-            // our pre-estimated size if the big texture was not enough for the algorithm to fit all textures in
-            // delete buffer and try again with an increased big texture
-            left.clear();
-        }
+    if(!layoutPages(sortedItems, maxTexSize))
+    {
+        pages.clear();
+        return false;
+    }
 
-        // increase width or height, try whether opengl is able to handle textures that big
-        const auto newSize = (curSize.x <= curSize.y) ? Extent(curSize.x * 2, curSize.y) : Extent(curSize.x, curSize.y * 2);
-        if(!texture.checkSize(newSize))
-            maxTex = true;
-        else
-            curSize = newSize;
-    } while(true);
+    // Page and index of each bitmap
+    std::vector<std::pair<Page*, unsigned>> bitmaps;
+    bitmaps.reserve(items.size());
+    for(Page& page : pages)
+    {
+        page.buffer = std::make_unique<libsiedler2::PixelBufferARGB>(page.size.x, page.size.y);
+        for(unsigned i = 0; i < page.bitmaps.size(); i++)
+            bitmaps.emplace_back(&page, i);
+    }
+
+    // The bitmaps are placed in distinct areas so they can be drawn in parallel
+    const libsiedler2::ArchivItem_Palette* p_5 = LOADER.GetPaletteN("pal5");
+    const libsiedler2::ArchivItem_Palette* p_colors = LOADER.GetPaletteN("colors");
+    const auto drawBitmap = [&bitmaps, p_5, p_colors](size_t idx) {
+        const Page& page = *bitmaps[idx].first;
+        glSmartBitmap& bmp = *page.bitmaps[bitmaps[idx].second].first;
+        const Extent& pos = page.bitmaps[bitmaps[idx].second].second;
+        bmp.drawTo(*page.buffer, pos, p_5, p_colors);
+        setTexCoords(bmp, pos, page.size);
+    };
+    if(threadPool)
+        threadPool->parallelFor(bitmaps.size(), drawBitmap);
+    else
+    {
+        for(size_t i = 0; i < bitmaps.size(); i++)
+            drawBitmap(i);
+    }
+    return true;
 }
 
-bool glTexturePacker::pack()
+bool glTexturePacker::uploadPages()
 {
-    std::sort(items.begin(), items.end(), isSizeGreater);
+    for(Page& page : pages)
+    {
+        glTexture texture;
+        if(!texture || !texture.checkSize(page.size))
+        {
+            reset();
+            return false;
+        }
+        if((false) && page.buffer)
+        {
+            bfs::path outFilepath =
+              std::to_string(texture.get()) + "-" + std::to_string(page.size.x) + "x" + std::to_string(page.size.y) + ".bmp";
+            saveBitmap(*page.buffer, outFilepath);
+        }
+        const bool uploaded =
+          page.buffer ? texture.uploadData(*page.buffer) : texture.uploadData(page.size, page.cachedPixels);
+        if(!uploaded)
+        {
+            reset();
+            return false;
+        }
+        // tell or glSmartBitmap, that it uses a shared texture (so it won't try to delete/free it)
+        for(const auto& bitmap : page.bitmaps)
+            bitmap.first->setSharedTexture(texture.get());
+        textures.emplace_back(std::move(texture));
+        // Free the memory early
+        page.buffer.reset();
+    }
+    pages.clear();
+    cacheFile.reset();
+    return true;
+}
 
-    if(packHelper(items))
-        return true;
+bool glTexturePacker::pack(helpers::ThreadPool* threadPool)
+{
+    return packPages(getMaxTextureSize(), threadPool) && uploadPages();
+}
 
+void glTexturePacker::reset()
+{
     // reset glSmartBitmap textures
     for(glSmartBitmap* bmp : items)
         bmp->setSharedTexture(0);
 
     textures.clear();
+    pages.clear();
+    cacheFile.reset();
+}
+
+Extent glTexturePacker::getMaxTextureSize()
+{
+    glTexture texture;
+    if(!texture)
+        return Extent(0, 0);
+    // Start at a size bigger than what current cards support and reduce the larger dimension till it works
+    Extent size(1u << 15, 1u << 15);
+    while(size.x > 1u && size.y > 1u && !texture.checkSize(size))
+    {
+        if(size.x >= size.y)
+            size.x /= 2;
+        else
+            size.y /= 2;
+    }
+    return size;
+}
+
+namespace {
+const std::array<char, 8> cacheMagic = {{'R', 'T', 'T', 'R', 'A', 'T', 'L', 'S'}};
+constexpr uint32_t cacheVersion = 1;
+
+template<typename T>
+void writeValue(bnw::ofstream& stream, const T& value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/// Reads values from a memory range and checks for the end
+class MemoryReader
+{
+    const char* cur_;
+    const char* end_;
+
+public:
+    MemoryReader(const char* data, size_t size) : cur_(data), end_(data + size) {}
+    template<typename T>
+    bool read(T& value)
+    {
+        if(static_cast<size_t>(end_ - cur_) < sizeof(value))
+            return false;
+        std::memcpy(&value, cur_, sizeof(value));
+        cur_ += sizeof(value);
+        return true;
+    }
+    /// Return a pointer to the next numBytes bytes or nullptr if there are not enough left
+    const char* skip(size_t numBytes)
+    {
+        if(static_cast<size_t>(end_ - cur_) < numBytes)
+            return nullptr;
+        const char* result = cur_;
+        cur_ += numBytes;
+        return result;
+    }
+};
+} // namespace
+
+uint64_t glTexturePacker::calcItemsHash() const
+{
+    helpers::Fnv1aHash hash;
+    for(const glSmartBitmap* bmp : items)
+    {
+        const Extent size = bmp->getRequiredTexSize();
+        const Position origin = bmp->GetOrigin();
+        hash.add(size.x);
+        hash.add(size.y);
+        hash.add(origin.x);
+        hash.add(origin.y);
+        hash.add(bmp->isPlayer());
+    }
+    return hash.get();
+}
+
+bool glTexturePacker::savePages(const bfs::path& filePath, uint64_t key) const
+{
+    if(pages.empty() || !pages.front().buffer)
+        return false;
+    // Position of each item on the pages
+    std::map<const glSmartBitmap*, std::pair<uint32_t, Extent>> itemPositions;
+    for(unsigned pageIdx = 0; pageIdx < pages.size(); pageIdx++)
+    {
+        for(const auto& bitmap : pages[pageIdx].bitmaps)
+            itemPositions[bitmap.first] = std::make_pair(pageIdx, bitmap.second);
+    }
+    if(itemPositions.size() != items.size())
+        return false;
+
+    boost::system::error_code ec;
+    bfs::create_directories(filePath.parent_path(), ec);
+    // Write to a temporary file first so an aborted write never leaves a broken cache
+    const bfs::path tmpFilePath = filePath.string() + ".tmp";
+    {
+        bnw::ofstream file(tmpFilePath.string(), std::ios::binary);
+        if(!file)
+            return false;
+        file.write(cacheMagic.data(), cacheMagic.size());
+        writeValue(file, cacheVersion);
+        writeValue(file, static_cast<uint32_t>(pages.size()));
+        writeValue(file, static_cast<uint32_t>(items.size()));
+        writeValue(file, uint32_t(0)); // Padding
+        writeValue(file, key);
+        writeValue(file, calcItemsHash());
+        for(const Page& page : pages)
+        {
+            writeValue(file, static_cast<uint32_t>(page.size.x));
+            writeValue(file, static_cast<uint32_t>(page.size.y));
+        }
+        for(const glSmartBitmap* bmp : items)
+        {
+            const auto& position = itemPositions[bmp];
+            writeValue(file, position.first);
+            writeValue(file, static_cast<uint32_t>(position.second.x));
+            writeValue(file, static_cast<uint32_t>(position.second.y));
+        }
+        for(const Page& page : pages)
+            file.write(reinterpret_cast<const char*>(page.buffer->getPixelPtr()), page.size.x * page.size.y * 4u);
+        if(!file)
+        {
+            file.close();
+            bfs::remove(tmpFilePath, ec);
+            return false;
+        }
+    }
+    bfs::rename(tmpFilePath, filePath, ec);
+    return !ec;
+}
+
+bool glTexturePacker::loadPages(const bfs::path& filePath, uint64_t key)
+{
+    pages.clear();
+    cacheFile.reset();
+
+    boost::system::error_code ec;
+    if(!bfs::is_regular_file(filePath, ec))
+        return false;
+    auto mappedFile = std::make_unique<boost::iostreams::mapped_file_source>();
+    try
+    {
+        mappedFile->open(filePath.string());
+    } catch(const std::exception&)
+    {
+        return false;
+    }
+    if(!mappedFile->is_open())
+        return false;
+
+    MemoryReader reader(mappedFile->data(), mappedFile->size());
+    std::array<char, 8> magic;
+    uint32_t version, numPages, numItems, padding;
+    uint64_t fileKey, itemsHash;
+    if(!reader.read(magic) || magic != cacheMagic || !reader.read(version) || version != cacheVersion || !reader.read(numPages)
+       || !reader.read(numItems) || !reader.read(padding) || !reader.read(fileKey) || !reader.read(itemsHash))
+        return false;
+    if(fileKey != key || numItems != items.size() || itemsHash != calcItemsHash() || numPages == 0)
+        return false;
+
+    std::vector<Page> newPages(numPages);
+    for(Page& page : newPages)
+    {
+        uint32_t width, height;
+        if(!reader.read(width) || !reader.read(height) || width == 0 || height == 0)
+            return false;
+        page.size = Extent(width, height);
+    }
+    for(glSmartBitmap* bmp : items)
+    {
+        uint32_t pageIdx, x, y;
+        if(!reader.read(pageIdx) || !reader.read(x) || !reader.read(y) || pageIdx >= numPages)
+            return false;
+        Page& page = newPages[pageIdx];
+        const Extent pos(x, y);
+        if(pos.x + bmp->getRequiredTexSize().x > page.size.x || pos.y + bmp->getRequiredTexSize().y > page.size.y)
+            return false;
+        page.bitmaps.emplace_back(bmp, pos);
+    }
+    for(Page& page : newPages)
+    {
+        page.cachedPixels = reader.skip(page.size.x * page.size.y * 4u);
+        if(!page.cachedPixels)
+            return false;
+    }
 
-    return false;
+    for(const Page& page : newPages)
+    {
+        for(const auto& bitmap : page.bitmaps)
+            setTexCoords(*bitmap.first, bitmap.second, page.size);
+    }
+    pages = std::move(newPages);
+    cacheFile = std::move(mappedFile);
+    return true;
 }
 
 glTexture::glTexture() : handle(VIDEODRIVER.GenerateTexture()), size(0, 0)
@@ -187,12 +469,17 @@ bool glTexture::checkSize(const Extent& size)
 }
 
 bool glTexture::uploadData(const libsiedler2::PixelBufferARGB& buffer)
+{
+    return uploadData(Extent(buffer.getWidth(), buffer.getHeight()), buffer.getPixelPtr());
+}
+
+bool glTexture::uploadData(const Extent& newSize, const void* pixels)
 {
     if(!handle)
         return false;
     VIDEODRIVER.BindTexture(handle);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, buffer.getWidth(), buffer.getHeight(), 0, GL_BGRA, GL_UNSIGNED_BYTE, buffer.getPixelPtr());
-    size = Extent(buffer.getWidth(), buffer.getHeight());
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, newSize.x, newSize.y, 0, GL_BGRA, GL_UNSIGNED_BYTE, pixels);
+    size = newSize;
     int resultWidth;
     glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &resultWidth);
     return resultWidth > 0;
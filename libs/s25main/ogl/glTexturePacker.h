@@ -19,10 +19,23 @@
 #define glTexturePacker_h__
 
 #include "Point.h"
+#include <boost/filesystem/path.hpp>
+#include <cstdint>
+#include <memory>
+#include <utility>
 #include <vector>
 
 class glSmartBitmap;
 
+namespace boost {
+namespace iostreams {
+class mapped_file_source;
+}
+} // namespace boost
+namespace helpers {
+class ThreadPool;
+}
+
 namespace libsiedler2 {
 class PixelBufferARGB;
 }
@@ -47,18 +60,59 @@ public:
     void bind();
     bool checkSize(const Extent&);
     bool uploadData(const libsiedler2::PixelBufferARGB&);
+    /// Upload size.x * size.y pixels in BGRA format
+    bool uploadData(const Extent& size, const void* pixels);
 };
 
 class glTexturePacker
 {
 private:
+    /// One texture with the bitmaps placed on it
+    struct Page
+    {
+        Extent size;
+        std::vector<std::pair<glSmartBitmap*, Extent>> bitmaps;
+        std::unique_ptr<libsiedler2::PixelBufferARGB> buffer;
+        /// Pixels of the page if loaded from a cache file (instead of buffer)
+        const void* cachedPixels = nullptr;
+    };
     std::vector<glTexture> textures;
+    /// Bitmaps in the order they were added
     std::vector<glSmartBitmap*> items;
+    std::vector<Page> pages;
+    /// Cache file the pages were loaded from. Kept open (mapped) till the upload
+    std::unique_ptr<boost::iostreams::mapped_file_source> cacheFile;
+
+    /// Return a hash of the properties of the bitmaps (sizes etc.) but not their content
+    uint64_t calcItemsHash() const;
 
-    bool packHelper(std::vector<glSmartBitmap*>& list);
+    /// Distribute the bitmaps to pages not bigger than maxTexSize
+    bool layoutPages(std::vector<glSmartBitmap*> list, const Extent& maxTexSize);
+    /// Remove all textures and the references to them
+    void reset();
 
 public:
-    bool pack();
+    glTexturePacker();
+    ~glTexturePacker();
+
+    /// Pack all bitmaps into as few textures as possible. Drawing the textures is distributed over the threadPool if given
+    bool pack(helpers::ThreadPool* threadPool = nullptr);
+    /// First step of pack(): Distribute the bitmaps to textures of at most maxTexSize and draw them to buffers.
+    /// Does not use OpenGL so the bitmaps are drawn on the threads of the threadPool (if given)
+    bool packPages(const Extent& maxTexSize, helpers::ThreadPool* threadPool = nullptr);
+    /// Second step of pack(): Upload the textures created by packPages. Must be called from the OpenGL thread.
+    /// On failure no bitmap uses a shared texture
+    bool uploadPages();
+    /// Return the maximum supported size of a texture
+    static Extent getMaxTextureSize();
+
+    /// Save the pages created by packPages to a file which can be loaded with loadPages instead of calling packPages.
+    /// The key must identify the content of the bitmaps as only their properties (e.g. size) are checked when loading
+    bool savePages(const bfs::path& filePath, uint64_t key) const;
+    /// Load pages stored by savePages. Returns false if the file does not exist or was stored for a different key or bitmaps.
+    /// Use uploadPages afterwards
+    bool loadPages(const bfs::path& filePath, uint64_t key);
+
     void add(glSmartBitmap& bmp) { items.push_back(&bmp); }
     const auto& getTextures() const { return textures; }
 };
@@ -17,17 +17,13 @@
 
 #include "rttrDefines.h" // IWYU pragma: keep
 #include "glTexturePackerNode.h"
-#include "ogl/glSmartBitmap.h"
-#include "libsiedler2/PixelBufferARGB.h"
 
-bool glTexturePackerNode::insert(glSmartBitmap* b, libsiedler2::PixelBufferARGB& buffer, std::vector<glTexturePackerNode*>& todo)
+bool glTexturePackerNode::insert(const Extent& texSize, Extent& outPos, std::vector<glTexturePackerNode*>& todo)
 {
     todo.clear();
 
     todo.push_back(this);
 
-    const Extent texSize = b->getRequiredTexSize();
-
     while(!todo.empty())
     {
         glTexturePackerNode* current = todo.back();
@@ -41,7 +37,7 @@ bool glTexturePackerNode::insert(glSmartBitmap* b, libsiedler2::PixelBufferARGB&
         }
 
         // we are a leaf and do already contain an image
-        if(current->bmp)
+        if(current->used)
             continue;
 
         // no space left for this item
@@ -50,26 +46,8 @@ bool glTexturePackerNode::insert(glSmartBitmap* b, libsiedler2::PixelBufferARGB&
 
         if(texSize == current->size)
         {
-            b->drawTo(buffer, current->pos);
-            current->bmp = b;
-
-            const Point<float> bufferSize(buffer.getWidth(), buffer.getHeight());
-            Extent currentSize(current->size);
-            if(b->isPlayer())
-                currentSize.x /= 2;
-
-            b->texCoords[0] = current->pos / bufferSize;
-            b->texCoords[2] = (current->pos + currentSize) / bufferSize;
-            b->texCoords[1] = {b->texCoords[0].x, b->texCoords[2].y};
-            b->texCoords[3] = {b->texCoords[2].x, b->texCoords[0].y};
-
-            if(b->isPlayer())
-            {
-                b->texCoords[4] = b->texCoords[3];
-                b->texCoords[6] = (current->pos + current->size) / bufferSize;
-                b->texCoords[5] = {b->texCoords[4].x, b->texCoords[6].y};
-                b->texCoords[7] = {b->texCoords[6].x, b->texCoords[4].y};
-            }
+            current->used = true;
+            outPos = current->pos;
             return true;
         }
 
@@ -21,11 +21,6 @@
 #include "Point.h"
 #include <vector>
 
-class glSmartBitmap;
-namespace libsiedler2 {
-class PixelBufferARGB;
-} // namespace libsiedler2
-
 class glTexturePackerNode
 {
     /// Position on the packed texture (can't be negative)
@@ -33,15 +28,15 @@ class glTexturePackerNode
     /// Size of all the subnodes combined (makes up area covered)
     Extent size;
 
-    glSmartBitmap* bmp;
+    bool used;
     glTexturePackerNode* child[2];
 
 public:
-    glTexturePackerNode() : pos(0, 0), size(0, 0), bmp(nullptr) { child[0] = child[1] = nullptr; }
-    glTexturePackerNode(const Extent& size) : pos(0, 0), size(size), bmp(nullptr) { child[0] = child[1] = nullptr; }
-    /// Find a position in the buffer to draw the bitmap starting at this node
+    glTexturePackerNode() : pos(0, 0), size(0, 0), used(false) { child[0] = child[1] = nullptr; }
+    glTexturePackerNode(const Extent& size) : pos(0, 0), size(size), used(false) { child[0] = child[1] = nullptr; }
+    /// Find a position for a bitmap of the given size starting at this node and return it in outPos
     /// todo list is cleared and used to avoid frequent allocations
-    bool insert(glSmartBitmap* b, libsiedler2::PixelBufferARGB& buffer, std::vector<glTexturePackerNode*>& todo);
+    bool insert(const Extent& texSize, Extent& outPos, std::vector<glTexturePackerNode*>& todo);
     void destroy(unsigned reserve = 0);
 };
 
@@ -28,12 +28,6 @@
 /// FreePathFinder implementation
 //////////////////////////////////////////////////////////////////////////
 
-/// MapNodes
-using MapNodes = std::vector<NewNode>;
-using FreePathNodes = std::vector<FreePathNode>;
-MapNodes nodes;
-FreePathNodes fpNodes;
-
 void FreePathFinder::Init(const MapExtent& mapSize)
 {
     currentVisit = 0;
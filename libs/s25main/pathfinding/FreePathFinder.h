@@ -20,6 +20,7 @@
 
 #include "gameTypes/Direction.h"
 #include "gameTypes/MapCoordinates.h"
+#include "pathfinding/NewNode.h"
 #include <vector>
 
 class GameWorldBase;
@@ -35,6 +36,9 @@ class FreePathFinder
     GameWorldBase& gwb_;
     unsigned currentVisit;
     Extent size_;
+    /// Nodes for the alternating and the template pathfinding. Per instance so multiple worlds can search concurrently
+    std::vector<NewNode> nodes;
+    std::vector<FreePathNode> fpNodes;
 
 public:
     FreePathFinder(GameWorldBase& gwb) : gwb_(gwb), currentVisit(0), size_(0, 0) {}
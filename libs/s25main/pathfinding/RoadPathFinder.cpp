@@ -20,7 +20,6 @@
 #include "EventManager.h"
 #include "buildings/nobHarborBuilding.h"
 #include "pathfinding/OpenListPrioQueue.h"
-#include "pathfinding/OpenListVector.h"
 #include "world/GameWorldBase.h"
 #include "nodeObjs/noRoadNode.h"
 #include "gameData/GameConsts.h"
@@ -43,8 +42,6 @@ struct RoadNodeComperatorGreater
 };
 
 using QueueImpl = OpenListPrioQueue<const noRoadNode*, RoadNodeComperatorGreater>;
-using VecImpl = OpenListVector<const noRoadNode*>;
-VecImpl todo;
 
 // Namespace with all functors usable as additional cost functors
 namespace AdditonalCosts {
@@ -110,6 +107,23 @@ struct And : private T_Func1, private T_Func2
 };
 } // namespace SegmentConstraints
 
+void RoadPathFinder::IncreaseCurrentVisit()
+{
+    currentVisit++;
+
+    // if the counter reaches its maximum, tidy up
+    if(currentVisit == std::numeric_limits<unsigned>::max())
+    {
+        RTTR_FOREACH_PT(MapPoint, gwb_.GetSize())
+        {
+            auto* const node = gwb_.GetSpecObj<noRoadNode>(pt);
+            if(node)
+                node->last_visit = 0;
+        }
+        currentVisit = 1;
+    }
+}
+
 /// Wegfinden ( A* ), O(v lg v) --> Wegfindung auf Stra�en
 template<class T_AdditionalCosts, class T_SegmentConstraints>
 bool RoadPathFinder::FindPathImpl(const noRoadNode& start, const noRoadNode& goal, const unsigned max, const T_AdditionalCosts addCosts,
@@ -133,19 +147,7 @@ bool RoadPathFinder::FindPathImpl(const noRoadNode& start, const noRoadNode& goa
     }
 
     // increase current_visit_on_roads, so we don't have to clear the visited-states at every run
-    currentVisit++;
-
-    // if the counter reaches its maximum, tidy up
-    if(currentVisit == std::numeric_limits<unsigned>::max())
-    {
-        RTTR_FOREACH_PT(MapPoint, gwb_.GetSize())
-        {
-            auto* const node = gwb_.GetSpecObj<noRoadNode>(pt);
-            if(node)
-                node->last_visit = 0;
-        }
-        currentVisit = 1;
-    }
+    IncreaseCurrentVisit();
 
     // Anfangsknoten einf�gen
     todo.clear();
@@ -345,3 +347,81 @@ bool RoadPathFinder::PathExists(const noRoadNode& start, const noRoadNode& goal,
             return FindPathImpl(start, goal, max, AdditonalCosts::None(), SegmentConstraints::AvoidRoadType<RoadSegment::RT_BOAT>());
     }
 }
+
+std::vector<std::pair<const noRoadNode*, unsigned>> RoadPathFinder::FindAllCosts(const noRoadNode& start, const unsigned max)
+{
+    // Same as FindPathImpl without a goal (Dijkstra): Estimate == costs
+    const SegmentConstraints::AvoidRoadType<RoadSegment::RT_BOAT> isSegmentAllowed{};
+    std::vector<std::pair<const noRoadNode*, unsigned>> result;
+
+    IncreaseCurrentVisit();
+    todo.clear();
+
+    start.targetDistance = 0;
+    start.estimate = 0;
+    start.last_visit = currentVisit;
+    start.prev = nullptr;
+    start.cost = 0;
+    start.dir_ = 0;
+
+    todo.push(&start);
+
+    const auto addNode = [this](noRoadNode& node, const noRoadNode& prev, unsigned cost, unsigned dir) {
+        if(node.last_visit == currentVisit)
+        {
+            if(cost < node.cost)
+            {
+                node.cost = node.estimate = cost;
+                node.prev = &prev;
+                node.dir_ = dir;
+                todo.rearrange(&node);
+            }
+        } else
+        {
+            node.last_visit = currentVisit;
+            node.cost = node.estimate = cost;
+            node.targetDistance = 0;
+            node.prev = &prev;
+            node.dir_ = dir;
+            todo.push(&node);
+        }
+    };
+
+    while(!todo.empty())
+    {
+        const noRoadNode& best = *todo.pop();
+        result.emplace_back(&best, best.cost);
+
+        for(unsigned iDir = 0; iDir < 6; ++iDir)
+        {
+            const Direction dir = Direction::fromInt(iDir);
+            noRoadNode* neighbour = best.GetNeighbour(dir);
+            if(!neighbour || neighbour == best.prev)
+                continue;
+            // No pathes over buildings
+            if(dir == Direction::NORTHWEST)
+            {
+                const GO_Type got = neighbour->GetGOT();
+                if(got != GOT_FLAG && got != GOT_NOB_HARBORBUILDING)
+                    continue;
+            }
+            if(!isSegmentAllowed(*best.GetRoute(dir)))
+                continue;
+            const unsigned cost = best.cost + best.GetRoute(dir)->GetLength();
+            if(cost <= max)
+                addNode(*neighbour, best, cost, iDir);
+        }
+
+        if(best.GetGOT() == GOT_NOB_HARBORBUILDING)
+        {
+            for(const auto& sc : static_cast<const nobHarborBuilding&>(best).GetShipConnections())
+            {
+                const unsigned cost = best.cost + sc.way_costs;
+                if(cost <= max)
+                    addNode(*sc.dest, best, cost, SHIP_DIR);
+            }
+        }
+    }
+
+    return result;
+}
@@ -19,7 +19,10 @@
 #define RoadPathFinder_h__
 
 #include "gameTypes/MapCoordinates.h"
+#include "pathfinding/OpenListVector.h"
 #include <limits>
+#include <utility>
+#include <vector>
 
 class GameWorldBase;
 class noRoadNode;
@@ -29,6 +32,8 @@ class RoadPathFinder
 {
     GameWorldBase& gwb_;
     unsigned currentVisit;
+    /// Open list of the searches. Kept to reuse its memory
+    OpenListVector<const noRoadNode*> todo;
 
 public:
     RoadPathFinder(GameWorldBase& gwb) : gwb_(gwb), currentVisit(0) {}
@@ -56,7 +61,13 @@ public:
     bool PathExists(const noRoadNode& start, const noRoadNode& goal, bool allowWaterRoads,
                     unsigned max = std::numeric_limits<unsigned>::max(), const RoadSegment* forbidden = nullptr);
 
+    /// Calculates the costs of the shortest paths (as in FindPath without wareMode) from start to all nodes reachable within max costs
+    /// in a single search. Returns the nodes (including start) with their costs in increasing order of costs
+    std::vector<std::pair<const noRoadNode*, unsigned>> FindAllCosts(const noRoadNode& start,
+                                                                     unsigned max = std::numeric_limits<unsigned>::max());
+
 private:
+    void IncreaseCurrentVisit();
     template<class T_AdditionalCosts, class T_SegmentConstraints>
     bool FindPathImpl(const noRoadNode& start, const noRoadNode& goal, unsigned max, T_AdditionalCosts addCosts,
                       T_SegmentConstraints isSegmentAllowed, unsigned* length = nullptr, unsigned char* firstDir = nullptr,
@@ -22,7 +22,6 @@
 
 #include "RTTR_Assert.h"
 #include "random/XorShift.h"
-#include "libutil/Singleton.h"
 #include <array>
 #include <cstddef>
 #include <iosfwd>
@@ -39,8 +38,9 @@ class Serializer;
 /// T_PRNG must be a model of the Pseudo-Random Number Generator according to boost:
 ///        http://www.boost.org/doc/libs/1_61_0/doc/html/boost_random/reference.html#boost_random.reference.concepts.pseudo_random_number_generator
 /// Additionally it must implement Serialize and Deserialize functions and provide a static GetName function
+/// There is one instance per thread so independent games can run concurrently on different threads
 template<class T_PRNG>
-class Random : public Singleton<Random<T_PRNG>>
+class Random
 {
 public:
     /// The used random number generator type
@@ -70,6 +70,10 @@ public:
     };
 
     Random();
+    Random(const Random&) = delete;
+    Random& operator=(const Random&) = delete;
+    /// Return the instance of the calling thread
+    static Random& inst();
     /// Initialize the rng with a given seed
     void Init(const uint64_t& seed);
     /// Reset the Random class to start from a given state
@@ -271,6 +271,11 @@ void GameWorldBase::AltitudeChanged(const MapPoint pt)
     GetNotifications().publish(NodeNote(NodeNote::Altitude, pt));
 }
 
+void GameWorldBase::ObjectChanged(const MapPoint pt)
+{
+    GetNotifications().publish(NodeNote(NodeNote::Object, pt));
+}
+
 void GameWorldBase::RecalcBQAroundPoint(const MapPoint pt)
 {
     RecalcBQ(pt);
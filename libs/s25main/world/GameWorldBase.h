@@ -194,6 +194,8 @@ protected:
     void VisibilityChanged(MapPoint pt, unsigned player, Visibility oldVis, Visibility newVis) override;
     /// Called, when the altitude of a point was changed
     void AltitudeChanged(MapPoint pt) override;
+    /// Called when the object of a point was changed
+    void ObjectChanged(MapPoint pt) override;
 
 private:
     /// Returns the harbor ID of the next matching harbor in the given direction (0 = None)
@@ -21,7 +21,6 @@
 #include "GameInterface.h"
 #include "GamePlayer.h"
 #include "GlobalGameSettings.h"
-#include "TradePathCache.h"
 #include "addons/const_addons.h"
 #include "buildings/noBuildingSite.h"
 #include "buildings/nobMilitary.h"
@@ -33,6 +32,7 @@
 #include "lua/LuaInterfaceGame.h"
 #include "notifications/BuildingNote.h"
 #include "notifications/ExpeditionNote.h"
+#include "notifications/NodeNote.h"
 #include "notifications/RoadNote.h"
 #include "pathfinding/PathConditionHuman.h"
 #include "pathfinding/PathConditionRoad.h"
@@ -65,7 +65,6 @@ inline std::vector<GamePlayer> CreatePlayers(const std::vector<PlayerInfo>& play
 GameWorldGame::GameWorldGame(const std::vector<PlayerInfo>& players, const GlobalGameSettings& gameSettings, EventManager& em)
     : GameWorldBase(CreatePlayers(players, *this), gameSettings, em)
 {
-    TradePathCache::inst().Clear();
     GameObject::AttachWorld(this);
 }
 
@@ -136,6 +135,7 @@ void GameWorldGame::SetPointRoad(MapPoint pt, Direction dir, unsigned char type)
         pt = GetNeighbour(pt, dir);
 
     SetRoad(pt, dir.toUInt(), type);
+    GetNotifications().publish(NodeNote(NodeNote::Road, pt));
 
     if(gi)
         gi->GI_UpdateMinimap(pt);
@@ -414,6 +414,7 @@ void GameWorldGame::RecalcTerritory(const noBaseBuilding& building, TerritoryCha
             continue;
 
         SetOwner(curMapPt, newOwner);
+        GetNotifications().publish(NodeNote(NodeNote::Owner, curMapPt));
         ptsWithChangedOwners.push_back(curMapPt);
         if(newOwner != 0)
             sizeChanges[newOwner - 1]++;
@@ -1417,5 +1418,5 @@ void GameWorldGame::CreateTradeGraphs()
     if(!GetGGS().isEnabled(AddonId::TRADE))
         return;
 
-    TradePathCache::inst().Clear();
+    tradePathCache.Clear();
 }
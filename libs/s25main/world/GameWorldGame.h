@@ -18,6 +18,7 @@
 #ifndef GameWorldGame_h__
 #define GameWorldGame_h__
 
+#include "TradePathCache.h"
 #include "world/GameWorldBase.h"
 #include "gameTypes/MapCoordinates.h"
 #include <vector>
@@ -43,6 +44,8 @@ enum class TerritoryChangeReason
 /// "Interface-Klasse" für das Spiel
 class GameWorldGame : public GameWorldBase
 {
+    TradePathCache tradePathCache;
+
     /// Destroys player belongings if that pint does not belong to the player anymore
     void DestroyPlayerRests(MapPoint pt, unsigned char newOwner, const noBaseBuilding* exception);
 
@@ -77,6 +80,7 @@ public:
 
     /// Stellt anderen Spielern/Spielobjekten das Game-GUI-Interface zur Verfüung
     inline GameInterface* GetGameInterface() const { return gi; }
+    TradePathCache& GetTradePathCache() { return tradePathCache; }
 
     /// Kann dieser Punkt von auf Straßen laufenden Menschen betreten werden? (Kämpfe!)
     bool IsRoadNodeForFigures(MapPoint pt);
@@ -30,6 +30,8 @@
 #include "drivers/VideoDriverWrapper.h"
 #include "helpers/containerUtils.h"
 #include "helpers/toString.h"
+#include "ogl/IRenderer.h"
+#include "ogl/SpriteBatch.h"
 #include "ogl/FontStyle.h"
 #include "ogl/glArchivItem_Bitmap.h"
 #include "ogl/glArchivItem_Font.h"
@@ -148,6 +150,11 @@ void GameWorldView::Draw(const RoadBuildState& rb, const MapPoint selected, bool
     terrainRenderer.Draw(GetFirstPt(), GetLastPt(), gwv, water);
     glTranslatef(static_cast<GLfloat>(offset.x), static_cast<GLfloat>(offset.y), 0.0f);
 
+    // Collect all objects, figures and overlays and draw them with few draw calls
+    ogl::SpriteBatch* spriteBatch = VIDEODRIVER.GetRenderer() ? &VIDEODRIVER.GetRenderer()->GetSpriteBatch() : nullptr;
+    if(spriteBatch)
+        spriteBatch->begin();
+
     for(int y = firstPt.y; y <= lastPt.y; ++y)
     {
         // Figuren speichern, die in dieser Zeile gemalt werden müssen
@@ -210,6 +217,9 @@ void GameWorldView::Draw(const RoadBuildState& rb, const MapPoint selected, bool
             catapult_stone->Draw(offset);
     }
 
+    if(spriteBatch)
+        spriteBatch->end();
+
     if(zoomFactor_ != 1.f) //-V550
     {
         glMatrixMode(GL_PROJECTION);
@@ -382,7 +392,7 @@ void GameWorldView::DrawProductivity(const noBaseBuilding& no, const DrawPoint&
         unsigned color = COLOR_GREY;
 
         unsigned short p = static_cast<const noBuildingSite&>(no).GetBuildProgress();
-        SmallFont->Draw(curPos, (boost::format("(%1% %%)") % p).str(), FontStyle::CENTER | FontStyle::VCENTER, color);
+        SmallFont->Draw(curPos, "(" + helpers::toString(p) + " %)", FontStyle::CENTER | FontStyle::VCENTER, color);
     } else if(got == GOT_NOB_USUAL || got == GOT_NOB_SHIPYARD)
     {
         const auto& n = static_cast<const nobUsual&>(no);
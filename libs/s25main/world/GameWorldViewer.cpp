@@ -56,10 +56,12 @@ void GameWorldViewer::InitVisualData()
 void GameWorldViewer::InitTerrainRenderer()
 {
     tr.GenerateOpenGL(*this);
-    // Notify renderer about altitude changes
+    // Notify renderer about altitude and road changes
     evAltitudeChanged = gwb.GetNotifications().subscribe<NodeNote>([this](const NodeNote& note) {
         if(note.type == NodeNote::Altitude)
             tr.AltitudeChanged(note.pos, *this);
+        else if(note.type == NodeNote::Road)
+            tr.RoadChanged(note.pos);
     });
     // And visibility changes
     evVisibilityChanged = gwb.GetNotifications().subscribe<PlayerNodeNote>([this](const PlayerNodeNote& note) {
@@ -180,6 +182,7 @@ void GameWorldViewer::SetVisiblePointRoad(const MapPoint& pt, Direction dir, uns
     } else
         nodePt = GetNeighbour(pt, dir);
     visualNodes[GetWorld().GetIdx(nodePt)].roads[dir.toUInt()] = type;
+    tr.RoadChanged(nodePt);
 }
 
 bool GameWorldViewer::IsOnRoad(const MapPoint& pt) const
@@ -159,6 +159,7 @@ void World::SetNO(const MapPoint pt, noBase* obj, const bool replace /* = false*
     RTTR_Assert(!dynamic_cast<noMovable*>(obj)); // It should be a static, non-movable object
 #endif
     GetNodeInt(pt).obj = obj;
+    ObjectChanged(pt);
 }
 
 void World::DestroyNO(const MapPoint pt, const bool checkExists /* = true*/)
@@ -171,6 +172,7 @@ void World::DestroyNO(const MapPoint pt, const bool checkExists /* = true*/)
         GetNodeInt(pt).obj = nullptr;
         obj->Destroy();
         deletePtr(obj);
+        ObjectChanged(pt);
     } else
         RTTR_Assert(!checkExists);
 }
@@ -197,6 +197,8 @@ protected:
     virtual void AltitudeChanged(MapPoint pt) = 0;
     /// Notify derived classes of changed visibility
     virtual void VisibilityChanged(MapPoint pt, unsigned player, Visibility oldVis, Visibility newVis) = 0;
+    /// Notify derived classes of a set, replaced or destroyed object
+    virtual void ObjectChanged(MapPoint pt) = 0;
     /// Sets the road for the given (road) direction
     void SetRoad(MapPoint pt, unsigned char roadDir, unsigned char type);
     BoundaryStones& GetBoundaryStones(const MapPoint pt) { return GetNodeInt(pt).boundary_stones; }
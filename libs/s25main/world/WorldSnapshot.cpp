@@ -0,0 +1,192 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "WorldSnapshot.h"
+#include "world/GameWorldBase.h"
+#include "nodeObjs/noBase.h"
+#include "notifications/NodeNote.h"
+#include "notifications/PlayerNodeNote.h"
+#include <algorithm>
+
+constexpr unsigned WorldSnapshot::TILE_SIZE;
+constexpr unsigned WorldSnapshot::TILE_NODES;
+
+bool WorldSnapshot::Tile::operator==(const Tile& rhs) const
+{
+    return owner == rhs.owner && bq == rhs.bq && got == rhs.got && roads == rhs.roads && visibility == rhs.visibility;
+}
+
+WorldSnapshot::WorldSnapshot(unsigned version, unsigned gf, MapExtent size, unsigned numPlayers)
+    : version_(version), gf_(gf), size_(size), numPlayers_(numPlayers)
+{}
+
+unsigned char WorldSnapshot::GetRoad(MapPoint pt, unsigned dir) const
+{
+    RTTR_Assert(dir < 3);
+    return GetTile(pt).roads[GetTileIdx(pt)][dir];
+}
+
+Visibility WorldSnapshot::GetVisibility(MapPoint pt, unsigned player) const
+{
+    RTTR_Assert(player < numPlayers_);
+    return Visibility(GetTile(pt).visibility[player * TILE_NODES + GetTileIdx(pt)]);
+}
+
+bool WorldSnapshot::IsSameTile(const WorldSnapshot& other, MapPoint pt) const
+{
+    if(size_ != other.size_)
+        return false;
+    return &GetTile(pt) == &other.GetTile(pt);
+}
+
+WorldSnapshotPublisher::WorldSnapshotPublisher() : enabled_(false), lastVersion_(0), trackedWorld_(nullptr) {}
+
+void WorldSnapshotPublisher::SetEnabled(bool enabled)
+{
+    enabled_ = enabled;
+    if(!enabled)
+    {
+        StopTracking();
+        lastSnapshot_.reset();
+        std::atomic_store(&publishedSnapshot_, std::shared_ptr<const WorldSnapshot>());
+        scratchTile_.reset();
+    }
+}
+
+void WorldSnapshotPublisher::Publish(const GameWorldBase& world, unsigned gf)
+{
+    if(!enabled_)
+        return;
+    const MapExtent size = world.GetSize();
+    const unsigned numPlayers = world.GetNumPlayers();
+    std::shared_ptr<WorldSnapshot> snapshot(new WorldSnapshot(++lastVersion_, gf, size, numPlayers));
+    // Tiles can only be shared with a snapshot of the same world and layout
+    const WorldSnapshot* lastSnapshot = lastSnapshot_.get();
+    if(lastSnapshot && (&world != trackedWorld_ || lastSnapshot->size_ != size || lastSnapshot->numPlayers_ != numPlayers))
+        lastSnapshot = nullptr;
+
+    const unsigned numTilesX = snapshot->GetNumTilesX();
+    const unsigned numTilesY = (size.y + WorldSnapshot::TILE_SIZE - 1) / WorldSnapshot::TILE_SIZE;
+    if(lastSnapshot)
+    {
+        // Only changed tiles need to be copied. They are still shared if they were changed back
+        snapshot->tiles_ = lastSnapshot->tiles_;
+        for(unsigned tileIdx : dirtyTiles_)
+        {
+            if(!scratchTile_)
+                scratchTile_ = std::make_shared<WorldSnapshot::Tile>();
+            FillTile(*scratchTile_, world, tileIdx % numTilesX, tileIdx / numTilesX);
+            if(!(*snapshot->tiles_[tileIdx] == *scratchTile_))
+                snapshot->tiles_[tileIdx] = std::move(scratchTile_);
+            isTileDirty_[tileIdx] = false;
+        }
+        dirtyTiles_.clear();
+    } else
+    {
+        StartTracking(world);
+        snapshot->tiles_.reserve(numTilesX * numTilesY);
+        for(unsigned tileY = 0; tileY < numTilesY; tileY++)
+        {
+            for(unsigned tileX = 0; tileX < numTilesX; tileX++)
+            {
+                auto tile = std::make_shared<WorldSnapshot::Tile>();
+                FillTile(*tile, world, tileX, tileY);
+                snapshot->tiles_.push_back(std::move(tile));
+            }
+        }
+    }
+    lastSnapshot_ = snapshot;
+    std::atomic_store(&publishedSnapshot_, lastSnapshot_);
+}
+
+std::shared_ptr<const WorldSnapshot> WorldSnapshotPublisher::GetSnapshot() const
+{
+    return std::atomic_load(&publishedSnapshot_);
+}
+
+void WorldSnapshotPublisher::StartTracking(const GameWorldBase& world)
+{
+    StopTracking();
+    trackedWorld_ = &world;
+    const MapExtent size = world.GetSize();
+    isTileDirty_.assign(((size.x + WorldSnapshot::TILE_SIZE - 1) / WorldSnapshot::TILE_SIZE)
+                          * ((size.y + WorldSnapshot::TILE_SIZE - 1) / WorldSnapshot::TILE_SIZE),
+                        false);
+    // Owner, BQ, roads and objects are announced by node notes, visibility by player node notes. Altitude is not stored
+    NotificationManager& notifications = world.GetNotifications();
+    evNode_ = notifications.subscribe<NodeNote>([this](const NodeNote& note) {
+        if(note.type != NodeNote::Altitude)
+            MarkTileDirty(note.pos);
+    });
+    evPlayerNode_ = notifications.subscribe<PlayerNodeNote>([this](const PlayerNodeNote& note) { MarkTileDirty(note.pt); });
+}
+
+void WorldSnapshotPublisher::StopTracking()
+{
+    evNode_.reset();
+    evPlayerNode_.reset();
+    trackedWorld_ = nullptr;
+    isTileDirty_.clear();
+    dirtyTiles_.clear();
+}
+
+void WorldSnapshotPublisher::MarkTileDirty(const MapPoint pt)
+{
+    const unsigned numTilesX = (trackedWorld_->GetSize().x + WorldSnapshot::TILE_SIZE - 1) / WorldSnapshot::TILE_SIZE;
+    const unsigned tileIdx = (pt.y / WorldSnapshot::TILE_SIZE) * numTilesX + pt.x / WorldSnapshot::TILE_SIZE;
+    if(!isTileDirty_[tileIdx])
+    {
+        isTileDirty_[tileIdx] = true;
+        dirtyTiles_.push_back(tileIdx);
+    }
+}
+
+void WorldSnapshotPublisher::FillTile(WorldSnapshot::Tile& tile, const GameWorldBase& world, unsigned tileX, unsigned tileY) const
+{
+    const unsigned numPlayers = world.GetNumPlayers();
+    const MapExtent size = world.GetSize();
+    tile.visibility.resize(numPlayers * WorldSnapshot::TILE_NODES);
+    const unsigned startX = tileX * WorldSnapshot::TILE_SIZE;
+    const unsigned startY = tileY * WorldSnapshot::TILE_SIZE;
+    // Border tiles are only partially filled -> clear so the unused part compares equal
+    if(startX + WorldSnapshot::TILE_SIZE > size.x || startY + WorldSnapshot::TILE_SIZE > size.y)
+    {
+        tile.owner.fill(0);
+        tile.bq.fill(0);
+        tile.got.fill(0);
+        tile.roads.fill(std::array<uint8_t, 3>());
+        std::fill(tile.visibility.begin(), tile.visibility.end(), 0);
+    }
+    const unsigned endX = std::min<unsigned>(startX + WorldSnapshot::TILE_SIZE, size.x);
+    const unsigned endY = std::min<unsigned>(startY + WorldSnapshot::TILE_SIZE, size.y);
+    for(unsigned y = startY; y < endY; y++)
+    {
+        for(unsigned x = startX; x < endX; x++)
+        {
+            const MapPoint pt(x, y);
+            const MapNode& node = world.GetNode(pt);
+            const unsigned idx = WorldSnapshot::GetTileIdx(pt);
+            tile.owner[idx] = node.owner;
+            tile.bq[idx] = node.bq;
+            tile.got[idx] = world.GetNO(pt)->GetGOT();
+            tile.roads[idx] = node.roads;
+            for(unsigned player = 0; player < numPlayers; player++)
+                tile.visibility[player * WorldSnapshot::TILE_NODES + idx] = node.fow[player].visibility;
+        }
+    }
+}
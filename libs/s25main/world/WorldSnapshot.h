@@ -0,0 +1,130 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef WorldSnapshot_h__
+#define WorldSnapshot_h__
+
+#include "gameTypes/BuildingQuality.h"
+#include "gameTypes/GO_Type.h"
+#include "gameTypes/MapCoordinates.h"
+#include "gameTypes/MapTypes.h"
+#include "notifications/Subscribtion.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class GameWorldBase;
+
+/// Read-only copy of the frequently queried planes of the world (owners, BQ, roads, object types, visibility) at a given GF.
+/// A snapshot never changes after creation so it can be read from any thread while the game continues.
+/// The data is stored in tiles of TILE_SIZE x TILE_SIZE nodes which are shared between snapshots if nothing changed in them
+class WorldSnapshot
+{
+    friend class WorldSnapshotPublisher;
+
+public:
+    static constexpr unsigned TILE_SIZE = 16;
+
+    /// Increases with each published snapshot
+    unsigned GetVersion() const { return version_; }
+    /// GF at which the snapshot was taken
+    unsigned GetGF() const { return gf_; }
+    MapExtent GetSize() const { return size_; }
+    unsigned GetNumPlayers() const { return numPlayers_; }
+
+    /// Owner of the point (playerIdx + 1, 0 = nobody)
+    unsigned char GetOwner(MapPoint pt) const { return GetTile(pt).owner[GetTileIdx(pt)]; }
+    /// BQ of the node without any player specific restrictions (as in MapNode::bq)
+    BuildingQuality GetBQ(MapPoint pt) const { return BuildingQuality(GetTile(pt).bq[GetTileIdx(pt)]); }
+    /// Road from the point in the given direction (0 = E, 1 = SE, 2 = SW as in MapNode::roads)
+    unsigned char GetRoad(MapPoint pt, unsigned dir) const;
+    /// Type of the object on the point (GOT_NOTHING if there is none)
+    GO_Type GetGOT(MapPoint pt) const { return GO_Type(GetTile(pt).got[GetTileIdx(pt)]); }
+    /// Visibility of the point for the player
+    Visibility GetVisibility(MapPoint pt, unsigned player) const;
+    /// True if nothing in the tile containing the point changed between the two snapshots.
+    /// Allows consumers to update only changed regions
+    bool IsSameTile(const WorldSnapshot& other, MapPoint pt) const;
+
+private:
+    static constexpr unsigned TILE_NODES = TILE_SIZE * TILE_SIZE;
+    struct Tile
+    {
+        std::array<uint8_t, TILE_NODES> owner, bq, got;
+        std::array<std::array<uint8_t, 3>, TILE_NODES> roads;
+        /// Visibility for each player: TILE_NODES entries per player
+        std::vector<uint8_t> visibility;
+
+        bool operator==(const Tile& rhs) const;
+    };
+
+    WorldSnapshot(unsigned version, unsigned gf, MapExtent size, unsigned numPlayers);
+
+    unsigned GetNumTilesX() const { return (size_.x + TILE_SIZE - 1) / TILE_SIZE; }
+    const Tile& GetTile(MapPoint pt) const { return *tiles_[(pt.y / TILE_SIZE) * GetNumTilesX() + pt.x / TILE_SIZE]; }
+    static unsigned GetTileIdx(MapPoint pt) { return (pt.y % TILE_SIZE) * TILE_SIZE + pt.x % TILE_SIZE; }
+
+    unsigned version_, gf_;
+    MapExtent size_;
+    unsigned numPlayers_;
+    std::vector<std::shared_ptr<const Tile>> tiles_;
+};
+
+/// Creates the snapshots of a world on the game thread and hands them out to any thread.
+/// Publishing is opt-in, so games without consumers do not pay for it.
+/// Changed tiles are tracked via the node notifications of the world, so only those are copied
+class WorldSnapshotPublisher
+{
+public:
+    WorldSnapshotPublisher();
+
+    /// Enable or disable publishing. Disabling also drops the current snapshot
+    void SetEnabled(bool enabled);
+    bool IsEnabled() const { return enabled_; }
+    /// Take a new snapshot of the world (if enabled). Must be called on the game thread between GFs (e.g. at an NWF).
+    /// Tiles which did not change since the last snapshot are shared with it
+    void Publish(const GameWorldBase& world, unsigned gf);
+    /// Return the latest snapshot or nullptr if there is none. Can be called from any thread.
+    /// The snapshot stays valid as long as it is referenced, even when newer ones get published
+    std::shared_ptr<const WorldSnapshot> GetSnapshot() const;
+
+private:
+    void FillTile(WorldSnapshot::Tile& tile, const GameWorldBase& world, unsigned tileX, unsigned tileY) const;
+    /// Track the changes of the world from now on
+    void StartTracking(const GameWorldBase& world);
+    void StopTracking();
+    void MarkTileDirty(MapPoint pt);
+
+    bool enabled_;
+    unsigned lastVersion_;
+    /// World whose changes are tracked. Tiles are only shared with snapshots of this world
+    const GameWorldBase* trackedWorld_;
+    Subscribtion evNode_, evPlayerNode_;
+    /// Flag for each tile if it changed since the last snapshot
+    std::vector<bool> isTileDirty_;
+    /// Indices of the changed tiles
+    std::vector<unsigned> dirtyTiles_;
+    /// Latest snapshot, only used by the game thread
+    std::shared_ptr<const WorldSnapshot> lastSnapshot_;
+    /// Latest snapshot for the readers. Only accessed through the atomic shared_ptr functions
+    std::shared_ptr<const WorldSnapshot> publishedSnapshot_;
+    /// Tile to fill before comparing it to the last one. Kept if unchanged to avoid allocations
+    std::shared_ptr<WorldSnapshot::Tile> scratchTile_;
+};
+
+#endif // WorldSnapshot_h__
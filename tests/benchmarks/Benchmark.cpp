@@ -0,0 +1,172 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "Benchmark.h"
+#include <boost/format.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <ostream>
+
+namespace {
+std::atomic<uint64_t> numAllocs(0), numAllocatedBytes(0);
+
+void* countedAlloc(std::size_t size)
+{
+    numAllocs.fetch_add(1, std::memory_order_relaxed);
+    numAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    // malloc(0) may return nullptr
+    return std::malloc(size ? size : 1);
+}
+
+std::vector<rttr::bench::Result>& results()
+{
+    static std::vector<rttr::bench::Result> results;
+    return results;
+}
+
+rttr::bench::BenchClock::duration minTime = std::chrono::milliseconds(500);
+} // namespace
+
+// Count all allocations of the benchmark executable
+void* operator new(std::size_t size)
+{
+    void* result = countedAlloc(size);
+    if(!result)
+        throw std::bad_alloc();
+    return result;
+}
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAlloc(size);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAlloc(size);
+}
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+namespace rttr { namespace bench {
+    State::State(std::string name)
+        : name_(std::move(name)), numIterations_(0), isStarted_(false), isRunning_(false), elapsed_(BenchClock::duration::zero()),
+          startAllocs_(0), startBytes_(0), numAllocs_(0), numBytes_(0)
+    {}
+
+    State::~State()
+    {
+        if(isRunning_)
+            pauseTiming();
+        if(!numIterations_)
+            return;
+        const auto perOp = [this](double value) { return value / numIterations_; };
+        results().push_back(Result{name_, numIterations_, perOp(std::chrono::duration<double, std::nano>(elapsed_).count()),
+                                   perOp(static_cast<double>(numAllocs_)), perOp(static_cast<double>(numBytes_))});
+    }
+
+    bool State::keepRunning()
+    {
+        if(!isStarted_)
+        {
+            isStarted_ = true;
+            resumeTiming();
+            return true;
+        }
+        ++numIterations_;
+        BenchClock::duration curElapsed = elapsed_;
+        if(isRunning_)
+            curElapsed += BenchClock::now() - startTime_;
+        if(curElapsed < minTime)
+            return true;
+        if(isRunning_)
+            pauseTiming();
+        return false;
+    }
+
+    void State::pauseTiming()
+    {
+        elapsed_ += BenchClock::now() - startTime_;
+        numAllocs_ += numAllocs.load(std::memory_order_relaxed) - startAllocs_;
+        numBytes_ += numAllocatedBytes.load(std::memory_order_relaxed) - startBytes_;
+        isRunning_ = false;
+    }
+
+    void State::resumeTiming()
+    {
+        isRunning_ = true;
+        startAllocs_ = numAllocs.load(std::memory_order_relaxed);
+        startBytes_ = numAllocatedBytes.load(std::memory_order_relaxed);
+        startTime_ = BenchClock::now();
+    }
+
+    void setMinTime(BenchClock::duration newMinTime) { minTime = newMinTime; }
+
+    const std::vector<Result>& getResults() { return results(); }
+
+    void writeReport(std::ostream& os)
+    {
+        os << boost::format("%-45s %12s %15s %12s %14s\n") % "Benchmark" % "Iterations" % "ns/op" % "allocs/op" % "bytes/op";
+        for(const Result& result : results())
+        {
+            os << boost::format("%-45s %12u %15.1f %12.1f %14.1f\n") % result.name % result.iterations % result.nsPerOp % result.allocsPerOp
+                    % result.bytesPerOp;
+        }
+    }
+
+    void writeJSON(std::ostream& os)
+    {
+        os << "{\n  \"benchmarks\": [";
+        bool isFirst = true;
+        for(const Result& result : results())
+        {
+            if(!isFirst)
+                os << ",";
+            isFirst = false;
+            os << boost::format("\n    {\"name\": \"%1%\", \"iterations\": %2%, \"real_time\": %3$.1f, \"time_unit\": \"ns\", "
+                                "\"allocs_per_iter\": %4$.2f, \"bytes_per_iter\": %5$.1f}")
+                    % result.name % result.iterations % result.nsPerOp % result.allocsPerOp % result.bytesPerOp;
+        }
+        os << "\n  ]\n}\n";
+    }
+}} // namespace rttr::bench
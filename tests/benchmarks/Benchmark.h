@@ -0,0 +1,77 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef Benchmark_h__
+#define Benchmark_h__
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace rttr { namespace bench {
+    using BenchClock = std::chrono::steady_clock;
+
+    /// Result of one benchmark. All values are per iteration
+    struct Result
+    {
+        std::string name;
+        uint64_t iterations;
+        double nsPerOp;
+        double allocsPerOp;
+        double bytesPerOp;
+    };
+
+    /// Runs the loop of one benchmark and records the result on destruction:
+    ///     State state("Name");
+    ///     while(state.keepRunning()) { ... }
+    /// The loop runs at least for the minimum time (see setMinTime)
+    class State
+    {
+    public:
+        explicit State(std::string name);
+        ~State();
+        State(const State&) = delete;
+        State& operator=(const State&) = delete;
+
+        /// Return true if another iteration should be done. Timing starts with the first call
+        bool keepRunning();
+        /// Exclude the following code (e.g. setup per iteration) from time and allocation measurement till resumeTiming is called
+        void pauseTiming();
+        void resumeTiming();
+        uint64_t getNumIterations() const { return numIterations_; }
+
+    private:
+        std::string name_;
+        uint64_t numIterations_;
+        bool isStarted_, isRunning_;
+        BenchClock::time_point startTime_;
+        BenchClock::duration elapsed_;
+        uint64_t startAllocs_, startBytes_, numAllocs_, numBytes_;
+    };
+
+    /// Set the minimum time each benchmark loop runs
+    void setMinTime(BenchClock::duration minTime);
+    const std::vector<Result>& getResults();
+    /// Write all results as a human readable table
+    void writeReport(std::ostream& os);
+    /// Write all results as JSON (format similar to Google Benchmark) for comparing runs
+    void writeJSON(std::ostream& os);
+}} // namespace rttr::bench
+
+#endif // Benchmark_h__
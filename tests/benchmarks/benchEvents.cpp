@@ -0,0 +1,108 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "Benchmark.h"
+#include "GameObject.h"
+#include "GamePlayer.h"
+#include "buildings/nobBaseWarehouse.h"
+#include "factories/BuildingFactory.h"
+#include "pathfinding/FindPathForRoad.h"
+#include "worldFixtures/CreateEmptyWorld.h"
+#include "worldFixtures/WorldFixture.h"
+#include "gameTypes/BuildingQuality.h"
+#include "gameTypes/Inventory.h"
+#include <boost/test/unit_test.hpp>
+#include <memory>
+
+namespace {
+class CountingEventHandler : public GameObject
+{
+public:
+    unsigned numEvents = 0;
+
+    void HandleEvent(unsigned /*id*/) override { ++numEvents; }
+    void Destroy() override {}
+    void Serialize(SerializedGameData&) const override {}
+    GO_Type GetGOT() const override { return GOT_UNKNOWN; }
+};
+
+/// One player owning the whole map with many soldiers in the HQ and military buildings around it connected by roads
+/// -> Lots of walking soldiers and carriers once the simulation runs
+struct SoldierWorld : WorldFixture<CreateEmptyWorld, 1, 64, 64>
+{
+    SoldierWorld()
+    {
+        RTTR_FOREACH_PT(MapPoint, world.GetSize())
+            world.SetOwner(pt, 1);
+        GamePlayer& player = world.GetPlayer(0);
+        const MapPoint hqPos = player.GetHQPos();
+        const MapPoint hqFlagPos = world.GetNeighbour(hqPos, Direction::SOUTHEAST);
+        Inventory goods;
+        goods.Add(JOB_PRIVATE, 200);
+        goods.Add(JOB_HELPER, 100);
+        world.GetSpecObj<nobBaseWarehouse>(hqPos)->AddGoods(goods, true);
+
+        for(const MapPoint& pt : world.GetPointsInRadius(hqPos, 12))
+        {
+            if(world.CalcDistance(pt, hqPos) < 6 || (pt.x + pt.y) % 5 != 0 || !canUseBq(world.GetBQ(pt, 0), BQ_HUT))
+                continue;
+            BuildingFactory::CreateBuilding(world, BLD_GUARDHOUSE, pt, 0, NAT_ROMANS);
+            const MapPoint flagPos = world.GetNeighbour(pt, Direction::SOUTHEAST);
+            const std::vector<Direction> road = FindPathForRoad(world, flagPos, hqFlagPos, false);
+            if(!road.empty())
+                world.BuildRoad(0, false, flagPos, road);
+        }
+        player.RegulateAllTroops();
+    }
+};
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Events)
+
+BOOST_AUTO_TEST_CASE(AddAndExecuteEvents)
+{
+    EventManager em(0);
+    CountingEventHandler handler;
+    rttr::bench::State state("EventManager/1000Events");
+    while(state.keepRunning())
+    {
+        for(unsigned i = 0; i < 1000u; i++)
+            em.AddEvent(&handler, 1 + i % 100u, i);
+        for(unsigned gf = 0; gf < 100u; gf++)
+            em.ExecuteNextGF();
+    }
+    BOOST_TEST(handler.numEvents == 1000u * state.getNumIterations());
+}
+
+BOOST_AUTO_TEST_CASE(ManySoldiers)
+{
+    rttr::bench::State state("GameFrames/ManySoldiers/1000GF");
+    while(state.keepRunning())
+    {
+        state.pauseTiming();
+        auto world = std::make_unique<SoldierWorld>();
+        state.resumeTiming();
+        for(unsigned gf = 0; gf < 1000u; gf++)
+            world->em.ExecuteNextGF();
+        state.pauseTiming();
+        world.reset();
+        state.resumeTiming();
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,65 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "Benchmark.h"
+#include "GameCommand.h"
+#include "worldFixtures/GCCollector.h"
+#include "libutil/Serializer.h"
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+namespace {
+struct CommandBatch : public GCCollector
+{
+    CommandBatch() { createBusyNWFCommands(*this); }
+};
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(GameCommands)
+
+BOOST_AUTO_TEST_CASE(EncodeBatch)
+{
+    const CommandBatch batch;
+    Serializer ser;
+    rttr::bench::State state("GameCommands/Encode520");
+    while(state.keepRunning())
+    {
+        ser.Clear();
+        gc::GameCommand::SerializeBatch(ser, batch.gcs);
+    }
+    BOOST_TEST_MESSAGE("Encoded size of " << batch.gcs.size() << " commands: " << ser.GetLength() << " bytes");
+}
+
+BOOST_AUTO_TEST_CASE(DecodeBatch)
+{
+    const CommandBatch batch;
+    Serializer ser;
+    gc::GameCommand::SerializeBatch(ser, batch.gcs);
+    Serializer readSer;
+    size_t numGCs = 0;
+    rttr::bench::State state("GameCommands/Decode520");
+    while(state.keepRunning())
+    {
+        readSer.Clear();
+        readSer.PushRawData(ser.GetData(), ser.GetLength());
+        numGCs += gc::GameCommand::DeserializeBatch(readSer).size();
+    }
+    BOOST_TEST(numGCs == batch.gcs.size() * state.getNumIterations());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,67 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "Benchmark.h"
+#include "lua/GameDataLoader.h"
+#include "mapGenerator/Map.h"
+#include "mapGenerator/MapSettings.h"
+#include "mapGenerator/RandomConfig.h"
+#include "mapGenerator/RandomMapGenerator.h"
+#include "gameData/WorldDescription.h"
+#include <boost/test/unit_test.hpp>
+
+namespace {
+void runCreateMap(const char* name, MapStyle style, unsigned numPlayers, const MapExtent& size)
+{
+    WorldDescription worldDesc;
+    GameDataLoader gdLoader(worldDesc);
+    BOOST_TEST_REQUIRE(gdLoader.Load());
+    MapSettings settings;
+    settings.numPlayers = numPlayers;
+    settings.size = size;
+    settings.style = style;
+    settings.Validate();
+
+    rttr::bench::State state(name);
+    while(state.keepRunning())
+    {
+        // Same seed each time to get reproducible maps
+        state.pauseTiming();
+        RandomConfig config;
+        config.Init(style, settings.type, 42, worldDesc);
+        RandomMapGenerator generator(config);
+        state.resumeTiming();
+        const Map map = generator.Create(settings);
+        BOOST_TEST_REQUIRE((map.size == size));
+    }
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(MapGenerator)
+
+BOOST_AUTO_TEST_CASE(CreateSmall)
+{
+    runCreateMap("RandomMap/Greenland/64x64", MapStyle::Greenland, 2, MapExtent(64, 64));
+}
+
+BOOST_AUTO_TEST_CASE(CreateLarge)
+{
+    runCreateMap("RandomMap/Continent/256x256", MapStyle::Continent, 4, MapExtent(256, 256));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,140 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "Benchmark.h"
+#include "GamePlayer.h"
+#include "worldFixtures/CreateEmptyWorld.h"
+#include "worldFixtures/WorldFixture.h"
+#include "nodeObjs/noFlag.h"
+#include "nodeObjs/noGranite.h"
+#include "pathfinding/RoadPathFinder.h"
+#include "gameData/GameConsts.h"
+#include <boost/test/unit_test.hpp>
+#include <limits>
+#include <vector>
+
+namespace {
+/// Empty world with a granite wall in the middle which has a single gap at the top
+template<unsigned T_size>
+struct WalledWorldFixture : WorldFixture<CreateEmptyWorld, 0, T_size, T_size>
+{
+    using Parent = WorldFixture<CreateEmptyWorld, 0, T_size, T_size>;
+    using Parent::world;
+
+    WalledWorldFixture()
+    {
+        for(unsigned y = 2; y < T_size; y++)
+            world.SetNO(MapPoint(T_size / 2, y), new noGranite(GT_1, 1));
+    }
+
+    void runFindHumanPath(const char* name, MapPoint start, MapPoint dest)
+    {
+        unsigned length;
+        BOOST_TEST_REQUIRE(world.FindHumanPath(start, dest, 0xFFFFFFFF, false, &length) != INVALID_DIR);
+        unsigned totalLength = 0;
+        rttr::bench::State state(name);
+        while(state.keepRunning())
+        {
+            world.FindHumanPath(start, dest, 0xFFFFFFFF, false, &length);
+            totalLength += length;
+        }
+        BOOST_TEST(totalLength == length * state.getNumIterations());
+    }
+};
+
+/// World owned by one player with a grid of flags every 2 nodes connected by roads
+template<unsigned T_size>
+struct RoadGridFixture : WorldFixture<CreateEmptyWorld, 1, T_size, T_size>
+{
+    using Parent = WorldFixture<CreateEmptyWorld, 1, T_size, T_size>;
+    using Parent::world;
+    std::vector<const noFlag*> flags;
+
+    RoadGridFixture()
+    {
+        RTTR_FOREACH_PT(MapPoint, world.GetSize())
+            world.SetOwner(pt, 1);
+        const MapPoint hqFlagPos = world.GetNeighbour(world.GetPlayer(0).GetHQPos(), Direction::SOUTHEAST);
+        for(unsigned y = 2; y + 2 < T_size; y += 2)
+        {
+            for(unsigned x = 2; x + 2 < T_size; x += 2)
+            {
+                const MapPoint pt(x, y);
+                if(pt != hqFlagPos && world.GetBQ(pt, 0) != BQ_NOTHING)
+                    world.SetFlag(pt, 0);
+            }
+        }
+        RTTR_FOREACH_PT(MapPoint, world.GetSize())
+        {
+            if(!world.template GetSpecObj<noFlag>(pt))
+                continue;
+            const MapPoint eastPt = world.GetNeighbour(world.GetNeighbour(pt, Direction::EAST), Direction::EAST);
+            if(world.template GetSpecObj<noFlag>(eastPt))
+                world.BuildRoad(0, false, pt, {Direction::EAST, Direction::EAST});
+            const MapPoint southPt = world.GetNeighbour(world.GetNeighbour(pt, Direction::SOUTHEAST), Direction::SOUTHWEST);
+            if(world.template GetSpecObj<noFlag>(southPt))
+                world.BuildRoad(0, false, pt, {Direction::SOUTHEAST, Direction::SOUTHWEST});
+            flags.push_back(world.template GetSpecObj<noFlag>(pt));
+        }
+        BOOST_TEST_REQUIRE(flags.size() > 2u);
+    }
+
+    void runFindRoadPath(const char* name, bool wareMode)
+    {
+        const noFlag& start = *flags.front();
+        const noFlag& goal = *flags.back();
+        unsigned length;
+        BOOST_TEST_REQUIRE(world.GetRoadPathFinder().FindPath(start, goal, wareMode, std::numeric_limits<unsigned>::max(), nullptr,
+                                                              &length));
+        unsigned totalLength = 0;
+        rttr::bench::State state(name);
+        while(state.keepRunning())
+        {
+            world.GetRoadPathFinder().FindPath(start, goal, wareMode, std::numeric_limits<unsigned>::max(), nullptr, &length);
+            totalLength += length;
+        }
+        BOOST_TEST(totalLength == length * state.getNumIterations());
+    }
+};
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Pathfinding)
+
+BOOST_FIXTURE_TEST_CASE(FreePathSmall, WalledWorldFixture<64>)
+{
+    runFindHumanPath("FreePath/64x64", MapPoint(4, 60), MapPoint(60, 60));
+}
+
+BOOST_FIXTURE_TEST_CASE(FreePathLarge, WalledWorldFixture<256>)
+{
+    runFindHumanPath("FreePath/256x256", MapPoint(4, 250), MapPoint(250, 250));
+}
+
+BOOST_FIXTURE_TEST_CASE(RoadPathSmall, RoadGridFixture<32>)
+{
+    runFindRoadPath("RoadPath/32x32", false);
+    runFindRoadPath("RoadPath/32x32/WareMode", true);
+}
+
+BOOST_FIXTURE_TEST_CASE(RoadPathLarge, RoadGridFixture<96>)
+{
+    runFindRoadPath("RoadPath/96x96", false);
+    runFindRoadPath("RoadPath/96x96/WareMode", true);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,104 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "Benchmark.h"
+#include "GamePlayer.h"
+#include "SerializedGameData.h"
+#include "buildings/noBaseBuilding.h"
+#include "worldFixtures/CreateEmptyWorld.h"
+#include "worldFixtures/WorldFixture.h"
+#include <boost/test/unit_test.hpp>
+
+namespace {
+using SmallWorldFixture = WorldFixture<CreateEmptyWorld, 2, 64, 64>;
+using LargeWorldFixture = WorldFixture<CreateEmptyWorld, 4, 256, 256>;
+
+template<class T_Fixture>
+void runRecalcBQ(T_Fixture& fixture, const char* name)
+{
+    auto& world = fixture.world;
+    rttr::bench::State state(name);
+    while(state.keepRunning())
+    {
+        RTTR_FOREACH_PT(MapPoint, world.GetSize())
+            world.RecalcBQ(pt);
+    }
+}
+
+template<class T_Fixture>
+void runRecalcTerritory(T_Fixture& fixture, const char* name)
+{
+    auto& world = fixture.world;
+    rttr::bench::State state(name);
+    while(state.keepRunning())
+    {
+        for(unsigned i = 0; i < world.GetNumPlayers(); i++)
+            world.RecalcTerritory(*world.template GetSpecObj<noBaseBuilding>(world.GetPlayer(i).GetHQPos()), TerritoryChangeReason::Build);
+    }
+}
+
+template<class T_Fixture>
+void runMakeSnapshot(T_Fixture& fixture, const char* name)
+{
+    // Let the players settle so there are some figures and events
+    rttr_skip_gfs(fixture.em, 500);
+    uint64_t totalSize = 0;
+    rttr::bench::State state(name);
+    while(state.keepRunning())
+    {
+        SerializedGameData sgd;
+        sgd.MakeSnapshot(fixture.game);
+        totalSize += sgd.GetLength();
+    }
+    BOOST_TEST(totalSize > 0u);
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(WorldCalculations)
+
+BOOST_FIXTURE_TEST_CASE(RecalcBQSmall, SmallWorldFixture)
+{
+    runRecalcBQ(*this, "RecalcBQ/64x64");
+}
+
+BOOST_FIXTURE_TEST_CASE(RecalcBQLarge, LargeWorldFixture)
+{
+    runRecalcBQ(*this, "RecalcBQ/256x256");
+}
+
+BOOST_FIXTURE_TEST_CASE(RecalcTerritorySmall, SmallWorldFixture)
+{
+    runRecalcTerritory(*this, "RecalcTerritory/2P");
+}
+
+BOOST_FIXTURE_TEST_CASE(RecalcTerritoryLarge, LargeWorldFixture)
+{
+    runRecalcTerritory(*this, "RecalcTerritory/4P");
+}
+
+BOOST_FIXTURE_TEST_CASE(MakeSnapshotSmall, SmallWorldFixture)
+{
+    runMakeSnapshot(*this, "MakeSnapshot/64x64");
+}
+
+BOOST_FIXTURE_TEST_CASE(MakeSnapshotLarge, LargeWorldFixture)
+{
+    runMakeSnapshot(*this, "MakeSnapshot/256x256");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,60 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#define BOOST_TEST_MODULE RTTR_Benchmarks
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "Benchmark.h"
+#include <rttr/test/Fixture.hpp>
+#include <boost/nowide/fstream.hpp>
+#include <boost/nowide/iostream.hpp>
+#include <boost/test/unit_test.hpp>
+#include <string>
+
+/// Runs each benchmark as a test case. Own arguments are passed after "--":
+///     benchmarks [--run_test=<filter>] -- [--json=<file>] [--min_time=<ms>]
+struct BenchmarkFixture : rttr::test::Fixture
+{
+    std::string jsonPath;
+
+    BenchmarkFixture()
+    {
+        const auto& suite = boost::unit_test::framework::master_test_suite();
+        for(int i = 1; i < suite.argc; i++)
+        {
+            const std::string arg = suite.argv[i];
+            if(arg.compare(0, 7, "--json=") == 0)
+                jsonPath = arg.substr(7);
+            else if(arg.compare(0, 11, "--min_time=") == 0)
+                rttr::bench::setMinTime(std::chrono::milliseconds(std::stoul(arg.substr(11))));
+            else
+                bnw::cerr << "Ignoring unknown argument " << arg << std::endl;
+        }
+    }
+    ~BenchmarkFixture()
+    {
+        rttr::bench::writeReport(bnw::cout);
+        if(jsonPath.empty())
+            return;
+        bnw::ofstream jsonFile(jsonPath);
+        rttr::bench::writeJSON(jsonFile);
+        if(!jsonFile)
+            bnw::cerr << "Failed to write " << jsonPath << std::endl;
+    }
+};
+
+BOOST_GLOBAL_FIXTURE(BenchmarkFixture);
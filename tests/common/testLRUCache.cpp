@@ -0,0 +1,68 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "commonDefines.h" // IWYU pragma: keep
+#include "helpers/LRUCache.h"
+#include <boost/test/unit_test.hpp>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(LRUCacheTests)
+
+BOOST_AUTO_TEST_CASE(FindAndInsert)
+{
+    helpers::LRUCache<std::string, int> cache(2);
+    BOOST_TEST(cache.find("a") == nullptr);
+    BOOST_TEST(cache.insert("a", 1) == 1);
+    BOOST_TEST_REQUIRE(cache.find("a"));
+    BOOST_TEST(*cache.find("a") == 1);
+    // Replacing does not add a new entry
+    cache.insert("a", 2);
+    BOOST_TEST(cache.size() == 1u);
+    BOOST_TEST(*cache.find("a") == 2);
+    cache.clear();
+    BOOST_TEST(cache.size() == 0u);
+    BOOST_TEST(cache.find("a") == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(RemovesLeastRecentlyUsed)
+{
+    helpers::LRUCache<int, int> cache(3);
+    cache.insert(1, 10);
+    cache.insert(2, 20);
+    cache.insert(3, 30);
+    // Access makes 1 the most recently used one -> 2 is removed next
+    BOOST_TEST(cache.find(1));
+    cache.insert(4, 40);
+    BOOST_TEST(cache.size() == 3u);
+    BOOST_TEST(cache.find(2) == nullptr);
+    BOOST_TEST(cache.find(1));
+    BOOST_TEST(cache.find(3));
+    BOOST_TEST(cache.find(4));
+    // Now 1 is the oldest
+    cache.insert(5, 50);
+    BOOST_TEST(cache.find(1) == nullptr);
+    BOOST_TEST(*cache.find(5) == 50);
+
+    // Copies are empty but usable
+    helpers::LRUCache<int, int> copy(cache);
+    BOOST_TEST(copy.size() == 0u);
+    BOOST_TEST(copy.maxSize() == 3u);
+    copy.insert(1, 1);
+    BOOST_TEST(*copy.find(1) == 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,76 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "commonDefines.h" // IWYU pragma: keep
+#include "helpers/SPSCQueue.h"
+#include <boost/test/unit_test.hpp>
+#include <memory>
+#include <thread>
+
+BOOST_AUTO_TEST_SUITE(SPSCQueueTests)
+
+BOOST_AUTO_TEST_CASE(PushAndPop)
+{
+    helpers::SPSCQueue<std::unique_ptr<int>> queue(2);
+    BOOST_TEST(queue.capacity() == 2u);
+    BOOST_TEST(queue.empty());
+    std::unique_ptr<int> value;
+    BOOST_TEST(!queue.tryPop(value));
+    for(int i = 0; i < 5; i++)
+    {
+        BOOST_TEST(queue.tryPush(std::make_unique<int>(i * 2)));
+        BOOST_TEST(queue.tryPush(std::make_unique<int>(i * 2 + 1)));
+        // Full -> Value is kept
+        std::unique_ptr<int> extraValue = std::make_unique<int>(42);
+        BOOST_TEST(!queue.tryPush(std::move(extraValue)));
+        BOOST_TEST_REQUIRE(!!extraValue);
+        BOOST_TEST(!queue.empty());
+        BOOST_TEST_REQUIRE(queue.tryPop(value));
+        BOOST_TEST(*value == i * 2);
+        BOOST_TEST_REQUIRE(queue.tryPop(value));
+        BOOST_TEST(*value == i * 2 + 1);
+        BOOST_TEST(queue.empty());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(KeepsOrderAcrossThreads)
+{
+    constexpr unsigned numValues = 100000;
+    helpers::SPSCQueue<unsigned> queue(64);
+    std::thread producer([&queue]() {
+        for(unsigned i = 0; i < numValues; i++)
+        {
+            unsigned value = i;
+            while(!queue.tryPush(std::move(value)))
+                std::this_thread::yield();
+        }
+    });
+    unsigned numInOrder = 0;
+    for(unsigned i = 0; i < numValues; i++)
+    {
+        unsigned value;
+        while(!queue.tryPop(value))
+            std::this_thread::yield();
+        if(value == i)
+            numInOrder++;
+    }
+    producer.join();
+    BOOST_TEST(numInOrder == numValues);
+    BOOST_TEST(queue.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,63 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "commonDefines.h" // IWYU pragma: keep
+#include "helpers/ThreadPool.h"
+#include <boost/test/unit_test.hpp>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(ThreadPoolTests)
+
+BOOST_AUTO_TEST_CASE(SubmitReturnsResult)
+{
+    helpers::ThreadPool pool(2);
+    BOOST_TEST(pool.getNumThreads() == 2u);
+    std::future<int> result = pool.submit([]() { return 42; });
+    BOOST_TEST(result.get() == 42);
+    std::future<void> error = pool.submit([]() { throw std::runtime_error("Failed"); });
+    BOOST_CHECK_THROW(error.get(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(ParallelForVisitsAll)
+{
+    helpers::ThreadPool pool(3);
+    std::vector<unsigned> values(1000);
+    pool.parallelFor(values.size(), [&values](size_t i) { values[i] += static_cast<unsigned>(i) + 1u; });
+    std::vector<unsigned> expected(values.size());
+    std::iota(expected.begin(), expected.end(), 1u);
+    BOOST_TEST(values == expected, boost::test_tools::per_element());
+
+    // Nothing to do
+    pool.parallelFor(0, [](size_t) { BOOST_FAIL("Should not be called"); });
+}
+
+BOOST_AUTO_TEST_CASE(ParallelForRethrows)
+{
+    helpers::ThreadPool pool(2);
+    BOOST_CHECK_THROW(pool.parallelFor(100,
+                                       [](size_t i) {
+                                           if(i == 50)
+                                               throw std::runtime_error("Failed");
+                                       }),
+                      std::runtime_error);
+    // Pool is still usable
+    BOOST_TEST(pool.submit([]() { return 1; }).get() == 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
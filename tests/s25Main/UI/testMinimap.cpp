@@ -0,0 +1,134 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "IngameMinimap.h"
+#include "uiHelper/uiHelpers.hpp"
+#include "world/GameWorldViewer.h"
+#include "worldFixtures/CreateEmptyWorld.h"
+#include "worldFixtures/WorldFixture.h"
+#include <libutil/warningSuppression.h>
+#include <glad/glad.h>
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+namespace {
+/// Area of the texture uploaded by glTexSubImage2D
+struct TexUpload
+{
+    int x, y, width, height;
+};
+
+namespace rttrOglMock3 {
+RTTR_IGNORE_DIAGNOSTIC("-Wmissing-declarations")
+
+std::vector<TexUpload> uploads;
+
+void APIENTRY glTexSubImage2D(GLenum, GLint, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum, GLenum, const void*)
+{
+    uploads.push_back(TexUpload{xoffset, yoffset, width, height});
+}
+
+RTTR_POP_DIAGNOSTIC
+} // namespace rttrOglMock3
+
+/// Texture of 160x70 pixels -> 3x2 tiles of 64x64
+using MinimapWorldFixture = WorldFixture<CreateEmptyWorld, 2, 80, 70>;
+
+struct TestMinimap : public IngameMinimap
+{
+    explicit TestMinimap(const GameWorldViewer& gwv) : IngameMinimap(gwv) {}
+    glArchivItem_Bitmap_Direct& GetMap() { return map; }
+    /// Check that the texture contains the colors of a serial calculation
+    void CheckColors()
+    {
+        RTTR_FOREACH_PT(MapPoint, GetMapSize())
+        {
+            for(unsigned t = 0; t < 2; ++t)
+            {
+                const unsigned texX = (pt.x * 2 + t + (pt.y & 1)) % (GetMapSize().x * 2);
+                BOOST_TEST_INFO("Node " << pt.x << "," << pt.y << " triangle " << t);
+                BOOST_TEST(map.getPixel(texX, pt.y).clrValue == CalcPixelColor(pt, t));
+            }
+        }
+    }
+};
+
+struct MinimapFixture : uiHelper::Fixture, MinimapWorldFixture
+{
+    GameWorldViewer gwv;
+    TestMinimap minimap;
+    MinimapFixture() : gwv(0, world), minimap(gwv)
+    {
+        // Create the texture so changes get uploaded
+        BOOST_TEST_REQUIRE(minimap.GetMap().GetTexture() != 0u);
+        glTexSubImage2D = rttrOglMock3::glTexSubImage2D;
+        rttrOglMock3::uploads.clear();
+    }
+};
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(MinimapSuite)
+
+BOOST_FIXTURE_TEST_CASE(ParallelBuildMatchesSerial, MinimapFixture)
+{
+    // Created in parallel rows
+    minimap.CheckColors();
+    // Recalculate only the territory in parallel rows
+    minimap.ToggleTerritory();
+    minimap.CheckColors();
+    minimap.ToggleTerritory();
+    minimap.CheckColors();
+    minimap.UpdateAll();
+    minimap.CheckColors();
+}
+
+BOOST_FIXTURE_TEST_CASE(ChangedNodeUploadsItsTile, MinimapFixture)
+{
+    // Both triangles of a node are next to each other in the texture. The node is at x = 81 on an odd row
+    minimap.UpdateNode(MapPoint(40, 65));
+    minimap.Draw(Rect());
+    BOOST_TEST_REQUIRE(rttrOglMock3::uploads.size() == 1u);
+    BOOST_TEST(rttrOglMock3::uploads[0].x == 81);
+    BOOST_TEST(rttrOglMock3::uploads[0].y == 65);
+    BOOST_TEST(rttrOglMock3::uploads[0].width == 2);
+    BOOST_TEST(rttrOglMock3::uploads[0].height == 1);
+
+    // Nodes in opposite corners upload only their tiles, nodes in the same tile upload their bounding box
+    rttrOglMock3::uploads.clear();
+    minimap.UpdateNode(MapPoint(0, 0));
+    minimap.UpdateNode(MapPoint(79, 69));
+    minimap.UpdateNode(MapPoint(5, 3));
+    minimap.Draw(Rect());
+    BOOST_TEST_REQUIRE(rttrOglMock3::uploads.size() == 3u);
+    BOOST_TEST(rttrOglMock3::uploads[0].x == 0);
+    BOOST_TEST(rttrOglMock3::uploads[0].y == 0);
+    BOOST_TEST(rttrOglMock3::uploads[0].width == 13);
+    BOOST_TEST(rttrOglMock3::uploads[0].height == 4);
+    // Last node on an odd row wraps around: Pixels 159 and 0 are in the last and first tile of the row
+    BOOST_TEST(rttrOglMock3::uploads[1].x == 159);
+    BOOST_TEST(rttrOglMock3::uploads[1].y == 69);
+    BOOST_TEST(rttrOglMock3::uploads[1].width == 1);
+    BOOST_TEST(rttrOglMock3::uploads[1].height == 1);
+    BOOST_TEST(rttrOglMock3::uploads[2].x == 0);
+    BOOST_TEST(rttrOglMock3::uploads[2].y == 69);
+    BOOST_TEST(rttrOglMock3::uploads[2].width == 1);
+    BOOST_TEST(rttrOglMock3::uploads[2].height == 1);
+    minimap.CheckColors();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,135 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "drivers/VideoDriverWrapper.h"
+#include "ogl/IRenderer.h"
+#include "ogl/SpriteBatch.h"
+#include "ogl/glSmartBitmap.h"
+#include "ogl/glTexturePacker.h"
+#include "uiHelper/uiHelpers.hpp"
+#include "libsiedler2/ArchivItem_Bitmap_Raw.h"
+#include "libsiedler2/PixelBufferARGB.h"
+#include <boost/test/unit_test.hpp>
+#include <array>
+#include <vector>
+
+namespace {
+/// Remembers the textures and quad counts of each draw call
+class RecordingSpriteBatch : public ogl::SpriteBatch
+{
+public:
+    std::vector<unsigned> drawnTextures, drawnQuads;
+    std::vector<Vertex> uploadedVertices;
+
+protected:
+    void uploadVertices(const std::vector<Vertex>& vertices) override { uploadedVertices = vertices; }
+    void drawQuads(unsigned texture, unsigned /*firstQuad*/, unsigned numQuads) override
+    {
+        drawnTextures.push_back(texture);
+        drawnQuads.push_back(numQuads);
+    }
+};
+
+void addQuad(ogl::SpriteBatch& batch, unsigned texture, float x)
+{
+    const std::array<Point<float>, 4> vertices = {{Point<float>(x, 0), Point<float>(x, 1), Point<float>(x + 1, 1), Point<float>(x + 1, 0)}};
+    batch.add(texture, vertices.data(), vertices.data(), 0xFFFFFFFF);
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(SpriteBatch)
+
+BOOST_AUTO_TEST_CASE(MergesConsecutiveTextures)
+{
+    RecordingSpriteBatch batch;
+    batch.begin();
+    BOOST_TEST(batch.isActive());
+    addQuad(batch, 1, 0);
+    addQuad(batch, 1, 1);
+    addQuad(batch, 2, 2);
+    addQuad(batch, 1, 3);
+    BOOST_TEST(batch.getNumPendingQuads() == 4u);
+    // Nothing drawn until flushed
+    BOOST_TEST(batch.drawnTextures.empty());
+    batch.end();
+    BOOST_TEST(!batch.isActive());
+    BOOST_TEST(batch.getNumPendingQuads() == 0u);
+    BOOST_TEST(batch.getNumFlushes() == 1u);
+    // Painter order must be kept -> 3 runs
+    BOOST_TEST(batch.getNumDrawCalls() == 3u);
+    const std::vector<unsigned> expectedTextures = {1, 2, 1};
+    const std::vector<unsigned> expectedQuads = {2, 1, 1};
+    BOOST_TEST(batch.drawnTextures == expectedTextures, boost::test_tools::per_element());
+    BOOST_TEST(batch.drawnQuads == expectedQuads, boost::test_tools::per_element());
+    BOOST_TEST_REQUIRE(batch.uploadedVertices.size() == 16u);
+    for(unsigned i = 0; i < 4u; i++)
+        BOOST_TEST(batch.uploadedVertices[i * 4u].pos.x == static_cast<float>(i));
+}
+
+BOOST_AUTO_TEST_CASE(EmptyFlushIsNoop)
+{
+    RecordingSpriteBatch batch;
+    batch.begin();
+    batch.flush();
+    batch.end();
+    BOOST_TEST(batch.getNumFlushes() == 0u);
+    BOOST_TEST(batch.drawnTextures.empty());
+}
+
+BOOST_FIXTURE_TEST_CASE(PackedBitmapsUseOneDrawCall, uiHelper::Fixture)
+{
+    std::array<libsiedler2::ArchivItem_Bitmap_Raw, 5> bmps;
+    std::array<glSmartBitmap, 5> smartBmps;
+    glTexturePacker packer;
+    for(unsigned i = 0; i < bmps.size(); ++i)
+    {
+        libsiedler2::PixelBufferARGB buffer(5 + i, 7 + i, libsiedler2::ColorARGB(0xFFFFFFFF));
+        bmps[i].create(buffer);
+        smartBmps[i].add(&bmps[i]);
+        packer.add(smartBmps[i]);
+    }
+    BOOST_TEST_REQUIRE(packer.pack());
+    BOOST_TEST_REQUIRE(packer.getTextures().size() == 1u);
+
+    BOOST_TEST(!VIDEODRIVER.GetActiveSpriteBatch());
+    IRenderer* renderer = VIDEODRIVER.GetRenderer();
+    BOOST_TEST_REQUIRE(renderer);
+    ogl::SpriteBatch& batch = renderer->GetSpriteBatch();
+    batch.resetCounters();
+    batch.begin();
+    BOOST_TEST(VIDEODRIVER.GetActiveSpriteBatch() == &batch);
+    for(glSmartBitmap& bmp : smartBmps)
+        bmp.draw(DrawPoint(10, 10));
+    BOOST_TEST(batch.getNumPendingQuads() == smartBmps.size());
+    batch.end();
+    BOOST_TEST(batch.getNumFlushes() == 1u);
+    BOOST_TEST(batch.getNumDrawCalls() == 1u);
+
+    // Drawing something not batched flushes before
+    batch.resetCounters();
+    batch.begin();
+    smartBmps[0].draw(DrawPoint(10, 10));
+    renderer->DrawRect(Rect(0, 0, 10, 10), 0xFFFFFFFF);
+    BOOST_TEST(batch.getNumFlushes() == 1u);
+    smartBmps[1].draw(DrawPoint(10, 10));
+    batch.end();
+    BOOST_TEST(batch.getNumFlushes() == 2u);
+    BOOST_TEST(batch.getNumDrawCalls() == 2u);
+    BOOST_TEST(!VIDEODRIVER.GetActiveSpriteBatch());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
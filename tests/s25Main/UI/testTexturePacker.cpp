@@ -16,13 +16,16 @@
 // along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
 
 #include "CollisionDetection.h"
+#include "helpers/ThreadPool.h"
 #include "ogl/glSmartBitmap.h"
 #include "ogl/glTexturePacker.h"
 #include "uiHelper/uiHelpers.hpp"
 #include "libsiedler2/ArchivItem_Bitmap_Raw.h"
 #include "libsiedler2/PixelBufferARGB.h"
+#include <boost/filesystem/operations.hpp>
 #include <boost/test/unit_test.hpp>
 #include <Rect.h>
+#include <algorithm>
 #include <array>
 
 BOOST_FIXTURE_TEST_SUITE(TexturePacker, uiHelper::Fixture)
@@ -74,4 +77,91 @@ BOOST_AUTO_TEST_CASE(SizeAndPosCorrect)
     }
 }
 
+BOOST_AUTO_TEST_CASE(MultiplePagesWithThreads)
+{
+    std::array<libsiedler2::ArchivItem_Bitmap_Raw, 10> bmps;
+    std::array<glSmartBitmap, 10> smartBmps;
+    glTexturePacker packer;
+    for(unsigned i = 0; i < bmps.size(); ++i)
+    {
+        libsiedler2::PixelBufferARGB buffer(16, 16, libsiedler2::ColorARGB(0xFFFFFFFF));
+        bmps[i].create(buffer);
+        smartBmps[i].add(&bmps[i]);
+        packer.add(smartBmps[i]);
+    }
+    // Bitmaps bigger than the max size
+    BOOST_TEST(!packer.packPages(Extent(8, 32)));
+
+    helpers::ThreadPool threadPool(2);
+    // 4 bitmaps per texture -> 3 textures
+    BOOST_TEST_REQUIRE(packer.packPages(Extent(32, 32), &threadPool));
+    // Nothing uploaded yet
+    BOOST_TEST(packer.getTextures().empty());
+    for(const auto& bmp : smartBmps)
+        BOOST_TEST(!bmp.isGenerated());
+    BOOST_TEST_REQUIRE(packer.uploadPages());
+    BOOST_TEST_REQUIRE(packer.getTextures().size() == 3u);
+    for(const auto& bmp : smartBmps)
+    {
+        BOOST_TEST_REQUIRE(bmp.isGenerated());
+        const auto itTexture = std::find_if(packer.getTextures().begin(), packer.getTextures().end(),
+                                            [&bmp](const glTexture& texture) { return texture.get() == bmp.getTexture(); });
+        BOOST_TEST_REQUIRE((itTexture != packer.getTextures().end()));
+        const Point<float> size(itTexture->getSize());
+        BOOST_TEST(size.x <= 32.f);
+        BOOST_TEST(size.y <= 32.f);
+        const auto curTexSize = bmp.texCoords[2] - bmp.texCoords[0];
+        BOOST_TEST(curTexSize.x * size.x == 16.f);
+        BOOST_TEST(curTexSize.y * size.y == 16.f);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SaveAndLoadPages)
+{
+    std::array<libsiedler2::ArchivItem_Bitmap_Raw, 5> bmps;
+    std::array<glSmartBitmap, 5> smartBmps, smartBmps2;
+    glTexturePacker packer, packer2;
+    for(unsigned i = 0; i < bmps.size(); ++i)
+    {
+        libsiedler2::PixelBufferARGB buffer(5 + i, 7 + i * 2, libsiedler2::ColorARGB(0xFFFFFFFF));
+        bmps[i].create(buffer);
+        smartBmps[i].add(&bmps[i]);
+        smartBmps2[i].add(&bmps[i]);
+        packer.add(smartBmps[i]);
+        packer2.add(smartBmps2[i]);
+    }
+    const bfs::path tmpPath = bfs::absolute(bfs::unique_path());
+    const bfs::path cacheFilePath = tmpPath / "textures.cache";
+    // Nothing packed yet
+    BOOST_TEST(!packer.savePages(cacheFilePath, 42));
+    BOOST_TEST(!packer2.loadPages(cacheFilePath, 42));
+
+    BOOST_TEST_REQUIRE(packer.packPages(Extent(64, 64)));
+    BOOST_TEST_REQUIRE(packer.savePages(cacheFilePath, 42));
+    BOOST_TEST_REQUIRE(packer.uploadPages());
+
+    // Wrong key
+    BOOST_TEST(!packer2.loadPages(cacheFilePath, 43));
+    BOOST_TEST_REQUIRE(packer2.loadPages(cacheFilePath, 42));
+    BOOST_TEST_REQUIRE(packer2.uploadPages());
+    BOOST_TEST(packer2.getTextures().size() == packer.getTextures().size());
+    for(unsigned i = 0; i < smartBmps.size(); ++i)
+    {
+        BOOST_TEST(smartBmps2[i].isGenerated());
+        for(unsigned j = 0; j < smartBmps[i].texCoords.size(); ++j)
+        {
+            BOOST_TEST(smartBmps2[i].texCoords[j].x == smartBmps[i].texCoords[j].x);
+            BOOST_TEST(smartBmps2[i].texCoords[j].y == smartBmps[i].texCoords[j].y);
+        }
+    }
+
+    // Different bitmaps
+    glTexturePacker packer3;
+    for(unsigned i = 1; i < smartBmps.size(); ++i)
+        packer3.add(smartBmps[i]);
+    BOOST_TEST(!packer3.loadPages(cacheFilePath, 42));
+
+    bfs::remove_all(tmpPath);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
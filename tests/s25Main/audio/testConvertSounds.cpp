@@ -0,0 +1,183 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "convertSounds.h"
+#include "libsiedler2/Archiv.h"
+#include "libsiedler2/ArchivItem_Sound_Wave.h"
+#include <boost/filesystem.hpp>
+#include <boost/nowide/fstream.hpp>
+#include <boost/test/unit_test.hpp>
+#include <memory>
+#include <vector>
+
+namespace {
+using SoundData = std::vector<std::vector<uint8_t>>;
+
+struct ConvertSoundsFixture
+{
+    const bfs::path tmpPath, scriptPath, cacheDir, sourceFile;
+    ConvertSoundsFixture()
+        : tmpPath(bfs::absolute(bfs::unique_path())), scriptPath(tmpPath / "sound.scs"), cacheDir(tmpPath / "cache"),
+          sourceFile(tmpPath / "sound.lst")
+    {
+        bfs::create_directories(tmpPath);
+        writeFile(scriptPath, "# Comment\n0 11025\nempty\n2 22050\n");
+    }
+    ~ConvertSoundsFixture() { bfs::remove_all(tmpPath); }
+
+    static void writeFile(const bfs::path& filePath, const std::string& content)
+    {
+        bnw::ofstream file(filePath);
+        file << content;
+    }
+
+    std::vector<bfs::path> getCacheFiles() const
+    {
+        std::vector<bfs::path> files;
+        for(const auto& it : bfs::directory_iterator(cacheDir))
+            files.push_back(it.path());
+        return files;
+    }
+
+    /// Convert the sounds created with the seed and return the data of all items
+    SoundData convert(uint8_t seed, const bfs::path& cache = bfs::path(), const bfs::path& source = bfs::path()) const
+    {
+        libsiedler2::Archiv sounds;
+        // Only 0 and 2 are in the script
+        addSound(sounds, 11025, 500, seed);
+        addSound(sounds, 44100, 100, seed);
+        addSound(sounds, 22050, 300, seed);
+        BOOST_TEST_REQUIRE(convertSounds(sounds, scriptPath, cache, source));
+        SoundData result;
+        for(unsigned i = 0; i < 3; i++)
+            result.push_back(dynamic_cast<libsiedler2::ArchivItem_Sound_Wave*>(sounds[i])->getData());
+        return result;
+    }
+
+    static void addSound(libsiedler2::Archiv& sounds, unsigned frequency, unsigned length, uint8_t seed)
+    {
+        auto sound = std::make_unique<libsiedler2::ArchivItem_Sound_Wave>();
+        auto header = sound->getHeader();
+        header.numChannels = 1;
+        header.samplesPerSec = header.bytesPerSec = frequency;
+        header.frameSize = 1;
+        header.bitsPerSample = 8;
+        header.dataSize = length;
+        header.fileSize = length + sizeof(header);
+        std::vector<uint8_t> data(length);
+        for(unsigned i = 0; i < length; i++)
+            data[i] = static_cast<uint8_t>(seed + i * 7u);
+        sound->setHeader(header);
+        sound->setData(data);
+        sounds.push(std::move(sound));
+    }
+};
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(ConvertSounds, ConvertSoundsFixture)
+
+BOOST_AUTO_TEST_CASE(CacheRoundTrip)
+{
+    const SoundData expected = convert(0);
+    // Only the listed items are converted
+    BOOST_TEST_REQUIRE(expected[0].size() > 500u);
+    BOOST_TEST_REQUIRE(expected[1].size() == 100u);
+    BOOST_TEST_REQUIRE(expected[2].size() > 300u);
+
+    BOOST_TEST((convert(0, cacheDir) == expected));
+    const std::vector<bfs::path> cacheFiles = getCacheFiles();
+    BOOST_TEST_REQUIRE(cacheFiles.size() == 1u);
+    BOOST_TEST((convert(0, cacheDir) == expected));
+    BOOST_TEST((getCacheFiles() == cacheFiles));
+
+    // Change the converted data in the cache to check it is really used
+    {
+        bnw::fstream file(cacheFiles[0].string(), std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(-1, std::ios::end);
+        file.put(static_cast<char>(expected[2].back() + 1));
+    }
+    const SoundData cached = convert(0, cacheDir);
+    BOOST_TEST((cached[0] == expected[0]));
+    BOOST_TEST(cached[2].back() == static_cast<uint8_t>(expected[2].back() + 1));
+}
+
+BOOST_AUTO_TEST_CASE(KeyMismatch)
+{
+    BOOST_TEST((convert(0, cacheDir) == convert(0)));
+    const std::vector<bfs::path> cacheFiles = getCacheFiles();
+    BOOST_TEST_REQUIRE(cacheFiles.size() == 1u);
+
+    // Different sounds -> Converted again and the old cache is removed
+    const SoundData expected = convert(1);
+    BOOST_TEST((expected != convert(0)));
+    BOOST_TEST((convert(1, cacheDir) == expected));
+    std::vector<bfs::path> newCacheFiles = getCacheFiles();
+    BOOST_TEST_REQUIRE(newCacheFiles.size() == 1u);
+    BOOST_TEST(newCacheFiles[0] != cacheFiles[0]);
+
+    // Different script
+    writeFile(scriptPath, "0 11025\n");
+    const SoundData expectedScript = convert(1);
+    BOOST_TEST((expectedScript[2] != expected[2]));
+    BOOST_TEST((convert(1, cacheDir) == expectedScript));
+    BOOST_TEST_REQUIRE(getCacheFiles().size() == 1u);
+    BOOST_TEST(getCacheFiles()[0] != newCacheFiles[0]);
+}
+
+BOOST_AUTO_TEST_CASE(BrokenCacheIsIgnored)
+{
+    const SoundData expected = convert(0);
+    convert(0, cacheDir);
+    BOOST_TEST_REQUIRE(getCacheFiles().size() == 1u);
+    const bfs::path cacheFile = getCacheFiles()[0];
+    const uint64_t cacheSize = bfs::file_size(cacheFile);
+
+    // Truncated
+    bfs::resize_file(cacheFile, cacheSize / 2u);
+    BOOST_TEST((convert(0, cacheDir) == expected));
+    // Cache is written again
+    BOOST_TEST(bfs::file_size(cacheFile) == cacheSize);
+
+    // Garbage
+    writeFile(cacheFile, "Not a sound cache");
+    BOOST_TEST((convert(0, cacheDir) == expected));
+    BOOST_TEST(bfs::file_size(cacheFile) == cacheSize);
+
+    // Empty
+    writeFile(cacheFile, "");
+    BOOST_TEST((convert(0, cacheDir) == expected));
+    BOOST_TEST(bfs::file_size(cacheFile) == cacheSize);
+}
+
+BOOST_AUTO_TEST_CASE(KeyedOnSourceFile)
+{
+    writeFile(sourceFile, "Sounds");
+    const SoundData expected = convert(0);
+    BOOST_TEST((convert(0, cacheDir, sourceFile) == expected));
+    // Same file -> Data is not checked
+    BOOST_TEST((convert(1, cacheDir, sourceFile) == expected));
+    // File changed -> Converted again
+    writeFile(sourceFile, "Other sounds");
+    BOOST_TEST((convert(1, cacheDir, sourceFile) == convert(1)));
+    BOOST_TEST(getCacheFiles().size() == 1u);
+    // Missing file -> Fall back to the data
+    bfs::remove(sourceFile);
+    BOOST_TEST((convert(0, cacheDir, sourceFile) == expected));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -16,19 +16,28 @@
 // along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
 
 #include "rttrDefines.h" // IWYU pragma: keep
+#include "PointOutput.h"
 #include "ai/AIPlayer.h"
+#include "ai/AIInterface.h"
+#include "ai/aijh/AIConstruction.h"
+#include "ai/aijh/AIMap.h"
 #include "ai/aijh/AIPlayerJH.h"
+#include "ai/aijh/AIReachability.h"
+#include "ai/aijh/AIResourceMap.h"
 #include "buildings/noBuilding.h"
 #include "buildings/noBuildingSite.h"
 #include "buildings/nobBaseWarehouse.h"
 #include "buildings/nobMilitary.h"
 #include "factories/AIFactory.h"
 #include "factories/BuildingFactory.h"
+#include "helpers/containerUtils.h"
+#include "pathfinding/RoadPathFinder.h"
 #include "worldFixtures/WorldWithGCExecution.h"
 #include "nodeObjs/noFlag.h"
 #include "nodeObjs/noTree.h"
 #include "gameData/BuildingProperties.h"
 #include <boost/test/unit_test.hpp>
+#include <limits>
 #include <memory>
 
 // We need border land
@@ -149,6 +158,57 @@ BOOST_FIXTURE_TEST_CASE(KeepBQUpdated, BiggerWorldWithGCExecution)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(AIMapIsUpdated, BiggerWorldWithGCExecution)
+{
+    auto ai = AIFactory::Create(AI::Info(AI::DEFAULT, AI::HARD), curPlayer, world);
+    const AIJH::AIPlayerJH& aijh = static_cast<AIJH::AIPlayerJH&>(*ai);
+    // Incremental updates must give the same result as a full recalculation
+    const auto checkNodes = [this, &aijh]() {
+        AIJH::AIMap expected;
+        expected.Resize(world.GetSize());
+        AIJH::AIReachability reachability(world, curPlayer, expected);
+        reachability.Init();
+        RTTR_FOREACH_PT(MapPoint, world.GetSize())
+        {
+            BOOST_TEST_INFO(pt);
+            BOOST_TEST_REQUIRE(aijh.GetAINode(pt).reachable == expected[pt].reachable);
+            // Values refreshed from the notifications
+            BOOST_TEST_REQUIRE(aijh.GetAINode(pt).bq == world.GetBQ(pt, curPlayer));
+            BOOST_TEST_REQUIRE(aijh.GetAINode(pt).owned == (world.GetNode(pt).owner == curPlayer + 1));
+            BOOST_TEST_REQUIRE(aijh.GetAINode(pt).border == (world.GetNode(pt).boundary_stones[0] == curPlayer + 1));
+        }
+    };
+    const auto runGF = [this, &ai]() {
+        em.ExecuteNextGF();
+        ai->RunGF(em.GetCurrentGF(), true);
+    };
+    checkNodes();
+    BOOST_TEST(aijh.GetAINode(world.GetNeighbour(hqPos, Direction::SOUTHEAST)).reachable);
+
+    const MapPoint flagPos = world.MakeMapPoint(world.GetNeighbour(hqPos, Direction::SOUTHEAST) + Position(4, 0));
+    this->SetFlag(flagPos);
+    runGF();
+    checkNodes();
+    this->BuildRoad(flagPos, false, std::vector<Direction>(4, Direction::WEST));
+    runGF();
+    checkNodes();
+    this->DestroyFlag(flagPos);
+    runGF();
+    checkNodes();
+
+    // Gain land
+    const MapPoint bldPos = world.MakeMapPoint(hqPos + Position(6, 0));
+    this->SetBuildingSite(bldPos, BLD_BARRACKS);
+    this->BuildRoad(world.GetNeighbour(bldPos, Direction::SOUTHEAST), false, std::vector<Direction>(6, Direction::WEST));
+    RTTR_EXEC_TILL(2000, world.GetSpecObj<noBuilding>(bldPos));
+    const nobMilitary* bld = world.GetSpecObj<nobMilitary>(bldPos);
+    for(unsigned i = 0; i < 500 && bld->GetNumTroops() == 0; i++)
+        runGF();
+    BOOST_TEST_REQUIRE(bld->GetNumTroops() > 0);
+    runGF();
+    checkNodes();
+}
+
 BOOST_FIXTURE_TEST_CASE(BuildWoodIndustry, WorldWithGCExecution<1>)
 {
     // Place a few trees
@@ -214,4 +274,174 @@ BOOST_FIXTURE_TEST_CASE(ExpandWhenNoSpace, BiggerWorldWithGCExecution)
     BOOST_REQUIRE(containsBldType(bldSites, BLD_BARRACKS) || containsBldType(bldSites, BLD_GUARDHOUSE));
 }
 
+namespace {
+struct ValueAdjuster
+{
+    NodeMapBase<int>& map;
+    unsigned radius;
+    int value;
+    bool operator()(const MapPoint pt, unsigned r) const
+    {
+        map[pt] += value * (radius - r);
+        return false;
+    }
+};
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(ResourceMapMatchesSequentialCalculation, BiggerWorldWithGCExecution)
+{
+    std::vector<gc::GameCommandPtr> gcs;
+    AIInterface aii(world, gcs, curPlayer);
+    AIJH::AIMap aiMap;
+    aiMap.Resize(world.GetSize());
+    RTTR_FOREACH_PT(MapPoint, world.GetSize())
+    {
+        AIJH::Node& node = aiMap[pt];
+        node.bq = aii.GetBuildingQuality(pt);
+        node.res = AIResource::NOTHING;
+        node.owned = node.reachable = true;
+        node.farmed = false;
+    }
+    AIJH::AIResourceMap resMap(AIResource::PLANTSPACE, aii, aiMap);
+    resMap.Init();
+    NodeMapBase<int> expected;
+    expected.Resize(world.GetSize());
+    RTTR_FOREACH_PT(MapPoint, world.GetSize())
+        expected[pt] = resMap[pt];
+
+    // Include radii bigger than the map which touch nodes multiple times
+    const std::vector<unsigned> radii = {0, 1, 3, 7, 11, 15};
+    std::vector<MapPoint> changePts = {MapPoint(0, 0), hqPos, MapPoint(world.GetWidth() - 1, world.GetHeight() - 1), MapPoint(5, 13)};
+    int value = 3;
+    for(const unsigned radius : radii)
+    {
+        for(const MapPoint& pt : changePts)
+        {
+            resMap.Change(pt, radius, value);
+            world.CheckPointsInRadius(pt, radius, ValueAdjuster{expected, radius, value}, true);
+            value = -value + 1;
+        }
+    }
+    const AIJH::AIResourceMap& constResMap = resMap;
+    RTTR_FOREACH_PT(MapPoint, world.GetSize())
+    {
+        BOOST_TEST_INFO(pt);
+        BOOST_TEST(constResMap[pt] == expected[pt]);
+    }
+
+    // Best position is the first one with the highest value in the order of GetPointsInRadiusWithCenter
+    aiMap[MapPoint(3, 3)].farmed = true;
+    for(const unsigned radius : {2u, 5u, 10u, 11u})
+    {
+        for(const MapPoint& pt : changePts)
+        {
+            MapPoint expectedPt = MapPoint::Invalid();
+            int bestValue = 0;
+            for(const MapPoint curPt : world.GetPointsInRadiusWithCenter(pt, radius))
+            {
+                if(expected[curPt] > bestValue && !aiMap[curPt].farmed && canUseBq(aiMap[curPt].bq, BQ_HUT))
+                {
+                    expectedPt = curPt;
+                    bestValue = expected[curPt];
+                }
+            }
+            BOOST_TEST_INFO(pt << " r=" << radius);
+            BOOST_TEST(resMap.FindBestPosition(pt, BQ_HUT, radius) == expectedPt);
+        }
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(ConnectFlagToRoadSystem, BiggerWorldWithGCExecution)
+{
+    auto ai = AIFactory::Create(AI::Info(AI::DEFAULT, AI::HARD), curPlayer, world);
+    AIJH::AIPlayerJH& aijh = static_cast<AIJH::AIPlayerJH&>(*ai);
+    const noFlag& hqFlag = *world.GetSpecObj<noFlag>(world.GetNeighbour(hqPos, Direction::SOUTHEAST));
+    const MapPoint roadFlagPos = world.MakeMapPoint(hqFlag.GetPos() + Position(4, 0));
+    this->SetFlag(roadFlagPos);
+    this->BuildRoad(roadFlagPos, false, std::vector<Direction>(4, Direction::WEST));
+    const MapPoint newFlagPos = world.MakeMapPoint(hqFlag.GetPos() + Position(0, 4));
+    this->SetFlag(newFlagPos);
+    const noFlag* roadFlag = world.GetSpecObj<noFlag>(roadFlagPos);
+    const noFlag* newFlag = world.GetSpecObj<noFlag>(newFlagPos);
+    BOOST_REQUIRE(roadFlag && newFlag);
+
+    // All costs are found in one search and match the single searches
+    const auto costs = world.GetRoadPathFinder().FindAllCosts(hqFlag);
+    BOOST_TEST_REQUIRE(costs.size() == 2u);
+    BOOST_TEST(costs[0].first == &hqFlag);
+    BOOST_TEST(costs[0].second == 0u);
+    BOOST_TEST(costs[1].first == roadFlag);
+    unsigned length;
+    BOOST_TEST_REQUIRE(world.GetRoadPathFinder().FindPath(*roadFlag, hqFlag, false, std::numeric_limits<unsigned>::max(), nullptr, &length));
+    BOOST_TEST(costs[1].second == length);
+
+    em.ExecuteNextGF();
+    std::vector<Direction> route;
+    BOOST_TEST_REQUIRE(aijh.GetConstruction().ConnectFlagToRoadSytem(newFlag, route));
+    // Route is buildable and ends at a connected flag
+    BOOST_TEST_REQUIRE(!route.empty());
+    MapPoint curPt = newFlagPos;
+    for(unsigned i = 0; i + 1u < route.size(); i++)
+    {
+        curPt = world.GetNeighbour(curPt, route[i]);
+        BOOST_TEST_INFO(curPt);
+        BOOST_TEST(world.IsRoadAvailable(false, curPt));
+    }
+    curPt = world.GetNeighbour(curPt, route.back());
+    BOOST_TEST((curPt == hqFlag.GetPos() || curPt == roadFlagPos));
+
+    // Nothing to do when already connected
+    this->BuildRoad(newFlagPos, false, route);
+    em.ExecuteNextGF();
+    BOOST_TEST(!aijh.GetConstruction().ConnectFlagToRoadSytem(newFlag, route));
+}
+
+BOOST_FIXTURE_TEST_CASE(ConnectFlagToRoadSystemNeedsFlagSpace, BiggerWorldWithGCExecution)
+{
+    // Corridor from the new flag west to the HQ flag surrounded by trees
+    const MapPoint hqFlagPos = world.GetNeighbour(hqPos, Direction::SOUTHEAST);
+    const MapPoint newFlagPos = world.MakeMapPoint(hqFlagPos + Position(4, 0));
+    std::vector<MapPoint> corridor;
+    for(int i = 1; i <= 3; i++)
+        corridor.push_back(world.MakeMapPoint(hqFlagPos + Position(i, 0)));
+    // Point reached on the 2nd step of the road
+    const MapPoint evenStepPt = corridor[1];
+    const MapPoint blockingFlagPos = world.GetNeighbour(evenStepPt, Direction::NORTHWEST);
+    this->SetFlag(newFlagPos);
+    const noFlag* newFlag = world.GetSpecObj<noFlag>(newFlagPos);
+    BOOST_REQUIRE(newFlag);
+    std::vector<MapPoint> treePts;
+    for(const MapPoint& center : {corridor[0], corridor[1], corridor[2], newFlagPos})
+    {
+        for(const MapPoint& pt : world.GetPointsInRadius(center, 2))
+        {
+            if(!world.GetNode(pt).obj && pt != blockingFlagPos && !helpers::contains(corridor, pt))
+            {
+                world.SetNO(pt, new noTree(pt, 0, 3));
+                treePts.push_back(pt);
+            }
+        }
+    }
+    for(const MapPoint& pt : treePts)
+        world.RecalcBQAroundPointBig(pt);
+    BOOST_TEST_REQUIRE(world.GetBQ(evenStepPt, curPlayer) != BQ_NOTHING);
+
+    auto ai = AIFactory::Create(AI::Info(AI::DEFAULT, AI::HARD), curPlayer, world);
+    AIJH::AIPlayerJH& aijh = static_cast<AIJH::AIPlayerJH&>(*ai);
+    em.ExecuteNextGF();
+    std::vector<Direction> route;
+    BOOST_TEST_REQUIRE(aijh.GetConstruction().ConnectFlagToRoadSytem(newFlag, route));
+    BOOST_TEST((route == std::vector<Direction>(4, Direction::WEST)));
+
+    // A flag next to the point of the 2nd step leaves no space for a flag there -> No route left
+    this->SetFlag(blockingFlagPos);
+    BOOST_TEST_REQUIRE(world.GetSpecObj<noFlag>(blockingFlagPos));
+    BOOST_TEST_REQUIRE(world.GetBQ(evenStepPt, curPlayer) == BQ_NOTHING);
+    BOOST_TEST_REQUIRE(world.IsRoadAvailable(false, evenStepPt));
+    em.ExecuteNextGF();
+    route.clear();
+    BOOST_TEST(!aijh.GetConstruction().ConnectFlagToRoadSytem(newFlag, route));
+    BOOST_TEST(route.empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,134 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "AIMatch.h"
+#include "AsyncChecksum.h"
+#include "EventManager.h"
+#include "Game.h"
+#include "helpers/ThreadPool.h"
+#include "network/GameClient.h"
+#include "random/Random.h"
+#include "worldFixtures/CreateEmptyWorld.h"
+#include <boost/test/unit_test.hpp>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+/// Restores the local player of the client changed by AIMatch::InitProcess
+struct AIMatchFixture
+{
+    const unsigned oldPlayerId;
+    AIMatchFixture() : oldPlayerId(GAMECLIENT.GetPlayerId()) { AIMatch::InitProcess(); }
+    ~AIMatchFixture() { GAMECLIENT.SetTestPlayerId(oldPlayerId); }
+};
+
+/// Run a match on an empty world. Must not use any BOOST_* checks as it may be run on another thread
+AIMatchResult runMatch(uint64_t seed)
+{
+    AIMatch match(std::vector<AI::Info>(2, AI::Info(AI::DEFAULT, AI::HARD)), GlobalGameSettings(), seed);
+    if(!CreateEmptyWorld(MapExtent(40, 32))(match.GetGame().world_))
+        throw std::runtime_error("Could not create the world");
+    // The world creation resets the RNG
+    RANDOM.Init(seed);
+    return match.Run(1000);
+}
+
+/// Run a game without active AIs, optionally skipping idle GFs. Return the checksum after numGFs GFs and the number of skipped GFs
+std::pair<unsigned, unsigned> runIdleGame(unsigned numGFs, bool skipIdleGFs)
+{
+    AIMatch match(std::vector<AI::Info>(2, AI::Info(AI::DUMMY)), GlobalGameSettings(), 1);
+    Game& game = match.GetGame();
+    BOOST_TEST_REQUIRE(CreateEmptyWorld(MapExtent(40, 32))(game.world_));
+    RANDOM.Init(1);
+    game.Start(false);
+    unsigned numSkipped = 0;
+    while(game.em_->GetCurrentGF() < numGFs)
+    {
+        if(skipIdleGFs)
+        {
+            // The statistic is updated every 750 GFs
+            BOOST_TEST(game.GetNextActiveGF() <= (game.em_->GetCurrentGF() / 750u + 1u) * 750u);
+            numSkipped += game.SkipIdleGFs(numGFs - 1);
+        }
+        game.RunGF();
+    }
+    BOOST_TEST(game.em_->GetCurrentGF() == numGFs);
+    return std::make_pair(AsyncChecksum::create(game).getHash(), numSkipped);
+}
+
+void checkEqual(const AIMatchResult& lhs, const AIMatchResult& rhs)
+{
+    BOOST_TEST(lhs.seed == rhs.seed);
+    BOOST_TEST(lhs.numGFs == rhs.numGFs);
+    BOOST_TEST(lhs.checksum == rhs.checksum);
+    BOOST_TEST_REQUIRE(lhs.players.size() == rhs.players.size());
+    for(unsigned i = 0; i < lhs.players.size(); i++)
+    {
+        BOOST_TEST(lhs.players[i].country == rhs.players[i].country);
+        BOOST_TEST(lhs.players[i].buildings == rhs.players[i].buildings);
+        BOOST_TEST(lhs.players[i].military == rhs.players[i].military);
+    }
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(AIMatchSuite, AIMatchFixture)
+
+BOOST_AUTO_TEST_CASE(RunsMatch)
+{
+    const AIMatchResult result = runMatch(42);
+    BOOST_TEST(result.seed == 42u);
+    BOOST_TEST(result.numGFs == 1000u);
+    BOOST_TEST(!result.isFinished);
+    BOOST_TEST_REQUIRE(result.players.size() == 2u);
+    for(const AIMatchResult::Player& player : result.players)
+    {
+        BOOST_TEST(!player.isDefeated);
+        // The AIs have done something
+        BOOST_TEST(player.buildings > 1u);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ParallelMatchesAreDeterministic)
+{
+    const unsigned numMatches = 4;
+    std::vector<AIMatchResult> expectedResults;
+    for(unsigned i = 0; i < numMatches; i++)
+        expectedResults.push_back(runMatch(i));
+    // Different seeds -> Different games
+    BOOST_TEST(expectedResults[0].checksum != expectedResults[1].checksum);
+
+    std::vector<AIMatchResult> results(numMatches);
+    helpers::ThreadPool threadPool(3);
+    threadPool.parallelFor(numMatches, [&results](size_t i) { results[i] = runMatch(i); });
+    for(unsigned i = 0; i < numMatches; i++)
+        checkEqual(results[i], expectedResults[i]);
+}
+
+BOOST_AUTO_TEST_CASE(SkippingIdleGFsKeepsGame)
+{
+    const unsigned numGFs = 3000;
+    const std::pair<unsigned, unsigned> expected = runIdleGame(numGFs, false);
+    const std::pair<unsigned, unsigned> result = runIdleGame(numGFs, true);
+    BOOST_TEST(result.first == expected.first);
+    BOOST_TEST(expected.second == 0u);
+    // Only a few warehouse events in an empty world
+    BOOST_TEST(result.second > numGFs / 2u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
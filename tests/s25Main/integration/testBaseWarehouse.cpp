@@ -16,14 +16,19 @@
 // along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
 
 #include "rttrDefines.h" // IWYU pragma: keep
+#include "FindWhConditions.h"
+#include "GameObject.h"
 #include "GamePlayer.h"
 #include "RTTR_AssertError.h"
+#include "buildings/noBaseBuilding.h"
 #include "buildings/nobBaseWarehouse.h"
 #include "factories/BuildingFactory.h"
 #include "worldFixtures/CreateEmptyWorld.h"
 #include "worldFixtures/WorldFixture.h"
+#include "nodeObjs/noFlag.h"
 #include "gameTypes/GoodTypes.h"
 #include "gameTypes/JobTypes.h"
+#include "gameData/BuildingConsts.h"
 #include "gameData/ShieldConsts.h"
 #include <rttr/test/LogAccessor.hpp>
 #include <boost/test/unit_test.hpp>
@@ -173,3 +178,113 @@ BOOST_FIXTURE_TEST_CASE(OrderJob, EmptyWorldFixture1P)
     BOOST_TEST_REQUIRE(hq->GetNumRealFigures(JOB_BUILDER) == 0u);
     BOOST_TEST_REQUIRE(hq->GetNumRealWares(GD_HAMMER) == 0u);
 }
+
+namespace {
+void checkWarehousesInventory(const GamePlayer& player)
+{
+    const VirtualInventory& whsInventory = player.GetWarehousesInventory();
+    VirtualInventory expected;
+    for(const nobBaseWarehouse* wh : player.GetBuildingRegister().GetStorehouses())
+    {
+        for(unsigned i = 0; i < NUM_WARE_TYPES; i++)
+        {
+            expected.visual.Add(GoodType(i), wh->GetNumVisualWares(GoodType(i)));
+            expected.real.Add(GoodType(i), wh->GetNumRealWares(GoodType(i)));
+        }
+        for(unsigned i = 0; i < NUM_JOB_TYPES; i++)
+        {
+            expected.visual.Add(Job(i), wh->GetNumVisualFigures(Job(i)));
+            expected.real.Add(Job(i), wh->GetNumRealFigures(Job(i)));
+        }
+    }
+    BOOST_TEST(whsInventory.visual.goods == expected.visual.goods, boost::test_tools::per_element());
+    BOOST_TEST(whsInventory.visual.people == expected.visual.people, boost::test_tools::per_element());
+    BOOST_TEST(whsInventory.real.goods == expected.real.goods, boost::test_tools::per_element());
+    BOOST_TEST(whsInventory.real.people == expected.real.people, boost::test_tools::per_element());
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(WarehousesInventory, EmptyWorldFixture1P)
+{
+    GamePlayer& player = world.GetPlayer(0);
+    auto* hq = world.GetSpecObj<nobBaseWarehouse>(player.GetHQPos());
+    checkWarehousesInventory(player);
+    // Added after the sum was created
+    auto* wh = static_cast<nobBaseWarehouse*>(
+      BuildingFactory::CreateBuilding(world, BLD_STOREHOUSE, player.GetHQPos() + MapPoint(4, 0), 0, NAT_ROMANS));
+    world.BuildRoad(0, false, hq->GetFlagPos(), {4, Direction::EAST});
+    checkWarehousesInventory(player);
+
+    const unsigned numCoins = player.GetWarehousesInventory()[GD_COINS];
+    BOOST_TEST(!player.FindWarehouse(*wh, FW::HasMinWares(GD_COINS, numCoins + 1u), false, false));
+    Inventory goods;
+    goods.Add(GD_COINS, numCoins + 1u);
+    wh->AddGoods(goods, true);
+    checkWarehousesInventory(player);
+    BOOST_TEST(player.FindWarehouse(*hq, FW::HasMinWares(GD_COINS, numCoins + 1u), false, false) == wh);
+
+    // Changes of only the real part
+    while(hq->GetNumRealFigures(JOB_BUILDER) > 0u)
+        BOOST_TEST_REQUIRE(hq->OrderJob(JOB_BUILDER, wh, false));
+    checkWarehousesInventory(player);
+    BOOST_TEST(player.GetWarehousesInventory().real[JOB_BUILDER] == 0u);
+    BOOST_TEST(!player.FindWarehouse(*wh, FW::HasFigure(JOB_BUILDER, false), false, false));
+
+    // Destroyed warehouse is removed from the sum
+    world.DestroyFlag(wh->GetFlagPos(), 0);
+    checkWarehousesInventory(player);
+    BOOST_TEST(player.GetWarehousesInventory()[GD_COINS] == numCoins);
+}
+
+namespace {
+/// Adds boards one by one to a warehouse when its event is executed
+class AddBoardsEventHandler : public GameObject
+{
+public:
+    nobBaseWarehouse& wh;
+    unsigned numBoards;
+
+    AddBoardsEventHandler(nobBaseWarehouse& wh, unsigned numBoards) : wh(wh), numBoards(numBoards) {}
+
+    void HandleEvent(unsigned) override
+    {
+        const unsigned startBoards = wh.GetNumRealWares(GD_BOARDS);
+        for(unsigned i = 1; i <= numBoards; i++)
+        {
+            Inventory goods;
+            goods.Add(GD_BOARDS);
+            wh.AddGoods(goods, true);
+            // Search for building sites is delayed till the end of the GF
+            BOOST_TEST_REQUIRE(wh.GetNumRealWares(GD_BOARDS) == startBoards + i);
+        }
+    }
+    // LCOV_EXCL_START
+    void Destroy() override {}
+    void Serialize(SerializedGameData&) const override {}
+    GO_Type GetGOT() const override { return GOT_UNKNOWN; }
+    // LCOV_EXCL_STOP
+};
+
+using EmptyWorldFixture1PBig = WorldFixture<CreateEmptyWorld, 1, 20, 20>;
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(NewWaresOrderedOncePerGF, EmptyWorldFixture1PBig)
+{
+    GamePlayer& player = world.GetPlayer(0);
+    // Empty storehouse not connected to the HQ but connected to a building site
+    auto* wh = static_cast<nobBaseWarehouse*>(
+      BuildingFactory::CreateBuilding(world, BLD_STOREHOUSE, player.GetHQPos() + MapPoint(4, 0), 0, NAT_ROMANS));
+    const MapPoint bldPos = wh->GetPos() + MapPoint(4, 0);
+    world.SetBuildingSite(BLD_WOODCUTTER, bldPos, 0);
+    world.BuildRoad(0, false, wh->GetFlagPos(), {4, Direction::EAST});
+    BOOST_TEST_REQUIRE(world.GetSpecObj<noBaseBuilding>(bldPos)->GetFlag()->GetRoute(Direction::WEST));
+    BOOST_TEST_REQUIRE(wh->GetNumRealWares(GD_BOARDS) == 0u);
+
+    const unsigned numBoardsRequired = BUILDING_COSTS[player.nation][BLD_WOODCUTTER].boards;
+    const unsigned numBoards = numBoardsRequired + 2u;
+    AddBoardsEventHandler evHandler(*wh, numBoards);
+    em.AddEvent(&evHandler, 1);
+    em.ExecuteNextEvent();
+    // Only after all events the site ordered exactly the boards it needs
+    BOOST_TEST(wh->GetNumRealWares(GD_BOARDS) == numBoards - numBoardsRequired);
+}
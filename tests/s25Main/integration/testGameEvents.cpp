@@ -242,4 +242,59 @@ BOOST_AUTO_TEST_CASE(InvalidEvent)
 #endif
 }
 
+namespace {
+/// Requests a callback on each event, but only the first per GF is added
+class CoalescingEventHandler : public GameObject
+{
+public:
+    EventManager& em;
+    std::vector<unsigned> handledEventIds;
+    std::vector<std::vector<unsigned>> callbackResults;
+    bool isCallbackScheduled = false;
+
+    explicit CoalescingEventHandler(EventManager& em) : em(em) {}
+    void HandleEvent(unsigned evId) override
+    {
+        BOOST_TEST(em.IsExecutingEvents());
+        handledEventIds.push_back(evId);
+        if(isCallbackScheduled)
+            return;
+        isCallbackScheduled = true;
+        em.AddPostEventsCallback([this]() {
+            BOOST_TEST(!em.IsExecutingEvents());
+            isCallbackScheduled = false;
+            callbackResults.push_back(handledEventIds);
+            handledEventIds.clear();
+        });
+    }
+    // LCOV_EXCL_START
+    void Destroy() override {}
+    void Serialize(SerializedGameData&) const override {}
+    GO_Type GetGOT() const override { return GOT_UNKNOWN; }
+    // LCOV_EXCL_STOP
+};
+} // namespace
+
+BOOST_AUTO_TEST_CASE(PostEventsCallback)
+{
+    TestEventManager evMgr(0);
+    CoalescingEventHandler obj(evMgr);
+    BOOST_TEST(!evMgr.IsExecutingEvents());
+    evMgr.AddEvent(&obj, 2, 1);
+    evMgr.AddEvent(&obj, 2, 2);
+    evMgr.AddEvent(&obj, 2, 3);
+    evMgr.AddEvent(&obj, 3, 4);
+    evMgr.ExecuteNextGF();
+    BOOST_TEST(obj.callbackResults.empty());
+    // Callback is executed once after all events of the GF
+    evMgr.ExecuteNextGF();
+    BOOST_TEST_REQUIRE(obj.callbackResults.size() == 1u);
+    BOOST_TEST(obj.callbackResults[0] == std::vector<unsigned>({1, 2, 3}), boost::test_tools::per_element());
+    // Also when skipping GFs
+    BOOST_TEST(evMgr.ExecuteNextEvent() == 1u);
+    BOOST_TEST_REQUIRE(obj.callbackResults.size() == 2u);
+    BOOST_TEST(obj.callbackResults[1] == std::vector<unsigned>({4}), boost::test_tools::per_element());
+    BOOST_TEST(!evMgr.IsExecutingEvents());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,174 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "AsyncChecksum.h"
+#include "GamePlayer.h"
+#include "Replay.h"
+#include "Savegame.h"
+#include "SerializedGameData.h"
+#include "buildings/nobUsual.h"
+#include "factories/BuildingFactory.h"
+#include "network/ClientInterface.h"
+#include "network/GameClient.h"
+#include "network/PlayerGameCommands.h"
+#include "uiHelper/uiHelpers.hpp"
+#include "worldFixtures/CreateEmptyWorld.h"
+#include "worldFixtures/GCCollector.h"
+#include "worldFixtures/WorldFixture.h"
+#include "nodeObjs/noFire.h"
+#include "random/Random.h"
+#include "gameTypes/MapInfo.h"
+#include "libutil/tmpFile.h"
+#include <boost/filesystem/operations.hpp>
+#include <boost/test/unit_test.hpp>
+#include <map>
+#include <memory>
+
+BOOST_AUTO_TEST_SUITE(ReplaySkipSuite)
+
+namespace {
+/// Length of the recorded replay. Keyframes are added every 100 GFs and commands 50 GFs after each keyframe
+const unsigned REPLAY_LEN = 350;
+
+/// Record a replay starting from a savegame to filePath.
+/// Return the checksum at the start of each GF (before the commands of that GF are executed)
+std::map<unsigned, AsyncChecksum> recordReplay(const std::string& filePath, unsigned& startGF)
+{
+    WorldFixture<CreateEmptyWorld, 2> fixture;
+    GameWorld& world = fixture.world;
+    const MapPoint hqPos = world.GetPlayer(0).GetHQPos();
+    const MapPoint usualBldPos = world.MakeMapPoint(hqPos + Position(3, 0));
+    auto* usualBld = static_cast<nobUsual*>(BuildingFactory::CreateBuilding(world, BLD_WOODCUTTER, usualBldPos, 0, NAT_VIKINGS));
+    world.BuildRoad(0, false, world.GetNeighbour(hqPos, Direction::SOUTHEAST), std::vector<Direction>(3, Direction::EAST));
+    usualBld->is_working = true;
+    for(const MapPoint& pt : {world.MakeMapPoint(hqPos + Position(8, 0)), world.MakeMapPoint(hqPos + Position(9, 0))})
+        world.SetNO(pt, new noFire(pt, false));
+
+    startGF = fixture.em.GetCurrentGF();
+    MapInfo map;
+    map.type = MAPTYPE_SAVEGAME;
+    map.title = "MapTitle";
+    map.filepath = "Map.swd";
+    map.savegame = std::make_unique<Savegame>();
+    for(unsigned i = 0; i < world.GetNumPlayers(); i++)
+        map.savegame->AddPlayer(world.GetPlayer(i));
+    map.savegame->ggs = fixture.ggs;
+    map.savegame->start_gf = startGF;
+    map.savegame->sgd.MakeSnapshot(fixture.game);
+
+    Replay replay;
+    for(unsigned i = 0; i < world.GetNumPlayers(); i++)
+        replay.AddPlayer(world.GetPlayer(i));
+    replay.ggs = fixture.ggs;
+    replay.random_init = 815;
+    // The replay starts with this RNG state
+    RANDOM.Init(replay.random_init);
+    BOOST_REQUIRE(replay.StartRecording(filePath, map));
+
+    std::map<unsigned, AsyncChecksum> checksums;
+    const unsigned endGF = startGF + REPLAY_LEN;
+    while(fixture.em.GetCurrentGF() < endGF)
+    {
+        const unsigned curGF = fixture.em.GetCurrentGF();
+        checksums[curGF] = AsyncChecksum::create(*fixture.game);
+        if((curGF - startGF) % 100 == 0 && curGF != startGF)
+        {
+            auto sgd = std::make_unique<SerializedGameData>();
+            sgd->MakeSnapshot(fixture.game);
+            replay.AddKeyframe(curGF, std::move(sgd), RANDOM.GetCurrentState());
+        }
+        if((curGF - startGF) % 100 == 50)
+        {
+            GCCollector collector;
+            collector.SetFlag(world.MakeMapPoint(hqPos + Position((curGF - startGF) / 50, 4)));
+            PlayerGameCommands cmds;
+            cmds.checksum = checksums[curGF];
+            cmds.gcs = collector.gcs;
+            replay.AddGameCommand(curGF, 0, cmds);
+            for(const gc::GameCommandPtr& gc : cmds.gcs)
+                gc->Execute(world, 0);
+        }
+        fixture.game->RunGF();
+        replay.UpdateLastGF(curGF);
+    }
+    checksums[endGF] = AsyncChecksum::create(*fixture.game);
+    replay.StopRecording();
+    BOOST_REQUIRE(replay.GetLastErrorMsg().empty());
+    return checksums;
+}
+
+/// Keeps the game currently used by the client
+struct ReplayClient : public ClientInterface
+{
+    std::shared_ptr<Game> game;
+
+    ReplayClient() { GAMECLIENT.SetInterface(this); }
+    ~ReplayClient() override { GAMECLIENT.RemoveInterface(this); }
+    void CI_GameLoading(const std::shared_ptr<Game>& newGame) override { game = newGame; }
+};
+
+/// Jump to the GF and finish loading a keyframe like the loading screen does
+void skipToGF(unsigned gf)
+{
+    GAMECLIENT.SkipGF(gf);
+    if(GAMECLIENT.GetState() == GameClient::CS_LOADING)
+    {
+        BOOST_TEST_REQUIRE(GAMECLIENT.LoadPendingReplayKeyframe());
+        GAMECLIENT.GameLoaded();
+    }
+    BOOST_TEST_REQUIRE(GAMECLIENT.GetState() == GameClient::CS_GAME);
+    BOOST_TEST(GAMECLIENT.IsPaused());
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(SkipMatchesLinearPlayback, uiHelper::Fixture)
+{
+    TmpFile tmpFile;
+    BOOST_REQUIRE(tmpFile.isValid());
+    tmpFile.close();
+    bfs::remove(tmpFile.filePath);
+    unsigned startGF;
+    const std::map<unsigned, AsyncChecksum> checksums = recordReplay(tmpFile.filePath, startGF);
+
+    ReplayClient client;
+    BOOST_REQUIRE(GAMECLIENT.StartReplay(tmpFile.filePath));
+    GAMECLIENT.GameLoaded();
+    BOOST_TEST_REQUIRE(GAMECLIENT.GetState() == GameClient::CS_GAME);
+    GAMECLIENT.OnGameStart();
+    BOOST_TEST_REQUIRE(client.game);
+
+    // Forward without a keyframe in between, forward exactly to a keyframe, forward beyond a keyframe,
+    // back to before the current keyframe and forward from a loaded keyframe without loading another one
+    for(unsigned offset : {80u, 200u, 340u, 150u, 199u})
+    {
+        const unsigned targetGF = startGF + offset;
+        skipToGF(targetGF);
+        BOOST_TEST_INFO("Target GF " << targetGF);
+        BOOST_TEST_REQUIRE(GAMECLIENT.GetGFNumber() == targetGF);
+        BOOST_TEST_INFO("Target GF " << targetGF);
+        BOOST_TEST((AsyncChecksum::create(*client.game) == checksums.at(targetGF)));
+    }
+    // Jumping to the current GF does nothing
+    skipToGF(startGF + 199);
+    BOOST_TEST(GAMECLIENT.GetGFNumber() == startGF + 199);
+
+    GAMECLIENT.Stop();
+    BOOST_TEST(!GAMECLIENT.IsReplayModeOn());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
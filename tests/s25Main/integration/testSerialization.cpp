@@ -28,14 +28,20 @@
 #include "factories/GameCommandFactory.h"
 #include "network/PlayerGameCommands.h"
 #include "worldFixtures/CreateEmptyWorld.h"
+#include "worldFixtures/GCCollector.h"
 #include "worldFixtures/WorldFixture.h"
 #include "nodeObjs/noFire.h"
+#include "random/Random.h"
 #include "gameTypes/MapInfo.h"
+#include "libutil/Serializer.h"
 #include "libutil/tmpFile.h"
 #include <rttr/test/testHelpers.hpp>
 #include <boost/filesystem/operations.hpp>
+#include <boost/nowide/fstream.hpp>
 #include <boost/test/unit_test.hpp>
+#include <cstring>
 #include <memory>
+#include <stdexcept>
 
 // LCOV_EXCL_START
 template<class T>
@@ -186,6 +192,63 @@ BOOST_AUTO_TEST_CASE(Serializer)
     BOOST_REQUIRE_EQUAL(sgd.PopVarSize(), 0xFFFFFFFFu);
 }
 
+BOOST_AUTO_TEST_CASE(GameCommandBatch)
+{
+    GCCollector cmds;
+    cmds.SetFlag(MapPoint(10, 20));
+    cmds.SetFlag(MapPoint(12, 19));
+    cmds.BuildRoad(MapPoint(12, 19), false, std::vector<Direction>(3, Direction::WEST));
+    // Big and wrapping differences
+    cmds.DestroyFlag(MapPoint(1000, 0));
+    cmds.DestroyFlag(MapPoint(0, 65535));
+    cmds.Surrender();
+    cmds.Attack(MapPoint(3, 4), 200, true);
+    cmds.SuggestPact(2, TREATY_OF_ALLIANCE, 0xFFFFFFFF);
+    cmds.ChangeReserve(MapPoint(3, 5), 1, 300);
+    cmds.SetCoinsAllowed(MapPoint(3, 5), false);
+    cmds.SetCoinsAllowed(MapPoint(4, 5), true);
+
+    ::Serializer ser;
+    gc::GameCommand::SerializeBatch(ser, cmds.gcs);
+    const std::vector<gc::GameCommandPtr> gcs = gc::GameCommand::DeserializeBatch(ser);
+    BOOST_TEST(ser.GetBytesLeft() == 0u);
+    BOOST_TEST_REQUIRE(gcs.size() == cmds.gcs.size());
+    for(unsigned i = 0; i < gcs.size(); i++)
+        BOOST_TEST(std::string(gcs[i]->GetTypeName()) == cmds.gcs[i]->GetTypeName());
+    // Same data -> same serialized data
+    ::Serializer ser2;
+    gc::GameCommand::SerializeBatch(ser2, gcs);
+    BOOST_TEST_REQUIRE(ser2.GetLength() == ser.GetLength());
+    BOOST_TEST(memcmp(ser2.GetData(), ser.GetData(), ser.GetLength()) == 0);
+
+    // Consecutive commands of the same type share the type and close points take 1 byte per coordinate
+    cmds.gcs.clear();
+    for(unsigned i = 0; i < 100u; i++)
+        cmds.SetFlag(MapPoint(5 + i, 5));
+    ser.Clear();
+    gc::GameCommand::SerializeBatch(ser, cmds.gcs);
+    // Count + run header + 100 points
+    BOOST_TEST(ser.GetLength() == 1u + 2u + 100u * 2u);
+    BOOST_TEST(gc::GameCommand::DeserializeBatch(ser).size() == 100u);
+
+    // Batch as used by the benchmarks
+    cmds.gcs.clear();
+    createBusyNWFCommands(cmds);
+    ser.Clear();
+    gc::GameCommand::SerializeBatch(ser, cmds.gcs);
+    const std::vector<gc::GameCommandPtr> busyGcs = gc::GameCommand::DeserializeBatch(ser);
+    BOOST_TEST(ser.GetBytesLeft() == 0u);
+    BOOST_TEST_REQUIRE(busyGcs.size() == cmds.gcs.size());
+    for(unsigned i = 0; i < busyGcs.size(); i++)
+        BOOST_TEST(std::string(busyGcs[i]->GetTypeName()) == cmds.gcs[i]->GetTypeName());
+
+    // Run longer than the number of commands
+    ser.Clear();
+    ser.PushVarSize(1);
+    ser.PushVarSize(1u << 6);
+    BOOST_CHECK_THROW(gc::GameCommand::DeserializeBatch(ser), std::length_error);
+}
+
 BOOST_FIXTURE_TEST_CASE(BaseSaveLoad, RandWorldFixture)
 {
     MapPoint hqPos = world.GetPlayer(0).GetHQPos();
@@ -421,6 +484,208 @@ BOOST_AUTO_TEST_CASE(ReplayWithMap)
     }
 }
 
+BOOST_AUTO_TEST_CASE(ReplayAfterCrash)
+{
+    MapInfo map;
+    map.type = MAPTYPE_OLDMAP;
+    map.title = "MapTitle";
+    map.mapData.data = std::vector<char>(42, 0x42);
+    map.mapData.length = 50;
+    std::vector<PlayerInfo> players(2);
+    players[0].ps = PS_OCCUPIED;
+    players[0].name = "Human";
+    players[1].ps = PS_AI;
+    players[1].aiInfo = AI::Info(AI::DEFAULT, AI::MEDIUM);
+
+    Replay replay;
+    for(const BasePlayerInfo& player : players)
+        replay.AddPlayer(player);
+
+    TmpFile tmpFile;
+    BOOST_REQUIRE(tmpFile.isValid());
+    tmpFile.close();
+    bfs::remove(tmpFile.filePath);
+    BOOST_REQUIRE(replay.StartRecording(tmpFile.filePath, map));
+    GlobalGameSettings ggs;
+    Game game(ggs, 0u, players);
+    PlayerGameCommands cmds = GetTestCommands().create(game).result;
+    AddReplayCmds(replay, cmds);
+    replay.StopRecording();
+    BOOST_REQUIRE(replay.GetLastErrorMsg().empty());
+
+    // Simulate an interrupted write: Start of a command and of a commit
+    {
+        bnw::ofstream file(tmpFile.filePath, std::ios::binary | std::ios::app);
+        const char partialData[] = {7, 0, 0, 0, Replay::RC_CHAT, 1, 2, 0x7F, 0, 0, 0, 'H', 'i', '\xFF', '\xFF', '\xFF', '\xFF', 9};
+        file.write(partialData, sizeof(partialData));
+    }
+
+    Replay loadReplay;
+    BOOST_REQUIRE(loadReplay.LoadHeader(tmpFile.filePath, true));
+    // Unknown till the commands are searched
+    BOOST_REQUIRE_EQUAL(loadReplay.GetLastGF(), 0u);
+    MapInfo newMap;
+    BOOST_REQUIRE(loadReplay.LoadGameData(newMap));
+    BOOST_REQUIRE_EQUAL(loadReplay.GetLastGF(), 5u);
+    RTTR_REQUIRE_EQUAL_COLLECTIONS(newMap.mapData.data, map.mapData.data);
+    // Everything after the last commit is ignored
+    CheckReplayCmds(loadReplay, cmds);
+}
+
+BOOST_AUTO_TEST_CASE(ReadReplayWhileRecording)
+{
+    MapInfo map;
+    map.type = MAPTYPE_OLDMAP;
+    map.title = "MapTitle";
+    map.mapData.data = std::vector<char>(42, 0x42);
+    map.mapData.length = 50;
+    std::vector<PlayerInfo> players(2);
+    players[0].ps = PS_OCCUPIED;
+    players[0].name = "Human";
+    players[1].ps = PS_AI;
+    players[1].aiInfo = AI::Info(AI::DEFAULT, AI::MEDIUM);
+
+    Replay replay;
+    for(const BasePlayerInfo& player : players)
+        replay.AddPlayer(player);
+
+    TmpFile tmpFile;
+    BOOST_REQUIRE(tmpFile.isValid());
+    tmpFile.close();
+    bfs::remove(tmpFile.filePath);
+    BinaryFile readFile;
+    BOOST_REQUIRE(!replay.OpenRecordedFile(readFile));
+    BOOST_REQUIRE(replay.StartRecording(tmpFile.filePath, map));
+    GlobalGameSettings ggs;
+    Game game(ggs, 0u, players);
+    PlayerGameCommands cmds = GetTestCommands().create(game).result;
+    AddReplayCmds(replay, cmds);
+
+    // All commands added so far can be read while still recording
+    BOOST_REQUIRE(replay.OpenRecordedFile(readFile));
+    readFile.Seek(0, SEEK_END);
+    std::vector<char> data(readFile.Tell());
+    readFile.Seek(0, SEEK_SET);
+    readFile.ReadRawData(data.data(), data.size());
+    readFile.Close();
+    TmpFile copiedFile;
+    BOOST_REQUIRE(copiedFile.isValid());
+    copiedFile.close();
+    {
+        bnw::ofstream file(copiedFile.filePath, std::ios::binary);
+        file.write(data.data(), data.size());
+    }
+    replay.AddChatCommand(6, 1, 1, "Not sent");
+    replay.StopRecording();
+
+    Replay loadReplay;
+    BOOST_REQUIRE(loadReplay.LoadHeader(copiedFile.filePath, true));
+    BOOST_REQUIRE_EQUAL(loadReplay.GetLastGF(), 5u);
+    MapInfo newMap;
+    BOOST_REQUIRE(loadReplay.LoadGameData(newMap));
+    CheckReplayCmds(loadReplay, cmds);
+}
+
+BOOST_FIXTURE_TEST_CASE(ReplayKeyframes, RandWorldFixture)
+{
+    MapPoint hqPos = world.GetPlayer(0).GetHQPos();
+    MapPoint usualBldPos = world.MakeMapPoint(hqPos + Position(3, 0));
+    auto* usualBld = static_cast<nobUsual*>(BuildingFactory::CreateBuilding(world, BLD_WOODCUTTER, usualBldPos, 0, NAT_VIKINGS));
+    world.BuildRoad(0, false, world.GetNeighbour(hqPos, Direction::SOUTHEAST), std::vector<Direction>(3, Direction::EAST));
+    usualBld->is_working = true;
+    for(const MapPoint& pt : {world.MakeMapPoint(hqPos + Position(8, 0)), world.MakeMapPoint(hqPos + Position(9, 0))})
+        world.SetNO(pt, new noFire(pt, false));
+
+    MapInfo map;
+    map.type = MAPTYPE_OLDMAP;
+    map.title = "MapTitle";
+    map.mapData.data = std::vector<char>(42, 0x42);
+    map.mapData.length = 50;
+    Replay replay;
+    for(unsigned i = 0; i < world.GetNumPlayers(); i++)
+        replay.AddPlayer(world.GetPlayer(i));
+    replay.ggs = ggs;
+
+    TmpFile tmpFile;
+    BOOST_REQUIRE(tmpFile.isValid());
+    tmpFile.close();
+    bfs::remove(tmpFile.filePath);
+    BOOST_REQUIRE(replay.StartRecording(tmpFile.filePath, map));
+
+    // Play linearly and record a keyframe every 100 GFs and commands in between
+    const unsigned startGF = em.GetCurrentGF();
+    const unsigned endGF = startGF + 350;
+    while(em.GetCurrentGF() < endGF)
+    {
+        const unsigned curGF = em.GetCurrentGF();
+        if((curGF - startGF) % 100 == 0)
+        {
+            auto sgd = std::make_unique<SerializedGameData>();
+            sgd->MakeSnapshot(game);
+            replay.AddKeyframe(curGF, std::move(sgd), RANDOM.GetCurrentState());
+        }
+        if((curGF - startGF) % 100 == 50)
+        {
+            PlayerGameCommands cmds = GetTestCommands().create(*game).result;
+            replay.AddGameCommand(curGF, 0, cmds);
+            for(const gc::GameCommandPtr& gc : cmds.gcs)
+                gc->Execute(world, 0);
+        }
+        game->RunGF();
+        replay.UpdateLastGF(curGF);
+    }
+    replay.StopRecording();
+    BOOST_REQUIRE(replay.GetLastErrorMsg().empty());
+    const AsyncChecksum linearChecksum = AsyncChecksum::create(*game);
+
+    Replay loadReplay;
+    BOOST_REQUIRE(loadReplay.LoadHeader(tmpFile.filePath, true));
+    MapInfo newMap;
+    BOOST_REQUIRE(loadReplay.LoadGameData(newMap));
+    const std::vector<unsigned> expectedKeyframes{startGF, startGF + 100, startGF + 200, startGF + 300};
+    const std::vector<unsigned> keyframes = loadReplay.GetKeyframeGFs();
+    RTTR_REQUIRE_EQUAL_COLLECTIONS(keyframes, expectedKeyframes);
+    unsigned keyframeGF;
+    BOOST_REQUIRE(loadReplay.FindKeyframe(startGF + 299, keyframeGF));
+    BOOST_REQUIRE_EQUAL(keyframeGF, startGF + 200);
+    BOOST_REQUIRE(loadReplay.FindKeyframe(endGF, keyframeGF));
+    BOOST_REQUIRE_EQUAL(keyframeGF, startGF + 300);
+
+    std::vector<PlayerInfo> players;
+    for(unsigned j = 0; j < loadReplay.GetNumPlayers(); j++)
+        players.push_back(PlayerInfo(loadReplay.GetPlayer(j)));
+    // Start with the last keyframe so the others need seeking backwards
+    for(auto it = expectedKeyframes.rbegin(); it != expectedKeyframes.rend(); ++it)
+    {
+        SerializedGameData sgd;
+        UsedPRNG rngState;
+        BOOST_REQUIRE(loadReplay.ReadKeyframe(*it, sgd, rngState));
+        auto loadedGame = std::make_shared<Game>(loadReplay.ggs, *it, players);
+        sgd.ReadSnapshot(loadedGame);
+        RANDOM.ResetState(rngState);
+
+        // No more commands after the last keyframe
+        unsigned nextGF;
+        BOOST_REQUIRE_EQUAL(loadReplay.ReadGF(&nextGF), *it < startGF + 300);
+        for(unsigned curGF = *it; curGF < endGF; curGF++)
+        {
+            while(nextGF == curGF)
+            {
+                BOOST_REQUIRE_EQUAL(loadReplay.ReadRCType(), Replay::RC_GAME);
+                uint8_t player;
+                PlayerGameCommands cmds;
+                loadReplay.ReadGameCommand(player, cmds);
+                for(const gc::GameCommandPtr& gc : cmds.gcs)
+                    gc->Execute(loadedGame->world_, player);
+                loadReplay.ReadGF(&nextGF);
+            }
+            loadedGame->RunGF();
+        }
+        BOOST_TEST_INFO("Keyframe " << *it);
+        BOOST_TEST((AsyncChecksum::create(*loadedGame) == linearChecksum));
+    }
+}
+
 BOOST_FIXTURE_TEST_CASE(ReplayWithSavegame, RandWorldFixture)
 {
     MapInfo map;
@@ -0,0 +1,112 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "BQOutput.h"
+#include "PointOutput.h"
+#include "worldFixtures/WorldWithGCExecution.h"
+#include "world/WorldSnapshot.h"
+#include "nodeObjs/noBase.h"
+#include <boost/test/unit_test.hpp>
+
+namespace {
+void checkSnapshotMatchesWorld(const WorldSnapshot& snapshot, const GameWorldBase& world)
+{
+    BOOST_TEST_REQUIRE(snapshot.GetSize() == world.GetSize());
+    BOOST_TEST_REQUIRE(snapshot.GetNumPlayers() == world.GetNumPlayers());
+    RTTR_FOREACH_PT(MapPoint, world.GetSize())
+    {
+        const MapNode& node = world.GetNode(pt);
+        BOOST_TEST_REQUIRE(snapshot.GetOwner(pt) == node.owner);
+        BOOST_TEST_REQUIRE(snapshot.GetBQ(pt) == node.bq);
+        BOOST_TEST_REQUIRE(snapshot.GetGOT(pt) == world.GetNO(pt)->GetGOT());
+        for(unsigned dir = 0; dir < 3; dir++)
+            BOOST_TEST_REQUIRE(snapshot.GetRoad(pt, dir) == node.roads[dir]);
+        for(unsigned player = 0; player < world.GetNumPlayers(); player++)
+            BOOST_TEST_REQUIRE(snapshot.GetVisibility(pt, player) == node.fow[player].visibility);
+    }
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(WorldSnapshots, WorldWithGCExecution2P)
+{
+    WorldSnapshotPublisher publisher;
+    // Nothing published unless enabled
+    publisher.Publish(world, 0);
+    BOOST_TEST(!publisher.GetSnapshot());
+
+    publisher.SetEnabled(true);
+    publisher.Publish(world, 5);
+    const std::shared_ptr<const WorldSnapshot> snapshot1 = publisher.GetSnapshot();
+    BOOST_TEST_REQUIRE(snapshot1);
+    BOOST_TEST(snapshot1->GetGF() == 5u);
+    checkSnapshotMatchesWorld(*snapshot1, world);
+
+    const MapPoint flagPt = hqPos + MapPoint(4, 0);
+    BOOST_TEST_REQUIRE(snapshot1->GetGOT(flagPt) == GOT_NOTHING);
+    this->SetFlag(flagPt);
+    BOOST_TEST_REQUIRE(world.GetNO(flagPt)->GetGOT() == GOT_FLAG);
+    publisher.Publish(world, 10);
+    const std::shared_ptr<const WorldSnapshot> snapshot2 = publisher.GetSnapshot();
+    BOOST_TEST_REQUIRE(snapshot2);
+    BOOST_TEST(snapshot2->GetVersion() > snapshot1->GetVersion());
+    checkSnapshotMatchesWorld(*snapshot2, world);
+    // The old snapshot is unchanged
+    BOOST_TEST(snapshot1->GetGOT(flagPt) == GOT_NOTHING);
+    BOOST_TEST(snapshot2->GetGOT(flagPt) == GOT_FLAG);
+    // Only tiles with changes are new
+    BOOST_TEST(!snapshot2->IsSameTile(*snapshot1, flagPt));
+    unsigned numSharedPts = 0;
+    RTTR_FOREACH_PT(MapPoint, world.GetSize())
+    {
+        if(snapshot2->IsSameTile(*snapshot1, pt))
+        {
+            numSharedPts++;
+            BOOST_TEST_REQUIRE(snapshot2->GetGOT(pt) == snapshot1->GetGOT(pt));
+        }
+    }
+    BOOST_TEST(numSharedPts > 0u);
+
+    // Nothing changed -> Everything shared
+    publisher.Publish(world, 15);
+    const std::shared_ptr<const WorldSnapshot> snapshot3 = publisher.GetSnapshot();
+    RTTR_FOREACH_PT(MapPoint, world.GetSize())
+        BOOST_TEST_REQUIRE(snapshot3->IsSameTile(*snapshot2, pt));
+
+    // Roads and destroyed objects are tracked too
+    const MapPoint roadEndPt = flagPt + MapPoint(2, 0);
+    this->BuildRoad(flagPt, false, std::vector<Direction>(2, Direction::EAST));
+    BOOST_TEST_REQUIRE(world.GetNO(roadEndPt)->GetGOT() == GOT_FLAG);
+    publisher.Publish(world, 20);
+    const std::shared_ptr<const WorldSnapshot> snapshot4 = publisher.GetSnapshot();
+    checkSnapshotMatchesWorld(*snapshot4, world);
+    BOOST_TEST(snapshot4->GetRoad(flagPt, 0) != 0u); // Index 0 is the road to the east
+
+    this->DestroyFlag(flagPt);
+    BOOST_TEST_REQUIRE(world.GetNO(flagPt)->GetGOT() == GOT_NOTHING);
+    publisher.Publish(world, 25);
+    const std::shared_ptr<const WorldSnapshot> snapshot5 = publisher.GetSnapshot();
+    checkSnapshotMatchesWorld(*snapshot5, world);
+    BOOST_TEST(snapshot5->GetGOT(flagPt) == GOT_NOTHING);
+    BOOST_TEST(snapshot5->GetRoad(flagPt, 0) == 0u);
+
+    publisher.SetEnabled(false);
+    BOOST_TEST(!publisher.GetSnapshot());
+    // Readers keep their snapshots
+    BOOST_TEST(snapshot3->GetGOT(flagPt) == GOT_FLAG);
+    BOOST_TEST(snapshot4->GetGOT(roadEndPt) == GOT_FLAG);
+}
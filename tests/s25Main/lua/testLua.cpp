@@ -746,6 +746,72 @@ BOOST_AUTO_TEST_CASE(WorldEvents)
     BOOST_REQUIRE_EQUAL(getLog(), (resFmt % 2 % pt3 % "Water" % 5).str());
 }
 
+BOOST_AUTO_TEST_CASE(BatchedWorldEvents)
+{
+    const MapPoint pt1(3, 4), pt2(5, 1), pt3(7, 6);
+    LuaInterfaceGame& lua = world.GetLua();
+    executeLua("function onExploredPoints(player_id, points)\n"
+               "  for _, pt in ipairs(points) do rttr:Log('explored: '..player_id..'('..pt[1]..', '..pt[2]..')'..tostring(pt[3])) end\n"
+               "end");
+    executeLua("function onOccupiedPoints(player_id, points)\n"
+               "  rttr:Log('occupied: '..player_id..':'..#points)\n"
+               "end");
+    clearLog();
+    lua.EventExplored(1, pt1, 0);
+    lua.EventExplored(0, pt2, 2);
+    lua.EventExplored(1, pt3, 1);
+    lua.EventOccupied(1, pt1);
+    lua.EventOccupied(1, pt2);
+    // Nothing till the GF
+    BOOST_REQUIRE_EQUAL(getLog(), "");
+    lua.EventGameFrame(1);
+    boost::format expFmt("explored: %1%%2%%3%\n");
+    std::string expected = (expFmt % 0 % pt2 % 1).str();
+    expected += (expFmt % 1 % pt1 % "nil").str();
+    expected += (expFmt % 1 % pt3 % 0).str();
+    expected += "occupied: 1:2\n";
+    BOOST_REQUIRE_EQUAL(getLog(), expected);
+    // Sent only once
+    lua.EventGameFrame(2);
+    BOOST_REQUIRE_EQUAL(getLog(), "");
+
+    // Points are not collected after the hook was removed
+    executeLua("onExploredPoints = nil");
+    lua.EventExplored(1, pt1, 0);
+    lua.EventGameFrame(3);
+    BOOST_REQUIRE_EQUAL(getLog(), "");
+}
+
+BOOST_AUTO_TEST_CASE(RedefineHooks)
+{
+    LuaInterfaceGame& lua = world.GetLua();
+    // Hooks defined or changed by other hooks are used
+    executeLua("function onStart(isFirstStart)\n"
+               "  function onGameFrame(gf) rttr:Log('gf1: '..gf) end\n"
+               "end");
+    clearLog();
+    lua.EventGameFrame(1);
+    BOOST_REQUIRE_EQUAL(getLog(), "");
+    lua.EventStart(true);
+    lua.EventGameFrame(2);
+    BOOST_REQUIRE_EQUAL(getLog(), "gf1: 2\n");
+    executeLua("oldGF = onGameFrame\n"
+               "onGameFrame = function(gf) rttr:Log('gf2: '..gf) oldGF(gf) end");
+    lua.EventGameFrame(3);
+    BOOST_REQUIRE_EQUAL(getLog(), "gf2: 3\ngf1: 3\n");
+    // Only functions are called
+    executeLua("onGameFrame = 42");
+    BOOST_REQUIRE(isLuaEqual("onGameFrame", "42"));
+    lua.EventGameFrame(4);
+    BOOST_REQUIRE_EQUAL(getLog(), "");
+    executeLua("onGameFrame = nil");
+    lua.EventGameFrame(5);
+    BOOST_REQUIRE_EQUAL(getLog(), "");
+    // Other globals are unaffected
+    executeLua("someGlobal = 1");
+    BOOST_REQUIRE(isLuaEqual("someGlobal", "1"));
+}
+
 BOOST_AUTO_TEST_CASE(onOccupied)
 {
     executeLua("occupied = {}\n\
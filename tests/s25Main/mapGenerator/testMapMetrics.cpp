@@ -0,0 +1,80 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "mapGenerator/Map.h"
+#include "mapGenerator/MapMetrics.h"
+#include "mapGenerator/ObjectGenerator.h"
+#include "mapGenerator/RandomConfig.h"
+#include "mapGenerator/VertexUtility.h"
+#include "gameData/TerrainDesc.h"
+#include "libsiedler2/enumTypes.h"
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(MapMetricsTest)
+
+/**
+ * Tests the MapMetrics::Compute method on a map with known terrain, objects and resources.
+ */
+BOOST_AUTO_TEST_CASE(Compute_CountsAreasAndResources)
+{
+    RandomConfig config;
+    BOOST_REQUIRE(config.Init(MapStyle::Random, DescIdx<LandscapeDesc>(0), 0x1337));
+    DescIdx<TerrainDesc> t =
+      config.FindTerrain([](const auto& desc) { return desc.kind == TerrainKind::LAND && desc.Is(ETerrain::Buildable); });
+    const uint8_t meadow = config.worldDesc.get(t).s2Id;
+    t = config.FindTerrain([](const auto& desc) { return desc.kind == TerrainKind::WATER; });
+    const uint8_t water = config.worldDesc.get(t).s2Id;
+
+    const MapExtent size(16, 16);
+    Map map(size, "map", "author");
+    map.numPlayers = 2;
+    map.hqPositions[0] = MapPoint(4, 8);
+    map.hqPositions[1] = MapPoint(12, 8);
+    RTTR_FOREACH_PT(Position, size)
+    {
+        const int index = VertexUtility::GetIndexOf(pt, size);
+        // Water in the 4 right columns which belong to player 1
+        map.textureRsu[index] = map.textureLsd[index] = (pt.x >= 12) ? water : meadow;
+    }
+    for(unsigned i = 0; i < 2; i++)
+        ObjectGenerator::CreateHeadquarter(map, VertexUtility::GetIndexOf(Position(map.hqPositions[i]), size), i);
+    map.objectInfo[20] = libsiedler2::OI_TreeOrPalm;
+    map.objectInfo[21] = libsiedler2::OI_Stone1;
+    map.resource[0] = libsiedler2::R_Gold + 5;
+    map.resource[1] = libsiedler2::R_Coal + 3;
+    map.resource[2] = libsiedler2::R_Fish;
+
+    const MapMetrics metrics = MapMetrics::Compute(map, config);
+    // Vertices in the same distance to both HQs (x = 0 and x = 8) count for player 0
+    // Player 0: 9 columns minus HQ, tree and stone. Player 1: 3 columns of land minus HQ (HQ is on water)
+    BOOST_TEST_REQUIRE(metrics.buildableArea.size() == 2u);
+    BOOST_TEST(metrics.buildableArea[0] == 9u * 16u - 3u);
+    BOOST_TEST(metrics.buildableArea[1] == 3u * 16u);
+    BOOST_TEST(metrics.hqFairness == 48. / 141.);
+    BOOST_TEST(metrics.waterShare == 0.25);
+    BOOST_TEST(metrics.gold == 5u);
+    BOOST_TEST(metrics.coal == 3u);
+    BOOST_TEST(metrics.iron == 0u);
+    BOOST_TEST(metrics.granite == 0u);
+    BOOST_TEST(metrics.fish == 1u);
+    BOOST_TEST(metrics.water == 16u * 16u - 3u);
+    BOOST_TEST(metrics.trees == 1u);
+    BOOST_TEST(metrics.stones == 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -38,9 +38,10 @@ class ObjGenFixture
 protected:
     RandomConfig config;
     MapUtility helper;
+    MapRandom rnd;
 
 public:
-    ObjGenFixture() : helper(config) { BOOST_REQUIRE(config.Init(MapStyle::Random, DescIdx<LandscapeDesc>(0), 0x1337)); }
+    ObjGenFixture() : helper(config), rnd(0x1337, 0) { BOOST_REQUIRE(config.Init(MapStyle::Random, DescIdx<LandscapeDesc>(0), 0x1337)); }
 };
 } // namespace
 
@@ -357,7 +358,7 @@ BOOST_FIXTURE_TEST_CASE(SetTree_EmptyTerrain, ObjGenFixture)
     Map map(size, "map", "author");
 
     Position p(size / 2);
-    helper.SetTree(map, p);
+    helper.SetTree(map, p, rnd);
 
     BOOST_REQUIRE_NE(map.objectType[p.y * size.x + p.x], libsiedler2::OT_Empty);
     BOOST_REQUIRE_NE(map.objectInfo[p.y * size.x + p.x], libsiedler2::OI_Empty);
@@ -382,7 +383,7 @@ BOOST_FIXTURE_TEST_CASE(SetTree_DesertTerrain, ObjGenFixture)
     }
 
     Position p(size / 2);
-    helper.SetTree(map, p);
+    helper.SetTree(map, p, rnd);
 
     BOOST_REQUIRE_NE(map.objectType[p.y * size.x + p.x], libsiedler2::OT_Empty);
     BOOST_REQUIRE_NE(map.objectInfo[p.y * size.x + p.x], libsiedler2::OI_Empty);
@@ -403,7 +404,7 @@ BOOST_FIXTURE_TEST_CASE(SetTree_NonEmptyTerrain, ObjGenFixture)
     map.objectType[index] = libsiedler2::OT_Stone_Begin;
     map.objectInfo[index] = libsiedler2::OI_Stone1;
 
-    helper.SetTree(map, p);
+    helper.SetTree(map, p, rnd);
 
     BOOST_REQUIRE_EQUAL(map.objectType[index], libsiedler2::OT_Stone_Begin);
     BOOST_REQUIRE_EQUAL(map.objectInfo[index], libsiedler2::OI_Stone1);
@@ -420,7 +421,7 @@ BOOST_FIXTURE_TEST_CASE(SetStone_EmptyTerrain, ObjGenFixture)
     Map map(size, "map", "author");
 
     Position p(size / 2);
-    helper.SetStone(map, p);
+    helper.SetStone(map, p, rnd);
 
     BOOST_REQUIRE_NE(map.objectType[p.y * size.x + p.x], libsiedler2::OT_Empty);
     BOOST_REQUIRE_NE(map.objectInfo[p.y * size.x + p.x], libsiedler2::OI_Empty);
@@ -441,7 +442,7 @@ BOOST_FIXTURE_TEST_CASE(SetStone_NonEmptyTerrain, ObjGenFixture)
     map.objectType[index] = libsiedler2::OT_Tree1_Begin;
     map.objectInfo[index] = libsiedler2::OI_TreeOrPalm;
 
-    helper.SetStone(map, p);
+    helper.SetStone(map, p, rnd);
 
     BOOST_REQUIRE_EQUAL(map.objectType[index], libsiedler2::OT_Tree1_Begin);
     BOOST_REQUIRE_EQUAL(map.objectInfo[index], libsiedler2::OI_TreeOrPalm);
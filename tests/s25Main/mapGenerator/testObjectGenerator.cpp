@@ -27,9 +27,10 @@ class ObjGenFixture
 protected:
     RandomConfig config;
     ObjectGenerator objGen;
+    MapRandom rnd;
 
 public:
-    ObjGenFixture() : objGen(config) { BOOST_REQUIRE(config.Init(MapStyle::Random, DescIdx<LandscapeDesc>(0), 0x1337)); }
+    ObjGenFixture() : objGen(config), rnd(0x1337, 0) { BOOST_REQUIRE(config.Init(MapStyle::Random, DescIdx<LandscapeDesc>(0), 0x1337)); }
 };
 } // namespace
 
@@ -41,7 +42,7 @@ BOOST_AUTO_TEST_SUITE(ObjectGeneratorTest)
  */
 BOOST_FIXTURE_TEST_CASE(CreateDuck_FullLikelyhood, ObjGenFixture)
 {
-    BOOST_REQUIRE_EQUAL(objGen.CreateDuck(100), libsiedler2::A_Duck);
+    BOOST_REQUIRE_EQUAL(objGen.CreateDuck(100, rnd), libsiedler2::A_Duck);
 }
 
 /**
@@ -50,7 +51,7 @@ BOOST_FIXTURE_TEST_CASE(CreateDuck_FullLikelyhood, ObjGenFixture)
  */
 BOOST_FIXTURE_TEST_CASE(CreateDuck_ZeroLikelyhood, ObjGenFixture)
 {
-    BOOST_REQUIRE_EQUAL(objGen.CreateDuck(0), libsiedler2::A_None);
+    BOOST_REQUIRE_EQUAL(objGen.CreateDuck(0, rnd), libsiedler2::A_None);
 }
 
 /**
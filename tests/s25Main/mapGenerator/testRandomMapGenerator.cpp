@@ -21,6 +21,7 @@
 #include "mapGenerator/RandomConfig.h"
 #include "mapGenerator/RandomMapGenerator.h"
 #include "mapGenerator/VertexUtility.h"
+#include "helpers/ThreadPool.h"
 #include "gameData/MaxPlayers.h"
 #include "libsiedler2/enumTypes.h"
 #include <boost/test/unit_test.hpp>
@@ -132,4 +133,37 @@ BOOST_AUTO_TEST_CASE(InvalidConfig)
     BOOST_REQUIRE_EQUAL(map.size, MapExtent(32, 34));
 }
 
+/**
+ * Tests the RandomMapGenerator.Create method. The same seed must generate the same map
+ * no matter how many threads are used.
+ */
+BOOST_AUTO_TEST_CASE(Create_SameMapForAllThreadCounts)
+{
+    MapSettings settings;
+    settings.size = MapExtent(64, 48);
+    settings.numPlayers = 3;
+    settings.minPlayerRadius = 0.3;
+    settings.maxPlayerRadius = 0.5;
+
+    const auto createMap = [&settings](helpers::ThreadPool* threadPool) {
+        RandomConfig config;
+        BOOST_REQUIRE(config.Init(MapStyle::Random, DescIdx<LandscapeDesc>(0), 0x1337));
+        RandomMapGenerator generator(config, threadPool);
+        return generator.Create(settings);
+    };
+    const Map expectedMap = createMap(nullptr);
+    for(unsigned numThreads : {1u, 3u})
+    {
+        helpers::ThreadPool threadPool(numThreads);
+        const Map map = createMap(&threadPool);
+        BOOST_TEST(map.z == expectedMap.z);
+        BOOST_TEST(map.textureRsu == expectedMap.textureRsu);
+        BOOST_TEST(map.textureLsd == expectedMap.textureLsd);
+        BOOST_TEST(map.objectType == expectedMap.objectType);
+        BOOST_TEST(map.objectInfo == expectedMap.objectInfo);
+        BOOST_TEST(map.animal == expectedMap.animal);
+        BOOST_TEST(map.resource == expectedMap.resource);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
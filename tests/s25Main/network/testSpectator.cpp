@@ -0,0 +1,201 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "PointOutput.h"
+#include "network/SpectatorClient.h"
+#include "network/SpectatorFeed.h"
+#include "network/SpectatorMessages.h"
+#include "worldFixtures/WorldWithGCExecution.h"
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <thread>
+
+namespace {
+const uint16_t spectatorPort = 5665;
+
+/// Run feed and clients till the condition is met or the time is up
+template<class T_Condition>
+bool runTill(SpectatorFeed& feed, std::vector<SpectatorClient*> clients, T_Condition condition)
+{
+    for(int i = 0; i < 2000; i++)
+    {
+        feed.Run();
+        for(SpectatorClient* client : clients)
+            BOOST_TEST_REQUIRE(client->Run());
+        if(condition())
+            return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+void checkRegion(const SpectatorClient& client, const GameWorldBase& world, unsigned char viewer = SpectatorFeed::ALL_VISIBLE)
+{
+    const SpectatorRegion& region = client.GetRegion();
+    for(unsigned i = 0; i < region.GetNumNodes(); i++)
+    {
+        const MapPoint pt = region.GetPoint(i, world.GetSize());
+        BOOST_TEST_INFO("Pt " << pt);
+        BOOST_TEST((client.GetNode(pt) == SpectatorFeed::GetNode(world, pt, viewer)));
+    }
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(SpectatorSuite)
+
+BOOST_AUTO_TEST_CASE(RegionWrapsAndClamps)
+{
+    const MapExtent mapSize(20, 10);
+    const SpectatorRegion region = SpectatorRegion(MapPoint(18, 8), MapExtent(5, 30)).ClampTo(mapSize);
+    BOOST_TEST(region.size == MapExtent(5, 10));
+    BOOST_TEST(region.GetNumNodes() == 50u);
+    BOOST_TEST(region.Contains(MapPoint(1, 3), mapSize));
+    BOOST_TEST(!region.Contains(MapPoint(5, 3), mapSize));
+    BOOST_TEST(region.GetPoint(0, mapSize) == MapPoint(18, 8));
+    BOOST_TEST(region.GetPoint(3, mapSize) == MapPoint(1, 8));
+    BOOST_TEST(region.GetPoint(5, mapSize) == MapPoint(18, 9));
+    BOOST_TEST(region.GetPoint(10, mapSize) == MapPoint(18, 0));
+    for(unsigned i = 0; i < region.GetNumNodes(); i++)
+        BOOST_TEST(region.GetIdx(region.GetPoint(i, mapSize), mapSize) == i);
+}
+
+BOOST_FIXTURE_TEST_CASE(StreamsSnapshotAndChanges, WorldWithGCExecution2P)
+{
+    SpectatorFeed feed(world);
+    BOOST_TEST_REQUIRE(feed.Listen(spectatorPort));
+
+    SpectatorClient client, fullClient;
+    BOOST_TEST_REQUIRE(client.Connect("localhost", spectatorPort));
+    BOOST_TEST_REQUIRE(fullClient.Connect("localhost", spectatorPort));
+    const SpectatorRegion region(world.MakeMapPoint(Position(hqPos) - Position(5, 5)), MapExtent(11, 11));
+    client.Subscribe(region);
+    // Larger than the map -> Whole map
+    fullClient.Subscribe(SpectatorRegion(MapPoint(3, 2), MapExtent(1000, 1000)));
+
+    BOOST_TEST_REQUIRE(runTill(feed, {&client, &fullClient}, [&]() { return client.HasData() && fullClient.HasData(); }));
+    BOOST_TEST(feed.GetNumSpectators() == 2u);
+    BOOST_TEST(client.GetMapSize() == world.GetSize());
+    BOOST_TEST(client.GetRegion().size == region.size);
+    BOOST_TEST(fullClient.GetRegion().size == world.GetSize());
+    checkRegion(client, world);
+    checkRegion(fullClient, world);
+
+    // Build a road from the HQ flag out of the region of the first client
+    const MapPoint hqFlagPos = world.GetNeighbour(hqPos, Direction::SOUTHEAST);
+    BOOST_TEST_REQUIRE(this->BuildRoad(hqFlagPos, false, std::vector<Direction>(6, Direction::EAST)));
+    const MapPoint flagPos = world.MakeMapPoint(Position(hqFlagPos) + Position(6, 0));
+    BOOST_TEST_REQUIRE(world.GetNO(flagPos)->GetGOT() == GOT_FLAG);
+
+    feed.PublishChanges(10);
+    BOOST_TEST_REQUIRE(runTill(feed, {&client, &fullClient}, [&]() { return client.GetGF() == 10u && fullClient.GetGF() == 10u; }));
+    checkRegion(client, world);
+    checkRegion(fullClient, world);
+    BOOST_TEST(client.GetNode(hqFlagPos).roads[0] != 0u);
+    BOOST_TEST(fullClient.GetNode(flagPos).got == GOT_FLAG);
+
+    // Nothing changed -> Only the GF is updated
+    feed.PublishChanges(20);
+    BOOST_TEST_REQUIRE(runTill(feed, {&client}, [&]() { return client.GetGF() == 20u; }));
+    checkRegion(client, world);
+
+    // Resubscribing sends a new snapshot
+    client.Subscribe(SpectatorRegion(flagPos, MapExtent(2, 2)));
+    BOOST_TEST(!client.HasData());
+    BOOST_TEST_REQUIRE(runTill(feed, {&client}, [&]() { return client.HasData(); }));
+    BOOST_TEST(client.GetNode(flagPos).got == GOT_FLAG);
+    checkRegion(client, world);
+
+    client.Disconnect();
+    fullClient.Disconnect();
+    BOOST_TEST_REQUIRE(runTill(feed, {}, [&]() { return feed.GetNumSpectators() == 0u; }));
+    feed.Stop();
+    BOOST_TEST(!feed.IsRunning());
+}
+
+BOOST_FIXTURE_TEST_CASE(StaysInSyncDuringLongerGame, WorldWithGCExecution2P)
+{
+    SpectatorFeed feed(world);
+    BOOST_TEST_REQUIRE(feed.Listen(spectatorPort + 1));
+
+    SpectatorClient client, fullClient;
+    BOOST_TEST_REQUIRE(client.Connect("localhost", spectatorPort + 1));
+    BOOST_TEST_REQUIRE(fullClient.Connect("localhost", spectatorPort + 1));
+    client.Subscribe(SpectatorRegion(world.MakeMapPoint(Position(hqPos) - Position(8, 8)), MapExtent(17, 17)));
+    fullClient.Subscribe(SpectatorRegion(MapPoint(0, 0), world.GetSize()));
+    BOOST_TEST_REQUIRE(runTill(feed, {&client, &fullClient}, [&]() { return client.HasData() && fullClient.HasData(); }));
+
+    // Buildings which get built, occupied and worked at, changing objects, roads and owners over time
+    const MapPoint hqFlagPos = world.GetNeighbour(hqPos, Direction::SOUTHEAST);
+    const MapPoint woodcutterFlagPos = world.MakeMapPoint(Position(hqFlagPos) + Position(4, 0));
+    const MapPoint barracksFlagPos = world.MakeMapPoint(Position(hqFlagPos) - Position(4, 0));
+    this->SetBuildingSite(world.GetNeighbour(woodcutterFlagPos, Direction::NORTHWEST), BLD_WOODCUTTER);
+    this->SetBuildingSite(world.GetNeighbour(barracksFlagPos, Direction::NORTHWEST), BLD_BARRACKS);
+    BOOST_TEST_REQUIRE(this->BuildRoad(hqFlagPos, false, std::vector<Direction>(4, Direction::EAST)));
+    BOOST_TEST_REQUIRE(this->BuildRoad(hqFlagPos, false, std::vector<Direction>(4, Direction::WEST)));
+
+    const MapPoint flagPos = world.MakeMapPoint(Position(hqPos) + Position(0, 4));
+    for(unsigned i = 0; i < 30; i++)
+    {
+        // Objects which are set and destroyed between the publishes
+        if(i % 2)
+            this->DestroyFlag(flagPos);
+        else
+            this->SetFlag(flagPos);
+        RTTR_SKIP_GFS(100);
+        const unsigned gf = em.GetCurrentGF();
+        feed.PublishChanges(gf);
+        BOOST_TEST_REQUIRE(runTill(feed, {&client, &fullClient}, [&]() { return client.GetGF() == gf && fullClient.GetGF() == gf; }));
+    }
+    checkRegion(client, world);
+    checkRegion(fullClient, world);
+
+    feed.Stop();
+}
+
+BOOST_FIXTURE_TEST_CASE(StreamsOnlyWhatThePlayerSees, WorldWithGCExecution2P)
+{
+    SpectatorFeed feed(world, curPlayer);
+    BOOST_TEST_REQUIRE(feed.Listen(spectatorPort + 2));
+    SpectatorClient client;
+    BOOST_TEST_REQUIRE(client.Connect("localhost", spectatorPort + 2));
+    client.Subscribe(SpectatorRegion(MapPoint(0, 0), world.GetSize()));
+    BOOST_TEST_REQUIRE(runTill(feed, {&client}, [&]() { return client.HasData(); }));
+    checkRegion(client, world, curPlayer);
+
+    const MapPoint enemyHqPos = world.GetPlayer(1).GetHQPos();
+    BOOST_TEST_REQUIRE(world.CalcVisiblityWithAllies(enemyHqPos, curPlayer) != VIS_VISIBLE);
+    BOOST_TEST(client.GetNode(hqPos).got == GOT_NOB_HQ);
+    BOOST_TEST(client.GetNode(enemyHqPos).got == GOT_NOTHING);
+    BOOST_TEST(client.GetNode(enemyHqPos).owner == 0u);
+
+    // Changes out of sight are not streamed either
+    const MapPoint enemyFlagPos = world.MakeMapPoint(Position(enemyHqPos) + Position(0, 4));
+    BOOST_TEST_REQUIRE(world.CalcVisiblityWithAllies(enemyFlagPos, curPlayer) != VIS_VISIBLE);
+    curPlayer = 1;
+    this->SetFlag(enemyFlagPos);
+    curPlayer = 0;
+    BOOST_TEST_REQUIRE(world.GetNO(enemyFlagPos)->GetGOT() == GOT_FLAG);
+    feed.PublishChanges(10);
+    BOOST_TEST_REQUIRE(runTill(feed, {&client}, [&]() { return client.GetGF() == 10u; }));
+    BOOST_TEST(client.GetNode(enemyFlagPos).got == GOT_NOTHING);
+    checkRegion(client, world, curPlayer);
+
+    feed.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
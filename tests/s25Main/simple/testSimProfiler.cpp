@@ -0,0 +1,116 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "SimProfiler.h"
+#include "helpers/chronoIO.h"
+#include <boost/test/unit_test.hpp>
+#include <sstream>
+
+namespace {
+struct ProfilerFixture
+{
+    ProfilerFixture() { SIMPROFILER.reset(); }
+    ~ProfilerFixture()
+    {
+        SIMPROFILER.setEnabled(false);
+        SIMPROFILER.setTraceEnabled(false);
+        SIMPROFILER.reset();
+    }
+};
+
+Clock::time_point timeAt(unsigned us)
+{
+    return Clock::time_point(std::chrono::microseconds(us));
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(SimProfilerTests, ProfilerFixture)
+
+BOOST_AUTO_TEST_CASE(AccumulatesAndSorts)
+{
+    SIMPROFILER.add(SimProfiler::PROF_EVENT, "nofCarrier", 1, timeAt(0), timeAt(10));
+    SIMPROFILER.add(SimProfiler::PROF_EVENT, "nofCarrier", 1, timeAt(10), timeAt(40));
+    SIMPROFILER.add(SimProfiler::PROF_EVENT, "nofCarrier", 2, timeAt(40), timeAt(45));
+    SIMPROFILER.add(SimProfiler::PROF_AI, "ExecuteAIJob", 0, timeAt(50), timeAt(150));
+
+    std::vector<SimProfiler::Entry> entries = SIMPROFILER.getEntries(SimProfiler::SORT_TOTAL);
+    BOOST_TEST_REQUIRE(entries.size() == 3u);
+    BOOST_TEST(entries[0].name == "ExecuteAIJob");
+    BOOST_TEST(entries[1].name == "nofCarrier");
+    BOOST_TEST(entries[1].id == 1u);
+    BOOST_TEST(entries[1].count == 2u);
+    BOOST_TEST(entries[1].total == std::chrono::microseconds(40));
+    BOOST_TEST(entries[1].max == std::chrono::microseconds(30));
+    BOOST_TEST(entries[1].getAverage() == std::chrono::microseconds(20));
+
+    entries = SIMPROFILER.getEntries(SimProfiler::SORT_COUNT);
+    BOOST_TEST(entries[0].name == "nofCarrier");
+    BOOST_TEST(entries[0].id == 1u);
+    entries = SIMPROFILER.getEntries(SimProfiler::SORT_MAX);
+    BOOST_TEST(entries[2].id == 2u);
+
+    std::stringstream report;
+    SIMPROFILER.writeReport(report);
+    BOOST_TEST(report.str().find("ExecuteAIJob") != std::string::npos);
+    // No timeline unless enabled
+    BOOST_TEST(SIMPROFILER.getNumTraceEvents() == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(WritesTrace)
+{
+    SIMPROFILER.setTraceEnabled(true, 2);
+    SIMPROFILER.add(SimProfiler::PROF_GF, "GameFrame", 7, timeAt(100), timeAt(200));
+    SIMPROFILER.add(SimProfiler::PROF_LUA, "onGameFrame", 0, timeAt(120), timeAt(150));
+    SIMPROFILER.add(SimProfiler::PROF_GF, "GameFrame", 8, timeAt(200), timeAt(300));
+    BOOST_TEST(SIMPROFILER.getNumTraceEvents() == 2u);
+    BOOST_TEST(SIMPROFILER.getNumDroppedTraceEvents() == 1u);
+    // Stats are still recorded
+    BOOST_TEST(SIMPROFILER.getEntries().size() == 3u);
+
+    std::stringstream trace;
+    SIMPROFILER.writeTrace(trace);
+    const std::string expected = "{\"traceEvents\":[\n"
+                                 "{\"name\":\"GameFrame\",\"cat\":\"GF\",\"ph\":\"X\",\"ts\":0,\"dur\":100,\"pid\":0,\"tid\":0,\"args\":{\"id\":7}},\n"
+                                 "{\"name\":\"onGameFrame\",\"cat\":\"Lua\",\"ph\":\"X\",\"ts\":20,\"dur\":30,\"pid\":0,\"tid\":0,\"args\":{\"id\":0}}\n"
+                                 "],\"displayTimeUnit\":\"ms\"}\n";
+    BOOST_TEST(trace.str() == expected);
+}
+
+BOOST_AUTO_TEST_CASE(ScopeOnlyRecordsWhenEnabled)
+{
+    {
+        SimProfilerScope scope(SimProfiler::PROF_GC, "SET_FLAG", 1);
+    }
+    BOOST_TEST(SIMPROFILER.getEntries().empty());
+    SIMPROFILER.setEnabled(true);
+    {
+        SimProfilerScope scope(SimProfiler::PROF_GC, "SET_FLAG", 1);
+    }
+    const std::vector<SimProfiler::Entry> entries = SIMPROFILER.getEntries();
+    BOOST_TEST_REQUIRE(entries.size() == 1u);
+    BOOST_TEST(entries[0].category == SimProfiler::PROF_GC);
+    BOOST_TEST(entries[0].count == 1u);
+}
+
+BOOST_AUTO_TEST_CASE(GOTypeNames)
+{
+    BOOST_TEST(SimProfiler::getGOTypeName(GOT_NOF_CARRIER) == std::string("nofCarrier"));
+    BOOST_TEST(SimProfiler::getGOTypeName(GOT_NOF_TRADEDONKEY) == std::string("nofTradeDonkey"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,60 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GCCollector_h__
+#define GCCollector_h__
+
+#include "GameCommand.h"
+#include "factories/GameCommandFactory.h"
+#include "gameTypes/InventorySetting.h"
+#include "gameTypes/PactTypes.h"
+#include <vector>
+
+/// Stores the commands instead of executing them
+class GCCollector : public GameCommandFactory
+{
+public:
+    std::vector<gc::GameCommandPtr> gcs;
+
+protected:
+    bool AddGC(gc::GameCommandPtr gc) override
+    {
+        gcs.push_back(gc);
+        return true;
+    }
+};
+
+/// Create the commands of a busy NWF: Mostly commands at (nearby) map points like an AI issues them
+inline void createBusyNWFCommands(GameCommandFactory& factory)
+{
+    for(unsigned i = 0; i < 100u; i++)
+    {
+        const MapPoint pt(100 + i % 10u * 3u, 50 + i / 10u * 2u);
+        factory.SetFlag(pt);
+        factory.BuildRoad(pt, false, std::vector<Direction>(4, Direction(i % 6u)));
+        factory.SetBuildingSite(MapPoint(pt.x, pt.y - 1), BLD_WOODCUTTER);
+        factory.SetCoinsAllowed(pt, i % 2u == 0u);
+        factory.SetInventorySetting(pt, JOB_PRIVATE, EInventorySetting::STOP);
+        if(i % 10u == 0u)
+        {
+            factory.Attack(MapPoint(pt.x + 20, pt.y), 10, true);
+            factory.SuggestPact(1, TREATY_OF_ALLIANCE, 0xFFFFFFFF);
+        }
+    }
+}
+
+#endif // GCCollector_h__
@@ -22,6 +22,7 @@
 #include "factories/GameCommandFactory.h"
 #include "libutil/Serializer.h"
 #include <boost/test/unit_test.hpp>
+#include <vector>
 
 class GCExecutor : public GameCommandFactory
 {
@@ -34,12 +35,14 @@ protected:
     {
         // Go through serialization to check if that works too
         Serializer ser;
-        gc->Serialize(ser);
+        gc::GameCommand::SerializeBatch(ser, {gc});
         gc.reset();
-        gc = gc::GameCommand::Deserialize(ser);
+        std::vector<gc::GameCommandPtr> gcs = gc::GameCommand::DeserializeBatch(ser);
         BOOST_REQUIRE_EQUAL(ser.GetBytesLeft(), 0u);
+        BOOST_REQUIRE_EQUAL(gcs.size(), 1u);
+        gc = gcs.front();
         Serializer ser2;
-        gc->Serialize(ser2);
+        gc::GameCommand::SerializeBatch(ser2, gcs);
         BOOST_REQUIRE_EQUAL(ser2.GetLength(), ser.GetLength());
         BOOST_REQUIRE_EQUAL(memcmp(ser2.GetData(), ser.GetData(), ser.GetLength()), 0);
         gc->Execute(GetWorld(), curPlayer);